@@ -30,6 +30,8 @@ check_function_exists( GetTempPath HAVE_WINDOWS_GET_TEMP_PATH )
 check_function_exists( fork HAVE_FORK )
 check_function_exists( getpwuid HAVE_GETPWUID )
 check_function_exists( fsync HAVE_FSYNC )
+check_function_exists( mmap HAVE_MMAP )
+check_function_exists( mkstemp HAVE_MKSTEMP )
 check_function_exists( setenv HAVE_POSIX_SETENV )
 check_function_exists( chmod HAVE_CHMOD )
 check_function_exists( pthread_timedjoin_np HAVE_TIMEDJOIN)
@@ -59,6 +61,9 @@ include(CheckSymbolExists)
 check_symbol_exists(_tzname time.h HAVE_WINDOWS_TZNAME)
 check_symbol_exists( tzname time.h HAVE_TZNAME)
 
+include(CheckStructHasMember)
+check_struct_has_member( "struct stat" st_mtim sys/stat.h HAVE_STAT_MTIM )
+
 find_path( HAVE_EXECINFO execinfo.h /usr/include )
 
 try_compile( HAVE_VA_COPY ${CMAKE_BINARY_DIR} ${PROJECT_SOURCE_DIR}/cmake/Tests/test_va_copy.c )
@@ -0,0 +1,154 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'fmt_load_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Benchmark of loading formatted keywords:
+
+    bash% fmt_load_bench [size]
+
+  A float and a double keyword of @size elements (default 5 million,
+  i.e. a 5 million cell grid property) are written to formatted
+  ECLIPSE files and to a GRDECL file in the current directory, and
+  then loaded again. As reference the float file is also parsed with
+  one fscanf() call per element, which is how the formatted files were
+  parsed previously.
+*/
+
+
+static void write_files( int size ) {
+  ecl_kw_type * float_kw  = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , size , ECL_DOUBLE );
+  int i;
+
+  for (i=0; i < size; i++) {
+    ecl_kw_iset_float( float_kw , i , 0.001 * (i % 100000));
+    ecl_kw_iset_double( double_kw , i , 0.001 * (i % 100000));
+  }
+
+  {
+    fortio_type * fortio = fortio_open_writer( "BENCH.FLOAT" , true , ECL_ENDIAN_FLIP );
+    ecl_kw_fwrite( float_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  {
+    fortio_type * fortio = fortio_open_writer( "BENCH.DOUBLE" , true , ECL_ENDIAN_FLIP );
+    ecl_kw_fwrite( double_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  {
+    FILE * stream = util_fopen( "BENCH.grdecl" , "w");
+    ecl_kw_fprintf_grdecl( float_kw , stream );
+    fclose( stream );
+  }
+
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+}
+
+
+static double load_kw( const char * filename ) {
+  timer_type * timer = timer_alloc( false );
+  double t;
+
+  timer_start( timer );
+  {
+    fortio_type * fortio = fortio_open_reader( filename , true , ECL_ENDIAN_FLIP );
+    ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( fortio );
+    ecl_kw_free( ecl_kw );
+    fortio_fclose( fortio );
+  }
+  t = timer_stop( timer );
+  timer_free( timer );
+  return t;
+}
+
+
+static double load_grdecl( const char * filename ) {
+  timer_type * timer = timer_alloc( false );
+  double t;
+
+  timer_start( timer );
+  {
+    FILE * stream = util_fopen( filename , "r");
+    ecl_kw_type * ecl_kw = ecl_kw_fscanf_alloc_grdecl_dynamic( stream , "FLOAT" , ECL_FLOAT );
+    ecl_kw_free( ecl_kw );
+    fclose( stream );
+  }
+  t = timer_stop( timer );
+  timer_free( timer );
+  return t;
+}
+
+
+static double load_fscanf( const char * filename , int size ) {
+  timer_type * timer = timer_alloc( false );
+  float * data = util_calloc( size , sizeof * data );
+  double t;
+
+  timer_start( timer );
+  {
+    FILE * stream = util_fopen( filename , "r");
+    char header[32];
+    int i;
+
+    if (fscanf( stream , "%s %s %s %s" , header , header , header , header ) != 4)
+      util_abort("%s: failed to read header from:%s \n",__func__ , filename);
+
+    for (i=0; i < size; i++)
+      if (fscanf( stream , "%gE" , &data[i] ) != 1)
+        util_abort("%s: read failed \n",__func__);
+
+    fclose( stream );
+  }
+  t = timer_stop( timer );
+  timer_free( timer );
+  free( data );
+  return t;
+}
+
+
+int main(int argc, char ** argv) {
+  int size = 5000000;
+
+  if (argc > 1)
+    util_sscanf_int( argv[1] , &size );
+
+  write_files( size );
+  printf("Elements: %d \n", size);
+  printf("fscanf() per element     float  : %8.4f sec \n", load_fscanf( "BENCH.FLOAT" , size ));
+  printf("ecl_kw_fread_alloc()     float  : %8.4f sec \n", load_kw( "BENCH.FLOAT" ));
+  printf("ecl_kw_fread_alloc()     double : %8.4f sec \n", load_kw( "BENCH.DOUBLE" ));
+  printf("ecl_kw_fscanf_alloc_grdecl()    : %8.4f sec \n", load_grdecl( "BENCH.grdecl" ));
+
+  remove( "BENCH.FLOAT" );
+  remove( "BENCH.DOUBLE" );
+  remove( "BENCH.grdecl" );
+  exit(0);
+}
@@ -43,6 +43,9 @@ typedef struct inv_map_struct inv_map_type;
   ecl_kw_type      * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio, inv_map_type * inv_map);
   ecl_kw_type      * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map );
   ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src );
+  bool               ecl_file_kw_fwrite( const ecl_file_kw_type * file_kw , FILE * stream );
+  ecl_file_kw_type * ecl_file_kw_fread_alloc( FILE * stream , offset_type file_size , bool fmt_file);
+  bool               ecl_file_kw_fcheck_header( const ecl_file_kw_type * file_kw , fortio_type * fortio);
   const char       * ecl_file_kw_get_header( const ecl_file_kw_type * file_kw );
   int                ecl_file_kw_get_size( const ecl_file_kw_type * file_kw );
   ecl_data_type      ecl_file_kw_get_data_type(const ecl_file_kw_type *);
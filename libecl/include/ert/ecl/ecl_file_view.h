@@ -38,12 +38,26 @@ typedef enum {
                                     mainly to save filedescriptors in cases where many ecl_file instances are open at
                                     the same time. */
   //
-  ECL_FILE_WRITABLE      =  2    /*
+  ECL_FILE_WRITABLE      =  2 ,  /*
                                     This flag opens the file in a mode where it can be updated and modified, but it
                                     must still exist and be readable. I.e. this should not compared with the normal:
                                     fopen(filename , "w") where an existing file is truncated to zero upon successfull
                                     open.
                                  */
+  //
+  ECL_FILE_MMAP          =  4 ,  /*
+                                    This flag will memory map the file and serve all keyword loads from the
+                                    mapping instead of through fseek()/fread() on a FILE object. Only used for
+                                    unformatted files opened read-only; otherwise it is silently ignored.
+                                 */
+  //
+  ECL_FILE_INDEX         =  8    /*
+                                    This flag will store the index created by scanning the file in a file
+                                    'filename.index' next to the file, and reuse that index instead of scanning
+                                    the file the next time it is opened. The index is only reused if the size and
+                                    modification time of the file are unchanged, and the first and last keyword
+                                    headers in the index are still found in the file.
+                                 */
 } ecl_file_flag_type;
 
 
@@ -73,6 +87,8 @@ typedef struct ecl_file_view_struct ecl_file_view_type;
   void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type * old_kw , ecl_kw_type * new_kw , bool insert_copy);
   bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw);
+  bool ecl_file_view_write_index( const ecl_file_view_type * ecl_file_view , FILE * stream );
+  bool ecl_file_view_fread_index( ecl_file_view_type * ecl_file_view , FILE * stream , offset_type file_size );
   void ecl_file_view_free( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_free__( void * arg );
   int ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , const char * kw);
@@ -0,0 +1,50 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_fmt_scan.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_FMT_SCAN_H
+#define ERT_ECL_FMT_SCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+typedef struct ecl_fmt_scan_struct ecl_fmt_scan_type;
+
+  ecl_fmt_scan_type * ecl_fmt_scan_alloc( FILE * stream );
+  void                ecl_fmt_scan_free( ecl_fmt_scan_type * scan );
+  bool                ecl_fmt_scan_next_token( ecl_fmt_scan_type * scan , const char ** token , int * length );
+  bool                ecl_fmt_scan_skip_line( ecl_fmt_scan_type * scan );
+  bool                ecl_fmt_scan_next_int( ecl_fmt_scan_type * scan , int * value );
+  bool                ecl_fmt_scan_next_float( ecl_fmt_scan_type * scan , float * value );
+  bool                ecl_fmt_scan_next_double( ecl_fmt_scan_type * scan , double * value );
+
+  bool                ecl_fmt_scan_parse_int( const char * token , int length , int * value );
+  bool                ecl_fmt_scan_parse_float( const char * token , int length , float * value );
+  bool                ecl_fmt_scan_parse_double( const char * token , int length , double * value );
+
+  UTIL_IS_INSTANCE_HEADER( ecl_fmt_scan );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -23,9 +23,13 @@ extern "C" {
 #endif
 #include <stdbool.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/double_vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_coarse_cell.h>
 #include <ert/ecl/ecl_kw.h>
@@ -89,6 +93,10 @@ extern "C" {
   bool            ecl_grid_cell_contains1(const ecl_grid_type * grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains3(const ecl_grid_type * grid , int i , int j ,int k , double x , double y , double z);
   int             ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index);
+  void            ecl_grid_get_global_index_list_from_xyz( ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index);
+#ifdef ERT_HAVE_THREAD_POOL
+  void            ecl_grid_get_global_index_list_from_xyz_mt( ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index , thread_pool_type * thread_pool);
+#endif
   bool            ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k );
   bool            ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j);
   const  char   * ecl_grid_get_name( const ecl_grid_type * );
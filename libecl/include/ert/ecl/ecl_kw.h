@@ -72,6 +72,7 @@ extern "C" {
   void           ecl_kw_set_data_ptr(ecl_kw_type * ecl_kw , void * data);
   void           ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw , fortio_type *fortio);
   bool           ecl_kw_fread_realloc_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
+  bool           ecl_kw_fread_data_as_double(const ecl_kw_type * ecl_kw , fortio_type * fortio , double * double_data);
   ecl_data_type  ecl_kw_get_data_type(const ecl_kw_type *);
   size_t         ecl_kw_get_sizeof_ctype(const ecl_kw_type *);
   const char   * ecl_kw_get_header8(const ecl_kw_type *);
@@ -30,7 +30,12 @@ extern "C" {
 #include <ert/util/stringlist.h>
 #include <ert/util/time_t_vector.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
 #include <ert/util/time_interval.h>
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_sum_tstep.h>
@@ -75,12 +80,15 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   int              ecl_sum_get_num( const ecl_sum_type * sum , const char * gen_key );
 
   double           ecl_sum_iget( const ecl_sum_type * ecl_sum , int time_index , int param_index);
+  void             ecl_sum_init_double_block( const ecl_sum_type * ecl_sum , const int_vector_type * params_index_list , const int_vector_type * time_index_list , double * block);
   int              ecl_sum_iget_num( const ecl_sum_type * sum , int param_index );
   const char *     ecl_sum_iget_wgname( const ecl_sum_type * sum , int param_index );
   const char *     ecl_sum_iget_keyword( const ecl_sum_type * sum , int param_index );
   int              ecl_sum_get_data_length( const ecl_sum_type * ecl_sum );
   void             ecl_sum_scale_vector( ecl_sum_type * ecl_sum, int index, double scalar );
   void             ecl_sum_shift_vector( ecl_sum_type * ecl_sum, int index, double addend );
+  void             ecl_sum_set_column_cache( ecl_sum_type * ecl_sum , bool enabled );
+  bool             ecl_sum_has_column_cache( const ecl_sum_type * ecl_sum );
   double           ecl_sum_iget_from_sim_time( const ecl_sum_type * ecl_sum , time_t sim_time , int param_index);
   double           ecl_sum_iget_from_sim_days( const ecl_sum_type * ecl_sum , double sim_days , int param_index );
 
@@ -92,6 +100,9 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   void             ecl_sum_free__(void * );
   void             ecl_sum_free(ecl_sum_type * );
   ecl_sum_type   * ecl_sum_fread_alloc(const char * , const stringlist_type * data_files, const char * key_join_string);
+#ifdef ERT_HAVE_THREAD_POOL
+  ecl_sum_type   * ecl_sum_fread_alloc_mt(const char * , const stringlist_type * data_files, const char * key_join_string , thread_pool_type * thread_pool);
+#endif
   ecl_sum_type   * ecl_sum_fread_alloc_case(const char *  , const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case__(const char *  , const char * key_join_string , bool include_restart);
   bool             ecl_sum_case_exists( const char * input_file );
@@ -30,6 +30,10 @@ extern "C" {
 #include <ert/util/double_vector.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/time_interval.h>
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_sum_tstep.h>
 #include <ert/ecl/smspec_node.h>
@@ -41,6 +45,9 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   void                     ecl_sum_data_fwrite_step( const ecl_sum_data_type * data , const char * ecl_case , bool fmt_case , bool unified, int report_step);
   void                     ecl_sum_data_fwrite( const ecl_sum_data_type * data , const char * ecl_case , bool fmt_case , bool unified);
   bool                     ecl_sum_data_fread( ecl_sum_data_type * data , const stringlist_type * filelist);
+#ifdef ERT_HAVE_THREAD_POOL
+  bool                     ecl_sum_data_fread_mt( ecl_sum_data_type * data , const stringlist_type * filelist , thread_pool_type * thread_pool);
+#endif
   void                     ecl_sum_data_fread_restart( ecl_sum_data_type * data , const stringlist_type * filelist);
   ecl_sum_data_type      * ecl_sum_data_alloc_writer( ecl_smspec_type * smspec );
   ecl_sum_data_type      * ecl_sum_data_alloc( ecl_smspec_type * smspec);
@@ -63,6 +70,7 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   double                   ecl_sum_data_get_sim_length( const ecl_sum_data_type * data );
   void                     ecl_sum_data_summarize(const ecl_sum_data_type * data , FILE * stream);
   double                   ecl_sum_data_iget( const ecl_sum_data_type * data , int internal_index , int params_index );
+  void                     ecl_sum_data_init_double_block( const ecl_sum_data_type * data , const int_vector_type * params_index_list , const int_vector_type * time_index_list , double * block);
 
   double                   ecl_sum_data_iget_sim_days( const ecl_sum_data_type *  , int );
   time_t                   ecl_sum_data_iget_sim_time( const ecl_sum_data_type *  , int );
@@ -83,6 +91,8 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   int                      ecl_sum_data_get_length( const ecl_sum_data_type * data );
   void                     ecl_sum_data_scale_vector( ecl_sum_data_type * data , int index, double scalar );
   void                     ecl_sum_data_shift_vector( ecl_sum_data_type * data , int index, double addend );
+  void                     ecl_sum_data_set_column_cache( ecl_sum_data_type * data , bool enabled );
+  bool                     ecl_sum_data_has_column_cache( const ecl_sum_data_type * data );
   int                      ecl_sum_data_iget_report_step(const ecl_sum_data_type * data , int internal_index);
   int                      ecl_sum_data_iget_mini_step(const ecl_sum_data_type * data , int internal_index);
   int                      ecl_sum_data_iget_report_end( const ecl_sum_data_type * data , int report_step );
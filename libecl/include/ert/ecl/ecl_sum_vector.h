@@ -38,6 +38,7 @@ typedef struct ecl_sum_vector_struct ecl_sum_vector_type;
   bool ecl_sum_vector_iget_is_rate(const ecl_sum_vector_type * ecl_sum_vector, int index);
   int ecl_sum_vector_iget_param_index(const ecl_sum_vector_type * ecl_sum_vector, int index);
   int ecl_sum_vector_get_size(const ecl_sum_vector_type * ecl_sum_vector);
+  void ecl_sum_vector_init_double_block(const ecl_sum_vector_type * ecl_sum_vector, const int_vector_type * time_index_list, double * block);
 
   UTIL_IS_INSTANCE_HEADER( ecl_sum_vector);
 
@@ -46,6 +46,8 @@ typedef struct fortio_struct fortio_type;
   bool               fortio_looks_like_fortran_file(const char *  , bool );
   void               fortio_copy_record(fortio_type * , fortio_type * , int , void * , bool *);
   fortio_type *      fortio_open_reader(const char *, bool fmt_file , bool endian_flip_header);
+  fortio_type *      fortio_open_reader_mmap(const char *, bool fmt_file , bool endian_flip_header);
+  bool               fortio_is_mmapped( const fortio_type * fortio );
   fortio_type *      fortio_open_writer(const char *, bool fmt_file , bool endian_flip_header);
   fortio_type *      fortio_open_readwrite(const char *, bool fmt_file , bool endian_flip_header);
   fortio_type *      fortio_open_append(const char *filename , bool fmt_file , bool endian_flip_header);
@@ -59,12 +61,13 @@ typedef struct fortio_struct fortio_type;
   void               fortio_fskip_buffer(fortio_type *, int );
   int                fortio_fskip_record(fortio_type *);
   bool               fortio_fread_buffer(fortio_type * , char * buffer, int buffer_size);
+  bool               fortio_fread_raw( fortio_type * fortio , void * buffer , size_t byte_size);
   void               fortio_fwrite_record(fortio_type * , const char * buffer, int buffer_size);
   FILE        *      fortio_get_FILE(const fortio_type *);
   void               fortio_fflush(fortio_type * ) ;
   bool               fortio_ftruncate_current( fortio_type * fortio);
   bool               fortio_is_fortio_file(fortio_type * );
-  void               fortio_rewind(const fortio_type *fortio);
+  void               fortio_rewind(fortio_type *fortio);
   const char  *      fortio_filename_ref(const fortio_type * );
   bool               fortio_fmt_file(const fortio_type *);
   offset_type        fortio_ftell( const fortio_type * fortio );
@@ -21,6 +21,17 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
+
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_MKSTEMP
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_CHMOD
+#include <sys/stat.h>
+#endif
 
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
@@ -123,6 +134,14 @@
 
 #define ECL_FILE_ID 776107
 
+/*
+  Identifier and version of the on-disk index written by
+  ecl_file_write_index(); the version must be bumped if the layout
+  of the index file is changed.
+*/
+#define ECL_FILE_INDEX_ID      776119
+#define ECL_FILE_INDEX_VERSION 2
+
 
 
 
@@ -558,6 +577,179 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
 }
 
 
+/*****************************************************************/
+/*
+  The persistent index. The index file contains the header
+  information of all the keywords, i.e. the content of the global
+  view after a scan, along with the size and modification time of the
+  file which was scanned:
+
+     ECL_FILE_INDEX_ID
+     ECL_FILE_INDEX_VERSION
+     file_size
+     mtime_sec
+     mtime_nsec
+     num_kw
+     [header_length , type , element_size , kw_size , header , offset] * num_kw
+
+  When the file is opened with the ECL_FILE_INDEX flag the index is
+  loaded instead of scanning the file, provided the size and mtime of
+  the file still match. The nanosecond part of the mtime is only
+  available where struct stat has the st_mtim field, and is zero
+  otherwise. In addition the first and the last keyword header in the
+  index are checked against the file, so a file which has been
+  rewritten with the same size within the resolution of the mtime is
+  still detected in most cases.
+
+  The index file is not trusted; a truncated or otherwise invalid
+  index is rejected and the file is scanned instead.
+*/
+
+typedef struct {
+  int64_t file_size;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+} ecl_file_index_stat_type;
+
+
+static bool ecl_file_index_stat( const char * filename , ecl_file_index_stat_type * index_stat ) {
+  stat_type stat_info;
+  if (util_stat( filename , &stat_info ) == 0) {
+    index_stat->file_size = stat_info.st_size;
+    index_stat->mtime_sec = stat_info.st_mtime;
+#ifdef HAVE_STAT_MTIM
+    index_stat->mtime_nsec = stat_info.st_mtim.tv_nsec;
+#else
+    index_stat->mtime_nsec = 0;
+#endif
+    return true;
+  } else
+    return false;
+}
+
+
+static char * ecl_file_alloc_index_filename( const char * filename ) {
+  return util_alloc_sprintf("%s.index" , filename );
+}
+
+
+static bool ecl_file_fwrite_index__( const ecl_file_type * ecl_file , const ecl_file_index_stat_type * index_stat , FILE * stream) {
+  int int_data[2] = { ECL_FILE_INDEX_ID , ECL_FILE_INDEX_VERSION };
+
+  if (fwrite( int_data , sizeof int_data[0] , 2 , stream ) != 2)
+    return false;
+
+  if (fwrite( index_stat , sizeof * index_stat , 1 , stream ) != 1)
+    return false;
+
+  return ecl_file_view_write_index( ecl_file->global_view , stream );
+}
+
+
+/**
+   Will write the index of the global view to the file
+   @index_filename. The index is first written to a new temporary file
+   in the same directory and then renamed, so a concurrent reader will
+   never see a partially written index. The temporary file is created
+   with mkstemp(), i.e. it is never shared with another writer. Returns
+   false if the index could not be written, e.g. because the directory
+   is not writable or the disk is full; in that case no index file is
+   left behind.
+*/
+
+bool ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename) {
+  bool write_ok = false;
+#ifdef HAVE_MKSTEMP
+  const char * src_file = fortio_filename_ref( ecl_file->fortio );
+  ecl_file_index_stat_type index_stat;
+
+  if (ecl_file_index_stat( src_file , &index_stat )) {
+    char * tmp_file = util_alloc_sprintf("%s.XXXXXX" , index_filename );
+    int fd = mkstemp( tmp_file );
+
+    if (fd != -1) {
+      FILE * stream = fdopen( fd , "wb");
+
+      if (stream) {
+        bool fwrite_ok;
+#ifdef HAVE_CHMOD
+        stat_type stat_info;
+#endif
+
+#ifdef HAVE_CHMOD
+        /* The index gets the same read/write permissions as the file it describes. */
+        if (util_stat( src_file , &stat_info ) == 0)
+          fchmod( fd , stat_info.st_mode & (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH));
+#endif
+
+        fwrite_ok = ecl_file_fwrite_index__( ecl_file , &index_stat , stream );
+        if ((fclose( stream ) == 0) && fwrite_ok)
+          write_ok = (rename( tmp_file , index_filename ) == 0);
+      } else
+        close( fd );
+
+      if (!write_ok)
+        remove( tmp_file );
+    }
+    free( tmp_file );
+  }
+#endif
+  return write_ok;
+}
+
+
+static bool ecl_file_fread_index( ecl_file_type * ecl_file , const char * index_filename) {
+  const char * src_file = fortio_filename_ref( ecl_file->fortio );
+  ecl_file_index_stat_type index_stat;
+  bool index_ok = false;
+
+  if (ecl_file_index_stat( src_file , &index_stat )) {
+    FILE * stream = fopen( index_filename , "rb");
+
+    if (stream) {
+      int int_data[2];
+      ecl_file_index_stat_type file_stat;
+
+      if ((fread( int_data , sizeof int_data[0] , 2 , stream ) == 2) &&
+          (int_data[0] == ECL_FILE_INDEX_ID) &&
+          (int_data[1] == ECL_FILE_INDEX_VERSION) &&
+          (fread( &file_stat , sizeof file_stat , 1 , stream ) == 1)) {
+
+        if ((file_stat.file_size == index_stat.file_size) &&
+            (file_stat.mtime_sec == index_stat.mtime_sec) &&
+            (file_stat.mtime_nsec == index_stat.mtime_nsec))
+          index_ok = ecl_file_view_fread_index( ecl_file->global_view , stream , index_stat.file_size );
+      }
+      fclose( stream );
+    }
+  }
+
+  return index_ok;
+}
+
+
+/*
+  Will first try to load the index from file, and if that fails fall
+  back to a full scan of the file. After a successfull scan the index
+  is written to file; if the index can not be written the file is
+  just scanned again on the next open.
+*/
+
+static bool ecl_file_load_index( ecl_file_type * ecl_file ) {
+  char * index_filename = ecl_file_alloc_index_filename( fortio_filename_ref( ecl_file->fortio ));
+  bool index_ok = ecl_file_fread_index( ecl_file , index_filename );
+
+  if (!index_ok) {
+    index_ok = ecl_file_scan( ecl_file );
+    if (index_ok)
+      ecl_file_write_index( ecl_file , index_filename );
+  }
+
+  free( index_filename );
+  return index_ok;
+}
+
+
 void ecl_file_select_global( ecl_file_type * ecl_file ) {
   ecl_file->active_view = ecl_file->global_view;
 }
@@ -573,6 +765,16 @@ void ecl_file_select_global( ecl_file_type * ecl_file ) {
 
    The ecl_file instance will retain an open fortio reference to the
    file until ecl_file_close() is called.
+
+   With the ECL_FILE_MMAP flag the file is memory mapped, both the
+   scan and the subsequent keyword loads are then served from the
+   mapping without any file system calls, and the file content is
+   shared in the page cache between all readers of the same file.
+
+   With the ECL_FILE_INDEX flag the index is stored in a file
+   'filename.index' next to the file, and subsequent opens will load
+   that index instead of scanning the file - see
+   ecl_file_load_index().
 */
 
 
@@ -584,15 +786,24 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
 
   if (ecl_file_view_check_flags(flags , ECL_FILE_WRITABLE))
     fortio = fortio_open_readwrite( filename , fmt_file , ECL_ENDIAN_FLIP);
+  else if (ecl_file_view_check_flags(flags , ECL_FILE_MMAP))
+    fortio = fortio_open_reader_mmap( filename , fmt_file , ECL_ENDIAN_FLIP);
   else
     fortio = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP);
 
   if (fortio) {
     ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
+    bool index_ok;
+
     ecl_file->fortio = fortio;
     ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
 
-    if (ecl_file_scan( ecl_file )) {
+    if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_INDEX))
+      index_ok = ecl_file_load_index( ecl_file );
+    else
+      index_ok = ecl_file_scan( ecl_file );
+
+    if (index_ok) {
       ecl_file_select_global( ecl_file );
 
       if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <ert/util/size_t_vector.h>
 #include <ert/util/util.h>
@@ -28,6 +29,7 @@
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_type.h>
 
 /*
   This file implements the datatype ecl_file_kw which is used to hold
@@ -47,6 +49,7 @@
 
 
 #define ECL_FILE_KW_TYPE_ID 646107
+#define ECL_FILE_KW_MAX_HEADER_LENGTH ECL_STRING8_LENGTH
 
 struct inv_map_struct {
   size_t_vector_type * file_kw_ptr;
@@ -175,6 +178,121 @@ ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src ) {
 
 
 
+/**
+   Will store the header information of the file_kw instance, i.e.
+   everything except the actual keyword, to the (binary) stream. Used
+   by the persistent ecl_file index; the inverse function is
+   ecl_file_kw_fread_alloc(). Returns false if the stream could not be
+   written, e.g. because the disk is full.
+*/
+
+bool ecl_file_kw_fwrite( const ecl_file_kw_type * file_kw , FILE * stream ) {
+  int header_length = strlen( file_kw->header );
+  int int_data[4] = { header_length ,
+                      ecl_type_get_type( file_kw->data_type ) ,
+                      file_kw->data_type.element_size ,
+                      file_kw->kw_size };
+
+  if (fwrite( int_data , sizeof int_data[0] , 4 , stream ) != 4)
+    return false;
+
+  if (fwrite( file_kw->header , 1 , header_length , stream ) != header_length)
+    return false;
+
+  if (fwrite( &file_kw->file_offset , sizeof file_kw->file_offset , 1 , stream ) != 1)
+    return false;
+
+  return true;
+}
+
+
+/*
+  The smallest number of bytes the data of a keyword can occupy in
+  the file; for formatted files every element takes at least one
+  character.
+*/
+
+static offset_type ecl_file_kw_min_data_size( ecl_data_type data_type , int kw_size , bool fmt_file) {
+  if (fmt_file)
+    return kw_size;
+  else
+    return (offset_type) kw_size * ecl_type_get_sizeof_ctype_fortio( data_type );
+}
+
+
+/**
+   Will read one file_kw instance written by ecl_file_kw_fwrite(). The
+   index file is not trusted: if the stream is truncated, the values
+   are invalid or the keyword does not fit inside a file of @file_size
+   bytes the function will return NULL.
+*/
+
+ecl_file_kw_type * ecl_file_kw_fread_alloc( FILE * stream , offset_type file_size , bool fmt_file) {
+  int int_data[4];
+  offset_type file_offset;
+  char header[ECL_FILE_KW_MAX_HEADER_LENGTH + 1];
+
+  if (fread( int_data , sizeof int_data[0] , 4 , stream ) != 4)
+    return NULL;
+
+  {
+    int header_length = int_data[0];
+    ecl_type_enum type = int_data[1];
+    int element_size = int_data[2];
+    int kw_size = int_data[3];
+
+    if ((header_length < 0) || (header_length > ECL_FILE_KW_MAX_HEADER_LENGTH))
+      return NULL;
+
+    if ((type < ECL_CHAR_TYPE) || (type > ECL_C010_TYPE) || (kw_size < 0))
+      return NULL;
+
+    if (ecl_type_create_from_type( type ).element_size != element_size)
+      return NULL;
+
+    if (fread( header , 1 , header_length , stream ) != header_length)
+      return NULL;
+    header[header_length] = '\0';
+
+    if (fread( &file_offset , sizeof file_offset , 1 , stream ) != 1)
+      return NULL;
+
+    if ((file_offset < 0) || (file_offset >= file_size))
+      return NULL;
+
+    if (ecl_file_kw_min_data_size( ecl_type_create_from_type( type ) , kw_size , fmt_file ) > file_size - file_offset)
+      return NULL;
+
+    return ecl_file_kw_alloc__( header , ecl_type_create_from_type( type ) , kw_size , file_offset );
+  }
+}
+
+
+/**
+   Will read the keyword header found at the offset of @file_kw in
+   @fortio, and check that it agrees with the header, size and type of
+   @file_kw, and that the data of the keyword can be skipped. Used to
+   check an ecl_file index against the file it was created from.
+*/
+
+bool ecl_file_kw_fcheck_header( const ecl_file_kw_type * file_kw , fortio_type * fortio) {
+  bool header_ok = false;
+
+  if (fortio_fseek( fortio , file_kw->file_offset , SEEK_SET )) {
+    ecl_kw_type * work_kw = ecl_kw_alloc_new("WORK-KW" , 0 , ECL_INT , NULL);
+    if (ecl_kw_fread_header( work_kw , fortio ) == ECL_KW_READ_OK) {
+      if ((strcmp( ecl_kw_get_header( work_kw ) , file_kw->header ) == 0) &&
+          (ecl_kw_get_size( work_kw ) == file_kw->kw_size) &&
+          ecl_type_is_equal( ecl_kw_get_data_type( work_kw ) , file_kw->data_type ))
+        header_ok = ecl_file_kw_fskip_data( file_kw , fortio );
+    }
+    ecl_kw_free( work_kw );
+  }
+
+  return header_ok;
+}
+
+
 void ecl_file_kw_free( ecl_file_kw_type * file_kw ) {
   if (file_kw->kw != NULL) {
     ecl_kw_free( file_kw->kw );
@@ -301,6 +301,78 @@ void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type
     vector_append_ref( ecl_file_view->kw_list , file_kw);
 }
 
+/**
+   Will write the header information of all the ecl_file_kw instances
+   in the view to @stream; ecl_file_view_fread_index() will recreate
+   the view from this without scanning the underlying file. Returns
+   false if the stream could not be written.
+*/
+
+bool ecl_file_view_write_index( const ecl_file_view_type * ecl_file_view , FILE * stream ) {
+  int size = vector_get_size( ecl_file_view->kw_list );
+  int index;
+
+  if (fwrite( &size , sizeof size , 1 , stream ) != 1)
+    return false;
+
+  for (index = 0; index < size; index++) {
+    const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , index );
+    if (!ecl_file_kw_fwrite( file_kw , stream ))
+      return false;
+  }
+  return true;
+}
+
+
+/**
+   Will load the index written by ecl_file_view_write_index(). All the
+   keywords must fit inside the @file_size bytes of the underlying
+   file, and the first and last keyword headers are checked against
+   the file content. If anything is wrong the view is left unchanged
+   and the function returns false, the caller should then scan the
+   file instead.
+*/
+
+bool ecl_file_view_fread_index( ecl_file_view_type * ecl_file_view , FILE * stream , offset_type file_size ) {
+  bool fmt_file = fortio_fmt_file( ecl_file_view->fortio );
+  vector_type * kw_list = vector_alloc_new();
+  bool index_ok = false;
+  int size;
+
+  if ((fread( &size , sizeof size , 1 , stream ) == 1) && (size > 0)) {
+    int index;
+    for (index = 0; index < size; index++) {
+      ecl_file_kw_type * file_kw = ecl_file_kw_fread_alloc( stream , file_size , fmt_file );
+      if (file_kw == NULL)
+        break;
+
+      vector_append_ref( kw_list , file_kw );
+    }
+
+    if (vector_get_size( kw_list ) == size)
+      index_ok = (ecl_file_kw_fcheck_header( vector_iget_const( kw_list , 0 ) , ecl_file_view->fortio ) &&
+                  ecl_file_kw_fcheck_header( vector_get_last_const( kw_list ) , ecl_file_view->fortio ));
+  }
+
+  {
+    int index;
+    for (index = 0; index < vector_get_size( kw_list ); index++) {
+      ecl_file_kw_type * file_kw = vector_iget( kw_list , index );
+      if (index_ok)
+        ecl_file_view_add_kw( ecl_file_view , file_kw );
+      else
+        ecl_file_kw_free( file_kw );
+    }
+  }
+
+  if (index_ok)
+    ecl_file_view_make_index( ecl_file_view );
+
+  vector_free( kw_list );
+  return index_ok;
+}
+
+
 void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
   vector_free( ecl_file_view->child_list );
   hash_free( ecl_file_view->kw_index );
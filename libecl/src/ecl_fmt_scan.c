@@ -0,0 +1,537 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_fmt_scan.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_fmt_scan.h>
+
+/*
+  The ecl_fmt_scan type is a small buffered tokenizer used when
+  reading formatted ECLIPSE files (FUNRST, FEGRID, ...) and GRDECL
+  files. Previously these were parsed with one fscanf() call per
+  element; the format string interpretation and stream locking in
+  fscanf() completely dominate the time spent loading large formatted
+  files.
+
+  The scanner reads the stream in large chunks and splits it in
+  whitespace separated tokens; the tokens are parsed with the
+  ecl_fmt_scan_parse_xxx() functions below. When the scanner is freed
+  the stream is repositioned just after the last consumed token, so
+  calling scope can continue using the stream with the normal stdio
+  functions. This implies that the stream must be seekable.
+
+  The number parsers do not depend on the current locale. Numbers
+  which can be converted exactly with one floating point operation
+  (i.e. less than 2^53 in the mantissa and a power of ten exponent
+  less than 23, this covers everything written by ERT and ECLIPSE)
+  are converted directly; the remaining numbers are converted with
+  strtod().
+*/
+
+#define ECL_FMT_SCAN_TYPE_ID      771053
+#define ECL_FMT_SCAN_BUFFER_SIZE  65536
+
+#define MAX_EXACT_MANTISSA        9007199254740992ULL    /* 2^53 */
+#define MAX_EXACT_POW10           22
+#define MAX_MANTISSA_DIGITS       19
+#define MAX_FALLBACK_LENGTH       128
+
+
+struct ecl_fmt_scan_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  FILE   * stream;
+  char   * buffer;
+  size_t   buffer_size;
+  size_t   pos;           /* The first byte in the buffer which has not been consumed. */
+  size_t   end;           /* The number of valid bytes in the buffer. */
+  bool     at_eof;
+};
+
+
+static const double pow10_table[MAX_EXACT_POW10 + 1] = {1e0  , 1e1  , 1e2  , 1e3  , 1e4  , 1e5  , 1e6  , 1e7  ,
+                                                         1e8  , 1e9  , 1e10 , 1e11 , 1e12 , 1e13 , 1e14 , 1e15 ,
+                                                         1e16 , 1e17 , 1e18 , 1e19 , 1e20 , 1e21 , 1e22};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_fmt_scan , ECL_FMT_SCAN_TYPE_ID )
+
+
+static bool ecl_fmt_scan_is_space( char c ) {
+  return (c == ' ' || (c >= '\t' && c <= '\r'));
+}
+
+
+ecl_fmt_scan_type * ecl_fmt_scan_alloc( FILE * stream ) {
+  ecl_fmt_scan_type * scan = util_malloc( sizeof * scan );
+  UTIL_TYPE_ID_INIT( scan , ECL_FMT_SCAN_TYPE_ID );
+  scan->stream      = stream;
+  scan->buffer_size = ECL_FMT_SCAN_BUFFER_SIZE;
+  scan->buffer      = util_malloc( scan->buffer_size );
+  scan->pos         = 0;
+  scan->end         = 0;
+  scan->at_eof      = false;
+  return scan;
+}
+
+
+/*
+  Will reposition the stream to the first byte which has not been
+  consumed by the scanner.
+*/
+
+void ecl_fmt_scan_free( ecl_fmt_scan_type * scan ) {
+  if (scan->pos < scan->end)
+    util_fseek( scan->stream , -(offset_type) (scan->end - scan->pos) , SEEK_CUR );
+
+  free( scan->buffer );
+  free( scan );
+}
+
+
+/*
+  Will move the unconsumed part of the buffer to the start of the
+  buffer and read more data from the stream. If the buffer is full
+  with one long token the buffer is grown. Returns the number of new
+  bytes.
+*/
+
+static size_t ecl_fmt_scan_fill( ecl_fmt_scan_type * scan ) {
+  size_t bytes_read;
+
+  if (scan->pos > 0) {
+    memmove( scan->buffer , &scan->buffer[scan->pos] , scan->end - scan->pos );
+    scan->end -= scan->pos;
+    scan->pos = 0;
+  }
+
+  if (scan->end == scan->buffer_size) {
+    scan->buffer_size *= 2;
+    scan->buffer = util_realloc( scan->buffer , scan->buffer_size );
+  }
+
+  bytes_read = fread( &scan->buffer[scan->end] , 1 , scan->buffer_size - scan->end , scan->stream );
+  if (bytes_read == 0)
+    scan->at_eof = true;
+
+  scan->end += bytes_read;
+  return bytes_read;
+}
+
+
+/*
+  Will skip whitespace, reading more data when needed. Returns false
+  if the end of the file is reached.
+*/
+
+static bool ecl_fmt_scan_skip_space( ecl_fmt_scan_type * scan ) {
+  while (true) {
+    while (scan->pos < scan->end && ecl_fmt_scan_is_space( scan->buffer[scan->pos] ))
+      scan->pos++;
+
+    if (scan->pos < scan->end)
+      return true;
+
+    if (scan->at_eof || ecl_fmt_scan_fill( scan ) == 0)
+      return false;
+  }
+}
+
+
+/*
+  Will locate the next whitespace separated token. The token is
+  returned as a pointer into the internal buffer and a length; it is
+  NOT \0 terminated, and it is only valid until the next call to the
+  scanner. Returns false when there are no more tokens in the stream.
+*/
+
+bool ecl_fmt_scan_next_token( ecl_fmt_scan_type * scan , const char ** token , int * length ) {
+  size_t index;
+
+  if (!ecl_fmt_scan_skip_space( scan ))
+    return false;
+
+  index = scan->pos;
+  while (true) {
+    while (index < scan->end && !ecl_fmt_scan_is_space( scan->buffer[index] ))
+      index++;
+
+    if (index < scan->end || scan->at_eof)
+      break;
+
+    {
+      size_t token_offset = index - scan->pos;
+      size_t bytes_read = ecl_fmt_scan_fill( scan );
+
+      index = scan->pos + token_offset;
+      if (bytes_read == 0)
+        break;
+    }
+  }
+
+  *token  = &scan->buffer[scan->pos];
+  *length = index - scan->pos;
+  scan->pos = index;
+  return true;
+}
+
+
+/*
+  Will consume everything up to and including the next newline.
+  Returns false if EOF is reached before a newline is found.
+*/
+
+bool ecl_fmt_scan_skip_line( ecl_fmt_scan_type * scan ) {
+  while (true) {
+    char * newline = memchr( &scan->buffer[scan->pos] , '\n' , scan->end - scan->pos );
+    if (newline) {
+      scan->pos = newline - scan->buffer + 1;
+      return true;
+    }
+
+    scan->pos = scan->end;
+    if (scan->at_eof || ecl_fmt_scan_fill( scan ) == 0)
+      return false;
+  }
+}
+
+
+/*****************************************************************/
+
+
+/*
+  The parse functions below parse a number starting at @p and stopping
+  at the first character which can not be part of the number, or at
+  @end. The return value is a pointer to the first character after
+  the number, or NULL if there is no valid number at @p.
+*/
+
+static const char * ecl_fmt_scan_parse_int__( const char * p , const char * end , void * value_ptr ) {
+  int * value      = value_ptr;
+  bool negative    = false;
+  int64_t acc      = 0;
+  int digits       = 0;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  while (p < end && *p >= '0' && *p <= '9') {
+    acc = 10 * acc + (*p - '0');
+    if (acc > (int64_t) INT_MAX + 1)
+      return NULL;
+    digits++;
+    p++;
+  }
+
+  if (digits == 0)
+    return NULL;
+
+  if (negative)
+    acc = -acc;
+
+  if (acc > INT_MAX)
+    return NULL;
+
+  *value = (int) acc;
+  return p;
+}
+
+
+/*
+  Copies the number to the \0 terminated buffer @tmp, replacing the
+  Fortran 'D' exponent with 'E' so the result can be passed to
+  strtod() / strtof().
+*/
+
+static bool ecl_fmt_scan_copy_number( char * tmp , const char * start , const char * stop ) {
+  int length = stop - start;
+  int i;
+
+  if (length <= 0 || length >= MAX_FALLBACK_LENGTH)
+    return false;
+
+  for (i = 0; i < length; i++)
+    tmp[i] = (start[i] == 'D' || start[i] == 'd') ? 'E' : start[i];
+  tmp[length] = '\0';
+  return true;
+}
+
+
+/*
+  Parses a decimal number with an optional exponent introduced with
+  one of the characters 'eEdD'. If the number can be converted with
+  one exact floating point operation the conversion is done here and
+  *exact is set to true.
+*/
+
+static const char * ecl_fmt_scan_parse_decimal( const char * p , const char * end , double * value , bool * exact) {
+  bool negative     = false;
+  uint64_t mantissa = 0;
+  int mantissa_digits = 0;
+  int digits        = 0;
+  int exp10         = 0;
+  bool truncated    = false;
+
+  *exact = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  while (p < end && *p >= '0' && *p <= '9') {
+    if (mantissa_digits < MAX_MANTISSA_DIGITS) {
+      mantissa = 10 * mantissa + (*p - '0');
+      if (mantissa > 0)
+        mantissa_digits++;
+    } else {
+      truncated = true;
+      exp10++;
+    }
+    digits++;
+    p++;
+  }
+
+  if (p < end && *p == '.') {
+    p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (mantissa_digits < MAX_MANTISSA_DIGITS) {
+        mantissa = 10 * mantissa + (*p - '0');
+        if (mantissa > 0)
+          mantissa_digits++;
+        exp10--;
+      } else
+        truncated = true;
+      digits++;
+      p++;
+    }
+  }
+
+  if (digits == 0)
+    return NULL;
+
+  if (p < end && (*p == 'E' || *p == 'e' || *p == 'D' || *p == 'd')) {
+    bool exp_negative = false;
+    int exp_value = 0;
+    int exp_digits = 0;
+    p++;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+      exp_negative = (*p == '-');
+      p++;
+    }
+
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (exp_value < 100000)
+        exp_value = 10 * exp_value + (*p - '0');
+      exp_digits++;
+      p++;
+    }
+
+    if (exp_digits == 0)
+      return NULL;
+
+    exp10 += exp_negative ? -exp_value : exp_value;
+  }
+
+  if (truncated)
+    return p;
+
+  if (mantissa == 0) {
+    *value = negative ? -0.0 : 0.0;
+    *exact = true;
+  } else if (mantissa <= MAX_EXACT_MANTISSA && exp10 >= -MAX_EXACT_POW10 && exp10 <= MAX_EXACT_POW10) {
+    double v = (double) mantissa;
+    if (exp10 < 0)
+      v /= pow10_table[-exp10];
+    else
+      v *= pow10_table[exp10];
+
+    *value = negative ? -v : v;
+    *exact = true;
+  }
+
+  return p;
+}
+
+
+static const char * ecl_fmt_scan_parse_double__( const char * p , const char * end , void * value_ptr ) {
+  double * value = value_ptr;
+  bool exact;
+  const char * stop = ecl_fmt_scan_parse_decimal( p , end , value , &exact );
+
+  if (stop && !exact) {
+    char tmp[MAX_FALLBACK_LENGTH];
+    char * end_ptr;
+
+    if (!ecl_fmt_scan_copy_number( tmp , p , stop ))
+      return NULL;
+
+    *value = strtod( tmp , &end_ptr );
+    if (end_ptr != &tmp[stop - p])
+      return NULL;
+  }
+
+  return stop;
+}
+
+
+/*
+  Going via a correctly rounded double gives the correctly rounded
+  float, except when the double lies exactly on the midpoint between
+  two floats; in that case the number is converted with strtof().
+*/
+
+static const char * ecl_fmt_scan_parse_float__( const char * p , const char * end , void * value_ptr ) {
+  float * value = value_ptr;
+  double double_value;
+  bool exact;
+  const char * stop = ecl_fmt_scan_parse_decimal( p , end , &double_value , &exact );
+
+  if (stop == NULL)
+    return NULL;
+
+  if (exact) {
+    uint64_t bits;
+
+    /*
+      A double on the midpoint between two normal floats has exactly
+      the top bit set in the 29 mantissa bits which are not present in
+      a float. Subnormal floats have fewer mantissa bits, these values
+      are always converted with strtof().
+    */
+    memcpy( &bits , &double_value , sizeof bits );
+    if (((bits & 0x1FFFFFFFULL) == 0x10000000ULL) || ((double_value != 0) && (fabs( double_value ) < FLT_MIN)))
+      exact = false;
+  }
+
+  if (exact)
+    *value = (float) double_value;
+  else {
+    char tmp[MAX_FALLBACK_LENGTH];
+    char * end_ptr;
+
+    if (!ecl_fmt_scan_copy_number( tmp , p , stop ))
+      return NULL;
+
+    *value = strtof( tmp , &end_ptr );
+    if (end_ptr != &tmp[stop - p])
+      return NULL;
+  }
+
+  return stop;
+}
+
+
+bool ecl_fmt_scan_parse_int( const char * token , int length , int * value ) {
+  return (ecl_fmt_scan_parse_int__( token , token + length , value ) == token + length);
+}
+
+
+bool ecl_fmt_scan_parse_float( const char * token , int length , float * value ) {
+  return (ecl_fmt_scan_parse_float__( token , token + length , value ) == token + length);
+}
+
+
+bool ecl_fmt_scan_parse_double( const char * token , int length , double * value ) {
+  return (ecl_fmt_scan_parse_double__( token , token + length , value ) == token + length);
+}
+
+
+/*****************************************************************/
+
+/*
+  The ecl_fmt_scan_next_xxx() functions parse the next number directly
+  from the buffer, without first locating the end of the token. If
+  the number runs to the end of the buffer it might continue in the
+  next chunk of the file; in that case more data is read and the
+  number is parsed again. The functions return false if the next
+  token is not a valid number, or if there are no more tokens.
+*/
+
+typedef const char * (parse_ftype) ( const char * , const char * , void * );
+
+
+static bool ecl_fmt_scan_token_complete( const char * start , const char * end ) {
+  const char * p;
+  for (p = start; p < end; p++)
+    if (ecl_fmt_scan_is_space( *p ))
+      return true;
+  return false;
+}
+
+
+static bool ecl_fmt_scan_next__( ecl_fmt_scan_type * scan , parse_ftype * parse , void * value) {
+  while (true) {
+    const char * start;
+    const char * end;
+    const char * stop;
+
+    if (!ecl_fmt_scan_skip_space( scan ))
+      return false;
+
+    start = &scan->buffer[scan->pos];
+    end   = &scan->buffer[scan->end];
+    stop  = parse( start , end , value );
+
+    if (stop && stop < end) {
+      if (!ecl_fmt_scan_is_space( *stop ))
+        return false;
+
+      scan->pos = stop - scan->buffer;
+      return true;
+    }
+
+    if (scan->at_eof) {
+      if (stop == NULL)
+        return false;
+
+      scan->pos = scan->end;
+      return true;
+    }
+
+    if (stop == NULL && ecl_fmt_scan_token_complete( start , end ))
+      return false;
+
+    ecl_fmt_scan_fill( scan );
+  }
+}
+
+
+bool ecl_fmt_scan_next_int( ecl_fmt_scan_type * scan , int * value ) {
+  return ecl_fmt_scan_next__( scan , ecl_fmt_scan_parse_int__ , value );
+}
+
+
+bool ecl_fmt_scan_next_float( ecl_fmt_scan_type * scan , float * value ) {
+  return ecl_fmt_scan_next__( scan , ecl_fmt_scan_parse_float__ , value );
+}
+
+
+bool ecl_fmt_scan_next_double( ecl_fmt_scan_type * scan , double * value ) {
+  return ecl_fmt_scan_next__( scan , ecl_fmt_scan_parse_double__ , value );
+}
@@ -28,6 +28,12 @@
 #include <ert/util/hash.h>
 #include <ert/util/vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/ert_api_config.h>
+#include <ert/util/arg_pack.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/geometry/geo_util.h>
 #include <ert/geometry/geo_polygon.h>
@@ -691,13 +697,13 @@ static void point_copy_values(point_type * p , const point_type * src) {
 #define HOST_CELL_NONE     -1
 
 #define CELL_FLAG_VALID    1     /* In the case of GRID files not necessarily all cells geometry values set - in that case this will be left as false. */
-#define CELL_FLAG_CENTER   2     /* Has the center value been calculated - this is by default not done to speed up loading a tiny bit. */
 #define CELL_FLAG_TAINTED  4     /* lazy fucking stupid reservoir engineers make invalid grid
                                     cells - for kicks??  must try to keep those cells out of
                                     real-world calculations with some hysteric heuristics.*/
-#define CELL_FLAG_VOLUME 8
 
 typedef struct ecl_cell_struct           ecl_cell_type;
+typedef struct ecl_grid_xyz_index_struct ecl_grid_xyz_index_type;
+typedef struct ecl_grid_geometry_struct  ecl_grid_geometry_type;
 
 #define GET_CELL_FLAG(cell,flag) (((cell->cell_flags & (flag)) == 0) ? false : true)
 #define SET_CELL_FLAG(cell,flag) ((cell->cell_flags |= (flag)))
@@ -705,17 +711,50 @@ typedef struct ecl_cell_struct           ecl_cell_type;
 #define METER_TO_CM_SCALE_FACTOR   100.0
 
 struct ecl_cell_struct {
-  point_type center;
   point_type corner_list[8];
 
-  double                 volume;             /* Cache volume - whether it is initialized or not is handled by a cell_flags. */
+  const ecl_grid_type   *lgr;                /* if this cell is part of an lgr; this will point to a grid instance for that lgr; NULL if not part of lgr. */
+  nnc_info_type        * nnc_info;           /* Non-neighbour connection info*/
   int                    active;
   int                    active_index[2];    /* [0]: The active matrix index; [1]: the active fracture index */
-  const ecl_grid_type   *lgr;                /* if this cell is part of an lgr; this will point to a grid instance for that lgr; NULL if not part of lgr. */
   int                    host_cell;          /* the global index of the host cell for an lgr cell, set to -1 for normal cells. */
   int                    coarse_group;       /* The index of the coarse group holding this cell -1 for non-coarsened cells. */
   int                    cell_flags;
-  nnc_info_type        * nnc_info;           /* Non-neighbour connection info*/
+};
+
+
+/*
+  The cell centers and volumes are derived quantities which are not
+  stored in the ecl_cell_type structs; they are kept in separate
+  arrays, one value per cell, which are only allocated if the
+  centers/volumes are requested. That keeps the cells smaller, and
+  scans like ecl_grid_get_cdepth1A() over many cells only touch the
+  values they need.
+
+  The centers are calculated for all the cells in one go, the first
+  time a center is requested. The volumes are more expensive to
+  calculate, they are calculated one cell at a time as they are
+  requested - with NAN meaning 'not yet calculated'. The center array
+  is stored as one block with all the x values, followed by all the y
+  and z values.
+
+  The getters take a const grid and can be called from several
+  threads. The lock in the geometry struct is only taken to allocate
+  the arrays; the array pointers are published with release/acquire
+  atomics, so once an array exists the getters do not lock at all.
+  The individual volume values are read and written with relaxed
+  atomics - two threads may both calculate the same volume, but they
+  will store the same value. When both arrays have been filled they
+  use 32 bytes per cell, compared to the 40 bytes the center and
+  volume fields used in ecl_cell_type.
+*/
+
+struct ecl_grid_geometry_struct {
+  double * center;
+  double * volume;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t lock;
+#endif
 };
 
 
@@ -735,7 +774,11 @@ struct ecl_grid_struct {
   int                   size;          /* == nx*ny*nz */
   int                   total_active;
   int                   total_active_fracture;
-  bool                * visited;                /* internal helper struct used when searching for index - can be NULL. */
+  ecl_grid_xyz_index_type * xyz_index;         /* spatial index used when searching for index - built on demand, can be NULL. */
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t           xyz_index_lock;    /* protects the on demand build of the xyz_index. */
+#endif
+  ecl_grid_geometry_type  * geometry;          /* cell centers and volumes - the arrays are allocated on demand. */
   int                 * index_map;              /* this a list of nx*ny*nz elements, where value -1 means inactive cell .*/
   int                 * inv_index_map;          /* this is list of total_active elements - which point back to the index_map. */
 
@@ -824,14 +867,15 @@ static void ecl_cell_dump( const ecl_cell_type * cell , FILE * stream) {
 }
 
 
-static void ecl_cell_assert_center( ecl_cell_type * cell);
+static void ecl_cell_get_center( const ecl_cell_type * cell , point_type * center);
 
 static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k , FILE * stream , const double * offset) {
+  point_type center;
   fprintf(stream , "Cell: i:%3d  j:%3d    k:%3d   host_cell:%d  CoarseGroup:%4d active_nr:%6d  active:%d \nCorners:\n",i,j,k,cell->host_cell, cell->coarse_group , cell->active_index[MATRIX_INDEX], cell->active);
 
-  ecl_cell_assert_center( cell );
+  ecl_cell_get_center( cell , &center );
   fprintf(stream , "Center   : ");
-  point_dump_ascii( &cell->center , stream , offset);
+  point_dump_ascii( &center , stream , offset);
   fprintf(stream , "\n");
 
   {
@@ -1116,23 +1160,14 @@ static int ecl_cell_get_tetrahedron_method( int i , int j , int k) {
 #undef mod
 */
 
-static void ecl_cell_set_center( ecl_cell_type * cell) {
-  point_set(&cell->center , 0 , 0 , 0);
+static void ecl_cell_get_center( const ecl_cell_type * cell , point_type * center) {
+  point_set(center , 0 , 0 , 0);
   {
     int c;
     for (c = 0; c < 8; c++)
-      point_inplace_add(&cell->center , &cell->corner_list[c]);
+      point_inplace_add(center , &cell->corner_list[c]);
   }
-  point_inplace_scale(&cell->center , 1.0 / 8.0);
-
-  SET_CELL_FLAG( cell , CELL_FLAG_CENTER );
-}
-
-
-
-static void ecl_cell_assert_center( ecl_cell_type * cell) {
-  if (!GET_CELL_FLAG(cell , CELL_FLAG_CENTER))
-    ecl_cell_set_center( cell );
+  point_inplace_scale(center , 1.0 / 8.0);
 }
 
 
@@ -1281,70 +1316,63 @@ static bool tetrahedron_contains(tetrahedron_type tet, const point_type p) {
  * when used in opm-parser and has been optimised significantly. This means
  * inlining several operations, e.g. vector operations, and other tricks.
  */
-static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
-  if (GET_CELL_FLAG(cell , CELL_FLAG_VOLUME))
-    return cell->volume;
+static double ecl_cell_get_signed_volume( const ecl_cell_type * cell) {
+  /*
+   * We make an activation record local copy of the cell's corners for less
+   * jumping in memory and better cache performance.
+   */
+  point_type center;
+  point_type corners[ 8 ];
+  ecl_cell_get_center( cell , &center );
+  memcpy( corners, cell->corner_list, sizeof( point_type ) * 8 );
 
-  ecl_cell_assert_center( cell );
-  {
-    /*
-     * We make an activation record local copy of the cell's corners for less
-     * jumping in memory and better cache performance.
-     */
-    point_type center = cell->center;
-    point_type corners[ 8 ];
-    memcpy( corners, cell->corner_list, sizeof( point_type ) * 8 );
-
-    tetrahedron_type tet = { .p0 = center };
-    double           volume = 0;
-    /*
-      using both tetrahedron decompositions - gives good agreement
-      with porv from eclipse init files.
-    */
+  tetrahedron_type tet = { .p0 = center };
+  double           volume = 0;
+  /*
+    using both tetrahedron decompositions - gives good agreement
+    with porv from eclipse init files.
+  */
 
-    /*
-     * The order of these loops is intentional and guided by profiling. It's much
-     * faster to access method, then the number, rather than the other way
-     * around. If you are to change this, please measure performance impact.
-     */
-    for( int method = 0; method < 2; ++method ) {
-      for( int itet = 0; itet < 12; ++itet  ) {
-        const int point0 = tetrahedron_permutations[ method ][ itet ][ 0 ];
-        const int point1 = tetrahedron_permutations[ method ][ itet ][ 1 ];
-        const int point2 = tetrahedron_permutations[ method ][ itet ][ 2 ];
-
-        tet.p1 = corners[ point0 ];
-        tet.p2 = corners[ point1 ];
-        tet.p3 = corners[ point2 ];
-        volume += tetrahedron_volume6( tet ) / 6;
-      }
+  /*
+   * The order of these loops is intentional and guided by profiling. It's much
+   * faster to access method, then the number, rather than the other way
+   * around. If you are to change this, please measure performance impact.
+   */
+  for( int method = 0; method < 2; ++method ) {
+    for( int itet = 0; itet < 12; ++itet  ) {
+      const int point0 = tetrahedron_permutations[ method ][ itet ][ 0 ];
+      const int point1 = tetrahedron_permutations[ method ][ itet ][ 1 ];
+      const int point2 = tetrahedron_permutations[ method ][ itet ][ 2 ];
+
+      tet.p1 = corners[ point0 ];
+      tet.p2 = corners[ point1 ];
+      tet.p3 = corners[ point2 ];
+      volume += tetrahedron_volume6( tet ) / 6;
     }
+  }
 
-    /* The volume of a tetrahedron is
-     *        |a·(b x c)|
-     *  V  =  -----------
-     *             6
-     * Since sum( |a·(b x c)| ) / 6 is equal to
-     * sum( |a·(b x c)| / 6 ) we can do the (rather expensive) division only once
-     * and still get the correct result. We multiply by 0.5 because we've now
-     * considered two decompositions of the tetrahedron, and want their average.
-     *
-     *
-     * Note added: these volume calculations are used to calculate pore
-     * volumes in OPM, it turns out that opm is very sensitive to these
-     * volumes. Extracting the divison by 6.0 was actually enough to
-     * induce a regression test failure in flow, this has therefor been
-     * reverted.
-     */
+  /* The volume of a tetrahedron is
+   *        |a·(b x c)|
+   *  V  =  -----------
+   *             6
+   * Since sum( |a·(b x c)| ) / 6 is equal to
+   * sum( |a·(b x c)| / 6 ) we can do the (rather expensive) division only once
+   * and still get the correct result. We multiply by 0.5 because we've now
+   * considered two decompositions of the tetrahedron, and want their average.
+   *
+   *
+   * Note added: these volume calculations are used to calculate pore
+   * volumes in OPM, it turns out that opm is very sensitive to these
+   * volumes. Extracting the divison by 6.0 was actually enough to
+   * induce a regression test failure in flow, this has therefor been
+   * reverted.
+   */
 
-    cell->volume = volume * 0.5;
-    SET_CELL_FLAG( cell , CELL_FLAG_VOLUME );
-  }
-  return cell->volume;
+  return volume * 0.5;
 }
 
 
-static double ecl_cell_get_volume( ecl_cell_type * cell ) {
+static double ecl_cell_get_volume( const ecl_cell_type * cell ) {
   return fabs( ecl_cell_get_signed_volume(cell));
 }
 
@@ -1524,6 +1552,139 @@ static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid , int global
 }
 
 
+static ecl_grid_geometry_type * ecl_grid_geometry_alloc( void ) {
+  ecl_grid_geometry_type * geometry = util_malloc( sizeof * geometry );
+  geometry->center = NULL;
+  geometry->volume = NULL;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &geometry->lock , NULL );
+#endif
+  return geometry;
+}
+
+
+static void ecl_grid_geometry_free( ecl_grid_geometry_type * geometry ) {
+  util_safe_free( geometry->center );
+  util_safe_free( geometry->volume );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &geometry->lock );
+#endif
+  free( geometry );
+}
+
+
+static void ecl_grid_geometry_lock( ecl_grid_geometry_type * geometry ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &geometry->lock );
+#endif
+}
+
+
+static void ecl_grid_geometry_unlock( ecl_grid_geometry_type * geometry ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &geometry->lock );
+#endif
+}
+
+
+static double * ecl_grid_geometry_load_ptr( double ** ptr ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  return __atomic_load_n( ptr , __ATOMIC_ACQUIRE );
+#else
+  return *ptr;
+#endif
+}
+
+
+static void ecl_grid_geometry_store_ptr( double ** ptr , double * data ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  __atomic_store_n( ptr , data , __ATOMIC_RELEASE );
+#else
+  *ptr = data;
+#endif
+}
+
+
+/*
+  Will return the center array; the centers of all the cells are
+  calculated the first time this is called. The x, y and z values
+  for cell nr global_index are found at [global_index],
+  [global_index + size] and [global_index + 2*size] respectively.
+  The array is not modified after it has been published.
+*/
+
+static const double * ecl_grid_get_center_data( const ecl_grid_type * grid ) {
+  ecl_grid_geometry_type * geometry = grid->geometry;
+  double * center_data = ecl_grid_geometry_load_ptr( &geometry->center );
+
+  if (center_data == NULL) {
+    ecl_grid_geometry_lock( geometry );
+    center_data = geometry->center;
+    if (center_data == NULL) {
+      const int size = grid->size;
+      int global_index;
+
+      center_data = util_calloc( 3 * size , sizeof * center_data );
+      for (global_index = 0; global_index < size; global_index++) {
+        point_type p;
+        ecl_cell_get_center( ecl_grid_get_cell( grid , global_index ) , &p );
+        center_data[global_index]            = p.x;
+        center_data[global_index + size]     = p.y;
+        center_data[global_index + 2 * size] = p.z;
+      }
+      ecl_grid_geometry_store_ptr( &geometry->center , center_data );
+    }
+    ecl_grid_geometry_unlock( geometry );
+  }
+
+  return center_data;
+}
+
+
+static double * ecl_grid_get_volume_data( const ecl_grid_type * grid ) {
+  ecl_grid_geometry_type * geometry = grid->geometry;
+  double * volume_data = ecl_grid_geometry_load_ptr( &geometry->volume );
+
+  if (volume_data == NULL) {
+    ecl_grid_geometry_lock( geometry );
+    volume_data = geometry->volume;
+    if (volume_data == NULL) {
+      int i;
+      volume_data = util_calloc( grid->size , sizeof * volume_data );
+      for (i = 0; i < grid->size; i++)
+        volume_data[i] = NAN;
+      ecl_grid_geometry_store_ptr( &geometry->volume , volume_data );
+    }
+    ecl_grid_geometry_unlock( geometry );
+  }
+
+  return volume_data;
+}
+
+
+static double ecl_grid_get_cell_signed_volume( const ecl_grid_type * grid , int global_index ) {
+  double * volume_data = ecl_grid_get_volume_data( grid );
+  double volume;
+
+#ifdef ERT_HAVE_THREAD_POOL
+  __atomic_load( &volume_data[global_index] , &volume , __ATOMIC_RELAXED );
+#else
+  volume = volume_data[global_index];
+#endif
+
+  if (isnan( volume )) {
+    volume = ecl_cell_get_signed_volume( ecl_grid_get_cell( grid , global_index ));
+#ifdef ERT_HAVE_THREAD_POOL
+    __atomic_store( &volume_data[global_index] , &volume , __ATOMIC_RELAXED );
+#else
+    volume_data[global_index] = volume;
+#endif
+  }
+
+  return volume;
+}
+
+
 /**
    this function uses heuristics (ahhh - i hate it) in an attempt to
    mark cells with fucked geometry - see further comments in the
@@ -1595,7 +1756,11 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
 
   grid->dualp_flag            = dualp_flag;
   grid->coord_kw              = NULL;
-  grid->visited               = NULL;
+  grid->xyz_index             = NULL;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &grid->xyz_index_lock , NULL );
+#endif
+  grid->geometry              = ecl_grid_geometry_alloc( );
   grid->inv_index_map         = NULL;
   grid->index_map             = NULL;
   grid->fracture_index_map    = NULL;
@@ -4142,124 +4307,351 @@ int ecl_grid_get_global_index_from_xy_bottom( const ecl_grid_type * ecl_grid , d
 }
 
 
-static void ecl_grid_clear_visited( ecl_grid_type * grid ) {
-  if (grid->visited == NULL)
-    grid->visited = util_calloc( grid->size , sizeof * grid->visited );
+/*
+  The xyz index is a uniform 3D binning of the bounding boxes of the
+  cells, it is used to find the cells which can possibly contain a
+  point (x,y,z) without scanning through the whole grid. The bins
+  are stored in compressed form: the cells overlapping bin nr b are
+  found in cell_list[ bin_offset[b] ... bin_offset[b+1] ), sorted in
+  increasing global index order. A cell is listed once for every bin
+  its bounding box overlaps, so the offsets are size_t; the length of
+  cell_list can exceed the number of cells many times.
+
+  The index is built the first time ecl_grid_get_global_index_from_xyz()
+  is called; the build is protected by the xyz_index_lock, and the
+  lookups themselves do not modify the grid, so lookups from several
+  threads are safe.
+
+  Cells without the CELL_FLAG_VALID flag, i.e. cells in a GRID file
+  which have no geometry, are not in the index and are never returned
+  from the lookup. The old linear search did test these cells, using
+  corner coordinates which were never set.
+*/
 
-  {
-    int i;
-    for (i=0; i < grid->size; i++)
-      grid->visited[i] = false;
-  }
+struct ecl_grid_xyz_index_struct {
+  int      nb[3];           /* Number of bins in x, y and z direction. */
+  double   min[3];
+  double   max[3];
+  double   inv_bin_size[3];
+  size_t * bin_offset;
+  int    * cell_list;
+};
+
+
+static bool ecl_grid_xyz_index_include_cell( const ecl_cell_type * cell ) {
+  if (!GET_CELL_FLAG(cell , CELL_FLAG_VALID))
+    return false;
+
+  if (GET_CELL_FLAG(cell , CELL_FLAG_TAINTED))
+    return false;
+
+  return true;
+}
+
+
+static int ecl_grid_xyz_index_get_bin1( const ecl_grid_xyz_index_type * xyz_index , int dim , double value) {
+  int bin = (int) floor( (value - xyz_index->min[dim]) * xyz_index->inv_bin_size[dim] );
+  return util_int_min( util_int_max( bin , 0 ) , xyz_index->nb[dim] - 1);
+}
+
+
+static void ecl_grid_xyz_index_get_cell_range( const ecl_grid_xyz_index_type * xyz_index , const ecl_cell_type * cell , int * b1 , int * b2) {
+  b1[0] = ecl_grid_xyz_index_get_bin1( xyz_index , 0 , ecl_cell_min_x( cell ));
+  b1[1] = ecl_grid_xyz_index_get_bin1( xyz_index , 1 , ecl_cell_min_y( cell ));
+  b1[2] = ecl_grid_xyz_index_get_bin1( xyz_index , 2 , ecl_cell_min_z( cell ));
+
+  b2[0] = ecl_grid_xyz_index_get_bin1( xyz_index , 0 , ecl_cell_max_x( cell ));
+  b2[1] = ecl_grid_xyz_index_get_bin1( xyz_index , 1 , ecl_cell_max_y( cell ));
+  b2[2] = ecl_grid_xyz_index_get_bin1( xyz_index , 2 , ecl_cell_max_z( cell ));
 }
 
 
 /*
-   Box coordinates are not inclusive, i.e. [i1,i2)
+  The number of bins in each direction is half the number of cells in
+  that direction; i.e. on average a bin is of the same size as a
+  2x2x2 block of cells.
 */
-static int ecl_grid_box_contains_xyz( const ecl_grid_type * grid , int i1, int i2 , int j1 , int j2 , int k1 , int k2 , const point_type * p) {
 
-  int i,j,k;
-  int global_index = -1;
-  for (k=k1; k < k2; k++)
-    for (j=j1; j < j2; j++)
-      for (i=i1; i < i2; i++) {
-        global_index = ecl_grid_get_global_index3( grid , i , j , k);
-        if (!grid->visited[ global_index ]) {
-          grid->visited[ global_index ] = true;
-          if (ecl_grid_cell_contains_xyz1( grid , global_index , p->x , p->y , p->z )) {
-            return global_index;
-          }
+static ecl_grid_xyz_index_type * ecl_grid_xyz_index_alloc( const ecl_grid_type * grid ) {
+  ecl_grid_xyz_index_type * xyz_index = util_malloc( sizeof * xyz_index );
+  const int cell_dims[3] = {grid->nx , grid->ny , grid->nz};
+  size_t num_bins;
+  int dim;
+
+  for (dim = 0; dim < 3; dim++) {
+    xyz_index->min[dim] = 0;
+    xyz_index->max[dim] = 0;
+  }
+
+  {
+    bool first = true;
+    for (int global_index = 0; global_index < grid->size; global_index++) {
+      const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+      if (ecl_grid_xyz_index_include_cell( cell )) {
+        const double cell_min[3] = {ecl_cell_min_x( cell ) , ecl_cell_min_y( cell ) , ecl_cell_min_z( cell )};
+        const double cell_max[3] = {ecl_cell_max_x( cell ) , ecl_cell_max_y( cell ) , ecl_cell_max_z( cell )};
+
+        for (dim = 0; dim < 3; dim++) {
+          if (first || cell_min[dim] < xyz_index->min[dim])
+            xyz_index->min[dim] = cell_min[dim];
+
+          if (first || cell_max[dim] > xyz_index->max[dim])
+            xyz_index->max[dim] = cell_max[dim];
         }
+        first = false;
+      }
+    }
+  }
+
+  num_bins = 1;
+  for (dim = 0; dim < 3; dim++) {
+    double extent = xyz_index->max[dim] - xyz_index->min[dim];
+    xyz_index->nb[dim] = util_int_max( 1 , cell_dims[dim] / 2 );
+    if (extent > 0)
+      xyz_index->inv_bin_size[dim] = xyz_index->nb[dim] / extent;
+    else {
+      xyz_index->nb[dim] = 1;
+      xyz_index->inv_bin_size[dim] = 0;
+    }
+    num_bins *= xyz_index->nb[dim];
+  }
+
+  xyz_index->bin_offset = util_calloc( num_bins + 1 , sizeof * xyz_index->bin_offset );
+  for (size_t b = 0; b <= num_bins; b++)
+    xyz_index->bin_offset[b] = 0;
+
+  /*
+    Two passes over the cells; the first pass counts the number of
+    cells in each bin, and the second pass fills in the cell_list.
+  */
+  for (int pass = 0; pass < 2; pass++) {
+    size_t * fill_pos = NULL;
+
+    if (pass == 1) {
+      for (size_t b = 0; b < num_bins; b++)
+        xyz_index->bin_offset[b + 1] += xyz_index->bin_offset[b];
+
+      xyz_index->cell_list = util_calloc( util_size_t_max( 1 , xyz_index->bin_offset[num_bins] ) , sizeof * xyz_index->cell_list );
+      fill_pos = util_alloc_copy( xyz_index->bin_offset , num_bins * sizeof * fill_pos );
+    }
+
+    for (int global_index = 0; global_index < grid->size; global_index++) {
+      const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+      if (ecl_grid_xyz_index_include_cell( cell )) {
+        int b1[3] , b2[3];
+        int bi,bj,bk;
+
+        ecl_grid_xyz_index_get_cell_range( xyz_index , cell , b1 , b2 );
+        for (bk = b1[2]; bk <= b2[2]; bk++)
+          for (bj = b1[1]; bj <= b2[1]; bj++)
+            for (bi = b1[0]; bi <= b2[0]; bi++) {
+              size_t bin = bi + (size_t) xyz_index->nb[0] * (bj + (size_t) xyz_index->nb[1] * bk);
+              if (pass == 0)
+                xyz_index->bin_offset[bin + 1]++;
+              else {
+                xyz_index->cell_list[ fill_pos[bin] ] = global_index;
+                fill_pos[bin]++;
+              }
+            }
       }
-  return -1;  /* Returning -1; did not find xyz. */
+    }
+    util_safe_free( fill_pos );
+  }
+
+  return xyz_index;
 }
 
 
-/**
- * Search for given xyz coordinate around global start_index in a box of size bx
- */
-static int ecl_grid_get_global_index_from_xyz_around_box(ecl_grid_type * grid , double x , double y , double z , int start_index, int bx, point_type * p) {
-  /* Try neighbours */
-    int i,j,k;
-    int i1,i2,j1,j2,k1,k2;
-    int nx,ny,nz;
-    ecl_grid_get_dims( grid , &nx , &ny , &nz , NULL);
-    ecl_grid_get_ijk1( grid , start_index , &i , &j , &k);
+static void ecl_grid_xyz_index_free( ecl_grid_xyz_index_type * xyz_index ) {
+  free( xyz_index->bin_offset );
+  free( xyz_index->cell_list );
+  free( xyz_index );
+}
 
-    i1 = util_int_max( 0 , i - bx );
-    j1 = util_int_max( 0 , j - bx );
-    k1 = util_int_max( 0 , k - bx );
 
-    i2 = util_int_min( nx , i + bx );
-    j2 = util_int_min( ny , j + bx );
-    k2 = util_int_min( nz , k + bx );
+static int ecl_grid_xyz_index_lookup( const ecl_grid_type * grid , const ecl_grid_xyz_index_type * xyz_index , const point_type * p) {
+  const double xyz[3] = {p->x , p->y , p->z};
+  int b[3];
+  int dim;
 
-    int global_index = ecl_grid_box_contains_xyz( grid , i1 , i2 , j1 , j2 , k1 , k2 , p);
-    return global_index;
+  for (dim = 0; dim < 3; dim++) {
+    if (xyz[dim] < xyz_index->min[dim] || xyz[dim] > xyz_index->max[dim])
+      return -1;
+    b[dim] = ecl_grid_xyz_index_get_bin1( xyz_index , dim , xyz[dim] );
+  }
+
+  {
+    size_t bin = b[0] + (size_t) xyz_index->nb[0] * (b[1] + (size_t) xyz_index->nb[1] * b[2]);
+    size_t pos;
+
+    for (pos = xyz_index->bin_offset[bin]; pos < xyz_index->bin_offset[bin + 1]; pos++) {
+      int global_index = xyz_index->cell_list[pos];
+      if (ecl_grid_cube_contains( ecl_grid_get_cell( grid , global_index ) , p ))
+        if (ecl_grid_cell_contains_xyz1( grid , global_index , p->x , p->y , p->z ))
+          return global_index;
+    }
+  }
+  return -1;
 }
 
 
+static int ecl_grid_get_global_index_from_xyz__( const ecl_grid_type * grid , const point_type * p , int start_index) {
+  if (start_index > 0 && start_index < grid->size)
+    if (ecl_grid_cell_contains_xyz1( grid , start_index , p->x , p->y , p->z ))
+      return start_index;
+
+  return ecl_grid_xyz_index_lookup( grid , grid->xyz_index , p );
+}
+
+
+static void ecl_grid_assert_xyz_index( ecl_grid_type * grid ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &grid->xyz_index_lock );
+#endif
+
+  if (grid->xyz_index == NULL)
+    grid->xyz_index = ecl_grid_xyz_index_alloc( grid );
+
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &grid->xyz_index_lock );
+#endif
+}
+
 
 /**
    This function will find the global index of the cell containing the
    world coordinates (x,y,z), if no cell can be found the function
    will return -1.
 
-   The function is basically based on scanning through the cells in
-   natural (i fastest) order and querying whether the cell[i,j,k]
-   contains the (x,y,z) point; not very elegant :-(
+   The cells which can contain the point are found with a spatial
+   index over the cell bounding boxes, which is built on the first
+   call; candidate cells are then checked with
+   ecl_grid_cell_contains_xyz1(). If several cells contain the point
+   the one with the lowest global index is returned.
 
    The last argument - 'start_index' - can be used to speed things up
    a bit if you have reasonable guess of where the the (x,y,z) is
-   located. The start_index value is used as this:
+   located, e.g. the previous cell when walking along a well
+   trajectory. The start_index value is used as this:
 
+     start_index == 0: I do not have a clue, the cells are searched in
+        increasing global index order.
 
-     start_index == 0: I do not have a clue, start from the beginning
-        and scan through the grid linearly.
+     start_index != 0: The cell 'start_index' is checked first.
 
+   If several cells contain the point the one with the lowest global
+   index is returned. Cells without geometry are not considered - see
+   the comment above ecl_grid_xyz_index_struct.
 
-     start_index != 0:
-        1. Check the cell 'start_index'.
-        2. Check the neighbours (i +/- 1, j +/- 1, k +/- 1 ).
-        3. Give up and do a linear search starting from start_index.
-
+   The function can be called from several threads - see also
+   ecl_grid_get_global_index_list_from_xyz().
 */
+
 int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index) {
-  int global_index;
   point_type p;
   point_set( &p , x , y , z);
-  ecl_grid_clear_visited( grid );
+  ecl_grid_assert_xyz_index( grid );
+  return ecl_grid_get_global_index_from_xyz__( grid , &p , start_index );
+}
 
-  if (start_index >= 0) {
-    /* Try start index */
-    if (ecl_grid_cell_contains_xyz1( grid , start_index , x,y,z))
-      return start_index;
-    else {
-      /* Try boxes 2, 4, 8, ..., 64  */
-      for (int bx = 1; bx <= 6; bx++) {
-        global_index = ecl_grid_get_global_index_from_xyz_around_box(grid, x, y, z,
-                                                                     start_index,
-                                                                     1<<bx, &p);
-        if (global_index >= 0)
-          return global_index;
-      }
-    }
-  }
 
-  /*
-    OK - the attempted shortcuts did not pay off. Perform full linear search.
-  */
+/*****************************************************************/
 
-  global_index = -1;
+static void ecl_grid_get_global_index_list_from_xyz__( const ecl_grid_type * grid , int offset , int num_points , const double * x , const double * y , const double * z , int * global_index) {
+  int start_index = -1;
+  int i;
 
-  for (int index = 0; index < grid->size; index++) {
-    if (ecl_grid_cell_contains_xyz1( grid , index , x , y , z))
-      return index;
+  for (i = offset; i < offset + num_points; i++) {
+    point_type p;
+    point_set( &p , x[i] , y[i] , z[i] );
+    global_index[i] = ecl_grid_get_global_index_from_xyz__( grid , &p , start_index );
+    if (global_index[i] >= 0)
+      start_index = global_index[i];
   }
-  return -1;
 }
 
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+static void * ecl_grid_get_global_index_list_from_xyz_mt__( void * arg ) {
+  arg_pack_type * arg_pack   = arg_pack_safe_cast( arg );
+  const ecl_grid_type * grid = arg_pack_iget_const_ptr( arg_pack , 0 );
+  int offset                 = arg_pack_iget_int( arg_pack , 1 );
+  int num_points             = arg_pack_iget_int( arg_pack , 2 );
+  const double * x           = arg_pack_iget_const_ptr( arg_pack , 3 );
+  const double * y           = arg_pack_iget_const_ptr( arg_pack , 4 );
+  const double * z           = arg_pack_iget_const_ptr( arg_pack , 5 );
+  int * global_index         = arg_pack_iget_ptr( arg_pack , 6 );
+
+  ecl_grid_get_global_index_list_from_xyz__( grid , offset , num_points , x , y , z , global_index );
+  return NULL;
+}
+
+#endif
+
+
+/**
+   Will look up the global index of the cells containing the
+   @num_points points (x[i] , y[i] , z[i]) and store the result in
+   @global_index, with -1 for points which are not in the grid. The
+   previous hit is used as start_index for the next point, so points
+   along a trajectory should be passed in order.
+*/
+
+void ecl_grid_get_global_index_list_from_xyz( ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index) {
+  ecl_grid_assert_xyz_index( grid );
+  ecl_grid_get_global_index_list_from_xyz__( grid , 0 , num_points , x , y , z , global_index );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+/**
+   As ecl_grid_get_global_index_list_from_xyz(), but the points are
+   split in contiguous chunks, one for each of the threads in
+   @thread_pool, which are looked up in parallel. The thread_pool is
+   owned by the caller and can be reused between calls.
+*/
+
+void ecl_grid_get_global_index_list_from_xyz_mt( ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index , thread_pool_type * thread_pool) {
+  int num_threads = thread_pool_get_max_running( thread_pool );
+
+  if (num_threads > 1 && num_points > num_threads) {
+    arg_pack_type ** arglist = util_malloc( num_threads * sizeof * arglist );
+    int chunk_size = num_points / num_threads;
+    int chunk_mod  = num_points % num_threads;
+    int offset     = 0;
+    int it;
+
+    ecl_grid_assert_xyz_index( grid );
+    thread_pool_restart( thread_pool );
+    for (it = 0; it < num_threads; it++) {
+      int size = chunk_size + ((it < chunk_mod) ? 1 : 0);
+
+      arglist[it] = arg_pack_alloc();
+      arg_pack_append_const_ptr( arglist[it] , grid );
+      arg_pack_append_int( arglist[it] , offset );
+      arg_pack_append_int( arglist[it] , size );
+      arg_pack_append_const_ptr( arglist[it] , x );
+      arg_pack_append_const_ptr( arglist[it] , y );
+      arg_pack_append_const_ptr( arglist[it] , z );
+      arg_pack_append_ptr( arglist[it] , global_index );
+
+      thread_pool_add_job( thread_pool , ecl_grid_get_global_index_list_from_xyz_mt__ , arglist[it] );
+      offset += size;
+    }
+    thread_pool_join( thread_pool );
+
+    for (it = 0; it < num_threads; it++)
+      arg_pack_free( arglist[it] );
+    free( arglist );
+  } else
+    ecl_grid_get_global_index_list_from_xyz( grid , num_points , x , y , z , global_index );
+}
+
+#endif
+
+
 bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k ) {
   int g = ecl_grid_get_global_index_from_xyz(grid, x, y, z, start_index);
   if (g < 0)
@@ -4440,7 +4832,12 @@ void ecl_grid_free(ecl_grid_type * grid) {
   vector_free( grid->coarse_cells );
   hash_free( grid->children );
   util_safe_free( grid->parent_name );
-  util_safe_free( grid->visited );
+  if (grid->xyz_index != NULL)
+    ecl_grid_xyz_index_free( grid->xyz_index );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &grid->xyz_index_lock );
+#endif
+  ecl_grid_geometry_free( grid->geometry );
   util_safe_free( grid->name );
   free( grid );
 }
@@ -4455,16 +4852,12 @@ void ecl_grid_free__( void * arg ) {
 
 
 void ecl_grid_get_distance(const ecl_grid_type * grid , int global_index1, int global_index2 , double *dx , double *dy , double *dz) {
-  ecl_cell_type * cell1 = ecl_grid_get_cell( grid , global_index1);
-  ecl_cell_type * cell2 = ecl_grid_get_cell( grid , global_index2);
+  const double * center = ecl_grid_get_center_data( grid );
+  const int size = grid->size;
 
-  ecl_cell_assert_center( cell1 );
-  ecl_cell_assert_center( cell2 );
-  {
-    *dx = cell1->center.x - cell2->center.x;
-    *dy = cell1->center.y - cell2->center.y;
-    *dz = cell1->center.z - cell2->center.z;
-  }
+  *dx = center[global_index1]            - center[global_index2];
+  *dy = center[global_index1 + size]     - center[global_index2 + size];
+  *dz = center[global_index1 + 2 * size] - center[global_index2 + 2 * size];
 }
 
 
@@ -4673,13 +5066,11 @@ void ecl_grid_get_ijk1A(const ecl_grid_type *ecl_grid , int active_index , int *
 
 
 void ecl_grid_get_xyz1(const ecl_grid_type * grid , int global_index , double *xpos , double *ypos , double *zpos) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
-  {
-    *xpos = cell->center.x;
-    *ypos = cell->center.y;
-    *zpos = cell->center.z;
-  }
+  const double * center = ecl_grid_get_center_data( grid );
+
+  *xpos = center[global_index];
+  *ypos = center[global_index + grid->size];
+  *zpos = center[global_index + 2 * grid->size];
 }
 
 
@@ -4757,9 +5148,8 @@ void ecl_grid_get_xyz1A(const ecl_grid_type * grid , int active_index , double *
 
 
 double ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
-  return cell->center.z;
+  const double * center = ecl_grid_get_center_data( grid );
+  return center[global_index + 2 * grid->size];
 }
 
 
@@ -5307,10 +5697,7 @@ int ecl_grid_get_cell_twist3(const ecl_grid_type * ecl_grid, int i, int j , int
 
 
 double ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-  int i,j,k;
-  ecl_grid_get_ijk1( ecl_grid , global_index, &i , &j , &k);
-  return ecl_cell_get_volume( cell );
+  return fabs( ecl_grid_get_cell_signed_volume( ecl_grid , global_index ));
 }
 
 
@@ -28,6 +28,7 @@
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_fmt_scan.h>
 #include <ert/ecl/ecl_endian_flip.h>
 #include <ert/ecl/ecl_type.h>
 
@@ -97,9 +98,10 @@ UTIL_IS_INSTANCE_FUNCTION(ecl_kw , ECL_KW_TYPE_ID )
 /* Format string used when reading and writing formatted
    files. Observe the following about these format strings:
 
-    1. The format string for reading double contains two '%'
-       identifiers, that is because doubles are read by parsing a
-       prefix and power separately.
+    1. The numerical and logical values are not read with these
+       format strings, but with the ecl_fmt_scan tokenizer, see
+       ecl_kw_fread_fmt_numeric_data(). The read formats for these
+       types are only retained for reference.
 
     2. For both double and float the write format contains two '%'
        characters - that is because the values are split in a prefix
@@ -1052,92 +1054,88 @@ static bool ecl_kw_fscanf_qstring(char *s , const char *fmt , int len, FILE *str
 
 
 
+static void ecl_kw_fread_fmt_string_data(ecl_kw_type * ecl_kw , fortio_type * fortio) {
+  const int blocksize   = get_blocksize( ecl_kw->data_type );
+  const int blocks      = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+  const char * read_fmt = get_read_fmt( ecl_kw->data_type );
+  FILE * stream         = fortio_get_FILE(fortio);
+  int    offset         = 0;
+  int    ib,ir;
+  for (ib = 0; ib < blocks; ib++) {
+    int read_elm = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
+    for (ir = 0; ir < read_elm; ir++) {
+      ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8, stream);
+      offset += ecl_kw_get_sizeof_ctype(ecl_kw);
+    }
+  }
+}
+
+
 /*
-  This rather painful parsing is because formatted eclipse double
-  format : 0.ddddD+01 - difficult to parse the 'D';
+  The numerical and logical formatted data is just a sequence of
+  whitespace separated values, the block structure does not need to be
+  taken into account when reading. The values are read with the
+  buffered ecl_fmt_scan reader instead of one fscanf() call per
+  element.
 */
-/** Should be: NESTED */
-
-static double __fscanf_ECL_double( FILE * stream , const char * fmt) {
-  int    read_count , power;
-  double value , arg;
-  read_count = fscanf( stream , fmt , &arg , &power);
-  if (read_count == 2)
-    value = arg * pow(10 , power );
-  else {
-    util_abort("%s: read failed \n",__func__);
-    value = -1;
+
+static void ecl_kw_fread_fmt_numeric_data(ecl_kw_type * ecl_kw , fortio_type * fortio) {
+  ecl_fmt_scan_type * scan = ecl_fmt_scan_alloc( fortio_get_FILE( fortio ));
+  const ecl_type_enum ecl_type = ecl_kw_get_type(ecl_kw);
+  int index;
+
+  for (index = 0; index < ecl_kw->size; index++) {
+    bool parse_ok = false;
+
+    switch(ecl_type) {
+    case(ECL_INT_TYPE):
+      parse_ok = ecl_fmt_scan_next_int( scan , &((int *) ecl_kw->data)[index] );
+      break;
+    case(ECL_FLOAT_TYPE):
+      parse_ok = ecl_fmt_scan_next_float( scan , &((float *) ecl_kw->data)[index] );
+      break;
+    case(ECL_DOUBLE_TYPE):
+      parse_ok = ecl_fmt_scan_next_double( scan , &((double *) ecl_kw->data)[index] );
+      break;
+    case(ECL_BOOL_TYPE):
+      {
+        const char * token;
+        int length;
+        if (!ecl_fmt_scan_next_token( scan , &token , &length ))
+          util_abort("%s: read failed - premature file end? \n",__func__ );
+
+        if (length == 1) {
+          if (token[0] == BOOL_TRUE_CHAR)
+            ecl_kw_iset_bool(ecl_kw , index , true);
+          else if (token[0] == BOOL_FALSE_CHAR)
+            ecl_kw_iset_bool(ecl_kw , index , false);
+          else
+            util_abort("%s: Logical value: [%c] not recogniced - aborting \n", __func__ , token[0]);
+          parse_ok = true;
+        }
+      }
+      break;
+    default:
+      util_abort("%s: Internal error: internal eclipse_type: %d not recognized - aborting \n",__func__ , ecl_type);
+    }
+
+    if (!parse_ok)
+      util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ , index , ecl_kw->header8 , fortio_filename_ref(fortio));
   }
-  return value;
+  ecl_fmt_scan_free( scan );
 }
 
+
 bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
   const char null_char         = '\0';
   bool fmt_file                = fortio_fmt_file( fortio );
   if (ecl_kw->size > 0) {
     const int blocksize = get_blocksize( ecl_kw->data_type );
     if (fmt_file) {
-      const int blocks      = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
-      const char * read_fmt = get_read_fmt( ecl_kw->data_type );
-      FILE * stream         = fortio_get_FILE(fortio);
-      int    offset         = 0;
-      int    index          = 0;
-      int    ib,ir;
-      for (ib = 0; ib < blocks; ib++) {
-        int read_elm = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
-        for (ir = 0; ir < read_elm; ir++) {
-          switch(ecl_kw_get_type(ecl_kw)) {
-          case(ECL_CHAR_TYPE):
-            ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8, stream);
-            break;
-          case(ECL_INT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (int *) &ecl_kw->data[offset]);
-              if (iread != 1)
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ , offset / ecl_kw_get_sizeof_ctype(ecl_kw) , ecl_kw->header8 , fortio_filename_ref(fortio));
-            }
-            break;
-          case(ECL_FLOAT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (float *) &ecl_kw->data[offset]);
-              if (iread != 1) {
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ ,
-                           offset / ecl_kw_get_sizeof_ctype(ecl_kw) ,
-                           ecl_kw->header8 ,
-                           fortio_filename_ref(fortio));
-              }
-            }
-            break;
-          case(ECL_DOUBLE_TYPE):
-            {
-              double value = __fscanf_ECL_double( stream , read_fmt );
-              ecl_kw_iset(ecl_kw , index , &value);
-            }
-            break;
-          case(ECL_BOOL_TYPE):
-            {
-              char bool_char;
-              if (fscanf(stream , read_fmt , &bool_char) == 1) {
-                if (bool_char == BOOL_TRUE_CHAR)
-                  ecl_kw_iset_bool(ecl_kw , index , true);
-                else if (bool_char == BOOL_FALSE_CHAR)
-                  ecl_kw_iset_bool(ecl_kw , index , false);
-                else
-                  util_abort("%s: Logical value: [%c] not recogniced - aborting \n", __func__ , bool_char);
-              } else
-                util_abort("%s: read failed - premature file end? \n",__func__ );
-            }
-            break;
-          case(ECL_MESS_TYPE):
-            ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8 , stream);
-            break;
-          default:
-            util_abort("%s: Internal error: internal eclipse_type: %d not recognized - aborting \n",__func__ , ecl_kw_get_type(ecl_kw));
-          }
-          offset += ecl_kw_get_sizeof_ctype(ecl_kw);
-          index++;
-        }
-      }
+      if (ecl_type_is_char(ecl_kw->data_type) || ecl_type_is_mess(ecl_kw->data_type))
+        ecl_kw_fread_fmt_string_data( ecl_kw , fortio );
+      else
+        ecl_kw_fread_fmt_numeric_data( ecl_kw , fortio );
 
       /* Skip the trailing newline */
       fortio_fseek( fortio , 1 , SEEK_CUR);
@@ -1153,12 +1151,12 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
             not a continous file/memory mapping.
           */
           int  read_elm = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
-          FILE * stream = fortio_get_FILE(fortio);
           int record_size = fortio_init_read(fortio);
           if (record_size >= 0) {
             int ir;
             for (ir = 0; ir < read_elm; ir++) {
-              util_fread( &ecl_kw->data[(ib * blocksize + ir) * ecl_kw_get_sizeof_ctype(ecl_kw)] , 1 , ECL_STRING8_LENGTH , stream , __func__);
+              if (!fortio_fread_raw( fortio , &ecl_kw->data[(ib * blocksize + ir) * ecl_kw_get_sizeof_ctype(ecl_kw)] , ECL_STRING8_LENGTH ))
+                util_abort("%s: reading string data of keyword:%s from:%s failed \n",__func__ , ecl_kw->header8 , fortio_filename_ref(fortio));
               ecl_kw->data[(ib * blocksize + ir) * ecl_kw_get_sizeof_ctype(ecl_kw) + ECL_STRING8_LENGTH] = null_char;
             }
             read_ok = fortio_complete_read(fortio , record_size);
@@ -1191,7 +1189,6 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 
 void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_data_type data_type, int element_count, const int_vector_type* index_map, char* buffer) {
     const int block_size = get_blocksize(data_type);
-    FILE *stream  = fortio_get_FILE( fortio );
     int index;
     int element_size = ecl_type_get_sizeof_ctype(data_type);
 
@@ -1207,7 +1204,8 @@ void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ec
             util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, element_index, element_count);
         }
         fortio_data_fseek(fortio, data_offset, element_index, element_size, element_count, block_size);
-        util_fread(&buffer[index * element_size], element_size, 1, stream, __func__);
+        if (!fortio_fread_raw(fortio, &buffer[index * element_size], element_size))
+            util_abort("%s: reading element %d from %s failed\n", __func__, element_index, fortio_filename_ref(fortio));
     }
 
     if (ECL_ENDIAN_FLIP) {
@@ -1223,6 +1221,80 @@ bool ecl_kw_fread_realloc_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
   return ecl_kw_fread_data(ecl_kw , fortio);
 }
 
+/**
+   Will read the data of @ecl_kw - whose header must already have been
+   read - directly into the double vector @double_data, without
+   allocating the keyword storage. For binary files the data is read
+   one record at a time into a small buffer, which is endian flipped
+   and converted to double in one pass; this avoids the full size
+   intermediate copy of ecl_kw_fread_realloc_data() +
+   ecl_kw_get_data_as_double(). The keyword must be of type int, float
+   or double.
+*/
+
+bool ecl_kw_fread_data_as_double(const ecl_kw_type * ecl_kw , fortio_type * fortio , double * double_data) {
+  const ecl_type_enum ecl_type = ecl_kw_get_type( ecl_kw );
+  bool read_ok = true;
+
+  if (!(ecl_type == ECL_INT_TYPE || ecl_type == ECL_FLOAT_TYPE || ecl_type == ECL_DOUBLE_TYPE))
+    util_abort("%s: keyword:%s can not be converted to double - aborting \n",__func__ , ecl_kw->header8);
+
+  if (fortio_fmt_file( fortio )) {
+    ecl_kw_type * tmp_kw = ecl_kw_alloc_empty( );
+    ecl_kw_initialize( tmp_kw , ecl_kw->header , ecl_kw->size , ecl_kw->data_type );
+    ecl_kw_alloc_data( tmp_kw );
+    read_ok = ecl_kw_fread_data( tmp_kw , fortio );
+    if (read_ok)
+      ecl_kw_get_data_as_double( tmp_kw , double_data );
+    ecl_kw_free( tmp_kw );
+  } else {
+    const int sizeof_ctype = ecl_kw_get_sizeof_ctype( ecl_kw );
+    union {
+      int   int_data[ BLOCKSIZE_NUMERIC ];
+      float float_data[ BLOCKSIZE_NUMERIC ];
+    } buffer;
+    int offset = 0;
+
+    while (read_ok && (offset < ecl_kw->size)) {
+      int read_elm    = util_int_min( BLOCKSIZE_NUMERIC , ecl_kw->size - offset );
+      int record_size = fortio_init_read( fortio );
+
+      if (record_size != read_elm * sizeof_ctype) {
+        read_ok = false;
+        break;
+      }
+
+      if (ecl_type == ECL_DOUBLE_TYPE) {
+        read_ok = fortio_fread_raw( fortio , &double_data[offset] , record_size );
+        if (read_ok && ECL_ENDIAN_FLIP)
+          util_endian_flip_vector( &double_data[offset] , sizeof_ctype , read_elm );
+      } else {
+        read_ok = fortio_fread_raw( fortio , &buffer , record_size );
+        if (read_ok) {
+          if (ecl_type == ECL_FLOAT_TYPE) {
+            if (ECL_ENDIAN_FLIP)
+              util_endian_flip_float_to_double( &double_data[offset] , buffer.float_data , read_elm );
+            else
+              util_float_to_double( &double_data[offset] , buffer.float_data , read_elm );
+          } else {
+            int i;
+            if (ECL_ENDIAN_FLIP)
+              util_endian_flip_vector( buffer.int_data , sizeof_ctype , read_elm );
+            for (i=0; i < read_elm; i++)
+              double_data[offset + i] = buffer.int_data[i];
+          }
+        }
+      }
+
+      if (read_ok)
+        read_ok = fortio_complete_read( fortio , record_size );
+      offset += read_elm;
+    }
+  }
+  return read_ok;
+}
+
+
 /**
    Static method without a class instance.
 */
@@ -1307,9 +1379,8 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw , fortio_type * for
     record_size = fortio_init_read(fortio);
     if (record_size > 0) {
       char buffer[ECL_KW_HEADER_DATA_SIZE];
-      size_t read_bytes = fread(buffer , 1 , ECL_KW_HEADER_DATA_SIZE , stream);
 
-      if (read_bytes == ECL_KW_HEADER_DATA_SIZE) {
+      if (fortio_fread_raw( fortio , buffer , ECL_KW_HEADER_DATA_SIZE )) {
         memcpy( header , &buffer[0] , ECL_STRING8_LENGTH);
         size = *( (int *) &buffer[ECL_STRING8_LENGTH] );
         memcpy( ecl_type_str , &buffer[ECL_STRING8_LENGTH + sizeof(size)] , ECL_TYPE_LENGTH);
@@ -1880,14 +1951,17 @@ ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target
 
 void ecl_kw_fread_double_param(const char * filename , bool fmt_file , double * double_data) {
   fortio_type   * fortio      = fortio_open_reader(filename , fmt_file , ECL_ENDIAN_FLIP);
-  ecl_kw_type   * ecl_kw      = ecl_kw_fread_alloc(fortio);
-  fortio_fclose(fortio);
+  ecl_kw_type   * ecl_kw      = ecl_kw_alloc_empty();
+  bool read_ok = false;
 
-  if (ecl_kw == NULL)
-    util_abort("%s: fatal error: loading parameter from: %s failed - aborting \n",__func__ , filename);
+  if (ecl_kw_fread_header(ecl_kw , fortio) == ECL_KW_READ_OK)
+    read_ok = ecl_kw_fread_data_as_double(ecl_kw , fortio , double_data);
 
-  ecl_kw_get_data_as_double(ecl_kw , double_data);
+  fortio_fclose(fortio);
   ecl_kw_free(ecl_kw);
+
+  if (!read_ok)
+    util_abort("%s: fatal error: loading parameter from: %s failed - aborting \n",__func__ , filename);
 }
 
 
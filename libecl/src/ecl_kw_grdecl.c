@@ -24,6 +24,7 @@
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_type.h>
 #include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_fmt_scan.h>
 
 
 /*
@@ -334,124 +335,153 @@ static void iset_range( char * data , int data_offset , int sizeof_ctype , void
    Observe that no-spaces-are-allowed-around-the-*
 */
 
+static bool grdecl_token_equal( const char * token , int length , const char * string ) {
+  return ((int) strlen( string ) == length) && (memcmp( token , string , length ) == 0);
+}
+
+
+static bool grdecl_parse_value( ecl_data_type data_type , const char * token , int length , void * value_ptr) {
+  if (ecl_type_is_int(data_type))
+    return ecl_fmt_scan_parse_int( token , length , value_ptr );
+
+  if (ecl_type_is_float(data_type))
+    return ecl_fmt_scan_parse_float( token , length , value_ptr );
+
+  if (ecl_type_is_double(data_type))
+    return ecl_fmt_scan_parse_double( token , length , value_ptr );
+
+  util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_type_get_name(data_type));
+  return false;
+}
+
+
+/*
+  Fast path: the token is either a plain number or a complete
+  'multiplier*value' pair.
+*/
+
+static bool grdecl_parse_token( ecl_data_type data_type , const char * token , int length , int * multiplier , void * value_ptr) {
+  const char * star = memchr( token , '*' , length );
+  if (star) {
+    int prefix_length = star - token;
+    return (ecl_fmt_scan_parse_int( token , prefix_length , multiplier ) &&
+            grdecl_parse_value( data_type , star + 1 , length - prefix_length - 1 , value_ptr ));
+  } else {
+    *multiplier = 1;
+    return grdecl_parse_value( data_type , token , length , value_ptr );
+  }
+}
+
+
+/*
+  Slow path with the original sscanf() based parsing; this is used
+  for tokens which are not accepted by grdecl_parse_token(), so that
+  partly numeric input like '10*' is interpreted as before.
+*/
+
+static bool grdecl_sscanf_token( ecl_data_type data_type , const char * token , int length , int * multiplier , void * value_ptr) {
+  char * buffer = util_alloc_substring_copy( token , 0 , length );
+  bool ok = true;
+
+  if (ecl_type_is_int(data_type)) {
+    if (sscanf(buffer , "%d*%d" , multiplier , (int *) value_ptr) == 2)
+      {}
+    else if (sscanf( buffer , "%d" , (int *) value_ptr) == 1)
+      *multiplier = 1;
+    else
+      ok = false;
+  } else if (ecl_type_is_float(data_type)) {
+    if (sscanf(buffer , "%d*%g" , multiplier , (float *) value_ptr) == 2)
+      {}
+    else if (sscanf( buffer , "%g" , (float *) value_ptr) == 1)
+      *multiplier = 1;
+    else
+      ok = false;
+  } else if (ecl_type_is_double(data_type)) {
+    if (sscanf(buffer , "%d*%lg" , multiplier , (double *) value_ptr) == 2)
+      {}
+    else if (sscanf( buffer , "%lg" , (double *) value_ptr) == 1)
+      *multiplier = 1;
+    else
+      ok = false;
+  } else
+    util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_type_get_name(data_type));
+
+  free( buffer );
+  return ok;
+}
+
+
 static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_data_type data_type , int * kw_size , FILE * stream ) {
-  char newline        = '\n';
-  bool atEOF          = false;
   int init_size       = 32;
-  int buffer_size     = 64;
   int data_index      = 0;
   int sizeof_ctype    = ecl_type_get_sizeof_ctype( data_type );
   int data_size       = init_size;
-  char * buffer       = util_calloc( (buffer_size + 1) , sizeof * buffer      );
   char * data         = util_calloc( sizeof_ctype * data_size , sizeof * data );
-
-  while (true) {
-    if (fscanf(stream , "%32s" , buffer) == 1) {
-      if (strcmp(buffer , ECL_COMMENT_STRING) == 0) {
-        // We have read a comment marker - just read up to the end of line.
-        char c;
-        while (true) {
-          c = fgetc( stream );
-          if (c == newline)
-            break;
-          if (c == EOF) {
-            atEOF = true;
-            break;
-          }
-        }
-      } else if (strcmp(buffer , ECL_DATA_TERMINATION) == 0)
+  ecl_fmt_scan_type * scan = ecl_fmt_scan_alloc( stream );
+  const char * token;
+  int length;
+
+  while (ecl_fmt_scan_next_token( scan , &token , &length )) {
+    if (grdecl_token_equal( token , length , ECL_COMMENT_STRING )) {
+      // We have read a comment marker - just read up to the end of line.
+      if (!ecl_fmt_scan_skip_line( scan ))
         break;
-      else {
-        // We have read a valid input string; scan numerical input values from it.
-        // The multiplier algorithm will fail hard if there are spaces on either side
-        // of the '*'.
-
-        int multiplier;
-        void * value_ptr = NULL;
-        bool   char_input = false;
-
-        if (ecl_type_is_int(data_type)) {
-          int value;
-
-          if (sscanf(buffer , "%d*%d" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%d" , &value) == 1)
-            multiplier = 1;
-          else {
-            char_input = true;
-            if (strict)
-              util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
-          }
-
-          value_ptr = &value;
-        } else if (ecl_type_is_float(data_type)) {
-          float value;
-
-          if (sscanf(buffer , "%d*%g" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%g" , &value) == 1)
-            multiplier = 1;
-          else {
-            char_input = true;
-            if (strict)
-              util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
-          }
-
-          value_ptr = &value;
-        } else if (ecl_type_is_double(data_type)) {
-          double value;
-
-          if (sscanf(buffer , "%d*%lg" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%lg" , &value) == 1)
-            multiplier = 1;
-          else {
-            char_input = true;
-            if (strict)
-              util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
+    } else if (grdecl_token_equal( token , length , ECL_DATA_TERMINATION ))
+      break;
+    else {
+      // We have read a valid input string; scan numerical input values from it.
+      // The multiplier algorithm will fail hard if there are spaces on either side
+      // of the '*'.
+
+      int multiplier;
+      double value_buffer;   /* Large enough for int, float and double. */
+      void * value_ptr = &value_buffer;
+      bool   char_input = false;
+
+      if (!grdecl_parse_token( data_type , token , length , &multiplier , value_ptr )) {
+        if (!grdecl_sscanf_token( data_type , token , length , &multiplier , value_ptr )) {
+          char_input = true;
+          if (strict) {
+            char * buffer = util_alloc_substring_copy( token , 0 , length );
+            util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
+            free( buffer );
           }
+        }
+      }
 
-          value_ptr = &value;
-        } else
-          util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_type_get_name(data_type));
-
-        /*
-          Removing this warning on user request:
-          if (char_input)
-          fprintf(stderr,"Warning: character string: \'%s\' ignored when reading keyword:%s \n",buffer , header);
-        */
-        if (!char_input) {
-          size_t min_size = data_index + multiplier;
-          if (min_size >= data_size) {
-            if (min_size <= ECL_KW_MAX_SIZE) {
-              size_t byte_size = sizeof_ctype * sizeof * data;
-
-              data_size  = util_size_t_min( ECL_KW_MAX_SIZE , 2*(data_index + multiplier));
-              byte_size *= data_size;
-
-              data = util_realloc( data , byte_size );
-            } else {
-              /*
-                We are asking for more elements than can possible be adressed in
-                an integer. Return NULL - and data size == 0; let calling scope
-                try to handle it.
-              */
-              data_index = 0;
-              break;
-            }
+      /*
+        Removing this warning on user request:
+        if (char_input)
+        fprintf(stderr,"Warning: character string: \'%s\' ignored when reading keyword:%s \n",buffer , header);
+      */
+      if (!char_input) {
+        size_t min_size = data_index + multiplier;
+        if (min_size >= data_size) {
+          if (min_size <= ECL_KW_MAX_SIZE) {
+            size_t byte_size = sizeof_ctype * sizeof * data;
+
+            data_size  = util_size_t_min( ECL_KW_MAX_SIZE , 2*(data_index + multiplier));
+            byte_size *= data_size;
+
+            data = util_realloc( data , byte_size );
+          } else {
+            /*
+              We are asking for more elements than can possible be adressed in
+              an integer. Return NULL - and data size == 0; let calling scope
+              try to handle it.
+            */
+            data_index = 0;
+            break;
           }
-
-          iset_range( data , data_index , sizeof_ctype , value_ptr , multiplier );
-          data_index += multiplier;
         }
 
+        iset_range( data , data_index , sizeof_ctype , value_ptr , multiplier );
+        data_index += multiplier;
       }
-      if (atEOF)
-        break;
-    } else
-      break;
+    }
   }
-  free( buffer );
+  ecl_fmt_scan_free( scan );
   *kw_size = data_index;
   data = util_realloc( data , sizeof_ctype * data_index * sizeof * data );
   return data;
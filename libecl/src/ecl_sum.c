@@ -32,6 +32,12 @@
 #include <ert/util/time_t_vector.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/time_interval.h>
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#else
+typedef struct thread_pool_struct thread_pool_type;   /* Only used as a NULL pointer. */
+#endif
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_sum.h>
@@ -167,12 +173,20 @@ static ecl_sum_type * ecl_sum_alloc__( const char * input_arg , const char * key
 }
 
 
-static bool ecl_sum_fread_data( ecl_sum_type * ecl_sum , const stringlist_type * data_files , bool include_restart) {
+static bool ecl_sum_fread_data( ecl_sum_type * ecl_sum , const stringlist_type * data_files , bool include_restart , thread_pool_type * thread_pool) {
+  bool data_loaded;
   if (ecl_sum->data != NULL)
     ecl_sum_free_data( ecl_sum );
 
   ecl_sum->data = ecl_sum_data_alloc( ecl_sum->smspec );
-  if (ecl_sum_data_fread( ecl_sum->data , data_files )) {
+#ifdef ERT_HAVE_THREAD_POOL
+  if (thread_pool)
+    data_loaded = ecl_sum_data_fread_mt( ecl_sum->data , data_files , thread_pool );
+  else
+#endif
+    data_loaded = ecl_sum_data_fread( ecl_sum->data , data_files );
+
+  if (data_loaded) {
     if (include_restart) {
 
     }
@@ -192,7 +206,7 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
 
 
 
-static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
+static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart , thread_pool_type * thread_pool) {
   ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
   if (ecl_sum->smspec) {
     bool fmt_file;
@@ -201,7 +215,7 @@ static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , con
   } else
     return false;
 
-  if (ecl_sum_fread_data( ecl_sum , data_files , include_restart )) {
+  if (ecl_sum_fread_data( ecl_sum , data_files , include_restart , thread_pool )) {
     ecl_file_enum file_type = ecl_util_get_file_type( stringlist_iget( data_files , 0 ) , NULL , NULL);
 
     if (file_type == ECL_SUMMARY_FILE)
@@ -228,7 +242,7 @@ static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
 
   ecl_util_alloc_summary_files( ecl_sum->path , ecl_sum->base , ecl_sum->ext , &header_file , summary_file_list );
   if ((header_file != NULL) && (stringlist_get_size( summary_file_list ) > 0)) {
-    caseOK = ecl_sum_fread( ecl_sum , header_file , summary_file_list , include_restart );
+    caseOK = ecl_sum_fread( ecl_sum , header_file , summary_file_list , include_restart , NULL );
   }
   util_safe_free( header_file );
   stringlist_free( summary_file_list );
@@ -250,10 +264,29 @@ static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
 
 ecl_sum_type * ecl_sum_fread_alloc(const char *header_file , const stringlist_type *data_files , const char * key_join_string) {
   ecl_sum_type * ecl_sum = ecl_sum_alloc__( header_file , key_join_string );
-  ecl_sum_fread( ecl_sum , header_file , data_files , false );
+  ecl_sum_fread( ecl_sum , header_file , data_files , false , NULL );
+  return ecl_sum;
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+/**
+   As ecl_sum_fread_alloc(), but when @data_files is a list of non
+   unified summary files they are loaded in parallel by the threads in
+   @thread_pool. The thread pool is owned by the calling scope; code
+   which already loads several cases in parallel should use
+   ecl_sum_fread_alloc() instead.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_mt(const char *header_file , const stringlist_type *data_files , const char * key_join_string , thread_pool_type * thread_pool) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc__( header_file , key_join_string );
+  ecl_sum_fread( ecl_sum , header_file , data_files , false , thread_pool );
   return ecl_sum;
 }
 
+#endif
+
 /*****************************************************************/
 
 void ecl_sum_set_unified( ecl_sum_type * ecl_sum , bool unified ) {
@@ -691,6 +724,18 @@ double ecl_sum_iget( const ecl_sum_type * ecl_sum , int time_index , int param_i
   return ecl_sum_data_iget(ecl_sum->data , time_index , param_index);
 }
 
+
+/*
+  Will fetch the values of all the vectors in @params_index_list at
+  all the internal time indices in @time_index_list into the row major
+  [time x key] block @block in one pass over the data; see the
+  documentation of ecl_sum_data_init_double_block().
+*/
+
+void ecl_sum_init_double_block( const ecl_sum_type * ecl_sum , const int_vector_type * params_index_list , const int_vector_type * time_index_list , double * block) {
+  ecl_sum_data_init_double_block( ecl_sum->data , params_index_list , time_index_list , block );
+}
+
 /*****************************************************************/
 /* Simple get functions which take a general var key as input    */
 
@@ -1192,6 +1237,14 @@ void ecl_sum_shift_vector( ecl_sum_type * ecl_sum, int index, double addend ) {
   ecl_sum_data_shift_vector( ecl_sum->data, index, addend );
 }
 
+void ecl_sum_set_column_cache( ecl_sum_type * ecl_sum , bool enabled ) {
+  ecl_sum_data_set_column_cache( ecl_sum->data , enabled );
+}
+
+bool ecl_sum_has_column_cache( const ecl_sum_type * ecl_sum ) {
+  return ecl_sum_data_has_column_cache( ecl_sum->data );
+}
+
 bool ecl_sum_check_sim_time( const ecl_sum_type * sum , time_t sim_time) {
   return ecl_sum_data_check_sim_time( sum->data , sim_time );
 }
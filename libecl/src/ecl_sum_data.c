@@ -24,6 +24,14 @@
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/time_interval.h>
+#include <ert/util/ert_api_config.h>
+#include <ert/util/arg_pack.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#include <ert/util/thread_pool.h>
+#else
+typedef struct thread_pool_struct thread_pool_type;   /* Only used as a NULL pointer. */
+#endif
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_smspec.h>
@@ -207,6 +215,56 @@
 
 #define INVALID_MINISTEP_NR -1
 
+/*
+  Column cache
+  ------------
+  The tstep objects store the data row wise, i.e. one tstep holds all
+  the PARAMS values for one time. When extracting one vector (column)
+  this means visiting every single tstep object. To speed that up the
+  ecl_sum_data structure keeps a column major copy of the data, built
+  on demand in blocks of COLUMN_BLOCK_SIZE neighbouring params:
+
+     block[ (params_index % COLUMN_BLOCK_SIZE) * length + time_index ]
+
+  Building one block costs one pass over the tsteps, and after that the
+  values of all the vectors in the block are contiguous. The cache is
+  dropped whenever tsteps are added or the vector is sorted. The
+  tsteps created with ecl_sum_data_add_new_tstep() are updated by the
+  calling scope after they have been returned, so for instances in
+  write mode the cache is not used at all.
+
+  The cache holds a float copy of every vector which has been read,
+  i.e. up to the same amount of memory as the tsteps themselves; for a
+  case with 10000 vectors and 5000 tsteps that is 200 MB. It is
+  therefore off by default, and must be turned on with
+  ecl_sum_data_set_column_cache() by callers which read many complete
+  vectors from the same instance; turning it off frees the blocks.
+
+  The blocks are built from the const read functions, and one instance
+  - e.g. a refcase - can be read from several threads at the same
+  time. The lock in the cache is only taken to build the block list
+  and the blocks; they are published with release stores and read
+  with acquire loads, so when a block has been built it is read
+  without locking. A block is not modified after it has been built.
+  The functions which drop the cache modify the instance, and must
+  not run concurrently with readers anyway.
+*/
+
+#define COLUMN_BLOCK_SIZE 64
+#define COLUMN_TILE_SIZE  16
+
+typedef struct {
+  bool      enabled;
+  bool      write_mode;         /* Tsteps have been created with ecl_sum_data_add_new_tstep() - the cache can not be enabled. */
+  int       length;             /* Number of tsteps when the blocks were built. */
+  int       params_size;
+  int       num_blocks;
+  float  ** blocks;             /* num_blocks pointers - NULL until the block has been built. */
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t lock;
+#endif
+} ecl_sum_data_column_cache_type;
+
 
 struct ecl_sum_data_struct {
   ecl_smspec_type        * smspec;                 /* A shared reference - only used for providing good error messages. */
@@ -225,15 +283,95 @@ struct ecl_sum_data_struct {
   time_interval_type     * sim_time;               /* The time interval sim_time goes from the first time value where we have
                                                       data to the end of the simulation. In the case of restarts the start
                                                       value might disagree with the simulation start reported by the smspec file. */
+  ecl_sum_data_column_cache_type * column_cache;   /* Column major copy of the data - see the documentation at the top. */
 };
 
 
 
+static ecl_sum_data_column_cache_type * ecl_sum_data_column_cache_alloc( void ) {
+  ecl_sum_data_column_cache_type * cache = util_malloc( sizeof * cache );
+  cache->enabled     = false;
+  cache->write_mode  = false;
+  cache->length      = 0;
+  cache->params_size = 0;
+  cache->num_blocks  = 0;
+  cache->blocks      = NULL;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &cache->lock , NULL );
+#endif
+  return cache;
+}
+
+
+static void ecl_sum_data_column_cache_clear( ecl_sum_data_column_cache_type * cache ) {
+  int iblock;
+  for (iblock = 0; iblock < cache->num_blocks; iblock++)
+    util_safe_free( cache->blocks[iblock] );
+
+  util_safe_free( cache->blocks );
+  cache->blocks     = NULL;
+  cache->num_blocks = 0;
+  cache->length     = 0;
+}
+
+
+static void ecl_sum_data_column_cache_free( ecl_sum_data_column_cache_type * cache ) {
+  ecl_sum_data_column_cache_clear( cache );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &cache->lock );
+#endif
+  free( cache );
+}
+
+
+static void ecl_sum_data_column_cache_lock( ecl_sum_data_column_cache_type * cache ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &cache->lock );
+#endif
+}
+
+
+static void ecl_sum_data_column_cache_unlock( ecl_sum_data_column_cache_type * cache ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &cache->lock );
+#endif
+}
+
+
+static float ** ecl_sum_data_column_cache_get_blocks( const ecl_sum_data_column_cache_type * cache ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  return __atomic_load_n( &cache->blocks , __ATOMIC_ACQUIRE );
+#else
+  return cache->blocks;
+#endif
+}
+
+
+static float * ecl_sum_data_column_cache_iget_block( float ** blocks , int iblock ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  return __atomic_load_n( &blocks[iblock] , __ATOMIC_ACQUIRE );
+#else
+  return blocks[iblock];
+#endif
+}
+
+
+static void ecl_sum_data_column_cache_publish( void * ptr , void * value ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  __atomic_store_n( (void **) ptr , value , __ATOMIC_RELEASE );
+#else
+  *((void **) ptr) = value;
+#endif
+}
+
+
+
 
 
 /*****************************************************************/
 
  void ecl_sum_data_free( ecl_sum_data_type * data ) {
+  ecl_sum_data_column_cache_free( data->column_cache );
   vector_free( data->data );
   int_vector_free( data->report_first_index );
   int_vector_free( data->report_last_index  );
@@ -272,6 +410,7 @@ ecl_sum_data_type * ecl_sum_data_alloc(ecl_smspec_type * smspec) {
   data->report_first_index    = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
   data->report_last_index     = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
   data->sim_time              = time_interval_alloc_open();
+  data->column_cache          = ecl_sum_data_column_cache_alloc( );
 
   ecl_sum_data_clear_index( data );
   return data;
@@ -305,6 +444,110 @@ static ecl_sum_tstep_type * ecl_sum_data_iget_ministep( const ecl_sum_data_type
 }
 
 
+static float * ecl_sum_data_alloc_column_block( const ecl_sum_data_type * data , int iblock ) {
+  ecl_sum_data_column_cache_type * cache = data->column_cache;
+  const int length = cache->length;
+  const int params_offset = iblock * COLUMN_BLOCK_SIZE;
+  const int block_size = util_int_min( COLUMN_BLOCK_SIZE , cache->params_size - params_offset );
+  float * block = util_calloc( util_int_max( 1 , block_size * length ) , sizeof * block );
+  int time_offset;
+
+  /*
+    The copy is done in tiles of COLUMN_TILE_SIZE tsteps; writing one
+    tstep at a time would spread the writes over block_size columns
+    which are all exactly length floats apart.
+  */
+  for (time_offset = 0; time_offset < length; time_offset += COLUMN_TILE_SIZE) {
+    const ecl_sum_tstep_type * ministep_list[COLUMN_TILE_SIZE];
+    const int tile_size = util_int_min( COLUMN_TILE_SIZE , length - time_offset );
+    int icol , it;
+
+    for (it = 0; it < tile_size; it++)
+      ministep_list[it] = ecl_sum_data_iget_ministep( data , time_offset + it );
+
+    for (icol = 0; icol < block_size; icol++) {
+      float * column = &block[ icol * length + time_offset ];
+      for (it = 0; it < tile_size; it++)
+        column[it] = ecl_sum_tstep_iget( ministep_list[it] , params_offset + icol );
+    }
+  }
+  return block;
+}
+
+
+/*
+  Will return a pointer to the ecl_sum_data_get_length() values of
+  vector @params_index, or NULL if the column cache is not in use for
+  this instance.
+*/
+
+static const float * ecl_sum_data_get_column( const ecl_sum_data_type * data , int params_index ) {
+  ecl_sum_data_column_cache_type * cache = data->column_cache;
+  float ** blocks;
+  float * block = NULL;
+  int iblock = params_index / COLUMN_BLOCK_SIZE;
+
+  if (!cache->enabled)
+    return NULL;
+
+  blocks = ecl_sum_data_column_cache_get_blocks( cache );
+  if (blocks && (params_index >= 0) && (params_index < cache->params_size))
+    block = ecl_sum_data_column_cache_iget_block( blocks , iblock );
+
+  if (block == NULL) {
+    ecl_sum_data_column_cache_lock( cache );
+    if (cache->blocks == NULL) {
+      cache->length      = vector_get_size( data->data );
+      cache->params_size = ecl_smspec_get_params_size( data->smspec );
+      cache->num_blocks  = (cache->params_size + COLUMN_BLOCK_SIZE - 1) / COLUMN_BLOCK_SIZE;
+      {
+        float ** new_blocks = util_calloc( util_int_max( 1 , cache->num_blocks ) , sizeof * new_blocks );
+        int i;
+        for (i = 0; i < cache->num_blocks; i++)
+          new_blocks[i] = NULL;
+        ecl_sum_data_column_cache_publish( &cache->blocks , new_blocks );
+      }
+    }
+
+    if ((params_index < 0) || (params_index >= cache->params_size))
+      util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",__func__ , params_index , cache->params_size);
+
+    block = cache->blocks[iblock];
+    if (block == NULL) {
+      block = ecl_sum_data_alloc_column_block( data , iblock );
+      ecl_sum_data_column_cache_publish( &cache->blocks[iblock] , block );
+    }
+    ecl_sum_data_column_cache_unlock( cache );
+  }
+
+  return &block[ (params_index % COLUMN_BLOCK_SIZE) * cache->length ];
+}
+
+
+/*
+  Turns the column cache on or off; when it is turned off the blocks
+  which have been built are freed. The cache can not be turned on for
+  instances in write mode.
+*/
+
+void ecl_sum_data_set_column_cache( ecl_sum_data_type * data , bool enabled ) {
+  ecl_sum_data_column_cache_type * cache = data->column_cache;
+
+  ecl_sum_data_column_cache_lock( cache );
+  if (!enabled)
+    ecl_sum_data_column_cache_clear( cache );
+
+  if (!cache->write_mode)
+    cache->enabled = enabled;
+  ecl_sum_data_column_cache_unlock( cache );
+}
+
+
+bool ecl_sum_data_has_column_cache( const ecl_sum_data_type * data ) {
+  return data->column_cache->enabled;
+}
+
+
 
 void ecl_sum_data_report2internal_range(const ecl_sum_data_type * data , int report_step , int * index1 , int * index2 ){
   if (index1 != NULL)
@@ -318,6 +561,8 @@ void ecl_sum_data_report2internal_range(const ecl_sum_data_type * data , int rep
 
 ecl_sum_data_type * ecl_sum_data_alloc_writer( ecl_smspec_type * smspec ) {
   ecl_sum_data_type * data = ecl_sum_data_alloc( smspec );
+  data->column_cache->enabled = false;
+  data->column_cache->write_mode = true;
   return data;
 }
 
@@ -671,7 +916,7 @@ double_vector_type * ecl_sum_data_alloc_seconds_solution( const ecl_sum_data_typ
     int index = 0;
     const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , index );
     const ecl_sum_tstep_type * prev_ministep;
-    double value = ecl_sum_tstep_iget( ministep , param_index );
+    double value = ecl_sum_data_iget( data , index , param_index );
     double prev_value;
 
     while (true) {
@@ -683,7 +928,7 @@ double_vector_type * ecl_sum_data_alloc_seconds_solution( const ecl_sum_data_typ
       prev_value = value;
 
       ministep = ecl_sum_data_iget_ministep( data , index );
-      value = ecl_sum_tstep_iget( ministep , param_index );
+      value = ecl_sum_data_iget( data , index , param_index );
 
       if ((value == cmp_value) ||
           (((value - cmp_value) * (cmp_value - prev_value)) > 0)) {
@@ -749,6 +994,7 @@ static void ecl_sum_data_append_tstep__( ecl_sum_data_type * data , ecl_sum_tste
   }
 
   vector_append_owned_ref( data->data , tstep , ecl_sum_tstep_free__);
+  ecl_sum_data_column_cache_clear( data->column_cache );
   data->index_valid = false;
 }
 
@@ -785,6 +1031,7 @@ static void ecl_sum_data_build_index( ecl_sum_data_type * sum_data ) {
     Sort the internal storage vector after sim_time.
   */
   vector_sort( sum_data->data , cmp_ministep );
+  ecl_sum_data_column_cache_clear( sum_data->column_cache );
 
 
   /* Identify various global first and last values.  */
@@ -851,6 +1098,8 @@ ecl_sum_tstep_type * ecl_sum_data_add_new_tstep( ecl_sum_data_type * data , int
   ecl_sum_tstep_type * tstep = ecl_sum_tstep_alloc_new( report_step , ministep_nr , sim_seconds , data->smspec );
   ecl_sum_tstep_type * prev_tstep = NULL;
 
+  data->column_cache->enabled = false;
+  data->column_cache->write_mode = true;
   if (vector_get_size( data->data ) > 0)
     prev_tstep = vector_get_last( data->data );
 
@@ -912,11 +1161,10 @@ ecl_sum_tstep_type * ecl_sum_data_add_new_tstep( ecl_sum_data_type * data , int
    calling routine will read the unified summary file partly.
 */
 
-static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
-                                      time_t load_end ,
-                                      int   report_step                ,
-                                      const ecl_file_view_type * summary_view,
-                                      const ecl_smspec_type * smspec) {
+static void ecl_sum_data_load_tsteps(vector_type * tstep_list ,
+                                     int   report_step ,
+                                     const ecl_file_view_type * summary_view,
+                                     const ecl_smspec_type * smspec) {
 
 
   int num_ministep  = ecl_file_view_get_num_named_kw( summary_view , PARAMS_KW);
@@ -936,20 +1184,46 @@ static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
                                                ecl_file_view_get_src_file( summary_view ),
                                                smspec );
 
-        if (tstep != NULL) {
-          if (load_end == 0 || (ecl_sum_tstep_get_sim_time( tstep ) < load_end))
-            ecl_sum_data_append_tstep__( data , tstep );
-          else
-            /* This tstep is in a time-period overlapping with data we
-               already have; discard this. */
-            ecl_sum_tstep_free( tstep );
-        }
+        if (tstep != NULL)
+          vector_append_ref( tstep_list , tstep );
       }
     }
   }
 }
 
 
+/*
+  The tsteps in @tstep_list are appended to the data instance, which
+  takes ownership of them; the tsteps which are in a time-period
+  overlapping with data we already have (i.e. after @load_end) are
+  discarded.
+*/
+
+static void ecl_sum_data_append_tstep_list( ecl_sum_data_type * data , time_t load_end , const vector_type * tstep_list) {
+  int i;
+  for (i = 0; i < vector_get_size( tstep_list ); i++) {
+    ecl_sum_tstep_type * tstep = vector_iget( tstep_list , i );
+    if (load_end == 0 || (ecl_sum_tstep_get_sim_time( tstep ) < load_end))
+      ecl_sum_data_append_tstep__( data , tstep );
+    else
+      ecl_sum_tstep_free( tstep );
+  }
+}
+
+
+static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
+                                      time_t load_end ,
+                                      int   report_step                ,
+                                      const ecl_file_view_type * summary_view,
+                                      const ecl_smspec_type * smspec) {
+
+  vector_type * tstep_list = vector_alloc_new();
+  ecl_sum_data_load_tsteps( tstep_list , report_step , summary_view , smspec );
+  ecl_sum_data_append_tstep_list( data , load_end , tstep_list );
+  vector_free( tstep_list );
+}
+
+
 void ecl_sum_data_add_case(ecl_sum_data_type * self, const ecl_sum_data_type * other) {
   int * param_mapping = NULL;
   bool  header_equal = ecl_smspec_equal( self->smspec , other->smspec);
@@ -995,6 +1269,96 @@ static bool ecl_sum_data_check_file( ecl_file_type * ecl_file ) {
 }
 
 
+/*
+  Loads all the tsteps from the non unified summary file @data_file
+  into @tstep_list; the function only reads the smspec instance and
+  can be called concurrently for different files.
+*/
+
+static void ecl_sum_data_load_summary_file( const char * data_file , const ecl_smspec_type * smspec , vector_type * tstep_list) {
+  ecl_file_enum file_type;
+  int report_step;
+  file_type = ecl_util_get_file_type( data_file , NULL , &report_step);
+  if (file_type != ECL_SUMMARY_FILE)
+    util_abort("%s: file:%s has wrong type \n",__func__ , data_file);
+  {
+    ecl_file_type * ecl_file = ecl_file_open( data_file , 0);
+    if (ecl_file) {
+      if (ecl_sum_data_check_file( ecl_file ))
+        ecl_sum_data_load_tsteps( tstep_list , report_step , ecl_file_get_global_view( ecl_file ) , smspec);
+      ecl_file_close( ecl_file );
+    }
+  }
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+static void * ecl_sum_data_load_summary_file_mt( void * arg ) {
+  arg_pack_type * arg_pack        = arg_pack_safe_cast( arg );
+  const char * data_file          = arg_pack_iget_const_ptr( arg_pack , 0 );
+  const ecl_smspec_type * smspec  = arg_pack_iget_const_ptr( arg_pack , 1 );
+  vector_type * tstep_list        = arg_pack_iget_ptr( arg_pack , 2 );
+
+  ecl_sum_data_load_summary_file( data_file , smspec , tstep_list );
+  return NULL;
+}
+
+#endif
+
+
+/*
+  Loads a list of non unified summary files. Each file is read into a
+  separate list of tsteps, and the lists are then appended in the
+  order of @filelist. When a @thread_pool is supplied the files are
+  opened and parsed in parallel by the threads of the pool. The pool
+  is owned by the calling scope and can be reused for several loads,
+  but it must be idle when this is called - it is restarted and
+  joined here. With @thread_pool == NULL the files are loaded one
+  after the other in the calling thread.
+*/
+
+static void ecl_sum_data_fread_summary_files( ecl_sum_data_type * data , time_t load_end , const stringlist_type * filelist , thread_pool_type * thread_pool) {
+  const int num_files = stringlist_get_size( filelist );
+  vector_type ** tstep_lists = util_calloc( num_files , sizeof * tstep_lists );
+  int filenr;
+
+  for (filenr = 0; filenr < num_files; filenr++)
+    tstep_lists[filenr] = vector_alloc_new();
+
+#ifdef ERT_HAVE_THREAD_POOL
+  if (thread_pool && (num_files > 1)) {
+    arg_pack_type ** arglist = util_calloc( num_files , sizeof * arglist );
+
+    thread_pool_restart( thread_pool );
+    for (filenr = 0; filenr < num_files; filenr++) {
+      arglist[filenr] = arg_pack_alloc();
+      arg_pack_append_const_ptr( arglist[filenr] , stringlist_iget( filelist , filenr ));
+      arg_pack_append_const_ptr( arglist[filenr] , data->smspec );
+      arg_pack_append_ptr( arglist[filenr] , tstep_lists[filenr] );
+      thread_pool_add_job( thread_pool , ecl_sum_data_load_summary_file_mt , arglist[filenr] );
+    }
+    thread_pool_join( thread_pool );
+
+    for (filenr = 0; filenr < num_files; filenr++)
+      arg_pack_free( arglist[filenr] );
+    free( arglist );
+  } else
+#endif
+  {
+    for (filenr = 0; filenr < num_files; filenr++)
+      ecl_sum_data_load_summary_file( stringlist_iget( filelist , filenr ) , data->smspec , tstep_lists[filenr] );
+  }
+
+  for (filenr = 0; filenr < num_files; filenr++) {
+    ecl_sum_data_append_tstep_list( data , load_end , tstep_lists[filenr] );
+    vector_free( tstep_lists[filenr] );
+  }
+  free( tstep_lists );
+}
+
+
+
 /*
   Observe that this can be called several times (but not with the same
   data - that will die).
@@ -1004,7 +1368,7 @@ static bool ecl_sum_data_check_file( ecl_file_type * ecl_file ) {
   call to ecl_sum_data_build_index().
 */
 
-static bool ecl_sum_data_fread__( ecl_sum_data_type * data , time_t load_end , const stringlist_type * filelist) {
+static bool ecl_sum_data_fread__( ecl_sum_data_type * data , time_t load_end , const stringlist_type * filelist , thread_pool_type * thread_pool) {
   if (stringlist_get_size( filelist ) == 0)
     return false;
 
@@ -1014,25 +1378,9 @@ static bool ecl_sum_data_fread__( ecl_sum_data_type * data , time_t load_end , c
       util_abort("%s: internal error - when calling with more than one file - you can not supply a unified file - come on?! \n",__func__);
 
     {
-      int filenr;
       if (file_type == ECL_SUMMARY_FILE) {
-
         /* Not unified. */
-        for (filenr = 0; filenr < stringlist_get_size( filelist ); filenr++) {
-          const char * data_file = stringlist_iget( filelist , filenr);
-          ecl_file_enum file_type;
-          int report_step;
-          file_type = ecl_util_get_file_type( data_file , NULL , &report_step);
-          if (file_type != ECL_SUMMARY_FILE)
-            util_abort("%s: file:%s has wrong type \n",__func__ , data_file);
-          {
-            ecl_file_type * ecl_file = ecl_file_open( data_file , 0);
-            if (ecl_file && ecl_sum_data_check_file( ecl_file )) {
-              ecl_sum_data_add_ecl_file( data , load_end , report_step , ecl_file_get_global_view( ecl_file ) , data->smspec);
-              ecl_file_close( ecl_file );
-            }
-          }
-        }
+        ecl_sum_data_fread_summary_files( data , load_end , filelist , thread_pool );
       } else if (file_type == ECL_UNIFIED_SUMMARY_FILE) {
         ecl_file_type * ecl_file = ecl_file_open( stringlist_iget(filelist ,0 ) , 0);
         if (ecl_file && ecl_sum_data_check_file( ecl_file )) {
@@ -1067,10 +1415,25 @@ static bool ecl_sum_data_fread__( ecl_sum_data_type * data , time_t load_end , c
 }
 
 bool ecl_sum_data_fread( ecl_sum_data_type * data , const stringlist_type * filelist) {
-  return ecl_sum_data_fread__( data , 0 , filelist );
+  return ecl_sum_data_fread__( data , 0 , filelist , NULL );
 }
 
 
+#ifdef ERT_HAVE_THREAD_POOL
+
+/*
+  As ecl_sum_data_fread(), but non unified summary files are loaded in
+  parallel by the threads in @thread_pool; see the documentation of
+  ecl_sum_data_fread_summary_files().
+*/
+
+bool ecl_sum_data_fread_mt( ecl_sum_data_type * data , const stringlist_type * filelist , thread_pool_type * thread_pool) {
+  return ecl_sum_data_fread__( data , 0 , filelist , thread_pool );
+}
+
+#endif
+
+
 
 static time_t ecl_sum_data_get_load_end( const ecl_sum_data_type * data ) {
   return data->__min_time;
@@ -1080,7 +1443,7 @@ static time_t ecl_sum_data_get_load_end( const ecl_sum_data_type * data ) {
 
 void ecl_sum_data_fread_restart( ecl_sum_data_type * data , const stringlist_type * filelist) {
   time_t load_end = ecl_sum_data_get_load_end( data );
-  ecl_sum_data_fread__( data , load_end , filelist );
+  ecl_sum_data_fread__( data , load_end , filelist , NULL );
 }
 
 
@@ -1097,7 +1460,7 @@ void ecl_sum_data_fread_restart( ecl_sum_data_type * data , const stringlist_typ
 
 ecl_sum_data_type * ecl_sum_data_fread_alloc( ecl_smspec_type * smspec , const stringlist_type * filelist , bool include_restart) {
   ecl_sum_data_type * data = ecl_sum_data_alloc( smspec );
-  ecl_sum_data_fread__( data , 0 , filelist );
+  ecl_sum_data_fread__( data , 0 , filelist , NULL );
 
   /*****************************************************************/
   /* OK - now we have loaded all the data. Must sort the internal
@@ -1191,8 +1554,55 @@ int ecl_sum_data_iget_mini_step(const ecl_sum_data_type * data , int internal_in
 
 
 double ecl_sum_data_iget( const ecl_sum_data_type * data , int time_index , int params_index ) {
-  const ecl_sum_tstep_type * ministep_data = ecl_sum_data_iget_ministep( data , time_index  );
-  return ecl_sum_tstep_iget( ministep_data , params_index);
+  const float * column = ecl_sum_data_get_column( data , params_index );
+  if (column) {
+    if ((time_index < 0) || (time_index >= data->column_cache->length))
+      util_abort("%s: time index:%d invalid: Valid range: [0,%d) \n",__func__ , time_index , data->column_cache->length);
+    return column[time_index];
+  } else {
+    const ecl_sum_tstep_type * ministep_data = ecl_sum_data_iget_ministep( data , time_index  );
+    return ecl_sum_tstep_iget( ministep_data , params_index);
+  }
+}
+
+
+/*
+  Will fill the dense row major block @block with the values of all
+  the vectors in @params_index_list for all the internal time indices
+  in @time_index_list, i.e.
+
+     block[ i * int_vector_size( params_index_list ) + j ] = value of params_index j at time_index_list[i]
+
+  The data is assembled with one pass over the tsteps; this should be
+  used in favour of ecl_sum_data_iget() in a double loop when many
+  vectors are extracted at many times. The storage pointed to by
+  @block must be preallocated by the calling scope.
+*/
+
+void ecl_sum_data_init_double_block( const ecl_sum_data_type * data , const int_vector_type * params_index_list , const int_vector_type * time_index_list , double * block) {
+  const int num_keys = int_vector_size( params_index_list );
+  const int * params_index = int_vector_get_const_ptr( params_index_list );
+  const int length = vector_get_size( data->data );
+  const int params_size = ecl_smspec_get_params_size( data->smspec );
+  int i , j;
+
+  for (j = 0; j < num_keys; j++) {
+    if ((params_index[j] < 0) || (params_index[j] >= params_size))
+      util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",__func__ , params_index[j] , params_size);
+  }
+
+  for (i = 0; i < int_vector_size( time_index_list ); i++) {
+    int time_index = int_vector_iget( time_index_list , i );
+    double * row = &block[ i * num_keys ];
+    const ecl_sum_tstep_type * ministep;
+
+    if ((time_index < 0) || (time_index >= length))
+      util_abort("%s: time index:%d invalid: Valid range: [0,%d) \n",__func__ , time_index , length);
+
+    ministep = ecl_sum_data_iget_ministep( data , time_index );
+    for (j = 0; j < num_keys; j++)
+      row[j] = ecl_sum_tstep_iget( ministep , params_index[j] );
+  }
 }
 
 
@@ -1209,10 +1619,7 @@ double ecl_sum_data_iget( const ecl_sum_data_type * data , int time_index , int
 */
 
 double ecl_sum_data_interp_get(const ecl_sum_data_type * data , int time_index1 , int time_index2 , double weight1 , double weight2 , int params_index) {
-  const ecl_sum_tstep_type * ministep_data1 = ecl_sum_data_iget_ministep( data , time_index1 );
-  const ecl_sum_tstep_type * ministep_data2 = ecl_sum_data_iget_ministep( data , time_index2 );
-
-  return ecl_sum_tstep_iget( ministep_data1 , params_index ) * weight1 + ecl_sum_tstep_iget( ministep_data2 , params_index ) * weight2;
+  return ecl_sum_data_iget( data , time_index1 , params_index ) * weight1 + ecl_sum_data_iget( data , time_index2 , params_index ) * weight2;
 }
 
 
@@ -1463,14 +1870,24 @@ void ecl_sum_data_init_data_vector( const ecl_sum_data_type * data , double_vect
     int report_step;
     for (report_step = data->first_report_step; report_step <= data->last_report_step; report_step++) {
       int last_index = int_vector_iget(data->report_last_index , report_step);
-      const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , last_index );
-      double_vector_append( data_vector , ecl_sum_tstep_iget( ministep , data_index ));
+      double_vector_append( data_vector , ecl_sum_data_iget( data , last_index , data_index ));
     }
   } else {
+    const float * column = ecl_sum_data_get_column( data , data_index );
+    const int length = vector_get_size( data->data );
     int i;
-    for (i = 0; i < vector_get_size(data->data); i++) {
-      const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , i  );
-      double_vector_append( data_vector , ecl_sum_tstep_iget( ministep , data_index ));
+
+    if (column) {
+      double * vector_data;
+      double_vector_resize( data_vector , length + 1 );
+      vector_data = double_vector_get_ptr( data_vector ) + 1;
+      for (i = 0; i < length; i++)
+        vector_data[i] = column[i];
+    } else {
+      for (i = 0; i < length; i++) {
+        const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , i  );
+        double_vector_append( data_vector , ecl_sum_tstep_iget( ministep , data_index ));
+      }
     }
   }
 }
@@ -1496,6 +1913,7 @@ int ecl_sum_data_get_length( const ecl_sum_data_type * data ) {
 
 void ecl_sum_data_scale_vector(ecl_sum_data_type * data, int index, double scalar) {
   int len = vector_get_size(data->data);
+  ecl_sum_data_column_cache_clear( data->column_cache );
   for (int i = 0; i < len; i++) {
     ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep(data,i);
     ecl_sum_tstep_iscale(ministep, index, scalar);
@@ -1504,6 +1922,7 @@ void ecl_sum_data_scale_vector(ecl_sum_data_type * data, int index, double scala
 
 void ecl_sum_data_shift_vector(ecl_sum_data_type * data, int index, double addend) {
   int len = vector_get_size(data->data);
+  ecl_sum_data_column_cache_clear( data->column_cache );
   for (int i = 0; i < len; i++) {
     ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep(data,i);
     ecl_sum_tstep_ishift(ministep, index, addend);
@@ -40,6 +40,7 @@ struct ecl_sum_vector_struct {
 void ecl_sum_vector_free( ecl_sum_vector_type * ecl_sum_vector ){
     int_vector_free(ecl_sum_vector->node_index_list);
     bool_vector_free(ecl_sum_vector->is_rate_list);
+    free(ecl_sum_vector);
 }
 
 
@@ -99,3 +100,19 @@ bool ecl_sum_vector_iget_is_rate(const ecl_sum_vector_type * ecl_sum_vector, int
 int ecl_sum_vector_iget_param_index(const ecl_sum_vector_type * ecl_sum_vector, int index){
     return int_vector_iget(ecl_sum_vector->node_index_list, index);
 }
+
+
+/*
+  Will fetch the values of all the keys in the vector at all the
+  internal time indices in @time_index_list into the row major
+  block @block, which must have room for
+
+     int_vector_size( time_index_list ) * ecl_sum_vector_get_size( ecl_sum_vector )
+
+  elements. The keys have already been resolved to params indices, so
+  no key lookups are performed.
+*/
+
+void ecl_sum_vector_init_double_block(const ecl_sum_vector_type * ecl_sum_vector, const int_vector_type * time_index_list, double * block){
+    ecl_sum_init_double_block(ecl_sum_vector->ecl_sum, ecl_sum_vector->node_index_list, time_index_list, block);
+}
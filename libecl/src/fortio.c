@@ -22,6 +22,12 @@
 #include <string.h>
 #include <errno.h>
 
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
 #include <ert/ecl/fortio.h>
@@ -90,6 +96,16 @@ struct fortio_struct {
   */
   bool               readable;
   offset_type        read_size;
+
+  /*
+    When the file has been opened with fortio_open_reader_mmap() the
+    complete file is mapped into memory, the stream is closed and all
+    the read functions in this file work on the mapping instead of
+    the FILE pointer. The mmap_pos field is the equivalent of the
+    stream position.
+  */
+  char             * mmap_data;
+  offset_type        mmap_pos;
 };
 
 
@@ -105,6 +121,8 @@ static fortio_type * fortio_alloc__(const char *filename , bool fmt_file , bool
   fortio->stream_owner       = stream_owner;
   fortio->read_size          = 0;
   fortio->readable           = readable;
+  fortio->mmap_data          = NULL;
+  fortio->mmap_pos           = 0;
   return fortio;
 }
 
@@ -303,6 +321,44 @@ fortio_type * fortio_open_reader(const char *filename , bool fmt_file , bool end
 
 
 
+/**
+   Will open the file for reading, map the complete file into memory
+   and close the underlying stream again. Subsequent reads are served
+   from the mapping, i.e. there are no fseek() / fread() system calls
+   and the file content is shared through the page cache between all
+   the processes and threads reading the same file.
+
+   Formatted files are parsed with fscanf() and must be read through
+   a FILE pointer; for formatted files, empty files, platforms without
+   mmap() and if the mapping fails the function silently falls back to
+   a normal stream based reader.
+*/
+
+fortio_type * fortio_open_reader_mmap(const char *filename , bool fmt_file , bool endian_flip_header) {
+  fortio_type * fortio = fortio_open_reader( filename , fmt_file , endian_flip_header );
+#ifdef HAVE_MMAP
+  if (fortio && !fmt_file && (fortio->read_size > 0)) {
+    void * data = mmap( NULL , fortio->read_size , PROT_READ , MAP_PRIVATE , fortio_fileno( fortio ) , 0);
+    if (data != MAP_FAILED) {
+      fortio->mmap_data = data;
+      fortio->mmap_pos = 0;
+      fclose( fortio->stream );
+      fortio->stream = NULL;
+    }
+  }
+#endif
+  return fortio;
+}
+
+
+bool fortio_is_mmapped( const fortio_type * fortio ) {
+  if (fortio->mmap_data)
+    return true;
+  else
+    return false;
+}
+
+
 fortio_type * fortio_open_writer(const char *filename , bool fmt_file , bool endian_flip_header ) {
   FILE * stream = fortio_fopen_write( filename , fmt_file );
   if (stream) {
@@ -346,7 +402,16 @@ fortio_type * fortio_open_append(const char *filename , bool fmt_file , bool end
 
 /*****************************************************************/
 
+/*
+  For a memory mapped fortio instance there is no stream; the mapping
+  is kept alive until fortio_fclose() and the stream functions below
+  are no-ops reporting an open stream.
+*/
+
 bool fortio_fclose_stream( fortio_type * fortio ) {
+  if (fortio->mmap_data)
+    return false;
+
   if (fortio->stream_owner) {
     if (fortio->stream) {
       int fclose_return = fclose( fortio->stream );
@@ -363,6 +428,9 @@ bool fortio_fclose_stream( fortio_type * fortio ) {
 
 
 bool fortio_fopen_stream( fortio_type * fortio ) {
+  if (fortio->mmap_data)
+    return false;
+
   if (fortio->stream == NULL) {
     fortio->stream = fopen( fortio->filename , fortio->fopen_mode );
     if (fortio->stream)
@@ -375,7 +443,7 @@ bool fortio_fopen_stream( fortio_type * fortio ) {
 
 
 bool fortio_stream_is_open( const fortio_type * fortio ) {
-  if (fortio->stream)
+  if (fortio->stream || fortio->mmap_data)
     return true;
   else
     return false;
@@ -383,7 +451,7 @@ bool fortio_stream_is_open( const fortio_type * fortio ) {
 
 
 bool fortio_assert_stream_open( fortio_type * fortio ) {
-  if (fortio->stream)
+  if (fortio->stream || fortio->mmap_data)
     return true;
   else {
     fortio_fopen_stream( fortio );
@@ -411,24 +479,36 @@ void fortio_fclose(fortio_type *fortio) {
     fortio->stream = NULL;
   }
 
+#ifdef HAVE_MMAP
+  if (fortio->mmap_data) {
+    munmap( fortio->mmap_data , fortio->read_size );
+    fortio->mmap_data = NULL;
+  }
+#endif
+
   fortio_free__(fortio);
 }
 
 
+/*
+  The reads go through fortio_fread_raw(), so the function gives the
+  same result for stream based and memory mapped instances; in both
+  cases the position is restored to where it was on entry.
+*/
+
 bool fortio_is_fortio_file(fortio_type * fortio) {
   offset_type init_pos = fortio_ftell(fortio);
-  int elm_read;
   bool is_fortio_file = false;
   int record_size;
-  elm_read = fread(&record_size , sizeof(record_size) , 1 , fortio->stream);
-  if (elm_read == 1) {
+
+  if (fortio_fread_raw( fortio , &record_size , sizeof record_size )) {
     int trailer;
 
     if (fortio->endian_flip_header)
       util_endian_flip_vector(&record_size , sizeof record_size , 1);
 
     if (fortio_fseek(fortio , (offset_type) record_size , SEEK_CUR) == 0) {
-      if (fread(&trailer , sizeof(record_size) , 1 , fortio->stream) == 1) {
+      if (fortio_fread_raw( fortio , &trailer , sizeof trailer )) {
         if (fortio->endian_flip_header)
           util_endian_flip_vector(&trailer , sizeof trailer , 1);
 
@@ -443,6 +523,35 @@ bool fortio_is_fortio_file(fortio_type * fortio) {
 }
 
 
+/**
+   Reads @byte_size raw bytes from the current position, without
+   interpreting any Fortran record markers. Will return false if the
+   file does not contain @byte_size more bytes. This is the only
+   function which should be used to read unformatted data directly,
+   because it works both for stream based and memory mapped fortio
+   instances.
+*/
+
+bool fortio_fread_raw( fortio_type * fortio , void * buffer , size_t byte_size) {
+  if (fortio->mmap_data) {
+    if ((fortio->mmap_pos + (offset_type) byte_size) <= fortio->read_size) {
+      memcpy( buffer , &fortio->mmap_data[fortio->mmap_pos] , byte_size );
+      fortio->mmap_pos += byte_size;
+      return true;
+    } else {
+      fortio->mmap_pos = fortio->read_size;
+      return false;
+    }
+  } else {
+    size_t bytes_read = fread( buffer , 1 , byte_size , fortio->stream );
+    if (bytes_read == byte_size)
+      return true;
+    else
+      return false;
+  }
+}
+
+
 /**
   This function reads the header (i.e. the number of bytes in the
   following record), stores that internally in the fortio struct, and
@@ -451,11 +560,9 @@ bool fortio_is_fortio_file(fortio_type * fortio) {
 */
 
 int fortio_init_read(fortio_type *fortio) {
-  int elm_read;
   int record_size;
 
-  elm_read = fread(&record_size , sizeof(record_size) , 1 , fortio->stream);
-  if (elm_read == 1) {
+  if (fortio_fread_raw( fortio , &record_size , sizeof record_size )) {
     if (fortio->endian_flip_header)
       util_endian_flip_vector(&record_size , sizeof record_size , 1);
 
@@ -491,9 +598,8 @@ void fortio_data_fseek(fortio_type* fortio, offset_type data_offset, size_t data
 
 bool fortio_complete_read(fortio_type *fortio , int record_size) {
   int trailer;
-  size_t read_count = fread(&trailer , sizeof trailer , 1 , fortio->stream );
 
-  if (read_count == 1) {
+  if (fortio_fread_raw( fortio , &trailer , sizeof trailer )) {
     if (fortio->endian_flip_header)
       util_endian_flip_vector(&trailer , sizeof trailer , 1);
 
@@ -514,8 +620,7 @@ bool fortio_complete_read(fortio_type *fortio , int record_size) {
 static int fortio_fread_record(fortio_type *fortio , char *buffer) {
   int record_size = fortio_init_read(fortio);
   if (record_size >= 0) {
-    size_t items_read = fread(buffer , 1 , record_size , fortio->stream);
-    if (items_read == record_size) {
+    if (fortio_fread_raw( fortio , buffer , record_size )) {
       bool complete_ok = fortio_complete_read(fortio , record_size);
       if (!complete_ok)
         record_size = -1;
@@ -592,7 +697,8 @@ void fortio_copy_record(fortio_type * src_stream , fortio_type * target_stream ,
     else
       bytes = record_size - bytes_read;
 
-    util_fread(buffer , 1 , bytes , src_stream->stream     , __func__);
+    if (!fortio_fread_raw( src_stream , buffer , bytes ))
+      util_abort("%s: failed to read %d bytes from %s \n",__func__ , bytes , src_stream->filename);
     util_fwrite(buffer , 1 , bytes , target_stream->stream , __func__);
 
     bytes_read += bytes;
@@ -601,7 +707,9 @@ void fortio_copy_record(fortio_type * src_stream , fortio_type * target_stream ,
   fortio_complete_read(src_stream , record_size);
   fortio_complete_write(target_stream , record_size);
 
-  if (feof(src_stream->stream))
+  if (src_stream->mmap_data)
+    *at_eof = fortio_read_at_eof( src_stream );
+  else if (feof(src_stream->stream))
     *at_eof = true;
   else
     *at_eof = false;
@@ -639,7 +747,8 @@ void * fortio_fread_alloc_record(fortio_type * fortio) {
   void * buffer;
   int record_size = fortio_init_read(fortio);
   buffer = util_malloc( record_size );
-  util_fread(buffer , 1 , record_size , fortio->stream , __func__);
+  if (!fortio_fread_raw( fortio , buffer , record_size ))
+    util_abort("%s: failed to read record from %s \n",__func__ , fortio->filename);
   fortio_complete_read(fortio , record_size);
   return buffer;
 }
@@ -732,17 +841,37 @@ fortio_status_type fortio_check_file( const char * filename , bool endian_flip)
 
 
 offset_type fortio_ftell( const fortio_type * fortio ) {
-  return util_ftell( fortio->stream );
+  if (fortio->mmap_data)
+    return fortio->mmap_pos;
+  else
+    return util_ftell( fortio->stream );
 }
 
 
+/*
+  For the memory mapped case this is only called from the readable
+  branch of fortio_fseek() with whence == SEEK_SET and an offset which
+  has already been checked against the file size; a negative offset,
+  i.e. seeking backwards past the start of the file, fails like it
+  does for the stream.
+*/
+
 static bool fortio_fseek__(fortio_type * fortio , offset_type offset , int whence) {
-  int fseek_return = util_fseek( fortio->stream , offset , whence );
-  if (fseek_return == 0)
+  if (fortio->mmap_data) {
+    if (offset < 0)
+      return false;
+
+    fortio->mmap_pos = offset;
     return true;
-  else
-    return false;
+  }
 
+  {
+    int fseek_return = util_fseek( fortio->stream , offset , whence );
+    if (fseek_return == 0)
+      return true;
+    else
+      return false;
+  }
 }
 
 /*
@@ -797,8 +926,16 @@ bool fortio_ftruncate_current( fortio_type * fortio ) {
 
 
 
+/*
+  Will return -1 if there is no open stream, that is also the case
+  for a memory mapped fortio instance.
+*/
+
 int fortio_fileno( fortio_type * fortio ) {
-  return fileno( fortio->stream );
+  if (fortio->stream)
+    return fileno( fortio->stream );
+  else
+    return -1;
 }
 
 
@@ -821,11 +958,11 @@ bool fortio_read_at_eof( fortio_type * fortio ) {
 
 
 /*****************************************************************/
-void          fortio_fflush(fortio_type * fortio) { fflush( fortio->stream); }
+void          fortio_fflush(fortio_type * fortio) { if (fortio->stream) fflush( fortio->stream); }
 FILE        * fortio_get_FILE(const fortio_type *fortio)        { return fortio->stream; }
 //bool          fortio_endian_flip(const fortio_type *fortio)   { return fortio->endian_flip_header; }
 bool          fortio_fmt_file(const fortio_type *fortio)        { return fortio->fmt_file; }
-void          fortio_rewind(const fortio_type *fortio)          { util_rewind(fortio->stream); }
+void          fortio_rewind(fortio_type *fortio)                { fortio_fseek(fortio , 0 , SEEK_SET); }
 const char  * fortio_filename_ref(const fortio_type * fortio)   { return (const char *) fortio->filename; }
 
 
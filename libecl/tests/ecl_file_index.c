@@ -0,0 +1,203 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+void write_file( const char * filename , const char * char_name , const char * kw2 , int size2) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * kw1 = ecl_kw_alloc( "KW1" , 2500 , ECL_FLOAT );
+  ecl_kw_type * char_kw = ecl_kw_alloc( char_name , 200 , ECL_CHAR );
+  int i;
+
+  for (i=0; i < ecl_kw_get_size( kw1 ); i++)
+    ecl_kw_iset_float( kw1 , i , i * 0.5 );
+
+  for (i=0; i < ecl_kw_get_size( char_kw ); i++)
+    ecl_kw_iset_string8( char_kw , i , "STRING");
+
+  ecl_kw_fwrite( kw1 , fortio );
+  ecl_kw_fwrite( char_kw , fortio );
+  {
+    ecl_kw_type * int_kw = ecl_kw_alloc( kw2 , size2 , ECL_INT );
+    ecl_kw_scalar_set_int( int_kw , 77 );
+    ecl_kw_fwrite( int_kw , fortio );
+    ecl_kw_free( int_kw );
+  }
+
+  ecl_kw_free( kw1 );
+  ecl_kw_free( char_kw );
+  fortio_fclose( fortio );
+}
+
+
+void test_equal( const char * filename ) {
+  ecl_file_type * scan_file = ecl_file_open( filename , 0 );
+  ecl_file_type * index_file = ecl_file_open( filename , ECL_FILE_INDEX );
+  int i;
+
+  test_assert_not_NULL( index_file );
+  test_assert_int_equal( ecl_file_get_size( scan_file ) , ecl_file_get_size( index_file ));
+  for (i=0; i < ecl_file_get_size( scan_file ); i++)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( scan_file , i ) , ecl_file_iget_kw( index_file , i )));
+
+  ecl_file_close( scan_file );
+  ecl_file_close( index_file );
+}
+
+
+/*
+  Will rewrite the file and then restore the modification time the
+  file had before, including the nanoseconds.
+*/
+
+void rewrite_file( const char * filename , const char * char_name , const char * kw2 , int size2) {
+  struct stat stat_info;
+  struct timespec times[2];
+
+  stat( filename , &stat_info );
+  times[0] = stat_info.st_atim;
+  times[1] = stat_info.st_mtim;
+  write_file( filename , char_name , kw2 , size2 );
+  test_assert_int_equal( utimensat( AT_FDCWD , filename , times , 0 ) , 0 );
+}
+
+
+void test_index_reused( ) {
+  write_file( "CASE.UNRST" , "CHAR" , "INT1" , 100 );
+  test_assert_false( util_file_exists( "CASE.UNRST.index" ));
+  test_equal( "CASE.UNRST" );
+  test_assert_true( util_file_exists( "CASE.UNRST.index" ));
+  test_equal( "CASE.UNRST" );
+
+  /*
+    Rewrite the file with a different name for the keyword in the
+    middle, but identical size and mtime. Only the first and last
+    keyword headers are checked, so the index is then (wrongly)
+    reused, which we check to verify that the index - and not a scan -
+    is used.
+  */
+  {
+    rewrite_file( "CASE.UNRST" , "CHAR2" , "INT1" , 100 );
+    {
+      ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , ECL_FILE_INDEX );
+      test_assert_true( ecl_file_has_kw( ecl_file , "CHAR" ));
+      test_assert_false( ecl_file_has_kw( ecl_file , "CHAR2" ));
+      ecl_file_close( ecl_file );
+    }
+  }
+
+  /* A new name for the last keyword is detected by the header check. */
+  {
+    rewrite_file( "CASE.UNRST" , "CHAR" , "INT2" , 100 );
+    {
+      ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , ECL_FILE_INDEX );
+      test_assert_true( ecl_file_has_kw( ecl_file , "INT2" ));
+      test_assert_false( ecl_file_has_kw( ecl_file , "INT1" ));
+      ecl_file_close( ecl_file );
+    }
+  }
+
+  /* Changing the size invalidates the index. */
+  write_file( "CASE.UNRST" , "CHAR" , "INT3" , 200 );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , ECL_FILE_INDEX );
+    test_assert_true( ecl_file_has_kw( ecl_file , "INT3" ));
+    test_assert_int_equal( ecl_file_iget_named_size( ecl_file , "INT3" , 0 ) , 200 );
+    ecl_file_close( ecl_file );
+  }
+  test_equal( "CASE.UNRST" );
+}
+
+
+void test_invalid_index( ) {
+  write_file( "CASE.UNRST" , "CHAR" , "INT" , 100 );
+  {
+    FILE * stream = util_fopen( "CASE.UNRST.index" , "w");
+    fprintf(stream , "Not an index");
+    fclose( stream );
+  }
+  test_equal( "CASE.UNRST" );
+}
+
+
+/*
+  A valid index which is truncated, or where the offset of the last
+  keyword - which is the last eight bytes of the index - points
+  outside the file, is rejected and the file is scanned instead.
+*/
+
+void test_corrupt_index( ) {
+  write_file( "CASE.UNRST" , "CHAR" , "INT" , 100 );
+  test_equal( "CASE.UNRST" );
+  {
+    offset_type index_size = util_file_size( "CASE.UNRST.index" );
+    {
+      FILE * stream = util_fopen( "CASE.UNRST.index" , "r+");
+      util_ftruncate( stream , index_size - 5 );
+      fclose( stream );
+    }
+    test_equal( "CASE.UNRST" );
+    test_assert_long_equal( util_file_size( "CASE.UNRST.index" ) , index_size );
+
+    {
+      FILE * stream = util_fopen( "CASE.UNRST.index" , "r+");
+      offset_type offset = 10 * util_file_size( "CASE.UNRST" );
+      fseek( stream , index_size - sizeof offset , SEEK_SET );
+      fwrite( &offset , sizeof offset , 1 , stream );
+      fclose( stream );
+    }
+    test_equal( "CASE.UNRST" );
+  }
+}
+
+
+void test_unwritable_directory( ) {
+  util_make_path( "readonly" );
+  write_file( "readonly/CASE.UNRST" , "CHAR" , "INT" , 100 );
+  chmod( "readonly" , S_IRUSR | S_IXUSR );
+  test_equal( "readonly/CASE.UNRST" );
+  if (access( "readonly" , W_OK ) != 0)
+    test_assert_false( util_file_exists( "readonly/CASE.UNRST.index" ));
+  chmod( "readonly" , S_IRWXU );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_index" );
+  {
+    test_index_reused( );
+    test_invalid_index( );
+    test_corrupt_index( );
+    test_unwritable_directory( );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,154 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_mmap.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+void write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * int_kw = ecl_kw_alloc( "INT" , 2500 , ECL_INT );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , 10 , ECL_DOUBLE );
+  ecl_kw_type * char_kw = ecl_kw_alloc( "CHAR" , 200 , ECL_CHAR );
+  ecl_kw_type * empty_kw = ecl_kw_alloc( "EMPTY" , 0 , ECL_FLOAT );
+  int i;
+
+  for (i=0; i < ecl_kw_get_size( int_kw ); i++)
+    ecl_kw_iset_int( int_kw , i , i );
+
+  for (i=0; i < ecl_kw_get_size( double_kw ); i++)
+    ecl_kw_iset_double( double_kw , i , i * 0.25 );
+
+  for (i=0; i < ecl_kw_get_size( char_kw ); i++)
+    ecl_kw_iset_string8( char_kw , i , (i % 2) ? "ODD" : "EVEN");
+
+  ecl_kw_fwrite( int_kw , fortio );
+  ecl_kw_fwrite( char_kw , fortio );
+  ecl_kw_fwrite( empty_kw , fortio );
+  ecl_kw_fwrite( double_kw , fortio );
+  ecl_kw_fwrite( int_kw , fortio );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( double_kw );
+  ecl_kw_free( char_kw );
+  ecl_kw_free( empty_kw );
+  fortio_fclose( fortio );
+}
+
+
+void test_equal( const char * filename , int flags ) {
+  ecl_file_type * stream_file = ecl_file_open( filename , 0 );
+  ecl_file_type * mmap_file = ecl_file_open( filename , ECL_FILE_MMAP | flags );
+
+  test_assert_not_NULL( mmap_file );
+  test_assert_int_equal( ecl_file_get_size( stream_file ) , ecl_file_get_size( mmap_file ));
+  test_assert_int_equal( ecl_file_get_num_named_kw( mmap_file , "INT" ) , 2 );
+  {
+    int i;
+    for (i=0; i < ecl_file_get_size( stream_file ); i++)
+      test_assert_true( ecl_kw_equal( ecl_file_iget_kw( stream_file , i ) , ecl_file_iget_kw( mmap_file , i )));
+  }
+  {
+    int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+    int buffer[3];
+
+    int_vector_append( index_map , 0 );
+    int_vector_append( index_map , 1500 );
+    int_vector_append( index_map , 2499 );
+    ecl_file_indexed_read( mmap_file , "INT" , 1 , index_map , (char *) buffer );
+    test_assert_int_equal( buffer[0] , 0 );
+    test_assert_int_equal( buffer[1] , 1500 );
+    test_assert_int_equal( buffer[2] , 2499 );
+    int_vector_free( index_map );
+  }
+
+  ecl_file_close( stream_file );
+  ecl_file_close( mmap_file );
+}
+
+
+void test_truncated( const char * filename ) {
+  offset_type file_size = util_file_size( filename );
+  {
+    FILE * stream = util_fopen(filename , "r+");
+    util_ftruncate( stream , file_size - 100);
+    fclose( stream );
+  }
+  test_assert_NULL( ecl_file_open( filename , ECL_FILE_MMAP ));
+}
+
+
+/*
+  fortio_is_fortio_file() must give the same answer for the stream
+  based and the memory mapped reader, and leave the position where it
+  was; the positions are the start of the file, inside the first
+  record marker, the start of the first data record and the end of
+  the file.
+*/
+
+void test_is_fortio_file( const char * filename ) {
+  offset_type positions[4] = { 0 , 4 , 8 + 16 , 0 };
+  fortio_type * stream_fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+  fortio_type * mmap_fortio = fortio_open_reader_mmap( filename , false , ECL_ENDIAN_FLIP );
+  int i;
+
+  positions[3] = util_file_size( filename );
+  test_assert_true( fortio_is_mmapped( mmap_fortio ));
+  for (i=0; i < 4; i++) {
+    test_assert_true( fortio_fseek( stream_fortio , positions[i] , SEEK_SET ));
+    test_assert_true( fortio_fseek( mmap_fortio , positions[i] , SEEK_SET ));
+
+    test_assert_bool_equal( fortio_is_fortio_file( stream_fortio ) , fortio_is_fortio_file( mmap_fortio ));
+    test_assert_long_equal( fortio_ftell( stream_fortio ) , positions[i] );
+    test_assert_long_equal( fortio_ftell( mmap_fortio ) , positions[i] );
+  }
+
+  /* Seeking before the start of the file fails for both readers. */
+  fortio_fseek( stream_fortio , 0 , SEEK_SET );
+  fortio_fseek( mmap_fortio , 0 , SEEK_SET );
+  test_assert_false( fortio_fseek( stream_fortio , -100 , SEEK_CUR ));
+  test_assert_false( fortio_fseek( mmap_fortio , -100 , SEEK_CUR ));
+  test_assert_long_equal( fortio_ftell( stream_fortio ) , 0 );
+  test_assert_long_equal( fortio_ftell( mmap_fortio ) , 0 );
+
+  fortio_fclose( stream_fortio );
+  fortio_fclose( mmap_fortio );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_mmap" );
+  {
+    write_file( "TEST.UNRST" );
+    test_equal( "TEST.UNRST" , 0 );
+    test_equal( "TEST.UNRST" , ECL_FILE_CLOSE_STREAM );
+    test_is_fortio_file( "TEST.UNRST" );
+    test_truncated( "TEST.UNRST" );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
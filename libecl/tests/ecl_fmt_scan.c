@@ -0,0 +1,321 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_fmt_scan.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_fmt_scan.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.h>
+
+
+void test_parse_int() {
+  int value;
+
+  test_assert_true( ecl_fmt_scan_parse_int( "17" , 2 , &value ));
+  test_assert_int_equal( value , 17 );
+  test_assert_true( ecl_fmt_scan_parse_int( "-2147483648" , 11 , &value ));
+  test_assert_int_equal( value , -2147483647 - 1);
+  test_assert_true( ecl_fmt_scan_parse_int( "+5xyz" , 2 , &value ));
+  test_assert_int_equal( value , 5 );
+
+  test_assert_false( ecl_fmt_scan_parse_int( "2147483648" , 10 , &value ));
+  test_assert_false( ecl_fmt_scan_parse_int( "-" , 1 , &value ));
+  test_assert_false( ecl_fmt_scan_parse_int( "1.0" , 3 , &value ));
+  test_assert_false( ecl_fmt_scan_parse_int( "" , 0 , &value ));
+}
+
+
+void test_parse_float() {
+  const char * tokens[] = {"0.12345678E+01" , "-0.98765432E-03" , "0.00000000E+00" , "1" , "-7." , ".5" ,
+                           "0.34028235E+39" , "0.11754944E-37" , "0.14012985E-44" , "3.4028235677973366e38" ,
+                           "1.00000005960464477539062499" , "123456789012345678901234567890", "0.1e-60"};
+  int i;
+  for (i=0; i < sizeof tokens / sizeof tokens[0]; i++) {
+    float value;
+    test_assert_true( ecl_fmt_scan_parse_float( tokens[i] , strlen( tokens[i] ) , &value ));
+    test_assert_true( value == strtof( tokens[i] , NULL ));
+  }
+
+  {
+    char token[64];
+    for (i=0; i < 100000; i++) {
+      float expected = (rand() - RAND_MAX / 2) * 1e-4f;
+      float value;
+      sprintf(token , "%.8E" , expected);
+      test_assert_true( ecl_fmt_scan_parse_float( token , strlen( token ) , &value ));
+      test_assert_true( value == strtof( token , NULL ));
+    }
+  }
+
+  {
+    float value;
+    test_assert_false( ecl_fmt_scan_parse_float( "1.0F" , 4 , &value ));
+    test_assert_false( ecl_fmt_scan_parse_float( "E+01" , 4 , &value ));
+    test_assert_false( ecl_fmt_scan_parse_float( "1.0E" , 4 , &value ));
+    test_assert_false( ecl_fmt_scan_parse_float( "." , 1 , &value ));
+  }
+}
+
+
+void test_parse_double() {
+  double value;
+
+  test_assert_true( ecl_fmt_scan_parse_double( "0.12345678901234D+01" , 20 , &value ));
+  test_assert_true( value == 1.2345678901234 );
+  test_assert_true( ecl_fmt_scan_parse_double( "-0.50000000000000D-300" , 22 , &value ));
+  test_assert_true( value == -0.5e-300 );
+  test_assert_true( ecl_fmt_scan_parse_double( "12345678901234567890123" , 23 , &value ));
+  test_assert_true( value == 12345678901234567890123.0 );
+  test_assert_true( ecl_fmt_scan_parse_double( "0.1" , 3 , &value ));
+  test_assert_true( value == 0.1 );
+
+  {
+    char token[64];
+    int i;
+    for (i=0; i < 100000; i++) {
+      double expected = (rand() - RAND_MAX / 2) * 1.0e-7;
+      sprintf(token , "%.14E" , expected);
+      test_assert_true( ecl_fmt_scan_parse_double( token , strlen( token ) , &value ));
+      test_assert_true( value == strtod( token , NULL ));
+    }
+  }
+}
+
+
+/*
+  Writes enough tokens to cross several buffer boundaries, and checks
+  that the stream is positioned right after the last consumed token
+  when the scanner is freed.
+*/
+
+void test_scan_tokens() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_fmt_scan_tokens" );
+  const int num_tokens = 100000;
+  int i;
+  {
+    FILE * stream = util_fopen( "TOKENS" , "w");
+    for (i=0; i < num_tokens; i++)
+      fprintf(stream , "%d%s" , i , (i % 7 == 0) ? "\n" : "   ");
+    fprintf(stream , "-- comment 1 2 3\nLAST");
+    fclose( stream );
+  }
+  {
+    FILE * stream = util_fopen( "TOKENS" , "r");
+    ecl_fmt_scan_type * scan = ecl_fmt_scan_alloc( stream );
+    const char * token;
+    int length;
+
+    test_assert_true( ecl_fmt_scan_is_instance( scan ));
+    for (i=0; i < num_tokens / 2; i++) {
+      int value;
+      test_assert_true( ecl_fmt_scan_next_token( scan , &token , &length ));
+      test_assert_true( ecl_fmt_scan_parse_int( token , length , &value ));
+      test_assert_int_equal( value , i );
+    }
+    ecl_fmt_scan_free( scan );
+
+    {
+      int value;
+      test_assert_int_equal( fscanf( stream , "%d" , &value ) , 1 );
+      test_assert_int_equal( value , num_tokens / 2 );
+    }
+
+    scan = ecl_fmt_scan_alloc( stream );
+    for (i=num_tokens / 2 + 1; i < num_tokens; i++) {
+      int value;
+      test_assert_true( ecl_fmt_scan_next_token( scan , &token , &length ));
+      test_assert_true( ecl_fmt_scan_parse_int( token , length , &value ));
+      test_assert_int_equal( value , i );
+    }
+    test_assert_true( ecl_fmt_scan_next_token( scan , &token , &length ));
+    test_assert_int_equal( length , 2 );
+    test_assert_true( ecl_fmt_scan_skip_line( scan ));
+    test_assert_true( ecl_fmt_scan_next_token( scan , &token , &length ));
+    test_assert_int_equal( length , 4 );
+    test_assert_int_equal( memcmp( token , "LAST" , 4 ) , 0 );
+    test_assert_false( ecl_fmt_scan_next_token( scan , &token , &length ));
+    ecl_fmt_scan_free( scan );
+    fclose( stream );
+  }
+  test_work_area_free( work_area );
+}
+
+
+void test_scan_numbers() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_fmt_scan_numbers" );
+  const int num_values = 100000;
+  int i;
+  {
+    FILE * stream = util_fopen( "NUMBERS" , "w");
+    for (i=0; i < num_values; i++)
+      fprintf(stream , "  %.8E  %.14E %d%s" , 0.125 * i , -0.25 * i , i , (i % 4 == 0) ? "\n" : "");
+    fprintf(stream , " 1.0X 7");
+    fclose( stream );
+  }
+  {
+    FILE * stream = util_fopen( "NUMBERS" , "r");
+    ecl_fmt_scan_type * scan = ecl_fmt_scan_alloc( stream );
+
+    for (i=0; i < num_values; i++) {
+      float  float_value;
+      double double_value;
+      int    int_value;
+
+      test_assert_true( ecl_fmt_scan_next_float( scan , &float_value ));
+      test_assert_true( ecl_fmt_scan_next_double( scan , &double_value ));
+      test_assert_true( ecl_fmt_scan_next_int( scan , &int_value ));
+      test_assert_float_equal( float_value , 0.125 * i );
+      test_assert_double_equal( double_value , -0.25 * i );
+      test_assert_int_equal( int_value , i );
+    }
+
+    {
+      double double_value;
+      int int_value;
+      const char * token;
+      int length;
+
+      test_assert_false( ecl_fmt_scan_next_double( scan , &double_value ));
+      test_assert_true( ecl_fmt_scan_next_token( scan , &token , &length ));
+      test_assert_int_equal( length , 4 );
+      test_assert_true( ecl_fmt_scan_next_int( scan , &int_value ));
+      test_assert_int_equal( int_value , 7 );
+      test_assert_false( ecl_fmt_scan_next_int( scan , &int_value ));
+    }
+    ecl_fmt_scan_free( scan );
+    fclose( stream );
+  }
+  test_work_area_free( work_area );
+}
+
+
+void test_formatted_kw() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_fmt_scan_kw" );
+  const int size = 2503;
+  ecl_kw_type * int_kw    = ecl_kw_alloc( "INT" , size , ECL_INT );
+  ecl_kw_type * float_kw  = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , size , ECL_DOUBLE );
+  ecl_kw_type * bool_kw   = ecl_kw_alloc( "BOOL" , size , ECL_BOOL );
+  ecl_kw_type * char_kw   = ecl_kw_alloc( "CHAR" , 3 , ECL_CHAR );
+  int i;
+
+  for (i=0; i < size; i++) {
+    ecl_kw_iset_int( int_kw , i , i * 1001 - 50000 );
+    ecl_kw_iset_float( float_kw , i , 0.5 * i - 100 );
+    ecl_kw_iset_double( double_kw , i , 0.25 * i - 100 );
+    ecl_kw_iset_bool( bool_kw , i , (i % 3) == 0 );
+  }
+  ecl_kw_iset_string8( char_kw , 0 , "A" );
+  ecl_kw_iset_string8( char_kw , 1 , "BB" );
+  ecl_kw_iset_string8( char_kw , 2 , "CCC" );
+
+  {
+    fortio_type * fortio = fortio_open_writer( "FMT" , true , ECL_ENDIAN_FLIP );
+    ecl_kw_fwrite( int_kw , fortio );
+    ecl_kw_fwrite( float_kw , fortio );
+    ecl_kw_fwrite( char_kw , fortio );
+    ecl_kw_fwrite( double_kw , fortio );
+    ecl_kw_fwrite( bool_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  {
+    fortio_type * fortio = fortio_open_reader( "FMT" , true , ECL_ENDIAN_FLIP );
+    ecl_kw_type * kw;
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , int_kw ));
+    ecl_kw_free( kw );
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , float_kw ));
+    ecl_kw_free( kw );
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , char_kw ));
+    ecl_kw_free( kw );
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , double_kw ));
+    ecl_kw_free( kw );
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , bool_kw ));
+    ecl_kw_free( kw );
+
+    test_assert_NULL( ecl_kw_fread_alloc( fortio ));
+    fortio_fclose( fortio );
+  }
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+  ecl_kw_free( bool_kw );
+  ecl_kw_free( char_kw );
+  test_work_area_free( work_area );
+}
+
+
+void test_grdecl() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_fmt_scan_grdecl" );
+  {
+    FILE * stream = util_fopen( "FILE.grdecl" , "w");
+    fprintf(stream , "PORO\n  3*0.25 0.5 -- 1 2 3\n 1E-1  2*0.75D+00 /\n");
+    fprintf(stream , "SPECGRID\n 10 12 5 1 F /\n");
+    fclose( stream );
+  }
+  {
+    FILE * stream = util_fopen( "FILE.grdecl" , "r");
+    ecl_kw_type * poro = ecl_kw_fscanf_alloc_grdecl_dynamic( stream , "PORO" , ECL_FLOAT );
+    ecl_kw_type * specgrid = ecl_kw_fscanf_alloc_grdecl_dynamic__( stream , "SPECGRID" , false , ECL_INT );
+
+    test_assert_int_equal( ecl_kw_get_size( poro ) , 7 );
+    test_assert_float_equal( ecl_kw_iget_float( poro , 0 ) , 0.25 );
+    test_assert_float_equal( ecl_kw_iget_float( poro , 2 ) , 0.25 );
+    test_assert_float_equal( ecl_kw_iget_float( poro , 3 ) , 0.50 );
+    test_assert_float_equal( ecl_kw_iget_float( poro , 4 ) , 0.10 );
+    test_assert_float_equal( ecl_kw_iget_float( poro , 6 ) , 0.75 );
+
+    test_assert_int_equal( ecl_kw_get_size( specgrid ) , 4 );
+    test_assert_int_equal( ecl_kw_iget_int( specgrid , 0 ) , 10 );
+    test_assert_int_equal( ecl_kw_iget_int( specgrid , 3 ) , 1 );
+
+    ecl_kw_free( poro );
+    ecl_kw_free( specgrid );
+    fclose( stream );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_parse_int();
+  test_parse_float();
+  test_parse_double();
+  test_scan_tokens();
+  test_scan_numbers();
+  test_formatted_kw();
+  test_grdecl();
+  exit(0);
+}
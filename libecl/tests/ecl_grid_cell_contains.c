@@ -22,6 +22,11 @@
 #include <math.h>
 
 #include <ert/util/test_util.h>
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#include <ert/util/thread_pool.h>
+#endif
 #include <ert/ecl/ecl_grid.h>
 
 
@@ -244,6 +249,171 @@ void test_corners() {
 
 
 
+/*
+  Compares the threaded list lookup with a brute force scan over all
+  cells for random points, some of them outside the grid.
+*/
+
+void test_find_list( ecl_grid_type * grid ) {
+  const int num_points = 500;
+  double * x = util_calloc( num_points , sizeof * x );
+  double * y = util_calloc( num_points , sizeof * y );
+  double * z = util_calloc( num_points , sizeof * z );
+  int * global_index = util_calloc( num_points , sizeof * global_index );
+  double xmin , xmax , ymin , ymax , zmin , zmax;
+  int i;
+
+  ecl_grid_get_cell_corner_xyz1( grid , 0 , 0 , &xmin , &ymin , &zmin );
+  xmax = xmin; ymax = ymin; zmax = zmin;
+  for (i = 0; i < ecl_grid_get_global_size( grid ); i++) {
+    for (int c = 0; c < 8; c++) {
+      double cx,cy,cz;
+      ecl_grid_get_cell_corner_xyz1( grid , i , c , &cx , &cy , &cz );
+      xmin = util_double_min( xmin , cx ); xmax = util_double_max( xmax , cx );
+      ymin = util_double_min( ymin , cy ); ymax = util_double_max( ymax , cy );
+      zmin = util_double_min( zmin , cz ); zmax = util_double_max( zmax , cz );
+    }
+  }
+
+  for (i = 0; i < num_points; i++) {
+    x[i] = xmin + (xmax - xmin) * (1.2 * rand() / RAND_MAX - 0.1);
+    y[i] = ymin + (ymax - ymin) * (1.2 * rand() / RAND_MAX - 0.1);
+    z[i] = zmin + (zmax - zmin) * (1.2 * rand() / RAND_MAX - 0.1);
+  }
+
+  ecl_grid_get_global_index_list_from_xyz( grid , num_points , x , y , z , global_index );
+#ifdef ERT_HAVE_THREAD_POOL
+  {
+    int * mt_global_index = util_calloc( num_points , sizeof * mt_global_index );
+    thread_pool_type * thread_pool = thread_pool_alloc( 4 , false );
+
+    /* The same thread_pool is used for two lookups. */
+    for (int it = 0; it < 2; it++) {
+      ecl_grid_get_global_index_list_from_xyz_mt( grid , num_points , x , y , z , mt_global_index , thread_pool );
+      for (i = 0; i < num_points; i++)
+        test_assert_int_equal( mt_global_index[i] , global_index[i] );
+    }
+
+    thread_pool_free( thread_pool );
+    free( mt_global_index );
+  }
+#endif
+
+  for (i = 0; i < num_points; i++) {
+    int expected = -1;
+    for (int g = 0; g < ecl_grid_get_global_size( grid ); g++) {
+      if (ecl_grid_cell_contains_xyz1( grid , g , x[i] , y[i] , z[i] )) {
+        expected = g;
+        break;
+      }
+    }
+    test_assert_int_equal( global_index[i] , expected );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x[i] , y[i] , z[i] , -1 ) , expected );
+  }
+
+  free( x );
+  free( y );
+  free( z );
+  free( global_index );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+/*
+  Several threads do their first lookup at the same time on a grid
+  where the xyz index has not been built yet; they must all find the
+  cell.
+*/
+
+static void * find_center( void * arg ) {
+  ecl_grid_type * grid = arg;
+  int global_index = ecl_grid_get_global_size( grid ) / 2;
+  double x , y , z;
+
+  ecl_grid_get_xyz1( grid , global_index , &x , &y , &z );
+  return (void *) (long) ecl_grid_get_global_index_from_xyz( grid , x , y , z , 0 );
+}
+
+
+void test_concurrent_build( ) {
+  const int num_threads = 8;
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 20 , 20 , 20 , 1 , 1 , 1 , NULL );
+  pthread_t threads[8];
+  int it;
+
+  for (it = 0; it < num_threads; it++)
+    pthread_create( &threads[it] , NULL , find_center , grid );
+
+  for (it = 0; it < num_threads; it++) {
+    void * result;
+    pthread_join( threads[it] , &result );
+    test_assert_int_equal( (int) (long) result , ecl_grid_get_global_size( grid ) / 2 );
+  }
+  ecl_grid_free( grid );
+}
+
+
+/*
+  The cell centers and volumes are cached in the grid when they are
+  first requested; threads asking for them at the same time on a new
+  grid must get the same values as a serial run on another grid.
+*/
+
+typedef struct {
+  const ecl_grid_type * grid;
+  const ecl_grid_type * ref_grid;
+  int                   error_count;
+} geometry_arg_type;
+
+
+static void * check_geometry( void * arg ) {
+  geometry_arg_type * geometry_arg = arg;
+  int global_index;
+
+  for (global_index = 0; global_index < ecl_grid_get_global_size( geometry_arg->grid ); global_index++) {
+    if (ecl_grid_get_cell_volume1( geometry_arg->grid , global_index ) != ecl_grid_get_cell_volume1( geometry_arg->ref_grid , global_index ))
+      geometry_arg->error_count++;
+
+    if (ecl_grid_get_cdepth1( geometry_arg->grid , global_index ) != ecl_grid_get_cdepth1( geometry_arg->ref_grid , global_index ))
+      geometry_arg->error_count++;
+  }
+  return NULL;
+}
+
+
+void test_concurrent_geometry( ) {
+  const int num_threads = 8;
+  ecl_grid_type * ref_grid = ecl_grid_alloc_rectangular( 20 , 20 , 20 , 1 , 2 , 3 , NULL );
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 20 , 20 , 20 , 1 , 2 , 3 , NULL );
+  pthread_t threads[8];
+  geometry_arg_type geometry_args[8];
+  int it;
+
+  for (it = 0; it < ecl_grid_get_global_size( ref_grid ); it++) {
+    ecl_grid_get_cell_volume1( ref_grid , it );
+    ecl_grid_get_cdepth1( ref_grid , it );
+  }
+
+  for (it = 0; it < num_threads; it++) {
+    geometry_args[it].grid = grid;
+    geometry_args[it].ref_grid = ref_grid;
+    geometry_args[it].error_count = 0;
+    pthread_create( &threads[it] , NULL , check_geometry , &geometry_args[it] );
+  }
+
+  for (it = 0; it < num_threads; it++) {
+    pthread_join( threads[it] , NULL );
+    test_assert_int_equal( geometry_args[it].error_count , 0 );
+  }
+
+  ecl_grid_free( grid );
+  ecl_grid_free( ref_grid );
+}
+
+#endif
+
+
 int main(int argc , char ** argv) {
   ecl_grid_type * grid;
 
@@ -259,7 +429,12 @@ int main(int argc , char ** argv) {
 
 
   test_find(grid);
+  test_find_list(grid);
   test_corners();
+#ifdef ERT_HAVE_THREAD_POOL
+  test_concurrent_build( );
+  test_concurrent_geometry( );
+#endif
   ecl_grid_free( grid );
   exit(0);
 }
@@ -38,6 +38,12 @@ void test_truncated(const char * filename , offset_type truncate_size) {
     test_assert_NULL( kw2 );
     fortio_fclose(fortio);
   }
+  {
+    fortio_type * fortio = fortio_open_reader_mmap( filename , false , true );
+    ecl_kw_type * kw2 = ecl_kw_fread_alloc( fortio );
+    test_assert_NULL( kw2 );
+    fortio_fclose(fortio);
+  }
 }
 
 
@@ -61,6 +67,16 @@ void test_fread_alloc() {
       ecl_kw_free( kw2 );
       fortio_fclose( fortio );
     }
+    {
+      fortio_type * fortio = fortio_open_reader_mmap("INT" , false , true );
+      ecl_kw_type * kw2 = ecl_kw_fread_alloc( fortio );
+      test_assert_true( fortio_is_mmapped( fortio ));
+      test_assert_true( ecl_kw_equal( kw1 , kw2 ));
+      test_assert_true( fortio_read_at_eof( fortio ));
+      test_assert_NULL( ecl_kw_fread_alloc( fortio ));
+      ecl_kw_free( kw2 );
+      fortio_fclose( fortio );
+    }
 
     {
       offset_type file_size = util_file_size("INT");
@@ -75,9 +91,57 @@ void test_fread_alloc() {
 }
 
 
+void test_fread_as_double(ecl_data_type data_type , bool fmt_file) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fread_as_double" );
+  {
+    const int size = 2503;
+    ecl_kw_type * kw1 = ecl_kw_alloc( "KW" , size , data_type );
+    double * double_data = util_calloc( size , sizeof * double_data );
+    double * expected = util_calloc( size , sizeof * expected );
+    int i;
+
+    for (i=0; i < size; i++) {
+      if (ecl_type_is_int( data_type ))
+        ecl_kw_iset_int( kw1 , i , i - 100 );
+      else if (ecl_type_is_float( data_type ))
+        ecl_kw_iset_float( kw1 , i , 0.25 * i );
+      else
+        ecl_kw_iset_double( kw1 , i , 0.125 * i );
+    }
+    ecl_kw_get_data_as_double( kw1 , expected );
+    {
+      fortio_type * fortio = fortio_open_writer("KW" , fmt_file , true );
+      ecl_kw_fwrite( kw1 , fortio );
+      fortio_fclose( fortio );
+    }
+    {
+      fortio_type * fortio = fortio_open_reader("KW" , fmt_file , true );
+      ecl_kw_type * kw2 = ecl_kw_alloc_empty( );
+      test_assert_int_equal( ecl_kw_fread_header( kw2 , fortio ) , ECL_KW_READ_OK );
+      test_assert_true( ecl_kw_fread_data_as_double( kw2 , fortio , double_data ));
+      for (i=0; i < size; i++)
+        test_assert_double_equal( double_data[i] , expected[i] );
+      ecl_kw_free( kw2 );
+      fortio_fclose( fortio );
+    }
+
+    ecl_kw_fread_double_param( "KW" , fmt_file , double_data );
+    for (i=0; i < size; i++)
+      test_assert_double_equal( double_data[i] , expected[i] );
+
+    free( double_data );
+    free( expected );
+    ecl_kw_free( kw1 );
+  }
+  test_work_area_free( work_area );
+}
+
+
 int main(int argc , char ** argv) {
   test_fread_alloc();
+  test_fread_as_double( ECL_INT , false );
+  test_fread_as_double( ECL_FLOAT , false );
+  test_fread_as_double( ECL_DOUBLE , false );
+  test_fread_as_double( ECL_FLOAT , true );
   exit(0);
 }
-
-
@@ -20,17 +20,29 @@
 
 #include <ert/util/test_util.h>
 #include <ert/util/time_t_vector.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
 #include <ert/util/util.h>
 #include <ert/util/test_work_area.h>
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_vector.h>
 #include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_util.h>
 
 
-void write_summary( const char * name , time_t start_time , int nx , int ny , int nz , int num_dates, int num_ministep, double ministep_length) {
-  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , start_time , true , nx , ny , nz );
+void write_summary( const char * name , bool unified , time_t start_time , int nx , int ny , int nz , int num_dates, int num_ministep, double ministep_length) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , unified , ":" , start_time , true , nx , ny , nz );
   double sim_seconds = 0;
 
+  ecl_sum_set_column_cache( ecl_sum , true );
+  test_assert_false( ecl_sum_has_column_cache( ecl_sum ));
+
   smspec_node_type * node1 = ecl_sum_add_var( ecl_sum , "FOPT" , NULL   , 0   , "Barrels" , 99.0 );
   smspec_node_type * node2 = ecl_sum_add_var( ecl_sum , "BPR"  , NULL   , 567 , "BARS"    , 0.0  );
   smspec_node_type * node3 = ecl_sum_add_var( ecl_sum , "WWCT" , "OP-1" , 0   , "(1)"     , 0.0  );
@@ -48,6 +60,7 @@ void write_summary( const char * name , time_t start_time , int nx , int ny , in
         test_assert_double_equal( ecl_sum_tstep_get_from_node( tstep , node1 ), sim_seconds );
         test_assert_double_equal( ecl_sum_tstep_get_from_node( tstep , node2 ), sim_seconds*10 );
         test_assert_double_equal( ecl_sum_tstep_get_from_node( tstep , node3 ), sim_seconds*100 );
+        test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , ecl_sum_get_data_length( ecl_sum ) - 1 , "BPR:567" ), sim_seconds*10 );
       }
       sim_seconds += ministep_length;
     }
@@ -57,7 +70,7 @@ void write_summary( const char * name , time_t start_time , int nx , int ny , in
 }
 
 
-void test_write_read( ) {
+void test_write_read( bool unified ) {
   const char * name = "CASE";
   time_t start_time = util_make_date_utc( 1,1,2010 );
   time_t end_time = start_time;
@@ -71,8 +84,10 @@ void test_write_read( ) {
     test_work_area_type * work_area = test_work_area_alloc("sum/write");
     ecl_sum_type * ecl_sum;
 
-    write_summary( name , start_time , nx , ny , nz , num_dates , num_ministep , ministep_length);
+    write_summary( name , unified , start_time , nx , ny , nz , num_dates , num_ministep , ministep_length);
     ecl_sum = ecl_sum_fread_alloc_case( name , ":" );
+    test_assert_false( ecl_sum_has_column_cache( ecl_sum ));
+    ecl_sum_set_column_cache( ecl_sum , true );
     test_assert_true( ecl_sum_is_instance( ecl_sum ));
 
     /* Time direction */
@@ -85,6 +100,74 @@ void test_write_read( ) {
     test_assert_true( ecl_sum_has_key( ecl_sum , "FOPT" ));
     test_assert_true( ecl_sum_has_key( ecl_sum , "WWCT:OP-1" ));
     test_assert_true( ecl_sum_has_key( ecl_sum , "BPR:567" ));
+    /* Values */
+    {
+      int fopt_index = ecl_sum_get_general_var_params_index( ecl_sum , "FOPT" );
+      int wwct_index = ecl_sum_get_general_var_params_index( ecl_sum , "WWCT:OP-1" );
+      double_vector_type * fopt = ecl_sum_alloc_data_vector( ecl_sum , fopt_index , false );
+      int time_index;
+
+      test_assert_int_equal( double_vector_size( fopt ) , ecl_sum_get_data_length( ecl_sum ) + 1);
+      for (time_index = 0; time_index < ecl_sum_get_data_length( ecl_sum ); time_index++) {
+        double sim_seconds = time_index * ministep_length;
+        test_assert_double_equal( double_vector_iget( fopt , time_index + 1 ) , sim_seconds );
+        test_assert_double_equal( ecl_sum_iget( ecl_sum , time_index , fopt_index ) , sim_seconds );
+        test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , time_index , "WWCT:OP-1" ) , 100 * sim_seconds );
+      }
+
+      ecl_sum_scale_vector( ecl_sum , wwct_index , 0.5 );
+      for (time_index = 0; time_index < ecl_sum_get_data_length( ecl_sum ); time_index++)
+        test_assert_double_equal( ecl_sum_iget( ecl_sum , time_index , wwct_index ) , 50 * time_index * ministep_length );
+
+      double_vector_free( fopt );
+    }
+
+    /* The same values without the column cache. */
+    {
+      int fopt_index = ecl_sum_get_general_var_params_index( ecl_sum , "FOPT" );
+      int time_index;
+
+      test_assert_true( ecl_sum_has_column_cache( ecl_sum ));
+      ecl_sum_set_column_cache( ecl_sum , false );
+      test_assert_false( ecl_sum_has_column_cache( ecl_sum ));
+      for (time_index = 0; time_index < ecl_sum_get_data_length( ecl_sum ); time_index++)
+        test_assert_double_equal( ecl_sum_iget( ecl_sum , time_index , fopt_index ) , time_index * ministep_length );
+
+      ecl_sum_set_column_cache( ecl_sum , true );
+      test_assert_true( ecl_sum_has_column_cache( ecl_sum ));
+    }
+
+    /* Block of values; the WWCT vector has been scaled above. */
+    {
+      ecl_sum_vector_type * keys = ecl_sum_vector_alloc( ecl_sum );
+      int_vector_type * time_index_list = int_vector_alloc( 0 , 0 );
+      double * block;
+      int i;
+
+      test_assert_true( ecl_sum_vector_add_key( keys , "WWCT:OP-1" ));
+      test_assert_true( ecl_sum_vector_add_key( keys , "FOPT" ));
+      test_assert_true( ecl_sum_vector_add_key( keys , "BPR:567" ));
+      test_assert_false( ecl_sum_vector_add_key( keys , "NO:SUCH_KEY" ));
+      for (int report_step = 1; report_step <= num_dates; report_step++)
+        int_vector_append( time_index_list , ecl_sum_iget_report_end( ecl_sum , report_step ));
+      int_vector_append( time_index_list , 0 );
+
+      block = util_calloc( 3 * int_vector_size( time_index_list ) , sizeof * block );
+      ecl_sum_vector_init_double_block( keys , time_index_list , block );
+      for (i = 0; i < int_vector_size( time_index_list ); i++) {
+        int time_index = int_vector_iget( time_index_list , i );
+        double sim_seconds = time_index * ministep_length;
+
+        test_assert_double_equal( block[3*i]     , 50 * sim_seconds );
+        test_assert_double_equal( block[3*i + 1] , sim_seconds );
+        test_assert_double_equal( block[3*i + 2] , 10 * sim_seconds );
+      }
+
+      free( block );
+      int_vector_free( time_index_list );
+      ecl_sum_vector_free( keys );
+    }
+
     {
       ecl_grid_type *grid = ecl_grid_alloc_rectangular(nx,ny,nz,1,1,1,NULL);
       int i,j,k;
@@ -103,7 +186,117 @@ void test_write_read( ) {
 
 
 
+#ifdef ERT_HAVE_THREAD_POOL
+
+/*
+  Several threads read from a newly loaded case at the same time, the
+  first reads build the column cache.
+*/
+
+typedef struct {
+  const ecl_sum_type * ecl_sum;
+  double               ministep_length;
+  int                  error_count;
+} read_arg_type;
+
+
+static void * read_values( void * arg ) {
+  read_arg_type * read_arg = arg;
+  const ecl_sum_type * ecl_sum = read_arg->ecl_sum;
+  int fopt_index = ecl_sum_get_general_var_params_index( ecl_sum , "FOPT" );
+  int bpr_index = ecl_sum_get_general_var_params_index( ecl_sum , "BPR:567" );
+  int time_index;
+
+  for (time_index = 0; time_index < ecl_sum_get_data_length( ecl_sum ); time_index++) {
+    double sim_seconds = time_index * read_arg->ministep_length;
+    if (ecl_sum_iget( ecl_sum , time_index , fopt_index ) != (float) sim_seconds)
+      read_arg->error_count++;
+
+    if (ecl_sum_iget( ecl_sum , time_index , bpr_index ) != (float) (10 * sim_seconds))
+      read_arg->error_count++;
+  }
+  return NULL;
+}
+
+
+void test_concurrent_read( ) {
+  const int num_threads = 8;
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  double ministep_length = 36000;
+  test_work_area_type * work_area = test_work_area_alloc("sum/concurrent");
+  pthread_t threads[8];
+  read_arg_type read_args[8];
+  ecl_sum_type * ecl_sum;
+  int it;
+
+  write_summary( "CASE" , true , start_time , 10 , 11 , 12 , 50 , 10 , ministep_length );
+  ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+  ecl_sum_set_column_cache( ecl_sum , true );
+  for (it = 0; it < num_threads; it++) {
+    read_args[it].ecl_sum = ecl_sum;
+    read_args[it].ministep_length = ministep_length;
+    read_args[it].error_count = 0;
+    pthread_create( &threads[it] , NULL , read_values , &read_args[it] );
+  }
+
+  for (it = 0; it < num_threads; it++) {
+    pthread_join( threads[it] , NULL );
+    test_assert_int_equal( read_args[it].error_count , 0 );
+  }
+
+  ecl_sum_free( ecl_sum );
+  test_work_area_free( work_area );
+}
+
+
+/*
+  A non unified case loaded with the files distributed over the
+  threads of a pool gives the same data as a serial load; the pool is
+  reused for a second load.
+*/
+
+void test_load_mt( ) {
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  test_work_area_type * work_area = test_work_area_alloc("sum/load_mt");
+  thread_pool_type * thread_pool = thread_pool_alloc( 4 , false );
+  stringlist_type * data_files = stringlist_alloc_new( );
+  char * header_file;
+  ecl_sum_type * ecl_sum;
+
+  write_summary( "CASE" , false , start_time , 10 , 11 , 12 , 20 , 10 , 36000 );
+  test_assert_true( ecl_util_alloc_summary_files( NULL , "CASE" , NULL , &header_file , data_files ));
+  test_assert_int_equal( stringlist_get_size( data_files ) , 20 );
+  ecl_sum = ecl_sum_fread_alloc( header_file , data_files , ":" );
+
+  for (int it = 0; it < 2; it++) {
+    ecl_sum_type * ecl_sum_mt = ecl_sum_fread_alloc_mt( header_file , data_files , ":" , thread_pool );
+    int params_size = ecl_smspec_get_params_size( ecl_sum_get_smspec( ecl_sum ));
+
+    test_assert_int_equal( ecl_sum_get_data_length( ecl_sum_mt ) , ecl_sum_get_data_length( ecl_sum ));
+    for (int time_index = 0; time_index < ecl_sum_get_data_length( ecl_sum ); time_index++) {
+      test_assert_time_t_equal( ecl_sum_iget_sim_time( ecl_sum_mt , time_index ) , ecl_sum_iget_sim_time( ecl_sum , time_index ));
+      for (int params_index = 0; params_index < params_size; params_index++)
+        test_assert_double_equal( ecl_sum_iget( ecl_sum_mt , time_index , params_index ) , ecl_sum_iget( ecl_sum , time_index , params_index ));
+    }
+    ecl_sum_free( ecl_sum_mt );
+  }
+
+  ecl_sum_free( ecl_sum );
+  free( header_file );
+  stringlist_free( data_files );
+  thread_pool_free( thread_pool );
+  test_work_area_free( work_area );
+}
+
+#endif
+
+
 int main( int argc , char ** argv) {
-  test_write_read();
+  test_write_read( true );
+  test_write_read( false );
+#ifdef ERT_HAVE_THREAD_POOL
+  test_concurrent_read( );
+  test_load_mt( );
+#endif
   exit(0);
 }
@@ -105,6 +105,10 @@ void                   analysis_config_set_stop_long_running( analysis_config_ty
 bool                   analysis_config_get_stop_long_running( const analysis_config_type * config);
 void                   analysis_config_set_max_runtime( analysis_config_type * config, int max_runtime  );
 int                    analysis_config_get_max_runtime( const analysis_config_type * config );
+void                   analysis_config_set_update_threads( analysis_config_type * config, int update_threads );
+int                    analysis_config_get_update_threads( const analysis_config_type * config );
+void                   analysis_config_set_update_block_size( analysis_config_type * config, int update_block_size );
+int                    analysis_config_get_update_block_size( const analysis_config_type * config );
 const char           * analysis_config_get_active_module_name( const analysis_config_type * config );
 bool                   analysis_config_get_std_scale_correlated_obs( const analysis_config_type * config);
 void                   analysis_config_set_std_scale_correlated_obs( analysis_config_type * config, bool std_scale_correlated_obs);
@@ -25,6 +25,8 @@ extern "C" {
 #include <stdio.h>
 #include <stdbool.h>
 
+#include <ert/util/buffer.h>
+
 #include <ert/enkf/fs_types.h>  
 
   typedef struct block_fs_driver_struct block_fs_driver_type;
@@ -42,6 +44,12 @@ extern "C" {
                                                     const char * filename );
   void                   block_fs_driver_fskip(FILE * fstab_stream);
 
+  int                    block_fs_driver_get_node_id( block_fs_driver_type * driver , const char * config_key );
+  void                   block_fs_driver_load_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens , buffer_type * buffer);
+  void                   block_fs_driver_save_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens , buffer_type * buffer);
+  void                   block_fs_driver_unlink_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens );
+  bool                   block_fs_driver_has_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens );
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@ extern "C" {
 
 /* These keys are used as options in KEY:VALUE statements */
 #define  BASE_SURFACE_KEY                  "BASE_SURFACE"
+#define  CODEC_KEY                         "CODEC"
 #define  DEFINE_KEY                        "DEFINE"
 #define  DYNAMIC_KEY                       "DYNAMIC"
 #define  ECL_FILE_KEY                      "ECL_FILE"
@@ -110,6 +111,7 @@ extern "C" {
 #define  MAX_RUNNING_LSF_KEY               "MAX_RUNNING_LSF"
 #define  MAX_RUNNING_RSH_KEY               "MAX_RUNNING_RSH"
 #define  MAX_SUBMIT_KEY                    "MAX_SUBMIT"
+#define  MAX_SUBMIT_RATE_KEY               "MAX_SUBMIT_RATE"
 #define  NUM_REALIZATIONS_KEY              "NUM_REALIZATIONS"
 #define  MIN_REALIZATIONS_KEY              "MIN_REALIZATIONS"
 #define  OBS_CONFIG_KEY                    "OBS_CONFIG"
@@ -137,10 +139,13 @@ extern "C" {
 #define  SETENV_KEY                        "SETENV"
 #define  STATIC_KW_KEY                     "ADD_STATIC_KW"
 #define  STD_CUTOFF_KEY                    "STD_CUTOFF"
+#define  SUBMIT_THREADS_KEY                "SUBMIT_THREADS"
 #define  SUMMARY_KEY                       "SUMMARY"
 #define  SURFACE_KEY                       "SURFACE"
 #define  UPDATE_LOG_PATH_KEY               "UPDATE_LOG_PATH"
 #define  UPDATE_PATH_KEY                   "UPDATE_PATH"
+#define  UPDATE_THREADS_KEY                "UPDATE_THREADS"
+#define  UPDATE_BLOCK_SIZE_KEY             "UPDATE_BLOCK_SIZE"
 #define  SINGLE_NODE_UPDATE_KEY            "SINGLE_NODE_UPDATE"
 #define  STORE_SEED_KEY                    "STORE_SEED"
 #define  UMASK_KEY                         "UMASK"
@@ -128,6 +128,8 @@
 #define DEFAULT_ANALYSIS_MIN_REALISATIONS  0   // 0: No lower limit
 #define DEFAULT_ANALYSIS_STOP_LONG_RUNNING false 
 #define DEFAULT_MAX_RUNTIME                0
+#define DEFAULT_UPDATE_THREADS             0       /* 0: Use the number of online CPUs. */
+#define DEFAULT_UPDATE_BLOCK_SIZE          0       /* 0: Update each dataset in one block. */
 #define DEFAULT_ITER_RETRY_COUNT           4
 
 
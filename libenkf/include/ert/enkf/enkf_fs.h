@@ -76,6 +76,10 @@ extern "C" {
                                          int iens); 
   
 
+  void              enkf_fs_copy_node(enkf_fs_type * src_fs , enkf_fs_type * target_fs , buffer_type * buffer ,
+                                      const char * node_key , enkf_var_type var_type ,
+                                      int report_step , int iens);
+
   bool              enkf_fs_has_vector(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int iens);
   bool              enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens);
 
@@ -24,6 +24,7 @@ extern "C" {
 #include <stdio.h>
 #include <stdbool.h>
 
+#include <ert/util/buffer.h>
 #include <ert/util/path_fmt.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/type_macros.h>
@@ -125,6 +126,8 @@ void                    field_config_get_ijk( const field_config_type * config ,
 field_type            * field_config_get_min_std( const field_config_type * field_config );
 const char            * field_config_default_extension(field_file_format_type , bool );
 bool                    field_config_write_compressed(const field_config_type * );
+buffer_codec_type       field_config_get_codec(const field_config_type * config);
+void                    field_config_set_codec(field_config_type * config , buffer_codec_type codec);
 field_file_format_type  field_config_guess_file_type(const char * );
 field_file_format_type  field_config_manual_file_type(const char * , bool);
 ecl_data_type           field_config_get_ecl_data_type(const field_config_type *);
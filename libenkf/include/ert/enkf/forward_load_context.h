@@ -24,6 +24,7 @@ extern "C" {
 #endif
 #include <ert/util/type_macros.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/thread_pool.h>
 
 #include <ert/ecl/ecl_sum.h>
 #include <ert/ecl/ecl_file.h>
@@ -39,6 +40,7 @@ extern "C" {
   void                        forward_load_context_update_result( forward_load_context_type * load_context , int flags);
   int                         forward_load_context_get_result( const forward_load_context_type * load_context );
   forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase, stringlist_type * messages);
+  forward_load_context_type * forward_load_context_alloc_mt( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase, stringlist_type * messages , thread_pool_type * thread_pool);
   void                        forward_load_context_free( forward_load_context_type * load_context );
   const ecl_sum_type        * forward_load_context_get_ecl_sum( const forward_load_context_type * load_context);
   const ecl_file_type       * forward_load_context_get_restart_file( const forward_load_context_type * load_context);
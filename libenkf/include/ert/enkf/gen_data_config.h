@@ -23,6 +23,7 @@ extern "C" {
 #endif
 #include <stdbool.h>
 
+#include <ert/util/buffer.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/util.h>
 #include <ert/util/bool_vector.h>
@@ -70,6 +71,8 @@ typedef enum { GEN_DATA_UNDEFINED = 0,
   gen_data_config_type       * gen_data_config_fscanf_alloc(const char * );
   const char  *                gen_data_config_get_key( const gen_data_config_type * config);
   int                          gen_data_config_get_byte_size( const gen_data_config_type * config , int report_step);
+  buffer_codec_type            gen_data_config_get_codec( const gen_data_config_type * config );
+  void                         gen_data_config_set_codec( gen_data_config_type * config , buffer_codec_type codec );
   int                          gen_data_config_get_data_size( const gen_data_config_type * config , int report_step);
   gen_data_file_format_type    gen_data_config_check_format( const void * format_string );
 
@@ -19,6 +19,7 @@
 #ifndef ERT_SUMMARY_H
 #define ERT_SUMMARY_H
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
 
 #include <ert/ecl/ecl_sum.h>
 #include <ert/ecl/ecl_file.h>
@@ -35,6 +36,7 @@
 double    summary_get(const summary_type * summary, int report_step );
 bool      summary_active_value( double value );
 int       summary_length(const summary_type * summary);
+bool      summary_forward_load_block(summary_type * summary , const int_vector_type * store_index , const double * column , int stride);
 
 VOID_HAS_DATA_HEADER(summary);
 UTIL_SAFE_CAST_HEADER(summary);
@@ -17,6 +17,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <ert/util/util.h>
 #include <ert/util/int_vector.h>
@@ -98,6 +99,32 @@ active_list_type * active_list_alloc_copy( const active_list_type * src) {
 }
 
 
+/**
+   Allocates a PARTLY_ACTIVE list with the active elements number
+   [offset, offset + length) of src; i.e. for an ALL_ACTIVE src the
+   indices offset, offset + 1, ..., offset + length - 1.
+*/
+
+active_list_type * active_list_alloc_sublist( const active_list_type * src , int offset , int length) {
+  active_list_type * sublist = active_list_alloc( );
+  sublist->mode = PARTLY_ACTIVE;
+  int_vector_resize( sublist->index_list , length );
+  {
+    int * index = int_vector_get_ptr( sublist->index_list );
+    if (src->mode == PARTLY_ACTIVE) {
+      const int * src_index = int_vector_get_const_ptr( src->index_list );
+      if (offset + length > int_vector_size( src->index_list ))
+        util_abort("%s: sublist [%d,%d) outside of the %d active elements\n",__func__ , offset , offset + length , int_vector_size( src->index_list ));
+      memcpy( index , &src_index[offset] , length * sizeof * index );
+    } else {
+      for (int i = 0; i < length; i++)
+        index[i] = offset + i;
+    }
+  }
+  return sublist;
+}
+
+
 void active_list_copy( active_list_type * target , const active_list_type * src) {
   target->mode = src->mode;
   int_vector_memcpy( target->index_list , src->index_list);
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <ert/util/util.h>
 #include <ert/util/stringlist.h>
@@ -65,6 +66,8 @@ struct analysis_config_struct {
   bool                            stop_long_running;
   bool                            std_scale_correlated_obs;
   int                             max_runtime;
+  int                             update_threads;              /* Number of worker threads in the update; 0: use all online CPUs. */
+  int                             update_block_size;           /* Max number of rows in the A matrix when streaming the update; 0: no streaming. */
   double                          global_std_scaling;
 };
 
@@ -170,6 +173,37 @@ void analysis_config_set_max_runtime( analysis_config_type * config, int max_run
   config->max_runtime = max_runtime;
 }
 
+void analysis_config_set_update_threads( analysis_config_type * config, int update_threads ) {
+  if (update_threads < 0)
+    update_threads = DEFAULT_UPDATE_THREADS;
+  config->update_threads = update_threads;
+}
+
+/**
+   Returns the number of threads to use for serializing, multiplying
+   and deserializing in the update. When UPDATE_THREADS has not been
+   set this is the number of online CPUs.
+*/
+
+int analysis_config_get_update_threads( const analysis_config_type * config ) {
+  if (config->update_threads > 0)
+    return config->update_threads;
+  else {
+    long num_cpu = sysconf( _SC_NPROCESSORS_ONLN );
+    return (num_cpu > 0) ? num_cpu : 1;
+  }
+}
+
+void analysis_config_set_update_block_size( analysis_config_type * config, int update_block_size ) {
+  if (update_block_size < 0)
+    update_block_size = DEFAULT_UPDATE_BLOCK_SIZE;
+  config->update_block_size = update_block_size;
+}
+
+int analysis_config_get_update_block_size( const analysis_config_type * config ) {
+  return config->update_block_size;
+}
+
 static void analysis_config_set_min_realisations( analysis_config_type * config , int min_realisations) {
   config->min_realisations = min_realisations;
 }
@@ -509,6 +543,12 @@ void analysis_config_init( analysis_config_type * analysis , const config_conten
     analysis_config_set_max_runtime( analysis, config_content_get_value_as_int( config, MAX_RUNTIME_KEY ));
   }
 
+  if (config_content_has_item( config, UPDATE_THREADS_KEY ))
+    analysis_config_set_update_threads( analysis, config_content_get_value_as_int( config, UPDATE_THREADS_KEY ));
+
+  if (config_content_has_item( config, UPDATE_BLOCK_SIZE_KEY ))
+    analysis_config_set_update_block_size( analysis, config_content_get_value_as_int( config, UPDATE_BLOCK_SIZE_KEY ));
+
 
   /* Loading external modules */
   analysis_config_load_all_external_modules_from_config(analysis, config);
@@ -612,6 +652,8 @@ analysis_config_type * analysis_config_alloc( rng_type * rng ) {
   analysis_config_set_min_realisations( config         , DEFAULT_ANALYSIS_MIN_REALISATIONS );
   analysis_config_set_stop_long_running( config        , DEFAULT_ANALYSIS_STOP_LONG_RUNNING );
   analysis_config_set_max_runtime( config              , DEFAULT_MAX_RUNTIME );
+  analysis_config_set_update_threads( config           , DEFAULT_UPDATE_THREADS );
+  analysis_config_set_update_block_size( config        , DEFAULT_UPDATE_BLOCK_SIZE );
 
   config->analysis_module      = NULL;
   config->analysis_modules     = hash_alloc();
@@ -652,6 +694,8 @@ void analysis_config_add_config_items( config_parser_type * config ) {
   config_add_key_value( config , UPDATE_LOG_PATH_KEY         , false , CONFIG_STRING);
   config_add_key_value( config , MIN_REALIZATIONS_KEY        , false , CONFIG_STRING );
   config_add_key_value( config , MAX_RUNTIME_KEY             , false , CONFIG_INT );
+  config_add_key_value( config , UPDATE_THREADS_KEY          , false , CONFIG_INT );
+  config_add_key_value( config , UPDATE_BLOCK_SIZE_KEY       , false , CONFIG_INT );
   config_add_key_value( config , STD_SCALE_CORRELATED_OBS_KEY, false , CONFIG_BOOL );
 
   item = config_add_key_value( config , STOP_LONG_RUNNING_KEY, false,  CONFIG_BOOL );
@@ -707,6 +751,18 @@ void analysis_config_fprintf_config( analysis_config_type * config , FILE * stre
     fprintf( stream , CONFIG_ENDVALUE_FORMAT , config->log_path );
   }
 
+  if (config->update_threads != DEFAULT_UPDATE_THREADS) {
+    fprintf( stream , CONFIG_KEY_FORMAT   , UPDATE_THREADS_KEY);
+    fprintf( stream , CONFIG_INT_FORMAT   , config->update_threads );
+    fprintf( stream , "\n");
+  }
+
+  if (config->update_block_size != DEFAULT_UPDATE_BLOCK_SIZE) {
+    fprintf( stream , CONFIG_KEY_FORMAT   , UPDATE_BLOCK_SIZE_KEY);
+    fprintf( stream , CONFIG_INT_FORMAT   , config->update_block_size );
+    fprintf( stream , "\n");
+  }
+
   fprintf(stream , "\n\n");
 }
 
@@ -19,8 +19,12 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include <ert/util/util.h>
+#include <ert/util/vector.h>
 #include <ert/util/path_fmt.h>
 #include <ert/util/block_fs.h>
 #include <ert/util/buffer.h>
@@ -36,6 +40,141 @@
 typedef struct bfs_struct bfs_type;
 typedef struct bfs_config_struct bfs_config_type;
 
+
+/*
+  The block_fs layer stores the nodes under the string keys
+  "config_key.report_step.iens", and the vectors under the keys
+  "config_key.iens"; this is the on disk format, and must be kept
+  for compatibility with existing filesystems.
+
+  The driver maps every config_key it has seen to an integer node_id,
+  with a bfs_node_key record holding the key prefix "config_key." and
+  the block_fs_key_hash() of that prefix. The records are only freed
+  with the driver, i.e. the memory is bounded by the number of
+  config_keys. A key is built by appending the report_step and iens
+  digits to the prefix in a buffer on the stack, and the hash is
+  continued over the digits only; the block_fs index is then searched
+  with the precomputed hash. The calling scope can look up the node_id
+  once with block_fs_driver_get_node_id(), and use the *_node_id()
+  functions; the string keyed functions in the fs_driver interface go
+  through the same path. Only keys which do not fit in the buffer are
+  allocated on the heap. Call bfs_key_free() when done with the key.
+*/
+
+#define BFS_KEY_BUFFER_SIZE 256
+#define BFS_KEY_SUFFIX_SIZE 32
+
+typedef struct {
+  char     * prefix;          /* "config_key." */
+  int        prefix_length;
+  uint32_t   prefix_hash;
+  uint32_t   config_key_hash; /* block_fs_key_hash( config_key ) */
+  int        node_id;
+} bfs_node_key_type;
+
+
+typedef struct {
+  char       buffer[BFS_KEY_BUFFER_SIZE];
+  char     * key;             /* Points to buffer, or to heap storage for long keys. */
+  uint32_t   hash_value;
+} bfs_key_type;
+
+
+static bfs_node_key_type * bfs_node_key_alloc( const char * config_key , uint32_t config_key_hash , int node_id ) {
+  bfs_node_key_type * node_key = util_malloc( sizeof * node_key );
+  node_key->prefix          = util_alloc_sprintf( "%s." , config_key );
+  node_key->prefix_length   = strlen( node_key->prefix );
+  node_key->config_key_hash = config_key_hash;
+  node_key->prefix_hash     = block_fs_key_hash_append( config_key_hash , "." );
+  node_key->node_id         = node_id;
+  return node_key;
+}
+
+
+static bool bfs_node_key_equal( const bfs_node_key_type * node_key , const char * config_key , uint32_t config_key_hash ) {
+  const int config_key_length = node_key->prefix_length - 1;
+
+  return (node_key->config_key_hash == config_key_hash) &&
+         (strncmp( node_key->prefix , config_key , config_key_length ) == 0) &&
+         (config_key[config_key_length] == '\0');
+}
+
+
+static void bfs_node_key_free__( void * arg ) {
+  bfs_node_key_type * node_key = arg;
+  free( node_key->prefix );
+  free( node_key );
+}
+
+
+/*
+  Writes the decimal digits of value to the end of the suffix buffer,
+  and returns a pointer to the first character.
+*/
+
+static char * bfs_key_format_int( char * end , int value ) {
+  unsigned int abs_value = (value < 0) ? -((unsigned int) value) : (unsigned int) value;
+  char * c = end;
+
+  do {
+    c--;
+    *c = '0' + (abs_value % 10);
+    abs_value /= 10;
+  } while (abs_value > 0);
+
+  if (value < 0) {
+    c--;
+    *c = '-';
+  }
+  return c;
+}
+
+
+static void bfs_key_init( bfs_key_type * bfs_key , const bfs_node_key_type * node_key , const char * suffix ) {
+  int suffix_length = strlen( suffix );
+  int length        = node_key->prefix_length + suffix_length;
+
+  if (length < BFS_KEY_BUFFER_SIZE)
+    bfs_key->key = bfs_key->buffer;
+  else
+    bfs_key->key = util_malloc( length + 1 );
+
+  memcpy( bfs_key->key , node_key->prefix , node_key->prefix_length );
+  memcpy( &bfs_key->key[ node_key->prefix_length ] , suffix , suffix_length + 1 );
+  bfs_key->hash_value = block_fs_key_hash_append( node_key->prefix_hash , suffix );
+}
+
+
+static void bfs_key_init_node( bfs_key_type * bfs_key , const bfs_node_key_type * node_key , int report_step , int iens) {
+  char suffix[BFS_KEY_SUFFIX_SIZE];
+  char * end = &suffix[BFS_KEY_SUFFIX_SIZE - 1];
+  char * c;
+
+  *end = '\0';
+  c = bfs_key_format_int( end , iens );
+  c--;
+  *c = '.';
+  c = bfs_key_format_int( c , report_step );
+  bfs_key_init( bfs_key , node_key , c );
+}
+
+
+static void bfs_key_init_vector( bfs_key_type * bfs_key , const bfs_node_key_type * node_key , int iens) {
+  char suffix[BFS_KEY_SUFFIX_SIZE];
+  char * end = &suffix[BFS_KEY_SUFFIX_SIZE - 1];
+
+  *end = '\0';
+  bfs_key_init( bfs_key , node_key , bfs_key_format_int( end , iens ));
+}
+
+
+static void bfs_key_free( bfs_key_type * bfs_key ) {
+  if (bfs_key->key != bfs_key->buffer)
+    free( bfs_key->key );
+}
+
+
+
 struct bfs_config_struct {
   int             fsync_interval;
   double          fragmentation_limit;
@@ -44,6 +183,7 @@ struct bfs_config_struct {
   int             block_size;
   int             max_cache_size;
   bool            bfs_lock;
+  size_t          write_behind_size;
 };
 
 
@@ -69,6 +209,11 @@ struct block_fs_driver_struct {
   
   // New variables
   bfs_type        ** fs_list;
+
+  pthread_rwlock_t     node_key_lock;
+  vector_type        * node_keys;       /* bfs_node_key_type instances indexed by node_id. */
+  bfs_node_key_type ** node_key_slots;  /* Open addressing table on config_key_hash - NULL for empty slots. */
+  int                  node_key_capacity;
 }; 
 
 /*****************************************************************/
@@ -83,8 +228,9 @@ bfs_config_type * bfs_config_alloc( fs_driver_enum driver_type , bool read_only,
   const bool DEFAULT_preload       = false;
 
   const int max_cache_size         = 512; 
-  const int fsync_interval         =  10;     /* An fsync() call is issued for every 10'th write. */
+  const int fsync_interval         =  10;     /* An fsync() call is issued for every 10'th write - not used in write-behind mode. */
   const double fragmentation_limit = 1.0;     /* 1.0 => NO defrag is run. */
+  const size_t write_behind_size   = 4 * 1024 * 1024;  /* Writes are committed to disk in batches of 4 MB, and on fsync. */
 
   {
     bfs_config_type * config = util_malloc( sizeof * config );
@@ -93,6 +239,7 @@ bfs_config_type * bfs_config_alloc( fs_driver_enum driver_type , bool read_only,
     config->fragmentation_limit = fragmentation_limit;
     config->read_only           = read_only;
     config->bfs_lock            = bfs_lock;
+    config->write_behind_size   = write_behind_size;
     
     switch (driver_type) {
     case( DRIVER_PARAMETER ):
@@ -164,6 +311,9 @@ static void bfs_mount( bfs_type * bfs) {
                                   config->preload , 
                                   config->read_only,
                                   config->bfs_lock);
+
+  if (!block_fs_is_readonly( bfs->block_fs ))
+    block_fs_set_write_behind( bfs->block_fs , config->write_behind_size );
 }
 
 
@@ -199,17 +349,6 @@ static block_fs_driver_type * block_fs_driver_safe_cast( void * __driver) {
   return driver;
 }
 
-static char * block_fs_driver_alloc_node_key( const block_fs_driver_type * driver , const char * node_key , int report_step , int iens) {
-  char * key = util_alloc_sprintf("%s.%d.%d" , node_key , report_step , iens);
-  return key;
-}
-
-
-static char * block_fs_driver_alloc_vector_key( const block_fs_driver_type * driver , const char * node_key , int iens) {
-  char * key = util_alloc_sprintf("%s.%d" , node_key , iens);
-  return key;
-}
-
 /**
    This function will take an input string, and try to to parse it as
    string.int.int, where string is the normal enkf key, and the two
@@ -222,20 +361,45 @@ static char * block_fs_driver_alloc_vector_key( const block_fs_driver_type * dri
    will not be touched.
 */
 
+static bool block_fs_sscanf_key_int( const char * begin , const char * end , int * value) {
+  if (begin == end)
+    return false;
+  {
+    char * error_ptr;
+    long int tmp = strtol( begin , &error_ptr , 10 );
+    if (error_ptr != end)
+      return false;
+
+    *value = tmp;
+    return true;
+  }
+}
+
+
 bool block_fs_sscanf_key(const char * key , char ** config_key , int * __report_step , int * __iens) {
-  char ** tmp;
-  int num_items;
+  /* The key can contain additional '.' - so the two integers are located from the end of the key. */
+  const char * iens_sep = strrchr( key , '.' );
+  const char * step_sep = NULL;
 
   *config_key = NULL;
-  util_split_string(key , "." , &num_items , &tmp);  /* The key can contain additional '.' - can not use sscanf(). */
-  if (num_items >= 3) {
+  if (iens_sep != NULL) {
+    const char * c = iens_sep;
+    while (c > key) {
+      c--;
+      if (*c == '.') {
+        step_sep = c;
+        break;
+      }
+    }
+  }
+
+  if ((step_sep != NULL) && (step_sep > key)) {
     int report_step , iens;
-    if (util_sscanf_int(tmp[num_items - 2] , &report_step) && util_sscanf_int(tmp[num_items - 1] , &iens)) {
+    if (block_fs_sscanf_key_int( step_sep + 1 , iens_sep , &report_step ) && block_fs_sscanf_key_int( iens_sep + 1 , iens_sep + strlen( iens_sep ) , &iens )) {
       /* OK - all is hunkadory */
       *__report_step = report_step;
       *__iens        = iens;
-      *config_key    = util_alloc_joined_string((const char **) tmp , num_items - 2 , ".");  /* This must bee freed by the calling scope */
-      util_free_stringlist( tmp , num_items );
+      *config_key    = util_alloc_substring_copy( key , 0 , step_sep - key );  /* This must bee freed by the calling scope */
       return true;
     } else  
       /* Failed to parse the two last items as integers. */
@@ -256,105 +420,227 @@ static bfs_type * block_fs_driver_get_fs( block_fs_driver_type * driver , int ie
 
 
 
+/*
+  Will return the node_key record of config_key, or NULL if it has not
+  been registered; must be called with the node_key_lock held.
+*/
+
+static bfs_node_key_type * block_fs_driver_find_node_key( const block_fs_driver_type * driver , const char * config_key , uint32_t config_key_hash ) {
+  uint32_t mask = driver->node_key_capacity - 1;
+  uint32_t i    = config_key_hash & mask;
+
+  while (true) {
+    bfs_node_key_type * node_key = driver->node_key_slots[i];
+    if ((node_key == NULL) || bfs_node_key_equal( node_key , config_key , config_key_hash ))
+      return node_key;
+    i = (i + 1) & mask;
+  }
+}
+
+
+static void block_fs_driver_insert_node_key( block_fs_driver_type * driver , bfs_node_key_type * node_key ) {
+  uint32_t mask = driver->node_key_capacity - 1;
+  uint32_t i    = node_key->config_key_hash & mask;
+
+  while (driver->node_key_slots[i] != NULL)
+    i = (i + 1) & mask;
+  driver->node_key_slots[i] = node_key;
+}
+
+
+static void block_fs_driver_resize_node_keys( block_fs_driver_type * driver , int capacity ) {
+  driver->node_key_capacity = capacity;
+  driver->node_key_slots    = util_realloc( driver->node_key_slots , capacity * sizeof * driver->node_key_slots );
+  memset( driver->node_key_slots , 0 , capacity * sizeof * driver->node_key_slots );
+
+  for (int node_id = 0; node_id < vector_get_size( driver->node_keys ); node_id++)
+    block_fs_driver_insert_node_key( driver , vector_iget( driver->node_keys , node_id ));
+}
+
+
+/*
+  Will return the node_key record of config_key; the first call with
+  a new config_key registers it.
+*/
+
+static const bfs_node_key_type * block_fs_driver_lookup_node_key( block_fs_driver_type * driver , const char * config_key ) {
+  uint32_t config_key_hash = block_fs_key_hash( config_key );
+  bfs_node_key_type * node_key;
+
+  pthread_rwlock_rdlock( &driver->node_key_lock );
+  node_key = block_fs_driver_find_node_key( driver , config_key , config_key_hash );
+  pthread_rwlock_unlock( &driver->node_key_lock );
+
+  if (node_key == NULL) {
+    pthread_rwlock_wrlock( &driver->node_key_lock );
+    node_key = block_fs_driver_find_node_key( driver , config_key , config_key_hash );
+    if (node_key == NULL) {
+      int node_id = vector_get_size( driver->node_keys );
+
+      if ((node_id + 1) * 2 > driver->node_key_capacity)
+        block_fs_driver_resize_node_keys( driver , 2 * driver->node_key_capacity );
+
+      node_key = bfs_node_key_alloc( config_key , config_key_hash , node_id );
+      vector_append_owned_ref( driver->node_keys , node_key , bfs_node_key_free__ );
+      block_fs_driver_insert_node_key( driver , node_key );
+    }
+    pthread_rwlock_unlock( &driver->node_key_lock );
+  }
+
+  return node_key;
+}
+
+
+int block_fs_driver_get_node_id( block_fs_driver_type * driver , const char * config_key ) {
+  const bfs_node_key_type * node_key = block_fs_driver_lookup_node_key( driver , config_key );
+  return node_key->node_id;
+}
+
+
+static const bfs_node_key_type * block_fs_driver_get_node_key( block_fs_driver_type * driver , int node_id ) {
+  const bfs_node_key_type * node_key;
+
+  pthread_rwlock_rdlock( &driver->node_key_lock );
+  if ((node_id < 0) || (node_id >= vector_get_size( driver->node_keys )))
+    util_abort("%s: invalid node_id:%d \n",__func__ , node_id);
+  node_key = vector_iget_const( driver->node_keys , node_id );
+  pthread_rwlock_unlock( &driver->node_key_lock );
+
+  return node_key;
+}
+
+
+static void block_fs_driver_load__( block_fs_driver_type * driver , const bfs_key_type * bfs_key , int iens , buffer_type * buffer) {
+  bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
+  block_fs_fread_realloc_buffer_hashed( bfs->block_fs , bfs_key->key , bfs_key->hash_value , buffer );
+}
+
+
+static void block_fs_driver_save__( block_fs_driver_type * driver , const bfs_key_type * bfs_key , int iens , buffer_type * buffer) {
+  bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
+  block_fs_fwrite_buffer_hashed( bfs->block_fs , bfs_key->key , bfs_key->hash_value , buffer );
+}
+
+
+static void block_fs_driver_unlink__( block_fs_driver_type * driver , const bfs_key_type * bfs_key , int iens ) {
+  bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
+  block_fs_unlink_file_hashed( bfs->block_fs , bfs_key->key , bfs_key->hash_value );
+}
+
+
+static bool block_fs_driver_has__( block_fs_driver_type * driver , const bfs_key_type * bfs_key , int iens ) {
+  bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
+  return block_fs_has_file_hashed( bfs->block_fs , bfs_key->key , bfs_key->hash_value );
+}
+
+
+void block_fs_driver_load_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens , buffer_type * buffer) {
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_get_node_key( driver , node_id ) , report_step , iens );
+  block_fs_driver_load__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
+}
+
+
+void block_fs_driver_save_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens , buffer_type * buffer) {
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_get_node_key( driver , node_id ) , report_step , iens );
+  block_fs_driver_save__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
+}
+
+
+void block_fs_driver_unlink_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens ) {
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_get_node_key( driver , node_id ) , report_step , iens );
+  block_fs_driver_unlink__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
+}
+
+
+bool block_fs_driver_has_node_id( block_fs_driver_type * driver , int node_id , int report_step , int iens ) {
+  bfs_key_type bfs_key;
+  bool has_node;
+  bfs_key_init_node( &bfs_key , block_fs_driver_get_node_key( driver , node_id ) , report_step , iens );
+  has_node = block_fs_driver_has__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
+  return has_node;
+}
+
+
 static void block_fs_driver_load_node(void * _driver , const char * node_key , int report_step , int iens ,  buffer_type * buffer) {
   block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
-  {
-    char * key          = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type      * bfs = block_fs_driver_get_fs( driver , iens );
-    
-    block_fs_fread_realloc_buffer( bfs->block_fs , key , buffer);
-    
-    free( key );
-  }
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , report_step , iens );
+  block_fs_driver_load__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
 }
 
 
 static void block_fs_driver_load_vector(void * _driver , const char * node_key , int iens ,  buffer_type * buffer) {
   block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
-  {
-    char * key          = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type      * bfs = block_fs_driver_get_fs( driver , iens );
-    
-    block_fs_fread_realloc_buffer( bfs->block_fs , key , buffer);
-    free( key );
-  }
+  bfs_key_type bfs_key;
+  bfs_key_init_vector( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , iens );
+  block_fs_driver_load__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
 }
 
-/*****************************************************************/
 
 static void block_fs_driver_save_node(void * _driver , const char * node_key , int report_step , int iens ,  buffer_type * buffer) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key     = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_fwrite_buffer( bfs->block_fs , key , buffer);
-    free( key );
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , report_step , iens );
+  block_fs_driver_save__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
 }
 
 
 static void block_fs_driver_save_vector(void * _driver , const char * node_key , int iens ,  buffer_type * buffer) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key     = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_fwrite_buffer( bfs->block_fs , key , buffer);
-    free( key );
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bfs_key_init_vector( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , iens );
+  block_fs_driver_save__( driver , &bfs_key , iens , buffer );
+  bfs_key_free( &bfs_key );
 }
 
-/*****************************************************************/
 
 void block_fs_driver_unlink_node(void * _driver , const char * node_key , int report_step , int iens ) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key     = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_unlink_file( bfs->block_fs , key );
-    free( key );
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bfs_key_init_node( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , report_step , iens );
+  block_fs_driver_unlink__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
 }
 
+
 void block_fs_driver_unlink_vector(void * _driver , const char * node_key , int iens ) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key     = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_unlink_file( bfs->block_fs , key );
-    free( key );
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bfs_key_init_vector( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , iens );
+  block_fs_driver_unlink__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
 }
 
 
-/*****************************************************************/
-
 bool block_fs_driver_has_node(void * _driver , const char * node_key , int report_step , int iens ) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key      = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type  * bfs = block_fs_driver_get_fs( driver , iens );
-    bool has_node   = block_fs_has_file( bfs->block_fs , key );
-    free( key );
-    return has_node;
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bool has_node;
+  bfs_key_init_node( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , report_step , iens );
+  has_node = block_fs_driver_has__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
+  return has_node;
 }
 
 
 bool block_fs_driver_has_vector(void * _driver , const char * node_key , int iens ) {
-  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
-  block_fs_driver_assert_cast(driver);
-  {
-    char * key      = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type  * bfs = block_fs_driver_get_fs( driver , iens );
-    bool has_node   = block_fs_has_file( bfs->block_fs , key );
-    free( key );
-    return has_node;
-  }
+  block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
+  bfs_key_type bfs_key;
+  bool has_node;
+  bfs_key_init_vector( &bfs_key , block_fs_driver_lookup_node_key( driver , node_key ) , iens );
+  has_node = block_fs_driver_has__( driver , &bfs_key , iens );
+  bfs_key_free( &bfs_key );
+  return has_node;
 }
 
 /*****************************************************************/
@@ -379,6 +665,9 @@ void block_fs_driver_free(void *_driver) {
     thread_pool_free( tp );
   }
   bfs_config_free( driver->config );
+  free( driver->node_key_slots );
+  vector_free( driver->node_keys );
+  pthread_rwlock_destroy( &driver->node_key_lock );
   free( driver->fs_list );
   free(driver);
 }
@@ -420,6 +709,10 @@ static block_fs_driver_type * block_fs_driver_alloc(int num_fs) {
   driver->num_fs        = num_fs;
 
   driver->fs_list       = util_calloc( driver->num_fs , sizeof * driver->fs_list );
+  driver->node_keys     = vector_alloc_new();
+  driver->node_key_slots = NULL;
+  block_fs_driver_resize_node_keys( driver , 64 );
+  pthread_rwlock_init( &driver->node_key_lock , NULL );
   return driver;
 }
 
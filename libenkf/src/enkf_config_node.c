@@ -927,7 +927,9 @@ enkf_config_node_type * enkf_config_node_alloc_GEN_DATA_from_config( const confi
       const char * min_std_file               = hash_safe_get( options , MIN_STD_KEY);
       const char * forward_string             = hash_safe_get( options , FORWARD_INIT_KEY );
       const char * report_steps_string        = hash_safe_get( options , REPORT_STEPS_KEY );
+      const char * codec_string               = hash_safe_get( options , CODEC_KEY );
       int_vector_type * report_steps          = int_vector_alloc(0,0);
+      buffer_codec_type codec                 = buffer_codec_default();
       bool forward_init = false;
       bool valid_input = true;
 
@@ -961,6 +963,9 @@ enkf_config_node_type * enkf_config_node_alloc_GEN_DATA_from_config( const confi
         valid_input = false;
       }
 
+      if (codec_string && !buffer_codec_sscanf( codec_string , &codec ))
+        fprintf(stderr,"** Warning: codec:%s for %s not recognized - using default ZLIB \n",codec_string , node_key);
+
       if (valid_input) {
 
         if (forward_string) {
@@ -992,6 +997,8 @@ enkf_config_node_type * enkf_config_node_alloc_GEN_DATA_from_config( const confi
           if (template)
             gen_data_config_set_template( gen_data_config , template , data_key);
 
+          gen_data_config_set_codec( gen_data_config , codec );
+
           for (int i=0; i < int_vector_size( report_steps ); i++) {
             int report_step = int_vector_iget( report_steps , i );
             gen_data_config_add_report_step( gen_data_config , report_step);
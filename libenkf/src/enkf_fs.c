@@ -826,6 +826,26 @@ void enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
 
 
 
+/**
+   Copies the stored representation of a node from src_fs to
+   target_fs, without decoding it into an enkf_node instance and
+   encoding it again; i.e. without the decompress -> recompress round
+   trip of enkf_node_load() + enkf_node_store(). The node is stored in
+   target_fs with the codec and timestamp it has in src_fs. The
+   buffer is used as scratch space, and can be reused between calls.
+*/
+
+void enkf_fs_copy_node(enkf_fs_type * src_fs , enkf_fs_type * target_fs , buffer_type * buffer ,
+                       const char * node_key , enkf_var_type var_type ,
+                       int report_step , int iens) {
+
+  enkf_fs_fread_node( src_fs , buffer , node_key , var_type , report_step , iens );
+  if ((var_type == PARAMETER) && (report_step > 0))
+    report_step = 0;
+  enkf_fs_fwrite_node( target_fs , buffer , node_key , var_type , report_step , iens );
+}
+
+
 bool enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens) {
   fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type , node_key));
   return driver->has_node(driver , node_key , report_step , iens );
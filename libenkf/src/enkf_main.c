@@ -27,6 +27,7 @@
 #include <dirent.h>
 #include <pwd.h>
 #include <unistd.h>
+#include <time.h>
 #include <sys/types.h>
 
 #define HAVE_THREAD_POOL 1
@@ -38,8 +39,10 @@
 #include <ert/util/bool_vector.h>
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
+#include <ert/util/vector.h>
 #include <ert/util/path_fmt.h>
 #include <ert/util/thread_pool.h>
+#include <ert/util/task_graph.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/msg.h>
 #include <ert/util/stringlist.h>
@@ -190,6 +193,7 @@ static void enkf_main_user_select_initial_fs(enkf_main_type * enkf_main );
 static void enkf_main_free_ensemble( enkf_main_type * enkf_main );
 static void enkf_main_init_jobname( enkf_main_type * enkf_main);
 static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
+                                       enkf_fs_type * source_fs ,
                                        enkf_fs_type * target_fs ,
                                        const bool_vector_type * ens_mask ,
                                        int target_step ,
@@ -199,7 +203,10 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                        int step2 ,
                                        const local_ministep_type * ministep ,
                                        const meas_data_type * forecast ,
-                                       obs_data_type * obs_data);
+                                       obs_data_type * obs_data ,
+                                       set_type * updated_keys ,
+                                       task_graph_type * task_graph ,
+                                       FILE * log_stream);
 
 /*****************************************************************/
 
@@ -631,6 +638,8 @@ typedef struct {
   const active_list_type     * active_list;
   matrix_type                * A;
   const int_vector_type      * iens_active_index;
+  bool                         load_target;   /* Load the node from src_fs before deserializing - when only some of the elements are in A. */
+  set_type                   * updated_keys;  /* The parameters which have already been written to target_fs in this update. */
 } serialize_info_type;
 
 
@@ -672,25 +681,73 @@ static void * serialize_nodes_mt( void * arg ) {
 }
 
 
-static void enkf_main_serialize_node( const char * node_key ,
-                                      const active_list_type * active_list ,
-                                      int row_offset ,
-                                      thread_pool_type * work_pool ,
-                                      serialize_info_type * serialize_info) {
+/*
+  The serialize and deserialize work of the update is run as tasks in
+  a task_graph. The unit of work is one node for one of the
+  realization ranges [iens1,iens2) in the serialize_info array; the
+  argument to each task is a private copy of the serialize_info
+  element, with the node specific fields filled in. The copies are
+  owned by the task_args vector, which must be kept alive until the
+  graph has been run.
+
+  The functions return the id of a barrier task which completes when
+  all the tasks added for the node have completed; the tasks will not
+  start before the task @depends_on (if >= 0) has completed. The
+  serialize tasks read the node from @read_fs, and the deserialize
+  tasks load the node from @read_fs when @load_target is true.
+
+  The parameters are not copied from the source case to the target
+  case before the update. A node is therefore read from the source
+  case until it has been written to the target case by the update;
+  see enkf_main_update_read_fs(). The parameters which are not
+  updated at all are copied at the end of the update, with
+  enkf_main_copy_parameters().
+*/
+
+static enkf_fs_type * enkf_main_update_read_fs( const serialize_info_type * serialize_info , const char * key ) {
+  if (set_has_key( serialize_info->updated_keys , key ))
+    return serialize_info->target_fs;
+  else
+    return serialize_info->src_fs;
+}
 
-  /* Multithreaded serializing*/
-  const int num_cpu_threads = thread_pool_get_max_running( work_pool );
+
+static int enkf_main_add_node_tasks( task_graph_type * graph ,
+                                     vector_type * task_args ,
+                                     void * (*func) (void *) ,
+                                     const serialize_info_type * serialize_info ,
+                                     const char * key ,
+                                     const active_list_type * active_list ,
+                                     int row_offset ,
+                                     matrix_type * A ,
+                                     enkf_fs_type * read_fs ,
+                                     bool load_target ,
+                                     int depends_on) {
+
+  const int num_cpu_threads = task_graph_get_num_threads( graph );
+  int barrier = task_graph_add_barrier( graph );
   int icpu;
 
-  thread_pool_restart( work_pool );
   for (icpu = 0; icpu < num_cpu_threads; icpu++) {
-    serialize_info[icpu].key         = node_key;
-    serialize_info[icpu].active_list = active_list;
-    serialize_info[icpu].row_offset  = row_offset;
-
-    thread_pool_add_job( work_pool , serialize_nodes_mt , &serialize_info[icpu]);
+    if (serialize_info[icpu].iens2 > serialize_info[icpu].iens1) {
+      serialize_info_type * info = util_alloc_copy( &serialize_info[icpu] , sizeof * info );
+      int task;
+
+      info->key         = key;
+      info->active_list = active_list;
+      info->row_offset  = row_offset;
+      info->A           = A;
+      info->src_fs      = read_fs;
+      info->load_target = load_target;
+      vector_append_owned_ref( task_args , info , free );
+
+      task = task_graph_add_task( graph , func , info );
+      if (depends_on >= 0)
+        task_graph_add_dependency( graph , task , depends_on );
+      task_graph_add_dependency( graph , barrier , task );
+    }
   }
-  thread_pool_join( work_pool );
+  return barrier;
 }
 
 
@@ -706,11 +763,12 @@ static int enkf_main_serialize_dataset( const ensemble_config_type * ens_config
                                         hash_type * use_count ,
                                         int * active_size ,
                                         int * row_offset,
-                                        thread_pool_type * work_pool,
+                                        task_graph_type * graph,
                                         serialize_info_type * serialize_info) {
 
   matrix_type * A   = serialize_info->A;
   stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
+  vector_type * task_args = vector_alloc_new( );
   const int num_kw  = stringlist_get_size( update_keys );
   int ens_size      = matrix_get_columns( A );
   int current_row   = 0;
@@ -726,28 +784,39 @@ static int enkf_main_serialize_dataset( const ensemble_config_type * ens_config
       continue;
     } else {
       const active_list_type * active_list      = local_dataset_get_node_active_list( dataset , key );
-      enkf_fs_type * src_fs = serialize_info->src_fs;
+      enkf_fs_type * src_fs = enkf_main_update_read_fs( serialize_info , key );
       active_size[ikw] = __get_active_size( ens_config , src_fs , key , report_step , active_list );
       row_offset[ikw]  = current_row;
+      current_row += active_size[ikw];
+    }
+  }
 
-      {
-        int matrix_rows = matrix_get_rows( A );
-        if ((active_size[ikw] + current_row) > matrix_rows)
-          matrix_resize( A , matrix_rows + 2 * active_size[ikw] , ens_size , true );
-      }
+  /*
+     A is sized for the full dataset before any of the nodes are
+     serialized; the nodes are then serialized concurrently without a
+     barrier between the keys.
+  */
+  if (current_row > matrix_get_rows( A ))
+    matrix_resize( A , current_row , ens_size , false );
 
-      if (active_size[ikw] > 0) {
-        enkf_main_serialize_node( key , active_list , row_offset[ikw] , work_pool , serialize_info );
-        current_row += active_size[ikw];
-      }
+  for (int ikw=0; ikw < num_kw; ikw++) {
+    if (active_size[ikw] > 0) {
+      const char * key = stringlist_iget(update_keys , ikw);
+      const active_list_type * active_list = local_dataset_get_node_active_list( dataset , key );
+      enkf_main_add_node_tasks( graph , task_args , serialize_nodes_mt , serialize_info , key , active_list , row_offset[ikw] , A ,
+                                enkf_main_update_read_fs( serialize_info , key ) , false , -1 );
     }
   }
+  task_graph_run( graph );
+
   matrix_shrink_header( A , current_row , ens_size );
+  vector_free( task_args );
   stringlist_free( update_keys );
   return matrix_get_rows( A );
 }
 
 static void deserialize_node( enkf_fs_type * fs,
+                              enkf_fs_type * load_fs,
                               const ensemble_config_type * ensemble_config,
                               const char * key ,
                               int iens,
@@ -759,6 +828,8 @@ static void deserialize_node( enkf_fs_type * fs,
   const enkf_config_node_type * config_node = ensemble_config_get_node( ensemble_config , key );
   enkf_node_type * node = enkf_node_alloc( config_node );
   node_id_type node_id = {.report_step = target_step, .iens = iens  };
+  if (load_fs)
+    enkf_node_load( node , load_fs , node_id );
   enkf_node_deserialize(node , fs , node_id , active_list , A , row_offset , column);
   state_map_update_undefined(enkf_fs_get_state_map(fs) , iens , STATE_INITIALIZED);
   enkf_node_free( node );
@@ -772,7 +843,7 @@ static void * deserialize_nodes_mt( void * arg ) {
   for (iens = info->iens1; iens < info->iens2; iens++) {
     int column = int_vector_iget( info->iens_active_index , iens );
     if (column >= 0)
-      deserialize_node( info->target_fs , info->ensemble_config , info->key , iens , info->target_step , info->row_offset , column, info->active_list , info->A );
+      deserialize_node( info->target_fs , info->load_target ? info->src_fs : NULL , info->ensemble_config , info->key , iens , info->target_step , info->row_offset , column, info->active_list , info->A );
   }
   return NULL;
 }
@@ -783,10 +854,10 @@ static void enkf_main_deserialize_dataset( ensemble_config_type * ensemble_confi
                                            const int * active_size ,
                                            const int * row_offset ,
                                            serialize_info_type * serialize_info ,
-                                           thread_pool_type * work_pool ) {
+                                           task_graph_type * graph ) {
 
-  int num_cpu_threads = thread_pool_get_max_running( work_pool );
   stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
+  vector_type * task_args = vector_alloc_new( );
   for (int i = 0; i < stringlist_get_size( update_keys ); i++) {
     const char             * key         = stringlist_iget(update_keys , i);
     enkf_config_node_type * config_node  = ensemble_config_get_node( ensemble_config , key );
@@ -800,23 +871,18 @@ static void enkf_main_deserialize_dataset( ensemble_config_type * ensemble_confi
     else {
       if (active_size[i] > 0) {
         const active_list_type * active_list      = local_dataset_get_node_active_list( dataset , key );
-
-        {
-          /* Multithreaded */
-          int icpu;
-          thread_pool_restart( work_pool );
-          for (icpu = 0; icpu < num_cpu_threads; icpu++) {
-            serialize_info[icpu].key         = key;
-            serialize_info[icpu].active_list = active_list;
-            serialize_info[icpu].row_offset  = row_offset[i];
-
-            thread_pool_add_job( work_pool , deserialize_nodes_mt , &serialize_info[icpu]);
-          }
-          thread_pool_join( work_pool );
-        }
+        enkf_main_add_node_tasks( graph , task_args , deserialize_nodes_mt , serialize_info , key , active_list , row_offset[i] , serialize_info->A ,
+                                  enkf_main_update_read_fs( serialize_info , key ) , false , -1 );
       }
     }
   }
+  task_graph_run( graph );
+
+  for (int i = 0; i < stringlist_get_size( update_keys ); i++) {
+    if (active_size[i] > 0)
+      set_add_key( serialize_info->updated_keys , stringlist_iget( update_keys , i ));
+  }
+  vector_free( task_args );
   stringlist_free( update_keys );
 }
 
@@ -834,6 +900,7 @@ static serialize_info_type * serialize_info_alloc( enkf_fs_type * src_fs,
                                                    run_mode_type run_mode ,
                                                    int report_step ,
                                                    matrix_type * A ,
+                                                   set_type * updated_keys ,
                                                    int num_cpu_threads ) {
 
   serialize_info_type * serialize_info = util_calloc( num_cpu_threads , sizeof * serialize_info );
@@ -849,6 +916,8 @@ static serialize_info_type * serialize_info_alloc( enkf_fs_type * src_fs,
     serialize_info[icpu].target_step = target_step;
     serialize_info[icpu].report_step = report_step;
     serialize_info[icpu].A           = A;
+    serialize_info[icpu].load_target = false;
+    serialize_info[icpu].updated_keys = updated_keys;
     serialize_info[icpu].iens1       = iens_offset;
     serialize_info[icpu].iens2       = iens_offset + (ens_size - iens_offset) / (num_cpu_threads - icpu);
     iens_offset = serialize_info[icpu].iens2;
@@ -977,6 +1046,81 @@ static FILE * enkf_main_log_step_list(enkf_main_type * enkf_main, const int_vect
 }
 
 
+static void * enkf_main_copy_parameter_mt( void * arg ) {
+  arg_pack_type * arg_pack                       = arg_pack_safe_cast( arg );
+  enkf_fs_type * source_fs                       = arg_pack_iget_ptr( arg_pack , 0 );
+  enkf_fs_type * target_fs                       = arg_pack_iget_ptr( arg_pack , 1 );
+  const enkf_config_node_type * config_node      = arg_pack_iget_const_ptr( arg_pack , 2 );
+  const int_vector_type * ens_active_list        = arg_pack_iget_const_ptr( arg_pack , 3 );
+  int index1                                     = arg_pack_iget_int( arg_pack , 4 );
+  int index2                                     = arg_pack_iget_int( arg_pack , 5 );
+  const char * key                               = enkf_config_node_get_key( config_node );
+
+  if ((enkf_config_node_get_impl_type( config_node ) == CONTAINER) || enkf_config_node_vector_storage( config_node )) {
+    enkf_node_type * data_node = enkf_node_alloc( config_node );
+    for (int j = index1; j < index2; j++) {
+      node_id_type node_id = { .iens = int_vector_iget( ens_active_list , j ), .report_step = 0 };
+      enkf_node_load( data_node , source_fs , node_id );
+      enkf_node_store( data_node , target_fs , false , node_id );
+    }
+    enkf_node_free( data_node );
+  } else {
+    buffer_type * buffer = buffer_alloc( 1024 );
+    for (int j = index1; j < index2; j++)
+      enkf_fs_copy_node( source_fs , target_fs , buffer , key , PARAMETER , 0 , int_vector_iget( ens_active_list , j ));
+    buffer_free( buffer );
+  }
+  return NULL;
+}
+
+
+/*
+  The parameters are not copied from the source case to the target
+  case before the update; the update reads each parameter from the
+  source case until it has written it to the target case. This
+  function copies the parameters which have not been updated, i.e. the
+  keys which are not in @updated_keys. The nodes are copied as stored
+  blobs, with one task for each parameter and range of realizations.
+*/
+
+static void enkf_main_copy_parameters( enkf_main_type * enkf_main ,
+                                       enkf_fs_type * source_fs ,
+                                       enkf_fs_type * target_fs ,
+                                       const int_vector_type * ens_active_list ,
+                                       const set_type * updated_keys ,
+                                       task_graph_type * task_graph ) {
+  stringlist_type * param_keys = ensemble_config_alloc_keylist_from_var_type( enkf_main->ensemble_config , PARAMETER );
+  vector_type * task_args      = vector_alloc_new( );
+  const int num_cpu_threads    = task_graph_get_num_threads( task_graph );
+  const int ens_size           = int_vector_size( ens_active_list );
+  int chunk_size               = util_int_max( 1 , (ens_size + num_cpu_threads - 1) / num_cpu_threads );
+
+  for (int i = 0; i < stringlist_get_size( param_keys ); i++) {
+    const char * key = stringlist_iget( param_keys , i );
+    if (set_has_key( updated_keys , key ))
+      continue;
+
+    for (int index1 = 0; index1 < ens_size; index1 += chunk_size) {
+      arg_pack_type * arg_pack = arg_pack_alloc( );
+
+      arg_pack_append_ptr( arg_pack , source_fs );
+      arg_pack_append_ptr( arg_pack , target_fs );
+      arg_pack_append_const_ptr( arg_pack , ensemble_config_get_node( enkf_main->ensemble_config , key ));
+      arg_pack_append_const_ptr( arg_pack , ens_active_list );
+      arg_pack_append_int( arg_pack , index1 );
+      arg_pack_append_int( arg_pack , util_int_min( index1 + chunk_size , ens_size ));
+      vector_append_owned_ref( task_args , arg_pack , arg_pack_free__ );
+
+      task_graph_add_task( task_graph , enkf_main_copy_parameter_mt , arg_pack );
+    }
+  }
+  task_graph_run( task_graph );
+
+  vector_free( task_args );
+  stringlist_free( param_keys );
+}
+
+
 /**
  * This is THE ENKF update function.  It should only be called from enkf_main_UPDATE.
  */
@@ -1000,32 +1144,12 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
   state_map_select_matching(source_state_map, ens_mask, STATE_HAS_DATA);
   {
     FILE * log_stream = enkf_main_log_step_list(enkf_main, step_list);
+    task_graph_type * task_graph = task_graph_alloc(analysis_config_get_update_threads(analysis_config));
     double global_std_scaling = analysis_config_get_global_std_scaling(analysis_config);
     meas_data_type * meas_data = meas_data_alloc(ens_mask);
     obs_data_type * obs_data = obs_data_alloc(global_std_scaling);
     int_vector_type * ens_active_list = bool_vector_alloc_active_list(ens_mask);
-
-    /*
-      Copy all the parameter nodes from source case to target case;
-      nodes which are updated will be fetched from the new target
-      case, and nodes which are not updated will be manually copied
-      over there.
-    */
-    if (target_fs != source_fs) {
-      stringlist_type * param_keys = ensemble_config_alloc_keylist_from_var_type(enkf_main->ensemble_config, PARAMETER);
-      for (int i = 0; i < stringlist_get_size(param_keys); i++) {
-        const char * key = stringlist_iget(param_keys, i);
-        enkf_config_node_type * config_node = ensemble_config_get_node(enkf_main->ensemble_config, key);
-        enkf_node_type * data_node = enkf_node_alloc(config_node);
-        for (int j = 0; j < int_vector_size(ens_active_list); j++) {
-          node_id_type node_id = { .iens = int_vector_iget(ens_active_list, j), .report_step = 0 };
-          enkf_node_load(data_node, source_fs, node_id);
-          enkf_node_store(data_node, target_fs, false, node_id);
-        }
-        enkf_node_free(data_node);
-      }
-      stringlist_free(param_keys);
-    }
+    set_type * updated_keys = set_alloc_empty();
 
     {
       hash_type * use_count = hash_alloc();
@@ -1068,6 +1192,7 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
 
         if ((obs_data_get_active_size(obs_data) > 0) && (meas_data_get_active_obs_size(meas_data) > 0))
             enkf_main_analysis_update(enkf_main,
+                                      source_fs,
                                       target_fs,
                                       ens_mask,
                                       target_step,
@@ -1077,12 +1202,22 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
                                       current_step,
                                       ministep,
                                       meas_data,
-                                      obs_data);
+                                      obs_data,
+                                      updated_keys,
+                                      task_graph,
+                                      log_stream);
         else if (target_fs != source_fs)
           ert_log_add_fmt_message(1, stderr, "No active observations/parameters for MINISTEP: %s.",
                                   local_ministep_get_name(ministep));
       }
 
+      /*
+        The parameters which have not been updated are copied from the
+        source case to the target case.
+      */
+      if (target_fs != source_fs)
+        enkf_main_copy_parameters(enkf_main, source_fs, target_fs, ens_active_list, updated_keys, task_graph);
+
       enkf_main_inflate(enkf_main, source_fs, target_fs, current_step, use_count);
       hash_free(use_count);
     }
@@ -1099,15 +1234,326 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
     }
 
     int_vector_free(ens_active_list);
+    set_free(updated_keys);
     obs_data_free(obs_data);
     meas_data_free(meas_data);
+    task_graph_free(task_graph);
     fclose(log_stream);
   }
   bool_vector_free( ens_mask);
 }
 
 
+/*
+  Wall clock time (seconds) spent in the different phases of the
+  update of one ministep; the times are written to the update log.
+*/
+
+typedef struct {
+  double serialize;
+  double initX;
+  double matmul;
+  double deserialize;
+  double pipelined;     /* Serialize, matmul and deserialize of datasets updated with enkf_main_update_dataset_pipelined(). */
+} update_timing_type;
+
+
+static double enkf_main_wall_time( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+
+/*
+  When the analysis module only needs the X matrix the update of a
+  dataset is run as one task graph, where the elements of one node
+  flow through serialize -> A*X -> deserialize without waiting for the
+  other nodes of the dataset: the storage I/O of one node overlaps with
+  the I/O and the matrix multiplication of the other nodes.
+
+  With UPDATE_BLOCK_SIZE > 0 the update is furthermore streamed in row
+  blocks of at most block_size rows, so that the memory needed for A
+  is bounded by 2 * block_size * ens_size, independent of the size of
+  the parameters in the dataset. Two blocks are in flight at a time:
+  the nodes of the next block are serialized into one half of A while
+  the current block is multiplied and deserialized from the other.
+
+  Consecutive nodes are packed into the same block, and a node which
+  does not fit in the remaining part of a block is split over several
+  blocks. Each part of a node in a block is described by an
+  update_segment_type instance. When a segment holds only some of the
+  elements of the node, the node is loaded from the target filesystem
+  before the updated elements are deserialized into it - and a split
+  node is consequently read and written once for each block it
+  touches. To keep these read-modify-write cycles in order the
+  deserialize tasks of a block wait for the deserialize tasks of the
+  previous block.
+*/
+
+#define UPDATE_MATMUL_MAX_ROWS 65536
+
+typedef struct {
+  const char             * key;
+  const active_list_type * active_list;   /* The elements of the node which are in this segment. */
+  active_list_type       * sublist;       /* Owned by the segment when the node is split - otherwise NULL. */
+  int                      row_offset;    /* The first row of the segment in the block. */
+  int                      rows;
+  bool                     load_target;
+} update_segment_type;
+
+
+static void update_segment_free__( void * arg ) {
+  update_segment_type * segment = arg;
+  if (segment->sublist)
+    active_list_free( segment->sublist );
+  free( segment );
+}
+
+
+static void enkf_main_add_update_segment( vector_type * segments ,
+                                          const char * key ,
+                                          const active_list_type * active_list ,
+                                          int node_size ,
+                                          int active_size ,
+                                          int node_row ,
+                                          int rows ,
+                                          int row_offset ,
+                                          bool load_partly_active) {
+  update_segment_type * segment = util_malloc( sizeof * segment );
+  segment->key        = key;
+  segment->row_offset = row_offset;
+  segment->rows       = rows;
+  if (rows == active_size) {
+    segment->sublist     = NULL;
+    segment->active_list = active_list;
+    segment->load_target = load_partly_active && (active_size < node_size);
+  } else {
+    segment->sublist     = active_list_alloc_sublist( active_list , node_row , rows );
+    segment->active_list = segment->sublist;
+    segment->load_target = true;
+  }
+  vector_append_owned_ref( segments , segment , update_segment_free__ );
+}
+
+
+static void * enkf_main_matmul_mt( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  matrix_type * A          = arg_pack_iget_ptr( arg_pack , 0 );
+  const matrix_type * X    = arg_pack_iget_const_ptr( arg_pack , 1 );
+  int row_offset           = arg_pack_iget_int( arg_pack , 2 );
+  int rows                 = arg_pack_iget_int( arg_pack , 3 );
+
+  matrix_type * A_view = matrix_alloc_shared( A , row_offset , 0 , rows , matrix_get_columns( A ));
+  matrix_inplace_matmul( A_view , X );
+  matrix_free( A_view );
+  return NULL;
+}
+
+
+/*
+  Adds tasks for A = A*X on the rows [row_offset, row_offset + rows)
+  of A, split in panels so that all the threads can take part. The
+  return value is a barrier which completes when all the panels are
+  complete.
+*/
+
+static int enkf_main_add_matmul_tasks( task_graph_type * graph ,
+                                       vector_type * task_args ,
+                                       matrix_type * A ,
+                                       const matrix_type * X ,
+                                       int row_offset ,
+                                       int rows ,
+                                       int depends_on) {
+  const int num_cpu_threads = task_graph_get_num_threads( graph );
+  int panel_rows = util_int_max( 1 , util_int_min( UPDATE_MATMUL_MAX_ROWS , (rows + num_cpu_threads - 1) / num_cpu_threads ));
+  int barrier    = task_graph_add_barrier( graph );
+  int row;
+
+  for (row = 0; row < rows; row += panel_rows) {
+    arg_pack_type * arg_pack = arg_pack_alloc( );
+    int task;
+
+    arg_pack_append_ptr( arg_pack , A );
+    arg_pack_append_const_ptr( arg_pack , X );
+    arg_pack_append_int( arg_pack , row_offset + row );
+    arg_pack_append_int( arg_pack , util_int_min( panel_rows , rows - row ));
+    vector_append_owned_ref( task_args , arg_pack , arg_pack_free__ );
+
+    task = task_graph_add_task( graph , enkf_main_matmul_mt , arg_pack );
+    if (depends_on >= 0)
+      task_graph_add_dependency( graph , task , depends_on );
+    task_graph_add_dependency( graph , barrier , task );
+  }
+  return barrier;
+}
+
+
+/*
+  Adds the tasks for the segments [seg1,seg2) which have been packed
+  into @block. For each segment the serialize tasks wait for
+  @block_free, the matmul of the segment rows waits for the serialize
+  tasks of the segment, and the deserialize tasks wait for the matmul
+  and for @prev_block_done. The return value is a barrier which
+  completes when all the segments have been deserialized.
+
+  When a node has been split over several segments the later segments
+  load the node from target_fs, where the previous segment of the node
+  has already been stored.
+*/
+
+static int enkf_main_add_block_tasks( task_graph_type * graph ,
+                                      vector_type * task_args ,
+                                      const vector_type * segments ,
+                                      int seg1 ,
+                                      int seg2 ,
+                                      matrix_type * block ,
+                                      const matrix_type * X ,
+                                      const serialize_info_type * serialize_info ,
+                                      int block_free ,
+                                      int prev_block_done) {
+
+  int block_done = task_graph_add_barrier( graph );
+
+  for (int iseg = seg1; iseg < seg2; iseg++) {
+    const update_segment_type * segment = vector_iget_const( segments , iseg );
+    enkf_fs_type * read_fs = enkf_main_update_read_fs( serialize_info , segment->key );
+    enkf_fs_type * load_fs = read_fs;
+    int serialized;
+    int updated;
+
+    if (iseg > 0) {
+      const update_segment_type * prev_segment = vector_iget_const( segments , iseg - 1 );
+      if (util_string_equal( prev_segment->key , segment->key ))
+        load_fs = serialize_info->target_fs;
+    }
+
+    serialized = enkf_main_add_node_tasks( graph , task_args , serialize_nodes_mt , serialize_info ,
+                                           segment->key , segment->active_list , segment->row_offset , block , read_fs , false , block_free );
+    updated    = enkf_main_add_matmul_tasks( graph , task_args , block , X , segment->row_offset , segment->rows , serialized );
+
+    if (prev_block_done >= 0)
+      task_graph_add_dependency( graph , updated , prev_block_done );
+
+    {
+      int deserialized = enkf_main_add_node_tasks( graph , task_args , deserialize_nodes_mt , serialize_info ,
+                                                   segment->key , segment->active_list , segment->row_offset , block , load_fs , segment->load_target , updated );
+      task_graph_add_dependency( graph , block_done , deserialized );
+    }
+  }
+  return block_done;
+}
+
+
+static void enkf_main_update_dataset_pipelined( const ensemble_config_type * ens_config ,
+                                                const local_dataset_type * dataset ,
+                                                int report_step ,
+                                                int block_size ,
+                                                matrix_type * A ,
+                                                const matrix_type * X ,
+                                                task_graph_type * graph ,
+                                                serialize_info_type * serialize_info ,
+                                                update_timing_type * timing) {
+
+  stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
+  const int num_kw              = stringlist_get_size( update_keys );
+  const int ens_size            = matrix_get_columns( A );
+  int * active_size             = util_calloc( num_kw , sizeof * active_size );
+  vector_type * segments        = vector_alloc_new( );
+  vector_type * task_args       = vector_alloc_new( );
+  matrix_type * blocks[2]       = { NULL , NULL };
+  int block_done[2]             = { -1 , -1 };
+  bool streaming;
+  int num_blocks                = 0;
+  int total_rows                = 0;
+
+  for (int ikw = 0; ikw < num_kw; ikw++) {
+    const char * key = stringlist_iget( update_keys , ikw );
+    const enkf_config_node_type * config_node = ensemble_config_get_node( ens_config , key );
+
+    if ((serialize_info[0].run_mode == SMOOTHER_UPDATE) && (enkf_config_node_get_var_type( config_node ) != PARAMETER))
+      active_size[ikw] = 0;
+    else
+      active_size[ikw] = __get_active_size( ens_config , enkf_main_update_read_fs( serialize_info , key ) , key , report_step , local_dataset_get_node_active_list( dataset , key ));
+    total_rows += active_size[ikw];
+  }
+
+  streaming = (block_size > 0) && (block_size < total_rows);
+  if (!streaming)
+    block_size = total_rows;
+
+  if (total_rows > 0) {
+    int buffer_rows = streaming ? 2 * block_size : block_size;
+    if (matrix_get_rows( A ) != buffer_rows)
+      matrix_resize( A , buffer_rows , ens_size , false );
+
+    blocks[0] = matrix_alloc_shared( A , 0 , 0 , block_size , ens_size );
+    if (streaming)
+      blocks[1] = matrix_alloc_shared( A , block_size , 0 , block_size , ens_size );
+  }
+
+  {
+    int block_rows = 0;
+    int seg1       = 0;
+
+    for (int ikw = 0; ikw < num_kw; ikw++) {
+      const char * key = stringlist_iget( update_keys , ikw );
+      const enkf_config_node_type * config_node = ensemble_config_get_node( ens_config , key );
+      const active_list_type * active_list = local_dataset_get_node_active_list( dataset , key );
+      int node_size   = enkf_config_node_get_data_size( config_node , report_step );
+      int node_row    = 0;
+
+      while (node_row < active_size[ikw]) {
+        int rows = util_int_min( active_size[ikw] - node_row , block_size - block_rows );
+
+        enkf_main_add_update_segment( segments , key , active_list , node_size , active_size[ikw] , node_row , rows , block_rows , streaming );
+        node_row   += rows;
+        block_rows += rows;
+        if (block_rows == block_size) {
+          int buffer = num_blocks % 2;
+          int done   = enkf_main_add_block_tasks( graph , task_args , segments , seg1 , vector_get_size( segments ) ,
+                                                  blocks[ buffer ] , X , serialize_info ,
+                                                  block_done[ buffer ] , block_done[ 1 - buffer ] );
+          block_done[ buffer ] = done;
+          seg1       = vector_get_size( segments );
+          block_rows = 0;
+          num_blocks++;
+        }
+      }
+    }
+
+    if (block_rows > 0) {
+      int buffer = num_blocks % 2;
+      enkf_main_add_block_tasks( graph , task_args , segments , seg1 , vector_get_size( segments ) ,
+                                 blocks[ buffer ] , X , serialize_info ,
+                                 block_done[ buffer ] , block_done[ 1 - buffer ] );
+    }
+  }
+
+  {
+    double start_time = enkf_main_wall_time();
+    task_graph_run( graph );
+    timing->pipelined += enkf_main_wall_time() - start_time;
+  }
+
+  for (int iseg = 0; iseg < vector_get_size( segments ); iseg++) {
+    const update_segment_type * segment = vector_iget_const( segments , iseg );
+    set_add_key( serialize_info->updated_keys , segment->key );
+  }
+
+  for (int b = 0; b < 2; b++) {
+    if (blocks[b])
+      matrix_free( blocks[b] );
+  }
+  vector_free( task_args );
+  vector_free( segments );
+  free( active_size );
+  stringlist_free( update_keys );
+}
+
+
 static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
+                                       enkf_fs_type * source_fs ,
                                        enkf_fs_type * target_fs ,
                                        const bool_vector_type * ens_mask ,
                                        int target_step ,
@@ -1117,18 +1563,23 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                        int step2 ,
                                        const local_ministep_type * ministep ,
                                        const meas_data_type * forecast ,
-                                       obs_data_type * obs_data) {
+                                       obs_data_type * obs_data ,
+                                       set_type * updated_keys ,
+                                       task_graph_type * task_graph ,
+                                       FILE * log_stream) {
 
-  const int cpu_threads       = 4;
+  const int cpu_threads       = task_graph_get_num_threads( task_graph );
   const int matrix_start_size = 250000;
-  thread_pool_type * tp       = thread_pool_alloc( cpu_threads , false );
+  const int block_size        = analysis_config_get_update_block_size( enkf_main->analysis_config );
+  update_timing_type timing   = { 0 };
+  double start_time;
   int active_ens_size   = meas_data_get_active_ens_size( forecast );
   int active_size       = obs_data_get_active_size( obs_data );
   matrix_type * X       = matrix_alloc( active_ens_size , active_ens_size );
   matrix_type * S       = meas_data_allocS( forecast );
   matrix_type * R       = obs_data_allocR( obs_data );
   matrix_type * dObs    = obs_data_allocdObs( obs_data );
-  matrix_type * A       = matrix_alloc( matrix_start_size , active_ens_size );
+  matrix_type * A       = NULL;
   matrix_type * E       = NULL;
   matrix_type * D       = NULL;
   matrix_type * localA  = NULL;
@@ -1138,6 +1589,14 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   if ( local_ministep_has_analysis_module (ministep))
     module = local_ministep_get_analysis_module (ministep);
 
+  /*
+     When the module only needs X the datasets are updated with the
+     pipelined update, which sizes A itself.
+  */
+  bool pipelined = (!analysis_module_check_option( module , ANALYSIS_USE_A) &&
+                    !analysis_module_check_option( module , ANALYSIS_UPDATE_A));
+  A = matrix_alloc( pipelined ? 1 : matrix_start_size , active_ens_size );
+
   assert_matrix_size(X , "X" , active_ens_size , active_ens_size);
   assert_matrix_size(S , "S" , active_size , active_ens_size);
   assert_matrix_size(R , "R" , active_size , active_size);
@@ -1162,7 +1621,7 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   analysis_module_init_update( module , ens_mask , S , R , dObs , E , D );
   {
     hash_iter_type * dataset_iter = local_ministep_alloc_dataset_iter( ministep );
-    serialize_info_type * serialize_info = serialize_info_alloc( target_fs, //src_fs - we have already copied the parameters from the src_fs to the target_fs
+    serialize_info_type * serialize_info = serialize_info_alloc( source_fs ,
                                                                  target_fs ,
                                                                  enkf_main->ensemble_config,
                                                                  iens_active_index,
@@ -1171,6 +1630,7 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                                                  run_mode ,
                                                                  step2 ,
                                                                  A ,
+                                                                 updated_keys ,
                                                                  cpu_threads);
 
 
@@ -1199,38 +1659,57 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
       double_vector_free( singular_values );
     }
 
-    if (localA == NULL)
+    if (localA == NULL) {
+      start_time = enkf_main_wall_time();
       analysis_module_initX( module , X , NULL , S , R , dObs , E , D );
+      timing.initX += enkf_main_wall_time() - start_time;
+    }
 
 
     while (!hash_iter_is_complete( dataset_iter )) {
       const char * dataset_name = hash_iter_get_next_key( dataset_iter );
       const local_dataset_type * dataset = local_ministep_get_dataset( ministep , dataset_name );
-      if (local_dataset_get_size( dataset )) {
+      if (pipelined && local_dataset_get_size( dataset ))
+        enkf_main_update_dataset_pipelined( enkf_main->ensemble_config , dataset , step2 , block_size , A , X , task_graph , serialize_info , &timing );
+      else if (local_dataset_get_size( dataset )) {
         int * active_size = util_calloc( local_dataset_get_size( dataset ) , sizeof * active_size );
         int * row_offset  = util_calloc( local_dataset_get_size( dataset ) , sizeof * row_offset  );
         local_obsdata_type   * local_obsdata = local_ministep_get_obsdata( ministep );
 
-        enkf_main_serialize_dataset( enkf_main->ensemble_config , dataset , step2 ,  use_count , active_size , row_offset , tp , serialize_info);
+        start_time = enkf_main_wall_time();
+        enkf_main_serialize_dataset( enkf_main->ensemble_config , dataset , step2 ,  use_count , active_size , row_offset , task_graph , serialize_info);
+        timing.serialize += enkf_main_wall_time() - start_time;
         module_info_type * module_info = enkf_main_module_info_alloc(ministep, obs_data, dataset, local_obsdata, active_size , row_offset);
 
+        start_time = enkf_main_wall_time();
         if (analysis_module_check_option( module , ANALYSIS_UPDATE_A)){
           if (analysis_module_check_option( module , ANALYSIS_ITERABLE)){
             analysis_module_updateA( module , localA , S , R , dObs , E , D , module_info );
           }
           else
             analysis_module_updateA( module , localA , S , R , dObs , E , D , module_info );
+          timing.initX += enkf_main_wall_time() - start_time;
         }
         else {
           if (analysis_module_check_option( module , ANALYSIS_USE_A)){
             analysis_module_initX( module , X , localA , S , R , dObs , E , D );
+            timing.initX += enkf_main_wall_time() - start_time;
           }
 
-          matrix_inplace_matmul_mt2( A , X , tp );
+          start_time = enkf_main_wall_time();
+          {
+            vector_type * task_args = vector_alloc_new( );
+            enkf_main_add_matmul_tasks( task_graph , task_args , A , X , 0 , matrix_get_rows( A ) , -1 );
+            task_graph_run( task_graph );
+            vector_free( task_args );
+          }
+          timing.matmul += enkf_main_wall_time() - start_time;
         }
 
         // The deserialize also calls enkf_node_store() functions.
-        enkf_main_deserialize_dataset( enkf_main_get_ensemble_config( enkf_main ) , dataset , active_size , row_offset , serialize_info , tp);
+        start_time = enkf_main_wall_time();
+        enkf_main_deserialize_dataset( enkf_main_get_ensemble_config( enkf_main ) , dataset , active_size , row_offset , serialize_info , task_graph);
+        timing.deserialize += enkf_main_wall_time() - start_time;
 
         free( active_size );
         free( row_offset );
@@ -1242,6 +1721,11 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   }
   analysis_module_complete_update( module );
 
+  fprintf(log_stream , "Update timing for ministep:%s with %d threads: serialize:%.3fs  initX:%.3fs  matmul:%.3fs  deserialize:%.3fs  pipelined:%.3fs\n",
+          local_ministep_get_name( ministep ) , cpu_threads , timing.serialize , timing.initX , timing.matmul , timing.deserialize , timing.pipelined);
+  ert_log_add_fmt_message(1 , NULL , "Update timing for ministep:%s with %d threads: serialize:%.3fs  initX:%.3fs  matmul:%.3fs  deserialize:%.3fs  pipelined:%.3fs",
+                          local_ministep_get_name( ministep ) , cpu_threads , timing.serialize , timing.initX , timing.matmul , timing.deserialize , timing.pipelined);
+
 
   /*****************************************************************/
 
@@ -2978,7 +3462,14 @@ int enkf_main_load_from_forward_model_with_fs(enkf_main_type * enkf_main, int it
 
   ert_run_context_type * run_context = ert_run_context_alloc_ENSEMBLE_EXPERIMENT( fs , iactive , model_config_get_runpath_fmt( model_config ) , enkf_main->subst_list , iter );
   arg_pack_type ** arg_list = util_calloc( ens_size , sizeof * arg_list );
-  thread_pool_type * tp     = thread_pool_alloc( 4 , true );  /* num_cpu - HARD coded. */
+  /*
+    The realizations are loaded in parallel by the threads in tp. When
+    only one realization is loaded it is loaded in this thread, and tp
+    is instead used to read the non unified summary files of that
+    realization in parallel.
+  */
+  const bool load_realizations_mt = (bool_vector_count_equal( iactive , true ) > 1);
+  thread_pool_type * tp     = thread_pool_alloc( 4 , load_realizations_mt );  /* num_cpu - HARD coded. */
 
   int iens = 0;
   for (; iens < ens_size; ++iens) {
@@ -2995,12 +3486,18 @@ int enkf_main_load_from_forward_model_with_fs(enkf_main_type * enkf_main, int it
       arg_pack_append_ptr(arg_pack, realizations_msg_list[iens]);                          /* 2: List of interactive mode messages. */
       arg_pack_append_bool( arg_pack, true );                                              /* 3: Manual load */
       arg_pack_append_ptr(arg_pack, &result[iens]);                                        /* 4: Result */
-      thread_pool_add_job( tp , enkf_state_load_from_forward_model_mt , arg_pack);
+      if (load_realizations_mt)
+        thread_pool_add_job( tp , enkf_state_load_from_forward_model_mt , arg_pack);
+      else {
+        arg_pack_append_ptr( arg_pack , tp );                                              /* 5: Thread pool for the summary files. */
+        enkf_state_load_from_forward_model_mt( arg_pack );
+      }
     }
     printf("done\n");
   }
 
-  thread_pool_join( tp );
+  if (load_realizations_mt)
+    thread_pool_join( tp );
   thread_pool_free( tp );
   printf("\n");
 
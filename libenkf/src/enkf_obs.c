@@ -378,6 +378,7 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
   int active_count          = 0;
   int last_step = -1;
   int step = -1;
+  int_vector_type * active_steps = int_vector_alloc( 0 , 0 );
 
   /*1: Determine which report_steps have active observations; and collect the observed values. */
   double_vector_reset( obs_std );
@@ -394,13 +395,16 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
       const summary_obs_type * summary_obs = obs_vector_iget_node( obs_vector , step );
       double_vector_iset( obs_std   , active_count , summary_obs_get_std( summary_obs ) * summary_obs_get_std_scaling( summary_obs ));
       double_vector_iset( obs_value , active_count , summary_obs_get_value( summary_obs ));
+      int_vector_iset( active_steps , active_count , step );
       last_step = step;
       active_count++;
     }
   }
 
-  if (active_count <= 0)
+  if (active_count <= 0) {
+    int_vector_free( active_steps );
     return;
+  }
 
   /*
     2: Estimate a covariance matrix.
@@ -424,43 +428,52 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
     for (int i=0; i < active_count; i++)
       obs_block_iset( obs_block , i , double_vector_iget( obs_value , i) , double_vector_iget( obs_std , i ));
 
-    int active_size = int_vector_size( ens_active_list );
-    active_count = 0;
-    step = -1;
-    while (true) {
-      step = obs_vector_get_next_active_step( obs_vector , step );
-      if (step < 0)
-        break;
-
-      if (local_obsdata_node_tstep_active(obs_node, step)
-          && obs_vector_iget_active( obs_vector , step )
-          && active_list_iget( active_list , 0 /* Index into the scalar summary observation */)) {
-        for (int iens_index = 0; iens_index < active_size; iens_index++) {
-          const int iens = int_vector_iget( ens_active_list , iens_index );
-          node_id_type node_id = {.report_step = step,
-                                  .iens        = iens};
-          enkf_node_load( work_node , fs , node_id );
-
-          int smlength   = summary_length( enkf_node_value_ptr( work_node ) );
-          if (step >= smlength) {
-            // if obs vector and sim vector have different length
-            // deactivate and continue to next
-            char * msg = util_alloc_sprintf("length of observation vector and simulated differ: %d vs. %d ", step, smlength);
-            meas_block_deactivate(meas_block , active_count);
-            obs_block_deactivate(obs_block , active_count, true, msg);
-            free( msg );
-            break;
-          } else {
-            meas_block_iset(meas_block , iens , active_count ,
-                            summary_get( enkf_node_value_ptr( work_node ),
-                                         node_id.report_step ));
+    /*
+      The summary node has vector storage, i.e. one load gives the
+      full time series of one realization; the loop over realizations
+      is therefore the outer loop, and each vector is loaded only once.
+      A report step where one of the simulated vectors is too short is
+      deactivated after all the realizations have been visited, because
+      meas_block_iset() will reactivate the observation.
+    */
+    {
+      int active_size = int_vector_size( ens_active_list );
+      int_vector_type * short_length = int_vector_alloc( active_count , -1 );
+
+      for (int iens_index = 0; iens_index < active_size; iens_index++) {
+        const int iens = int_vector_iget( ens_active_list , iens_index );
+        enkf_node_load_vector( work_node , fs , iens );
+        {
+          const summary_type * summary = enkf_node_value_ptr( work_node );
+          int smlength = summary_length( summary );
+
+          for (int i = 0; i < active_count; i++) {
+            step = int_vector_iget( active_steps , i );
+            if (step >= smlength) {
+              // if obs vector and sim vector have different length
+              // the observation is deactivated below
+              if (int_vector_iget( short_length , i ) < 0)
+                int_vector_iset( short_length , i , smlength );
+            } else
+              meas_block_iset(meas_block , iens , i , summary_get( summary , step ));
           }
         }
-        active_count++;
       }
+
+      for (int i = 0; i < active_count; i++) {
+        int smlength = int_vector_iget( short_length , i );
+        if (smlength >= 0) {
+          char * msg = util_alloc_sprintf("length of observation vector and simulated differ: %d vs. %d ", int_vector_iget( active_steps , i ), smlength);
+          meas_block_deactivate(meas_block , i);
+          obs_block_deactivate(obs_block , i, true, msg);
+          free( msg );
+        }
+      }
+      int_vector_free( short_length );
     }
     enkf_node_free( work_node );
   }
+  int_vector_free( active_steps );
 }
 
 
@@ -29,6 +29,7 @@
 #include <ert/util/path_fmt.h>
 #include <ert/util/thread_pool.h>
 #include <ert/util/hash.h>
+#include <ert/util/vector.h>
 #include <ert/util/util.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/stringlist.h>
@@ -44,6 +45,7 @@
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_vector.h>
 #include <ert/ecl/ecl_endian_flip.h>
 
 #include <ert/sched/sched_file.h>
@@ -560,6 +562,8 @@ static bool enkf_state_internalize_dynamic_eclipse_results(enkf_state_type * enk
         int_vector_resize( time_index , step2 + 1);
 
         const ecl_smspec_type * smspec = ecl_sum_get_smspec(summary);
+        ecl_sum_vector_type * key_vector = ecl_sum_vector_alloc( summary );
+        vector_type * block_nodes = vector_alloc_new( );
 
         for(int i = 0; i < ecl_smspec_num_nodes(smspec); i++) {
             const smspec_node_type * smspec_node = ecl_smspec_iget_node(smspec, i);
@@ -574,11 +578,51 @@ static bool enkf_state_internalize_dynamic_eclipse_results(enkf_state_type * enk
 
                 enkf_node_try_load_vector( node , result_fs , iens );  // Ensure that what is currently on file is loaded before we update.
 
-                enkf_node_forward_load_vector( node , load_context , time_index);
-                enkf_node_store_vector( node , result_fs , iens );
+                /*
+                  The keys are resolved to params indices here, and the
+                  values for all the keys are fetched with one pass over
+                  the summary data below.
+                */
+                if (ecl_sum_vector_add_key( key_vector , key ))
+                  vector_append_ref( block_nodes , node );
+                else {
+                  enkf_node_forward_load_vector( node , load_context , time_index);
+                  enkf_node_store_vector( node , result_fs , iens );
+                }
             }
         }
 
+        {
+          const int num_keys = ecl_sum_vector_get_size( key_vector );
+          int_vector_type * store_index = int_vector_alloc( 0 , 0 );
+          int_vector_type * ministep_index = int_vector_alloc( 0 , 0 );
+
+          for (int store = 0; store < int_vector_size( time_index ); store++) {
+            int summary_step = int_vector_iget( time_index , store );
+            if ((summary_step >= 0) && ecl_sum_has_report_step( summary , summary_step )) {
+              int_vector_append( store_index , store );
+              int_vector_append( ministep_index , ecl_sum_iget_report_end( summary , summary_step ));
+            }
+          }
+
+          {
+            double * block = util_calloc( util_int_max( 1 , num_keys * int_vector_size( ministep_index )) , sizeof * block );
+            ecl_sum_vector_init_double_block( key_vector , ministep_index , block );
+
+            for (int ikey = 0; ikey < num_keys; ikey++) {
+              enkf_node_type * node = vector_iget( block_nodes , ikey );
+              summary_forward_load_block( enkf_node_value_ptr( node ) , store_index , &block[ikey] , num_keys );
+              enkf_node_store_vector( node , result_fs , iens );
+            }
+            free( block );
+          }
+
+          int_vector_free( ministep_index );
+          int_vector_free( store_index );
+        }
+        vector_free( block_nodes );
+        ecl_sum_vector_free( key_vector );
+
         int_vector_free( time_index );
 
         /*
@@ -701,7 +745,7 @@ static void enkf_state_internalize_GEN_DATA(enkf_state_type * enkf_state ,
 
 
 
-static forward_load_context_type * enkf_state_alloc_load_context( const enkf_state_type * state , run_arg_type * run_arg, stringlist_type * messages) {
+static forward_load_context_type * enkf_state_alloc_load_context( const enkf_state_type * state , run_arg_type * run_arg, stringlist_type * messages , thread_pool_type * thread_pool) {
   bool load_summary = ensemble_config_has_impl_type(state->ensemble_config, SUMMARY);
   if (!load_summary) {
     const summary_key_matcher_type * matcher = ensemble_config_get_summary_key_matcher(state->ensemble_config);
@@ -713,11 +757,12 @@ static forward_load_context_type * enkf_state_alloc_load_context( const enkf_sta
     const ecl_config_type * ecl_config = state->shared_info->ecl_config;
     const char * eclbase = enkf_state_get_eclbase( state );
 
-    load_context = forward_load_context_alloc( run_arg,
-                                               load_summary,
-                                               ecl_config ,
-                                               eclbase,
-                                               messages );
+    load_context = forward_load_context_alloc_mt( run_arg,
+                                                  load_summary,
+                                                  ecl_config ,
+                                                  eclbase,
+                                                  messages ,
+                                                  thread_pool );
     return load_context;
   }
 }
@@ -733,9 +778,9 @@ static forward_load_context_type * enkf_state_alloc_load_context( const enkf_sta
 */
 
 
-static int enkf_state_internalize_results(enkf_state_type * enkf_state , run_arg_type * run_arg , stringlist_type * msg_list) {
+static int enkf_state_internalize_results(enkf_state_type * enkf_state , run_arg_type * run_arg , stringlist_type * msg_list , thread_pool_type * thread_pool) {
   model_config_type * model_config = enkf_state->shared_info->model_config;
-  forward_load_context_type * load_context = enkf_state_alloc_load_context( enkf_state , run_arg , msg_list);
+  forward_load_context_type * load_context = enkf_state_alloc_load_context( enkf_state , run_arg , msg_list , thread_pool);
   int report_step;
 
   /*
@@ -780,16 +825,17 @@ static int enkf_state_internalize_results(enkf_state_type * enkf_state , run_arg
 
 
 
-int enkf_state_load_from_forward_model(enkf_state_type * enkf_state ,
-                                       run_arg_type * run_arg ,
-                                       stringlist_type * msg_list) {
+static int enkf_state_load_from_forward_model__(enkf_state_type * enkf_state ,
+                                                run_arg_type * run_arg ,
+                                                stringlist_type * msg_list ,
+                                                thread_pool_type * thread_pool) {
 
   int result = 0;
 
   if (ensemble_config_have_forward_init( enkf_state->ensemble_config ))
     result |= enkf_state_forward_init( enkf_state , run_arg );
 
-  result |= enkf_state_internalize_results( enkf_state , run_arg , msg_list );
+  result |= enkf_state_internalize_results( enkf_state , run_arg , msg_list , thread_pool );
   {
     state_map_type * state_map = enkf_fs_get_state_map( run_arg_get_result_fs( run_arg ) );
     int iens = member_config_get_iens( enkf_state->my_config );
@@ -803,6 +849,13 @@ int enkf_state_load_from_forward_model(enkf_state_type * enkf_state ,
 }
 
 
+int enkf_state_load_from_forward_model(enkf_state_type * enkf_state ,
+                                       run_arg_type * run_arg ,
+                                       stringlist_type * msg_list) {
+  return enkf_state_load_from_forward_model__( enkf_state , run_arg , msg_list , NULL );
+}
+
+
 /**
    Observe that this does not return the loadOK flag; it will load as
    good as it can all the data it should, and be done with it.
@@ -815,12 +868,13 @@ void * enkf_state_load_from_forward_model_mt( void * arg ) {
   stringlist_type * msg_list   = arg_pack_iget_ptr( arg_pack  , 2 );
   bool manual_load             = arg_pack_iget_bool( arg_pack , 3 );
   int * result                 = arg_pack_iget_ptr( arg_pack  , 4 );
+  thread_pool_type * tp        = (arg_pack_size( arg_pack ) > 5) ? arg_pack_iget_ptr( arg_pack , 5 ) : NULL;
   int iens                     = run_arg_get_iens( run_arg );
 
   if (manual_load)
     state_map_update_undefined(enkf_fs_get_state_map( run_arg_get_result_fs(run_arg) ) , iens , STATE_INITIALIZED);
 
-  *result = enkf_state_load_from_forward_model( enkf_state , run_arg , msg_list );
+  *result = enkf_state_load_from_forward_model__( enkf_state , run_arg , msg_list , tp );
   if (*result & REPORT_STEP_INCOMPATIBLE) {
     // If refcase has been used for observations: crash and burn.
     fprintf(stderr,"** Warning the timesteps in refcase and current simulation are not in accordance - something wrong with schedule file?\n");
@@ -538,7 +538,7 @@ void ensemble_config_init_FIELD( ensemble_config_type * ensemble_config , const
       const config_content_node_type * node = config_content_item_iget_node( item , i );
       const char *  key                     = config_content_node_iget( node , 0 );
       const char *  var_type_string         = config_content_node_iget( node , 1 );
-      enkf_config_node_type * config_node;
+      enkf_config_node_type * config_node = NULL;
 
       {
         hash_type * options = hash_alloc();
@@ -617,6 +617,17 @@ void ensemble_config_init_FIELD( ensemble_config_type * ensemble_config , const
         } else
           util_abort("%s: field type: %s is not recognized\n",__func__ , var_type_string);
 
+        {
+          const char * codec_string = hash_safe_get( options , CODEC_KEY );
+          if (codec_string) {
+            buffer_codec_type codec;
+            if (buffer_codec_sscanf( codec_string , &codec ))
+              field_config_set_codec( enkf_config_node_get_ref( config_node ) , codec );
+            else
+              fprintf(stderr,"** Warning: codec:%s for field:%s not recognized - using default ZLIB \n",codec_string , key);
+          }
+        }
+
         hash_free( options );
       }
     }
@@ -391,7 +391,7 @@ void field_copy(const field_type *src , field_type * target ) {
 void field_read_from_buffer(field_type * field , buffer_type * buffer, enkf_fs_type * fs, int report_step) {
   int byte_size = field_config_get_byte_size( field->config );
   enkf_util_assert_buffer_type(buffer , FIELD);
-  buffer_fread_compressed(buffer , buffer_get_remaining_size( buffer ) , field->data , byte_size);
+  buffer_fread_encoded(buffer , buffer_get_remaining_size( buffer ) , field->data , byte_size);
 }
 
 
@@ -534,7 +534,7 @@ void field_ROFF_export(const field_type * field , const char * export_filename,
 bool field_write_to_buffer(const field_type * field , buffer_type * buffer , int report_step) {
   int byte_size = field_config_get_byte_size( field->config );
   buffer_fwrite_int( buffer , FIELD );
-  buffer_fwrite_compressed( buffer , field->data , byte_size );
+  buffer_fwrite_encoded( buffer , field->data , byte_size , field_config_get_sizeof_ctype( field->config ) , field_config_get_codec( field->config ));
   return true;
 }
 
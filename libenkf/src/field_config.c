@@ -142,6 +142,7 @@ struct field_config_struct {
   ecl_data_type           internal_data_type;
   bool                    __enkf_mode;          /* See doc of functions field_config_set_key() / field_config_enkf_OFF() */
   bool                    write_compressed;
+  buffer_codec_type       codec;                /* How the data are encoded when stored in the enkf_fs filesystem. */
 
   field_type_enum           type;
   field_type              * min_std;
@@ -428,6 +429,7 @@ field_config_type * field_config_alloc_empty( const char * ecl_kw_name , ecl_gri
   config->__enkf_mode         = true;
   config->grid                = NULL;
   config->write_compressed    = true;
+  config->codec               = buffer_codec_default();
   config->type                = UNKNOWN_FIELD_TYPE;
 
   config->output_transform      = NULL;
@@ -652,6 +654,14 @@ void field_config_get_ijk( const field_config_type * config , int active_index ,
 bool field_config_write_compressed(const field_config_type * config) { return config->write_compressed; }
 
 
+buffer_codec_type field_config_get_codec(const field_config_type * config) { return config->codec; }
+
+
+void field_config_set_codec(field_config_type * config , buffer_codec_type codec) {
+  config->codec = codec;
+}
+
+
 
 void field_config_set_truncation(field_config_type * config , int truncation, double min_value, double max_value) {
   config->truncation = truncation;
@@ -1028,6 +1038,12 @@ void field_config_fprintf_config( const field_config_type * config ,
 
   if (config->truncation & TRUNCATE_MAX)
     fprintf( stream , CONFIG_FLOAT_OPTION_FORMAT , MAX_KEY , config->max_value );
+
+  if (!buffer_codec_is_default( config->codec )) {
+    char * codec_string = buffer_codec_alloc_string( config->codec );
+    fprintf( stream , CONFIG_OPTION_FORMAT , CODEC_KEY , codec_string );
+    free( codec_string );
+  }
 }
 
 
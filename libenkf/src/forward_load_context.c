@@ -18,6 +18,7 @@
 
 #include <ert/util/type_macros.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/thread_pool.h>
 
 #include <ert/enkf/enkf_defaults.h>
 #include <ert/enkf/forward_load_context.h>
@@ -40,6 +41,7 @@ struct forward_load_context_struct {
   int step1;
   int step2;
   stringlist_type * messages;          // This is managed by external scope - can be NULL
+  thread_pool_type * thread_pool;      // Loads the summary files in parallel; managed by external scope - can be NULL
 
 
   /* The variables below are updated during the load process. */
@@ -72,26 +74,43 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
       /* Use several non unified files. */
       /* Bypassing the query to model_config_load_results() */
       int report_step = run_arg_get_load_start( run_arg );
+      stringlist_type * summary_files = stringlist_alloc_new();
       if (report_step == 0)
         report_step++;     // Ignore looking for the .S0000 summary file (it does not exist).
-      while (true) {
-        char * summary_file = ecl_util_alloc_exfilename(run_arg_get_runpath( run_arg ) , eclbase , ECL_SUMMARY_FILE , fmt_file ,  report_step);
 
-        if (summary_file != NULL)
-          stringlist_append_owned_ref( data_files , summary_file);
-        else
+      /*
+        The summary files are found with one listing of the runpath
+        directory, instead of checking for the existence of one file
+        at a time; on a network filesystem each check is a roundtrip
+        to the server.
+      */
+      ecl_util_select_filelist( run_path , eclbase , ECL_SUMMARY_FILE , fmt_file , summary_files );
+      for (int i = 0; i < stringlist_get_size( summary_files ); i++) {
+        const char * summary_file = stringlist_iget( summary_files , i );
+        int file_report_step;
+        ecl_util_get_file_type( summary_file , NULL , &file_report_step );
+
+        if (file_report_step < report_step)
+          continue;
+
+        if (file_report_step > report_step)
           /*
              We stop the loading at first 'hole' in the series of summary files;
              the internalize layer must report failure if we are missing data.
           */
           break;
 
+        stringlist_append_copy( data_files , summary_file );
         report_step++;
       }
+      stringlist_free( summary_files );
     }
 
     if ((header_file != NULL) && (stringlist_get_size(data_files) > 0)) {
-      summary = ecl_sum_fread_alloc(header_file , data_files , SUMMARY_KEY_JOIN_STRING );
+      if (load_context->thread_pool)
+        summary = ecl_sum_fread_alloc_mt(header_file , data_files , SUMMARY_KEY_JOIN_STRING , load_context->thread_pool );
+      else
+        summary = ecl_sum_fread_alloc(header_file , data_files , SUMMARY_KEY_JOIN_STRING );
       {
         time_t end_time = ecl_config_get_end_date( load_context->ecl_config );
         if (end_time > 0) {
@@ -134,7 +153,13 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
 
 
 
-forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages) {
+/*
+  The non unified summary files are loaded in parallel by the threads
+  in @thread_pool; the pool must not be used by anyone else while the
+  load context is allocated. Pass NULL to load the files serially.
+*/
+
+forward_load_context_type * forward_load_context_alloc_mt( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages , thread_pool_type * thread_pool) {
   forward_load_context_type * load_context = util_malloc( sizeof * load_context );
   UTIL_TYPE_ID_INIT( load_context , FORWARD_LOAD_CONTEXT_TYPE_ID );
 
@@ -144,6 +169,7 @@ forward_load_context_type * forward_load_context_alloc( const run_arg_type * run
   load_context->load_step = -1;  // Invalid - must call forward_load_context_select_step()
   load_context->load_result = 0;
   load_context->messages = messages;
+  load_context->thread_pool = thread_pool;
   load_context->ecl_config = ecl_config;
   load_context->eclbase = util_alloc_string_copy( eclbase );
 
@@ -154,6 +180,11 @@ forward_load_context_type * forward_load_context_alloc( const run_arg_type * run
 }
 
 
+forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages) {
+  return forward_load_context_alloc_mt( run_arg , load_summary , ecl_config , eclbase , messages , NULL );
+}
+
+
 
 bool forward_load_context_accept_messages( const forward_load_context_type * load_context ) {
   if (load_context->messages)
@@ -151,7 +151,11 @@ bool gen_data_write_to_buffer(const gen_data_type * gen_data , buffer_type * buf
       buffer_fwrite_int( buffer , size );
       buffer_fwrite_int( buffer , report_step);   /* Why the heck do I need to store this ????  It was a mistake ...*/
 
-      buffer_fwrite_compressed( buffer , gen_data->data , byte_size);
+      buffer_fwrite_encoded( buffer ,
+                             gen_data->data ,
+                             byte_size ,
+                             ecl_type_get_sizeof_ctype( gen_data_config_get_internal_data_type( gen_data->config )) ,
+                             gen_data_config_get_codec( gen_data->config ));
       return true;
     } else
       return false;   /* When false is returned - the (empty) file will be removed */
@@ -169,7 +173,7 @@ void gen_data_read_from_buffer(gen_data_type * gen_data , buffer_type * buffer ,
     size_t byte_size       = size * ecl_type_get_sizeof_ctype( gen_data_config_get_internal_data_type ( gen_data->config ));
     size_t compressed_size = buffer_get_remaining_size( buffer );
     gen_data->data         = util_realloc( gen_data->data , byte_size );
-    buffer_fread_compressed( buffer , compressed_size , gen_data->data , byte_size );
+    buffer_fread_encoded( buffer , compressed_size , gen_data->data , byte_size );
   }
   gen_data_assert_size( gen_data , size , report_step );
 
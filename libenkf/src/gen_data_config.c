@@ -66,6 +66,7 @@ struct gen_data_config_struct {
   int                            template_buffer_size;  /* The total size (bytes) of the template buffer .*/
   gen_data_file_format_type      input_format;          /* The format used for loading gen_data instances when the forward model has completed *AND* for loading the initial files.*/
   gen_data_file_format_type      output_format;         /* The format used when gen_data instances are written to disk for the forward model. */
+  buffer_codec_type              codec;                 /* How the data are encoded when stored in the enkf_fs filesystem. */
   int_vector_type              * data_size_vector;      /* Data size, i.e. number of elements , indexed with report_step */
   int_vector_type              * active_report_steps;   /* The report steps where we expect to load data for this instance. */
   pthread_mutex_t                update_lock;
@@ -134,6 +135,16 @@ int gen_data_config_get_byte_size( const gen_data_config_type * config , int rep
 }
 
 
+buffer_codec_type gen_data_config_get_codec( const gen_data_config_type * config ) {
+  return config->codec;
+}
+
+
+void gen_data_config_set_codec( gen_data_config_type * config , buffer_codec_type codec ) {
+  config->codec = codec;
+}
+
+
 
 static void gen_data_config_reset_template( gen_data_config_type * config ) {
   util_safe_free( config->template_buffer );
@@ -165,6 +176,7 @@ static gen_data_config_type * gen_data_config_alloc( const char * key , bool dyn
   memcpy(&config->internal_type, &data_type, sizeof data_type);
   config->input_format       = GEN_DATA_UNDEFINED;
   config->output_format      = GEN_DATA_UNDEFINED;
+  config->codec              = buffer_codec_default();
   config->data_size_vector   = int_vector_alloc( 0 , -1 );   /* The default value: -1 - indicates "NOT SET" */
   config->active_report_steps= int_vector_alloc( 0 , 0 );
   config->active_mask        = bool_vector_alloc(0 , true ); /* Elements are explicitly set to FALSE - this MUST default to true. */
@@ -646,6 +658,12 @@ void gen_data_config_fprintf_config( const gen_data_config_type * config , enkf_
 
   if (config->output_format != GEN_DATA_UNDEFINED)
     fprintf( stream , CONFIG_OPTION_FORMAT , OUTPUT_FORMAT_KEY , gen_data_config_format_name( config->output_format ));
+
+  if (!buffer_codec_is_default( config->codec )) {
+    char * codec_string = buffer_codec_alloc_string( config->codec );
+    fprintf( stream , CONFIG_OPTION_FORMAT , CODEC_KEY , codec_string );
+    free( codec_string );
+  }
 }
 
 
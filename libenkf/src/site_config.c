@@ -637,6 +637,22 @@ int site_config_get_max_submit(const site_config_type * site_config) {
   return job_queue_get_max_submit(site_config->job_queue);
 }
 
+void site_config_set_submit_threads(site_config_type * site_config, int submit_threads) {
+  job_queue_set_submit_threads(site_config->job_queue, submit_threads);
+}
+
+int site_config_get_submit_threads(const site_config_type * site_config) {
+  return job_queue_get_submit_threads(site_config->job_queue);
+}
+
+void site_config_set_max_submit_rate(site_config_type * site_config, double max_submit_rate) {
+  job_queue_set_max_submit_rate(site_config->job_queue, max_submit_rate);
+}
+
+double site_config_get_max_submit_rate(const site_config_type * site_config) {
+  return job_queue_get_max_submit_rate(site_config->job_queue);
+}
+
 static void site_config_install_job_queue(site_config_type * site_config) {
   /*
      All the various driver options are set, unconditionally of which
@@ -719,6 +735,12 @@ bool site_config_init(site_config_type * site_config, const config_content_type
   if (config_content_has_item(config, MAX_SUBMIT_KEY))
     site_config_set_max_submit(site_config, config_content_get_value_as_int(config, MAX_SUBMIT_KEY));
 
+  if (config_content_has_item(config, SUBMIT_THREADS_KEY))
+    site_config_set_submit_threads(site_config, config_content_get_value_as_int(config, SUBMIT_THREADS_KEY));
+
+  if (config_content_has_item(config, MAX_SUBMIT_RATE_KEY))
+    site_config_set_max_submit_rate(site_config, config_content_get_value_as_double(config, MAX_SUBMIT_RATE_KEY));
+
 
   /* LSF options */
   {
@@ -872,6 +894,14 @@ void site_config_add_queue_config_items(config_parser_type * config, bool site_m
   item = config_add_schema_item(config, MAX_SUBMIT_KEY, false);
   config_schema_item_set_argc_minmax(item, 1, 1);
   config_schema_item_iset_type(item, 0, CONFIG_INT);
+
+  item = config_add_schema_item(config, SUBMIT_THREADS_KEY, false);
+  config_schema_item_set_argc_minmax(item, 1, 1);
+  config_schema_item_iset_type(item, 0, CONFIG_INT);
+
+  item = config_add_schema_item(config, MAX_SUBMIT_RATE_KEY, false);
+  config_schema_item_set_argc_minmax(item, 1, 1);
+  config_schema_item_iset_type(item, 0, CONFIG_FLOAT);
 }
 
 void site_config_add_config_items(config_parser_type * config, bool site_mode) {
@@ -305,11 +305,30 @@ bool summary_forward_load_vector(summary_type * summary ,
 
 
 
+/*
+  Alternative to summary_forward_load_vector() used when many summary
+  vectors are internalized from the same ecl_sum instance; the values
+  have already been fetched with ecl_sum_init_double_block(). @column
+  points to the value of this key for the first element of
+  @store_index, and the values for consecutive elements are @stride
+  elements apart. The load_fail semantics are as in
+  summary_forward_load_vector() for a key which is present in the
+  summary case.
+*/
 
+bool summary_forward_load_block(summary_type * summary ,
+                                const int_vector_type * store_index ,
+                                const double * column ,
+                                int stride) {
+  load_fail_type load_fail_action = summary_config_get_load_fail_mode(summary->config );
+  if (load_fail_action == LOAD_FAIL_EXIT)
+    return false;
 
+  for (int i = 0; i < int_vector_size( store_index ); i++)
+    double_vector_iset( summary->data_vector , int_vector_iget( store_index , i ) , column[ i * stride ]);
 
-
-
+  return true;
+}
 
 
 /******************************************************************/
@@ -58,6 +58,23 @@ int main(int argc , char ** argv) {
   active_list_copy( active_list1 , active_list2 );
   test_assert_true(active_list_equal( active_list1 , active_list2 ));
 
+  {
+    active_list_type * all_active = active_list_alloc( );
+    active_list_type * sublist = active_list_alloc_sublist( all_active , 5 , 3 );
+    test_assert_int_equal( active_list_get_mode( sublist ) , PARTLY_ACTIVE );
+    test_assert_int_equal( active_list_get_active_size( sublist , 100 ) , 3 );
+    test_assert_int_equal( active_list_get_active( sublist )[0] , 5 );
+    test_assert_int_equal( active_list_get_active( sublist )[2] , 7 );
+    active_list_free( sublist );
+
+    sublist = active_list_alloc_sublist( active_list1 , 1 , 3 );
+    test_assert_int_equal( active_list_get_active_size( sublist , 100 ) , 3 );
+    test_assert_int_equal( active_list_get_active( sublist )[0] , 12 );
+    test_assert_int_equal( active_list_get_active( sublist )[2] , 27 );
+    active_list_free( sublist );
+    active_list_free( all_active );
+  }
+
   active_list_free( active_list1 );
   active_list_free( active_list2 );
   exit(0);
@@ -186,6 +186,30 @@ void test_min_realizations_number() {
   }
 }
 
+void test_update_threads( ) {
+  analysis_config_type * ac = create_analysis_config( );
+  test_assert_int_equal( analysis_config_get_update_threads( ac ) , sysconf( _SC_NPROCESSORS_ONLN ));
+
+  analysis_config_set_update_threads( ac , 7 );
+  test_assert_int_equal( 7 , analysis_config_get_update_threads( ac ) );
+
+  analysis_config_set_update_threads( ac , 0 );
+  test_assert_int_equal( analysis_config_get_update_threads( ac ) , sysconf( _SC_NPROCESSORS_ONLN ));
+  analysis_config_free( ac );
+}
+
+void test_update_block_size( ) {
+  analysis_config_type * ac = create_analysis_config( );
+  test_assert_int_equal( analysis_config_get_update_block_size( ac ) , 0 );
+
+  analysis_config_set_update_block_size( ac , 1000 );
+  test_assert_int_equal( 1000 , analysis_config_get_update_block_size( ac ) );
+
+  analysis_config_set_update_block_size( ac , -1 );
+  test_assert_int_equal( 0 , analysis_config_get_update_block_size( ac ) );
+  analysis_config_free( ac );
+}
+
 int main(int argc , char ** argv) {
   test_create();
   test_have_enough_realisations_defaulted();
@@ -193,6 +217,8 @@ int main(int argc , char ** argv) {
   test_min_realizations_number();
   test_current_module_options();
   test_stop_long_running();
+  test_update_threads();
+  test_update_block_size();
   exit(0);
 }
 
@@ -18,6 +18,9 @@
 #include <stdlib.h>
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_sum.h>
 
 #include <ert/enkf/forward_load_context.h>
 #include <ert/enkf/run_arg.h>
@@ -94,6 +97,61 @@ void test_load_restart2() {
 
 
 
+void make_summary_mock( const char * case_name , int num_steps ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( case_name , false , false , ":" , util_make_date_utc( 1,1,2010 ) , true , 10 , 10 , 10 );
+  smspec_node_type * node = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "Barrels" , 0.0 );
+
+  for (int report_step = 1; report_step <= num_steps; report_step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step , report_step * 86400.0 );
+    ecl_sum_tstep_set_from_node( tstep , node , report_step );
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+/*
+  The non unified summary files are loaded with and without a thread
+  pool; the pool is reused for the second parallel load.
+*/
+
+void test_load_summary_mt() {
+  test_work_area_type * work_area = test_work_area_alloc("forward_load_summary");
+  {
+    const int num_steps = 12;
+    run_arg_type * run_arg = run_arg_alloc_ENSEMBLE_EXPERIMENT(NULL , 0 , 0 , "run");
+    ecl_config_type * ecl_config = ecl_config_alloc( );
+    thread_pool_type * thread_pool = thread_pool_alloc( 4 , false );
+    forward_load_context_type * load_context;
+
+    ecl_config_set_eclbase( ecl_config , "BASE" );
+    util_make_path("run");
+    make_summary_mock( "run/BASE" , num_steps );
+
+    load_context = forward_load_context_alloc( run_arg , true , ecl_config , "BASE" , NULL );
+    test_assert_int_equal( forward_load_context_get_result( load_context ) , 0 );
+    test_assert_int_equal( ecl_sum_get_data_length( forward_load_context_get_ecl_sum( load_context )) , num_steps );
+    forward_load_context_free( load_context );
+
+    for (int i = 0; i < 2; i++) {
+      const ecl_sum_type * ecl_sum;
+      load_context = forward_load_context_alloc_mt( run_arg , true , ecl_config , "BASE" , NULL , thread_pool );
+      ecl_sum = forward_load_context_get_ecl_sum( load_context );
+      test_assert_int_equal( forward_load_context_get_result( load_context ) , 0 );
+      test_assert_int_equal( ecl_sum_get_data_length( ecl_sum ) , num_steps );
+      for (int time_index = 0; time_index < num_steps; time_index++)
+        test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , time_index , "FOPT" ) , time_index + 1 );
+      forward_load_context_free( load_context );
+    }
+
+    thread_pool_free( thread_pool );
+    ecl_config_free( ecl_config );
+    run_arg_free( run_arg );
+  }
+  test_work_area_free( work_area );
+}
+
+
 void test_add_message() {
   {
     forward_load_context_type * load_context = forward_load_context_alloc( NULL , false , NULL , NULL , NULL);
@@ -126,6 +184,7 @@ int main(int argc , char ** argv) {
   test_create();
   test_load_restart1();
   test_load_restart2();
+  test_load_summary_mt();
   test_add_message();
   test_update_result();
   exit(0);
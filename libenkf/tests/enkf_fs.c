@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <pthread.h>
@@ -29,7 +30,11 @@
 
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.h>
+#include <ert/util/buffer.h>
+#include <ert/util/util.h>
 #include <ert/enkf/enkf_fs.h>
+#include <ert/enkf/fs_driver.h>
+#include <ert/enkf/block_fs_driver.h>
 
 
 typedef struct
@@ -75,6 +80,197 @@ void test_refcount() {
   test_work_area_free( work_area );
 }
 
+static void fwrite_int_node( enkf_fs_type * fs , const char * key , enkf_var_type var_type , int report_step , int iens) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  buffer_fwrite_int( buffer , 1000 * report_step + iens );
+  if (report_step < 0)
+    enkf_fs_fwrite_vector( fs , buffer , key , var_type , iens );
+  else
+    enkf_fs_fwrite_node( fs , buffer , key , var_type , report_step , iens );
+  buffer_free( buffer );
+}
+
+
+static void assert_int_node( enkf_fs_type * fs , const char * key , enkf_var_type var_type , int report_step , int iens) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  if (report_step < 0) {
+    test_assert_true( enkf_fs_has_vector( fs , key , var_type , iens ));
+    enkf_fs_fread_vector( fs , buffer , key , var_type , iens );
+  } else {
+    test_assert_true( enkf_fs_has_node( fs , key , var_type , report_step , iens ));
+    enkf_fs_fread_node( fs , buffer , key , var_type , report_step , iens );
+  }
+  test_assert_int_equal( buffer_fread_int( buffer ) , 1000 * report_step + iens );
+  buffer_free( buffer );
+}
+
+
+void test_fwrite_fread() {
+  test_work_area_type * work_area = test_work_area_alloc("enkf_fs/fwrite_fread");
+  const int ens_size = 25;
+  char long_key[301];    /* Longer than the key buffer in the block_fs driver. */
+
+  memset( long_key , 'K' , 300 );
+  long_key[300] = '\0';
+  enkf_fs_create_fs("mnt" , BLOCK_FS_DRIVER_ID , NULL , false);
+  for (int mount = 0; mount < 2; mount++) {
+    enkf_fs_type * fs = enkf_fs_mount( "mnt" );
+    if (mount == 0) {
+      for (int iens = 0; iens < ens_size; iens++) {
+        fwrite_int_node( fs , "PERMX" , PARAMETER , 0 , iens );
+        fwrite_int_node( fs , "FOPR" , DYNAMIC_RESULT , -1 , iens );
+        for (int step = 1; step < 10; step += 3)
+          fwrite_int_node( fs , "PRESSURE" , DYNAMIC_RESULT , step , iens );
+        fwrite_int_node( fs , long_key , DYNAMIC_RESULT , 5 , iens );
+        fwrite_int_node( fs , long_key , DYNAMIC_RESULT , -1 , iens );
+      }
+      /* Rewriting an existing node. */
+      fwrite_int_node( fs , "PERMX" , PARAMETER , 0 , 3 );
+    }
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      assert_int_node( fs , "PERMX" , PARAMETER , 0 , iens );
+      assert_int_node( fs , "FOPR" , DYNAMIC_RESULT , -1 , iens );
+      for (int step = 1; step < 10; step += 3)
+        assert_int_node( fs , "PRESSURE" , DYNAMIC_RESULT , step , iens );
+      assert_int_node( fs , long_key , DYNAMIC_RESULT , 5 , iens );
+      assert_int_node( fs , long_key , DYNAMIC_RESULT , -1 , iens );
+      test_assert_false( enkf_fs_has_node( fs , "PRESSURE" , DYNAMIC_RESULT , 2 , iens ));
+      test_assert_false( enkf_fs_has_node( fs , "PRESSURE" , DYNAMIC_RESULT , 100 , iens ));
+    }
+    test_assert_false( enkf_fs_has_node( fs , "PERMX" , PARAMETER , 0 , ens_size ));
+    test_assert_false( enkf_fs_has_vector( fs , "PERMY" , PARAMETER , 0 ));
+    enkf_fs_decref( fs );
+  }
+  test_work_area_free( work_area );
+}
+
+
+void test_copy_node() {
+  test_work_area_type * work_area = test_work_area_alloc("enkf_fs/copy_node");
+  const int ens_size = 10;
+
+  enkf_fs_create_fs("src" , BLOCK_FS_DRIVER_ID , NULL , false);
+  enkf_fs_create_fs("target" , BLOCK_FS_DRIVER_ID , NULL , false);
+  {
+    enkf_fs_type * src_fs    = enkf_fs_mount( "src" );
+    enkf_fs_type * target_fs = enkf_fs_mount( "target" );
+    buffer_type * buffer     = buffer_alloc( 10 );
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      fwrite_int_node( src_fs , "PERMX" , PARAMETER , 0 , iens );
+      fwrite_int_node( src_fs , "PRESSURE" , DYNAMIC_RESULT , 5 , iens );
+    }
+
+    for (int iens = 0; iens < ens_size; iens += 2) {
+      enkf_fs_copy_node( src_fs , target_fs , buffer , "PERMX" , PARAMETER , 0 , iens );
+      enkf_fs_copy_node( src_fs , target_fs , buffer , "PRESSURE" , DYNAMIC_RESULT , 5 , iens );
+    }
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      if ((iens % 2) == 0) {
+        assert_int_node( target_fs , "PERMX" , PARAMETER , 0 , iens );
+        assert_int_node( target_fs , "PRESSURE" , DYNAMIC_RESULT , 5 , iens );
+      } else {
+        test_assert_false( enkf_fs_has_node( target_fs , "PERMX" , PARAMETER , 0 , iens ));
+        test_assert_false( enkf_fs_has_node( target_fs , "PRESSURE" , DYNAMIC_RESULT , 5 , iens ));
+      }
+      assert_int_node( src_fs , "PERMX" , PARAMETER , 0 , iens );
+    }
+
+    buffer_free( buffer );
+    enkf_fs_decref( target_fs );
+    enkf_fs_decref( src_fs );
+  }
+  test_work_area_free( work_area );
+}
+
+
+/*
+  Nodes written through the node_id functions are found by the string
+  keyed fs_driver functions, and vice versa.
+*/
+
+void test_node_id() {
+  test_work_area_type * work_area = test_work_area_alloc("enkf_fs/node_id");
+  const int ens_size = 10;
+  block_fs_driver_type * driver;
+  fs_driver_type * fs_driver;
+
+  {
+    FILE * stream = util_fopen( "fstab" , "w");
+    block_fs_driver_create_fs( stream , "mnt" , DRIVER_PARAMETER , 4 , "mod_%d" , "PARAMETER");
+    fclose( stream );
+
+    stream = util_fopen( "fstab" , "r");
+    test_assert_int_equal( util_fread_int( stream ) , DRIVER_PARAMETER );
+    driver = block_fs_driver_open( stream , "mnt" , DRIVER_PARAMETER , false );
+    fclose( stream );
+  }
+  fs_driver = (fs_driver_type *) driver;
+  {
+    int permx_id = block_fs_driver_get_node_id( driver , "PERMX" );
+    int poro_id  = block_fs_driver_get_node_id( driver , "PORO" );
+    buffer_type * buffer = buffer_alloc( 10 );
+
+    test_assert_int_not_equal( permx_id , poro_id );
+    test_assert_int_equal( permx_id , block_fs_driver_get_node_id( driver , "PERMX" ));
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      buffer_clear( buffer );
+      buffer_fwrite_int( buffer , iens );
+      block_fs_driver_save_node_id( driver , permx_id , 0 , iens , buffer );
+      block_fs_driver_save_node_id( driver , permx_id , -1 , iens , buffer );
+      fs_driver->save_node( driver , "PORO" , 12 , iens , buffer );
+    }
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      test_assert_true( fs_driver->has_node( driver , "PERMX" , 0 , iens ));
+      test_assert_true( block_fs_driver_has_node_id( driver , poro_id , 12 , iens ));
+      test_assert_false( block_fs_driver_has_node_id( driver , poro_id , 1 , iens ));
+
+      fs_driver->load_node( driver , "PERMX" , -1 , iens , buffer );
+      test_assert_int_equal( buffer_fread_int( buffer ) , iens );
+      block_fs_driver_load_node_id( driver , poro_id , 12 , iens , buffer );
+      test_assert_int_equal( buffer_fread_int( buffer ) , iens );
+    }
+
+    block_fs_driver_unlink_node_id( driver , permx_id , 0 , 3 );
+    test_assert_false( fs_driver->has_node( driver , "PERMX" , 0 , 3 ));
+    test_assert_true( fs_driver->has_node( driver , "PERMX" , -1 , 3 ));
+
+    buffer_free( buffer );
+  }
+  fs_driver->free_driver( driver );
+  test_work_area_free( work_area );
+}
+
+
+void test_sscanf_key() {
+  char * config_key;
+  int report_step , iens;
+
+  test_assert_true( block_fs_sscanf_key( "PERMX.10.317" , &config_key , &report_step , &iens ));
+  test_assert_string_equal( config_key , "PERMX" );
+  test_assert_int_equal( report_step , 10 );
+  test_assert_int_equal( iens , 317 );
+  free( config_key );
+
+  test_assert_true( block_fs_sscanf_key( "WOPR.OP_1.0.5" , &config_key , &report_step , &iens ));
+  test_assert_string_equal( config_key , "WOPR.OP_1" );
+  test_assert_int_equal( report_step , 0 );
+  test_assert_int_equal( iens , 5 );
+  free( config_key );
+
+  test_assert_false( block_fs_sscanf_key( "PERMX.317" , &config_key , &report_step , &iens ));
+  test_assert_NULL( config_key );
+  test_assert_false( block_fs_sscanf_key( "PERMX.X.317" , &config_key , &report_step , &iens ));
+  test_assert_false( block_fs_sscanf_key( "PERMX.10.31X" , &config_key , &report_step , &iens ));
+  test_assert_false( block_fs_sscanf_key( ".10.317" , &config_key , &report_step , &iens ));
+  test_assert_false( block_fs_sscanf_key( "PERMX" , &config_key , &report_step , &iens ));
+}
+
+
 void createFS() {
 
  pthread_mutex_lock(&data->mutex1);
@@ -151,6 +347,10 @@ void test_read_only2() {
 int main(int argc, char ** argv) {
   test_mount();
   test_refcount();
+  test_fwrite_fread();
+  test_copy_node();
+  test_node_id();
+  test_sscanf_key();
   test_read_only2();
   exit(0);
 }
@@ -0,0 +1,103 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_site_config_submit.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/config/config_parser.h>
+#include <ert/config/config_content.h>
+
+#include <ert/enkf/site_config.h>
+
+
+#define INCLUDE_KEY "INCLUDE"
+#define DEFINE_KEY  "DEFINE"
+
+
+/*
+  The SUBMIT_THREADS and MAX_SUBMIT_RATE keywords are parsed from a
+  site config written in the test area, and end up in the job_queue.
+*/
+
+static void parse_config( site_config_type * site_config , const char * config_file ) {
+  config_parser_type * config = config_alloc();
+  config_content_type * content;
+
+  site_config_add_config_items( config , false );
+  content = config_parse(config , config_file , "--" , INCLUDE_KEY , DEFINE_KEY , NULL , CONFIG_UNRECOGNIZED_IGNORE , true);
+  test_assert_true( config_content_is_valid( content ));
+  site_config_init( site_config , content );
+
+  config_content_free( content );
+  config_free( config );
+}
+
+
+void test_defaults() {
+  test_work_area_type * test_area = test_work_area_alloc("site-config-submit");
+  site_config_type * site_config = site_config_alloc_empty();
+
+  test_assert_int_equal( site_config_get_submit_threads( site_config ) , 4 );
+  test_assert_double_equal( site_config_get_max_submit_rate( site_config ) , 0 );
+  {
+    FILE * stream = util_fopen("config" , "w");
+    fprintf(stream , "MAX_SUBMIT 3\n");
+    fclose( stream );
+  }
+  parse_config( site_config , "config" );
+  test_assert_int_equal( site_config_get_submit_threads( site_config ) , 4 );
+  test_assert_double_equal( site_config_get_max_submit_rate( site_config ) , 0 );
+
+  site_config_free( site_config );
+  test_work_area_free( test_area );
+}
+
+
+void test_submit_options() {
+  test_work_area_type * test_area = test_work_area_alloc("site-config-submit");
+  site_config_type * site_config = site_config_alloc_empty();
+  {
+    FILE * stream = util_fopen("config" , "w");
+    fprintf(stream , "SUBMIT_THREADS 8\n");
+    fprintf(stream , "MAX_SUBMIT_RATE 2.5\n");
+    fclose( stream );
+  }
+  parse_config( site_config , "config" );
+  test_assert_int_equal( site_config_get_submit_threads( site_config ) , 8 );
+  test_assert_double_equal( site_config_get_max_submit_rate( site_config ) , 2.5 );
+
+  site_config_set_submit_threads( site_config , 2 );
+  site_config_set_max_submit_rate( site_config , 10 );
+  test_assert_int_equal( site_config_get_submit_threads( site_config ) , 2 );
+  test_assert_double_equal( site_config_get_max_submit_rate( site_config ) , 10 );
+
+  site_config_free( site_config );
+  test_work_area_free( test_area );
+}
+
+
+int main(int argc , char ** argv) {
+  util_install_signals();
+  test_defaults();
+  test_submit_options();
+  exit(0);
+}
@@ -2,6 +2,10 @@ add_executable( enkf_runpath_list enkf_runpath_list.c )
 target_link_libraries( enkf_runpath_list enkf  )
 add_test( enkf_runpath_list  ${EXECUTABLE_OUTPUT_PATH}/enkf_runpath_list ${CMAKE_CURRENT_SOURCE_DIR}/data/config/runpath_list/config )
 
+add_executable( enkf_site_config_submit enkf_site_config_submit.c )
+target_link_libraries( enkf_site_config_submit enkf  )
+add_test( enkf_site_config_submit ${EXECUTABLE_OUTPUT_PATH}/enkf_site_config_submit )
+
 add_executable( enkf_plot_tvector enkf_plot_tvector.c )
 target_link_libraries( enkf_plot_tvector enkf  )
 add_test( enkf_plot_tvector ${EXECUTABLE_OUTPUT_PATH}/enkf_plot_tvector)
@@ -0,0 +1,141 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'block_fs_read_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+#include <ert/util/buffer.h>
+#include <ert/util/arg_pack.h>
+#include <ert/util/thread_pool.h>
+#include <ert/util/block_fs.h>
+
+/*
+  Benchmark of concurrent reads from one block_fs mount:
+
+    bash% block_fs_read_bench MOUNT_FILE [ens_size] [field_size]
+
+  If the mount does not already contain them, ens_size nodes
+  FIELD.0.<iens> with field_size float values each are written - this
+  is the layout of one FIELD keyword for an ensemble. The full ensemble
+  is then read back with 1, 2, 4, ..., 32 threads, each thread reading
+  a contiguous range of realizations, and the time and read rate are
+  reported.
+*/
+
+#define MAX_THREADS 32
+
+
+static char * alloc_node_key( int iens ) {
+  return util_alloc_sprintf("FIELD.0.%d" , iens);
+}
+
+
+static void * read_range( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  block_fs_type * block_fs = arg_pack_iget_ptr( arg_pack , 0 );
+  int iens1 = arg_pack_iget_int( arg_pack , 1 );
+  int iens2 = arg_pack_iget_int( arg_pack , 2 );
+  buffer_type * buffer = buffer_alloc( 1024 );
+
+  for (int iens = iens1; iens < iens2; iens++) {
+    char * key = alloc_node_key( iens );
+    block_fs_fread_realloc_buffer( block_fs , key , buffer );
+    free( key );
+  }
+
+  buffer_free( buffer );
+  return NULL;
+}
+
+
+static void write_ensemble( block_fs_type * block_fs , int ens_size , int field_size) {
+  float * data = util_calloc( field_size , sizeof * data );
+  for (int iens = 0; iens < ens_size; iens++) {
+    char * key = alloc_node_key( iens );
+    if (!block_fs_has_file( block_fs , key )) {
+      for (int i = 0; i < field_size; i++)
+        data[i] = iens + 0.001 * i;
+      block_fs_fwrite_file( block_fs , key , data , field_size * sizeof * data );
+    }
+    free( key );
+  }
+  block_fs_fsync( block_fs );
+  free( data );
+}
+
+
+static double read_ensemble( block_fs_type * block_fs , int ens_size , int num_threads) {
+  thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+  arg_pack_type ** arg_list = util_calloc( num_threads , sizeof * arg_list );
+  timer_type * timer = timer_alloc( false );
+  double total_time;
+
+  timer_start( timer );
+  for (int it = 0; it < num_threads; it++) {
+    arg_list[it] = arg_pack_alloc( );
+    arg_pack_append_ptr( arg_list[it] , block_fs );
+    arg_pack_append_int( arg_list[it] , (it * ens_size) / num_threads );
+    arg_pack_append_int( arg_list[it] , ((it + 1) * ens_size) / num_threads );
+    thread_pool_add_job( tp , read_range , arg_list[it] );
+  }
+  thread_pool_join( tp );
+  timer_stop( timer );
+  total_time = timer_get_total_time( timer );
+
+  for (int it = 0; it < num_threads; it++)
+    arg_pack_free( arg_list[it] );
+  free( arg_list );
+  timer_free( timer );
+  thread_pool_free( tp );
+  return total_time;
+}
+
+
+int main(int argc, char ** argv) {
+  int ens_size   = 100;
+  int field_size = 1000000;
+
+  if (argc < 2) {
+    fprintf(stderr,"Usage: %s MOUNT_FILE [ens_size] [field_size]\n", argv[0]);
+    exit(1);
+  }
+  if (argc > 2)
+    util_sscanf_int( argv[2] , &ens_size );
+  if (argc > 3)
+    util_sscanf_int( argv[3] , &field_size );
+
+  {
+    block_fs_type * block_fs = block_fs_mount( argv[1] , 32 , 0 , 1.0 , 0 , false , false , false );
+    double mbytes = 1.0 * ens_size * field_size * sizeof(float) / (1024 * 1024);
+
+    write_ensemble( block_fs , ens_size , field_size );
+    read_ensemble( block_fs , ens_size , 1 );  /* Warm up the page cache. */
+
+    printf("Realizations: %d   field size: %d   total: %.1f MB \n", ens_size , field_size , mbytes);
+    for (int num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+      double t = read_ensemble( block_fs , ens_size , num_threads );
+      printf("Threads: %2d   %8.4f sec   %8.1f MB/s \n", num_threads , t , (t > 0) ? mbytes / t : 0.0);
+    }
+
+    block_fs_close( block_fs , false );
+  }
+  exit(0);
+}
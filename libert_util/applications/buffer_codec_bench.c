@@ -0,0 +1,137 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'buffer_codec_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+#include <ert/util/buffer.h>
+
+/*
+  Benchmark of the buffer codecs on data resembling FIELD parameters:
+
+    bash% buffer_codec_bench [nx] [ny] [nz] [repeat]
+
+  Two float fields are generated on a nx x ny x nz grid: a PERMX like
+  field which is lognormal and smoothly varying within each layer,
+  and a PORO like field with values in the range 0.05 - 0.35. For
+  each codec specification the compressed size relative to the raw
+  size, and the compression and decompression rates are reported.
+*/
+
+static const char * codec_list[] = { "ZLIB" , "ZLIB1" , "NONE" , "LZ" ,
+                                     "SHUFFLE+ZLIB" , "SHUFFLE+ZLIB1" , "SHUFFLE+LZ" ,
+                                     "DELTA+SHUFFLE+ZLIB1" , "DELTA+SHUFFLE+LZ" };
+
+
+static void fill_fields( float * permx , float * poro , int nx , int ny , int nz) {
+  for (int k = 0; k < nz; k++) {
+    double layer_mean = 4 + 2 * sin( 0.7 * k );
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int index = i + j * nx + k * nx * ny;
+        double noise = sin( 0.11 * i + 0.05 * j ) + 0.5 * cos( 0.07 * j - 0.13 * i + k ) + 0.1 * sin( 1.7 * i * j );
+        permx[index] = exp( layer_mean + 0.8 * noise );
+        poro[index]  = 0.20 + 0.05 * noise + 0.02 * sin( 0.7 * k );
+      }
+    }
+  }
+}
+
+
+static void bench_codec( const char * label , const char * spec , const float * data , int size , int repeat) {
+  buffer_codec_type codec;
+  size_t byte_size     = size * sizeof * data;
+  buffer_type * buffer = buffer_alloc( byte_size );
+  float * copy         = util_calloc( size , sizeof * copy );
+  timer_type * t_write = timer_alloc( false );
+  timer_type * t_read  = timer_alloc( false );
+  size_t encoded_size  = 0;
+  double mbytes        = 1.0 * repeat * byte_size / (1024 * 1024);
+
+  if (!buffer_codec_sscanf( spec , &codec ))
+    util_abort("%s: invalid codec:%s \n",__func__ , spec);
+
+  for (int r = 0; r < repeat; r++) {
+    buffer_rewind( buffer );
+    timer_start( t_write );
+    encoded_size = buffer_fwrite_encoded( buffer , data , byte_size , sizeof * data , codec );
+    timer_stop( t_write );
+
+    buffer_rewind( buffer );
+    timer_start( t_read );
+    buffer_fread_encoded( buffer , encoded_size , copy , byte_size );
+    timer_stop( t_read );
+  }
+
+  if (memcmp( data , copy , byte_size ) != 0)
+    util_abort("%s: roundtrip with codec:%s failed \n",__func__ , spec);
+
+  {
+    double tw = timer_get_total_time( t_write );
+    double tr = timer_get_total_time( t_read );
+    printf("%-6s %-22s  ratio: %6.3f   compress: %8.1f MB/s   decompress: %8.1f MB/s \n",
+           label , spec , 1.0 * encoded_size / byte_size ,
+           (tw > 0) ? mbytes / tw : 0.0 ,
+           (tr > 0) ? mbytes / tr : 0.0);
+  }
+
+  timer_free( t_read );
+  timer_free( t_write );
+  free( copy );
+  buffer_free( buffer );
+}
+
+
+int main(int argc, char ** argv) {
+  int nx = 100;
+  int ny = 100;
+  int nz = 50;
+  int repeat = 5;
+
+  if (argc > 1)
+    util_sscanf_int( argv[1] , &nx );
+  if (argc > 2)
+    util_sscanf_int( argv[2] , &ny );
+  if (argc > 3)
+    util_sscanf_int( argv[3] , &nz );
+  if (argc > 4)
+    util_sscanf_int( argv[4] , &repeat );
+
+  {
+    int size = nx * ny * nz;
+    int num_codecs = sizeof codec_list / sizeof codec_list[0];
+    float * permx = util_calloc( size , sizeof * permx );
+    float * poro  = util_calloc( size , sizeof * poro );
+
+    fill_fields( permx , poro , nx , ny , nz );
+    printf("Grid: %d x %d x %d   field size: %.1f MB \n", nx , ny , nz , 1.0 * size * sizeof(float) / (1024 * 1024));
+    for (int c = 0; c < num_codecs; c++)
+      bench_codec( "PERMX" , codec_list[c] , permx , size , repeat );
+    for (int c = 0; c < num_codecs; c++)
+      bench_codec( "PORO" , codec_list[c] , poro , size , repeat );
+
+    free( poro );
+    free( permx );
+  }
+  exit(0);
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'endian_flip_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+
+/*
+  Small benchmark of the endian conversion used when loading binary
+  ECLIPSE files:
+
+    bash% endian_flip_bench [elements] [repeat]
+
+  Reports the time to flip 4 and 8 byte vectors, and the time to go
+  from big endian float to native double with a flip followed by
+  util_float_to_double() compared to util_endian_flip_float_to_double().
+*/
+
+static void report(const char * label , const timer_type * timer , size_t bytes , int repeat) {
+  double t = timer_get_total_time( timer );
+  printf("%-32s  %8.4f sec   %8.1f MB/s \n", label , t , (t > 0) ? repeat * bytes / (t * 1024 * 1024) : 0.0);
+}
+
+
+int main(int argc, char ** argv) {
+  int elements = 10000000;
+  int repeat   = 10;
+  int i;
+
+  if (argc > 1)
+    util_sscanf_int( argv[1] , &elements );
+  if (argc > 2)
+    util_sscanf_int( argv[2] , &repeat );
+
+  {
+    float  * float_data  = util_calloc( elements , sizeof * float_data );
+    float  * flip_data   = util_calloc( elements , sizeof * flip_data );
+    double * double_data = util_calloc( elements , sizeof * double_data );
+    timer_type * t_flip32 = timer_alloc( false );
+    timer_type * t_flip64 = timer_alloc( false );
+    timer_type * t_2pass  = timer_alloc( false );
+    timer_type * t_fused  = timer_alloc( false );
+
+    for (i=0; i < elements; i++)
+      float_data[i] = 0.001 * i;
+    util_endian_flip_vector( float_data , sizeof * float_data , elements );
+
+    for (i=0; i < repeat; i++) {
+      timer_start( t_flip32 );
+      util_endian_flip_vector( float_data , sizeof * float_data , elements );
+      timer_stop( t_flip32 );
+
+      timer_start( t_flip64 );
+      util_endian_flip_vector( double_data , sizeof * double_data , elements );
+      timer_stop( t_flip64 );
+
+      memcpy( flip_data , float_data , elements * sizeof * float_data );
+      timer_start( t_2pass );
+      util_endian_flip_vector( flip_data , sizeof * flip_data , elements );
+      util_float_to_double( double_data , flip_data , elements );
+      timer_stop( t_2pass );
+
+      timer_start( t_fused );
+      util_endian_flip_float_to_double( double_data , float_data , elements );
+      timer_stop( t_fused );
+    }
+
+    printf("Elements: %d   repeat: %d \n", elements , repeat);
+    report("Flip 4 byte" , t_flip32 , elements * sizeof(float) , repeat);
+    report("Flip 8 byte" , t_flip64 , elements * sizeof(double) , repeat);
+    report("Flip + float->double" , t_2pass , elements * sizeof(float) , repeat);
+    report("Fused flip float->double" , t_fused , elements * sizeof(float) , repeat);
+
+    timer_free( t_flip32 );
+    timer_free( t_flip64 );
+    timer_free( t_2pass );
+    timer_free( t_fused );
+    free( float_data );
+    free( flip_data );
+    free( double_data );
+  }
+  exit(0);
+}
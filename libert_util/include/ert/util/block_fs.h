@@ -18,6 +18,8 @@
 
 #ifndef ERT_BLOCK_FS
 #define ERT_BLOCK_FS
+#include <stdint.h>
+
 #include <ert/util/buffer.h>
 #include <ert/util/vector.h>
 #include <ert/util/type_macros.h>
@@ -39,6 +41,7 @@ extern "C" {
   double          block_fs_get_fragmentation( const block_fs_type * block_fs );
   bool            block_fs_rotate( block_fs_type * block_fs , double fragmentation_limit);
   void            block_fs_fsync( block_fs_type * block_fs );
+  void            block_fs_set_write_behind( block_fs_type * block_fs , size_t max_pending_size );
   bool            block_fs_is_mount( const char * mount_file );
   bool            block_fs_is_readonly( const block_fs_type * block_fs);
   block_fs_type * block_fs_mount( const char * mount_file , 
@@ -58,6 +61,12 @@ extern "C" {
   void            block_fs_sync( block_fs_type * block_fs );
   void            block_fs_unlink_file( block_fs_type * block_fs , const char * filename);
   bool            block_fs_has_file( block_fs_type * block_fs , const char * filename);
+  uint32_t        block_fs_key_hash( const char * key );
+  uint32_t        block_fs_key_hash_append( uint32_t hash_value , const char * suffix );
+  void            block_fs_fwrite_buffer_hashed(block_fs_type * block_fs , const char * filename , uint32_t hash_value , const buffer_type * buffer);
+  void            block_fs_fread_realloc_buffer_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value , buffer_type * buffer);
+  void            block_fs_unlink_file_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value);
+  bool            block_fs_has_file_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value);
   vector_type   * block_fs_alloc_filelist( block_fs_type * block_fs  , const char * pattern , block_fs_sort_type sort_mode , bool include_free_nodes );
   void            block_fs_defrag( block_fs_type * block_fs );
   
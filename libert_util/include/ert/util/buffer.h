@@ -91,12 +91,39 @@ extern "C" {
   size_t             buffer_stream_fwrite_n( const buffer_type * buffer , size_t offset , ssize_t write_size , FILE * stream );
   void               buffer_stream_fprintf( const buffer_type * buffer , FILE * stream );
   void               buffer_stream_fread( buffer_type * buffer , size_t byte_size , FILE * stream);
+  void             * buffer_fwrite_reserve( buffer_type * buffer , size_t byte_size );
   buffer_type      * buffer_fread_alloc(const char * filename);
   void               buffer_fread_realloc(buffer_type * buffer , const char * filename);
 
 #ifdef ERT_HAVE_ZLIB
   size_t             buffer_fwrite_compressed(buffer_type * buffer, const void * ptr , size_t byte_size);
   size_t             buffer_fread_compressed(buffer_type * buffer , size_t compressed_size , void * target_ptr , size_t target_size);
+
+typedef enum {
+  BUFFER_CODEC_ZLIB = 0,
+  BUFFER_CODEC_NONE = 1,
+  BUFFER_CODEC_LZ   = 2
+} buffer_codec_enum;
+
+#define BUFFER_FILTER_DELTA    1
+#define BUFFER_FILTER_SHUFFLE  2
+
+  /*
+    Codec and filters used by buffer_fwrite_encoded(); level is the
+    zlib compression level 1-9, or 0 for the zlib default.
+  */
+  typedef struct {
+    buffer_codec_enum codec;
+    int               level;
+    int               filters;
+  } buffer_codec_type;
+
+  buffer_codec_type  buffer_codec_default( void );
+  bool               buffer_codec_is_default( buffer_codec_type codec );
+  bool               buffer_codec_sscanf( const char * spec , buffer_codec_type * codec );
+  char             * buffer_codec_alloc_string( buffer_codec_type codec );
+  size_t             buffer_fwrite_encoded( buffer_type * buffer , const void * ptr , size_t byte_size , size_t element_size , buffer_codec_type codec);
+  size_t             buffer_fread_encoded( buffer_type * buffer , size_t encoded_size , void * target_ptr , size_t target_size);
 #endif
 
 
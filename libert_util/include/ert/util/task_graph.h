@@ -0,0 +1,44 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'task_graph.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_TASK_GRAPH_H
+#define ERT_TASK_GRAPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+  typedef struct     task_graph_struct task_graph_type;
+
+  task_graph_type  * task_graph_alloc( int num_threads );
+  void               task_graph_free( task_graph_type * graph );
+  int                task_graph_add_task( task_graph_type * graph , void * (*) (void *) , void * arg );
+  int                task_graph_add_barrier( task_graph_type * graph );
+  void               task_graph_add_dependency( task_graph_type * graph , int task , int depends_on );
+  void               task_graph_run( task_graph_type * graph );
+  void               task_graph_clear( task_graph_type * graph );
+  int                task_graph_get_size( const task_graph_type * graph );
+  int                task_graph_get_num_threads( const task_graph_type * graph );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
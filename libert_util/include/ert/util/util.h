@@ -318,6 +318,7 @@ typedef enum {left_pad   = 0,
   char *  util_fread_alloc_string(FILE *);
   void    util_fskip_string(FILE *stream);
   void     util_endian_flip_vector(void * data , int element_size , int elements);
+  void     util_endian_flip_float_to_double(double * double_ptr , const float * float_ptr , int size);
   int      util_proc_mem_free(void);
 
 
@@ -23,11 +23,13 @@
 #include <stdio.h>
 #include <errno.h>
 #include <unistd.h>
+#include <limits.h>
 #include <pthread.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <fnmatch.h>
+#include <stdint.h>
 
-#include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/block_fs.h>
 #include <ert/util/vector.h>
@@ -38,21 +40,19 @@
 #define MOUNT_MAP_MAGIC_INT  8861290
 #define BLOCK_FS_TYPE_ID     7100652
 #define INDEX_MAGIC_INT      1213775
-#define INDEX_FORMAT_VERSION       1
+#define INDEX_FORMAT_VERSION       2
 
 // #define ENABLE_CACHE
 
 
 /*
   During mounting a significant part of the time is spent on filling
-  up the index hash table. By default a hash table is created with a
-  quite small size, and when initializing a large block_fs structure
-  it must be resized many times. By setting a default size with the
-  DEFAULT_INDEX_SIZE variable the hash table will immediately be
-  resized, avoiding some of the automatic calls to hash_resize. 
-
-  When the file system is loaded from an index a good size estimate
-  can be inferred directly from the index.  
+  up the index table. When the index is built by scanning the data
+  file the table is created with DEFAULT_INDEX_SIZE slots, avoiding
+  some of the automatic resizing for large block_fs structures.
+
+  When the file system is loaded from an index file the final size
+  is known up front, and the table is allocated once.
 */
 
 #define DEFAULT_INDEX_SIZE 2048
@@ -87,6 +87,8 @@ typedef enum {
 */
 typedef struct file_node_struct file_node_type;
 typedef struct free_node_struct free_node_type;
+typedef struct pending_write_struct pending_write_type;
+typedef struct node_index_struct node_index_type;
 
 struct free_node_struct {
   free_node_type * next;
@@ -108,6 +110,7 @@ struct file_node_struct{
   int                node_size;     /* The size in bytes of this node - must be >= data_size. NEVER Changed. */
   int                data_size;     /* The size of the data stored in this node - in addition the node might need to store header information. */
   node_status_type   status;        /* This should be: NODE_IN_USE | NODE_FREE; in addition the disk can have NODE_WRITE_ACTIVE for incomplete writes. */
+  pending_write_type * pending;     /* Data which has been written in write-behind mode, but not yet committed to disk - normally NULL. */
 
 #ifdef ENABLE_CACHE
   char             * cache;
@@ -116,6 +119,26 @@ struct file_node_struct{
 };
 
 
+/*
+  In write-behind mode (max_pending_size > 0) the data of a write is
+  copied into a pending_write instance, and all the pending writes are
+  committed to disk together by block_fs_commit__(). The file_node
+  instance is allocated, and inserted in the index, immediately; reads
+  of a file with a pending write are served from the pending copy.
+
+  The file_node points back to the pending_write which currently holds
+  its data; if the file is unlinked before commit the pending_write is
+  detached from the node (file_node == NULL) and skipped at commit.
+*/
+
+struct pending_write_struct {
+  file_node_type   * file_node;
+  char             * key;
+  char             * data;
+  int                data_size;
+};
+
+
 /**
    data_size   : manipulated in block_fs_fwrite__() and block_fs_insert_free_node().
    status      : manipulated in block_fs_fwrite__() and block_fs_unlink_file__();
@@ -147,14 +170,15 @@ struct block_fs_struct {
   int              block_size;      /* The size of blocks in bytes. */
   int              lock_fd;         /* The file descriptor for the lock_file. Set to -1 if we do not have write access. */
   
-  pthread_mutex_t  io_lock;         /* Lock held during fread of the data file. */
   pthread_rwlock_t rw_lock;         /* Read-write lock during all access to the fs. */
   
   int              num_free_nodes;   
-  hash_type      * index;           /* THE HASH table of all the nodes/files which have been stored. */
+  node_index_type * index;          /* THE HASH table of all the nodes/files which have been stored. */
   free_node_type * free_nodes;
   vector_type    * file_nodes;      /* This vector owns all the file_node instances - the index and free_nodes structures
                                        only contain pointers to the objects stored in this vector. */
+  file_node_type * index_nodes;     /* The file_node instances loaded from the index file are allocated as one block,
+                                       which is owned here instead of by the file_nodes vector. */
   int              write_count;     /* This just counts the number of writes since the file system was mounted. */
   int              max_cache_size;
   size_t           total_cache_size;
@@ -164,11 +188,17 @@ struct block_fs_struct {
                                             fragmentation_limit == 0.0 : Rotate when one byte is wasted. */
   bool             data_owner;
   int              fsync_interval;  /* 0: never  n: every nth iteration. */
+
+  vector_type    * pending_writes;    /* The pending_write instances not yet committed to disk. */
+  size_t           pending_size;      /* The total size of the data in pending_writes. */
+  size_t           max_pending_size;  /* 0: write-behind disabled  n: commit when more than n bytes are pending. */
 };
 
 /*****************************************************************/
 
 static void block_fs_rotate__( block_fs_type * block_fs );
+static void block_fs_commit__( block_fs_type * block_fs );
+static void block_fs_drop_pending__( block_fs_type * block_fs , file_node_type * node );
 
 UTIL_SAFE_CAST_FUNCTION( block_fs , BLOCK_FS_TYPE_ID )
 
@@ -198,21 +228,25 @@ static inline void block_fs_fseek(block_fs_type * block_fs , long offset) {
 */
 
 
-static file_node_type * file_node_alloc( node_status_type status , long int offset , int node_size) {
-  file_node_type * file_node = util_malloc( sizeof * file_node );
-  
+static void file_node_init( file_node_type * file_node , node_status_type status , long int offset , int node_size) {
   file_node->node_offset = offset;    /* These should NEVER change. */
   file_node->node_size   = node_size; /* -------------------------  */
 
   file_node->data_size   = 0;
   file_node->data_offset = 0;
   file_node->status      = status; 
+  file_node->pending     = NULL;
   
 #ifdef ENABLE_CACHE
   file_node->cache      = NULL;
   file_node->cache_size = 0;
 #endif
+}
+
 
+static file_node_type * file_node_alloc( node_status_type status , long int offset , int node_size) {
+  file_node_type * file_node = util_malloc( sizeof * file_node );
+  file_node_init( file_node , status , offset , node_size );
   return file_node;
 }
 
@@ -414,43 +448,44 @@ static void file_node_set_data_offset( file_node_type * file_node, const char *
 
 
 
-static void file_node_dump_index( const file_node_type * file_node , FILE * index_stream) {
-  util_fwrite_int( file_node->status , index_stream );
-  util_fwrite_long( file_node->node_offset , index_stream );
-  util_fwrite_int( file_node->node_size   , index_stream );
-  util_fwrite_int( file_node->data_offset , index_stream );
-  util_fwrite_int( file_node->data_size   , index_stream );
-}
+/*
+  The index file is laid out as:
 
+    | INDEX_MAGIC_INT | INDEX_FORMAT_VERSION | data_mtime: time_t |
+    | num_active: int | num_free: int | key_pool_size: long |
+    | index_record[num_active + num_free] | key_pool[key_pool_size] |
 
+  The first num_active records are the files in use, and the rest are
+  the free nodes in the order of the free_nodes list. The keys are
+  stored \0 terminated in the key_pool, which is kept in memory
+  unchanged as the key storage of the node_index when the index is
+  loaded.
+*/
 
-/*
-static file_node_type * file_node_index_fread_alloc( FILE * stream ) {
-  node_status_type status = util_fread_int( stream );
-  long int node_offset    = util_fread_long( stream );
-  int node_size           = util_fread_int( stream );
-  {
-    file_node_type * file_node = file_node_alloc( status , node_offset , node_size );
-    file_node->data_offset = util_fread_int( stream );
-    file_node->data_size   = util_fread_int( stream );
-    
-    return file_node;
-  }
+typedef struct {
+  int64_t   node_offset;
+  int64_t   key_offset;     /* The offset of the key in the key_pool - not used for free nodes. */
+  int32_t   node_size;
+  int32_t   data_offset;
+  int32_t   data_size;
+  uint32_t  hash_value;     /* block_fs_key_hash() of the key - not used for free nodes. */
+} index_record_type;
+
+
+static void file_node_fill_index_record( const file_node_type * file_node , index_record_type * record) {
+  record->node_offset = file_node->node_offset;
+  record->key_offset  = 0;
+  record->node_size   = file_node->node_size;
+  record->data_offset = file_node->data_offset;
+  record->data_size   = file_node->data_size;
+  record->hash_value  = 0;
 }
-*/
 
-static file_node_type * file_node_index_buffer_fread_alloc( buffer_type * buffer) {
-  node_status_type status = buffer_fread_int( buffer );
-  long int node_offset    = buffer_fread_long( buffer );
-  int node_size           = buffer_fread_int( buffer );
-  {
-    file_node_type * file_node = file_node_alloc( status , node_offset , node_size );
 
-    file_node->data_offset = buffer_fread_int( buffer );
-    file_node->data_size   = buffer_fread_int( buffer );
-    
-    return file_node;
-  }
+static void file_node_init_index_record( file_node_type * file_node , node_status_type status , const index_record_type * record) {
+  file_node_init( file_node , status , record->node_offset , record->node_size );
+  file_node->data_offset = record->data_offset;
+  file_node->data_size   = record->data_size;
 }
 
 /* file_node functions - end. */
@@ -482,6 +517,229 @@ static void free_node_free_list( free_node_type * head ) {
 }
 
 
+/*****************************************************************/
+/* node_index functions */
+
+/*
+  The node_index maps filenames to the file_node instances of the
+  files in use. It is a hash table with open addressing and linear
+  probing; all the slots are in one contiguous array, so a lookup is
+  normally one string compare and no pointer chasing, and filling the
+  table when mounting does not allocate per node.
+
+  Removed entries are marked with the INDEX_DELETED_KEY sentinel, and
+  the table is rehashed when less than one quarter of the slots are
+  empty. The hash value of every key is stored in the slot, and is
+  also stored in the index file, so neither rehashing nor loading an
+  index file needs to hash the keys again.
+
+  Keys loaded from an index file point into the key_pool which was
+  read together with the index, and are not copied; keys inserted
+  later are copied and owned by the slot.
+*/
+
+static char index_deleted_key;
+#define INDEX_DELETED_KEY (&index_deleted_key)
+
+typedef struct {
+  char           * key;          /* NULL: empty slot   INDEX_DELETED_KEY: removed entry. */
+  file_node_type * file_node;
+  uint32_t         hash_value;
+  bool             owned_key;
+} index_slot_type;
+
+
+struct node_index_struct {
+  index_slot_type * slots;
+  int               capacity;    /* The number of slots - always a power of two. */
+  int               size;        /* The number of keys in the index. */
+  int               used;        /* The number of slots which are not empty, i.e. size + removed entries. */
+  char            * key_pool;    /* The string table loaded from the index file - can be NULL. */
+};
+
+
+/*
+  The index is keyed on the 32 bit FNV-1a hash of the filename. The
+  hash can be continued over a suffix, i.e.
+
+     block_fs_key_hash_append( block_fs_key_hash( "A." ) , "1.2" ) == block_fs_key_hash( "A.1.2" )
+
+  so a caller which stores many files with a common prefix can hash
+  the prefix once, and pass the final hash value to the *_hashed()
+  functions.
+*/
+
+uint32_t block_fs_key_hash_append( uint32_t hash_value , const char * suffix ) {
+  const unsigned char * c = (const unsigned char *) suffix;
+
+  while (*c != '\0') {
+    hash_value ^= *c;
+    hash_value *= 16777619u;
+    c++;
+  }
+  return hash_value;
+}
+
+
+uint32_t block_fs_key_hash( const char * key ) {
+  return block_fs_key_hash_append( 2166136261u , key );
+}
+
+
+static bool index_slot_in_use( const index_slot_type * slot ) {
+  return (slot->key != NULL) && (slot->key != INDEX_DELETED_KEY);
+}
+
+
+static void node_index_alloc_slots( node_index_type * index , int size_hint ) {
+  int capacity = 16;
+  while (capacity < size_hint * 2)
+    capacity *= 2;
+
+  index->capacity = capacity;
+  index->slots    = util_calloc( capacity , sizeof * index->slots );
+  memset( index->slots , 0 , capacity * sizeof * index->slots );
+  index->used     = 0;
+}
+
+
+static node_index_type * node_index_alloc( int size_hint ) {
+  node_index_type * index = util_malloc( sizeof * index );
+  index->size     = 0;
+  index->key_pool = NULL;
+  node_index_alloc_slots( index , size_hint );
+  return index;
+}
+
+
+static void node_index_free( node_index_type * index ) {
+  for (int i = 0; i < index->capacity; i++) {
+    index_slot_type * slot = &index->slots[i];
+    if (index_slot_in_use( slot ) && slot->owned_key)
+      free( slot->key );
+  }
+  util_safe_free( index->key_pool );
+  free( index->slots );
+  free( index );
+}
+
+
+static int node_index_get_size( const node_index_type * index ) {
+  return index->size;
+}
+
+
+/*
+  Will return the slot holding key, or NULL if the key is not in the
+  index.
+*/
+
+static index_slot_type * node_index_lookup( const node_index_type * index , const char * key , uint32_t hash_value) {
+  uint32_t mask = index->capacity - 1;
+  uint32_t i    = hash_value & mask;
+
+  while (true) {
+    index_slot_type * slot = &index->slots[i];
+    if (slot->key == NULL)
+      return NULL;
+
+    if ((slot->hash_value == hash_value) && index_slot_in_use( slot ) && (strcmp( slot->key , key ) == 0))
+      return slot;
+
+    i = (i + 1) & mask;
+  }
+}
+
+
+/*
+  Inserts a key which is not already in the index; the first removed
+  or empty slot in the probe sequence is used.
+*/
+
+static void node_index_insert__( node_index_type * index , char * key , bool owned_key , uint32_t hash_value , file_node_type * file_node) {
+  uint32_t mask = index->capacity - 1;
+  uint32_t i    = hash_value & mask;
+
+  while (index_slot_in_use( &index->slots[i] ))
+    i = (i + 1) & mask;
+
+  {
+    index_slot_type * slot = &index->slots[i];
+    if (slot->key == NULL)
+      index->used++;
+
+    slot->key        = key;
+    slot->owned_key  = owned_key;
+    slot->hash_value = hash_value;
+    slot->file_node  = file_node;
+  }
+  index->size++;
+}
+
+
+static void node_index_resize( node_index_type * index , int size_hint ) {
+  index_slot_type * old_slots = index->slots;
+  int old_capacity            = index->capacity;
+
+  node_index_alloc_slots( index , size_hint );
+  index->size = 0;
+  for (int i = 0; i < old_capacity; i++) {
+    index_slot_type * slot = &old_slots[i];
+    if (index_slot_in_use( slot ))
+      node_index_insert__( index , slot->key , slot->owned_key , slot->hash_value , slot->file_node );
+  }
+  free( old_slots );
+}
+
+
+static file_node_type * node_index_get( const node_index_type * index , const char * key , uint32_t hash_value) {
+  index_slot_type * slot = node_index_lookup( index , key , hash_value );
+  if (slot == NULL)
+    return NULL;
+  else
+    return slot->file_node;
+}
+
+
+static void node_index_insert( node_index_type * index , const char * key , uint32_t hash_value , file_node_type * file_node ) {
+  index_slot_type * slot = node_index_lookup( index , key , hash_value );
+
+  if (slot != NULL)
+    slot->file_node = file_node;
+  else {
+    if ((index->used + 1) * 4 > index->capacity * 3)
+      node_index_resize( index , index->size + 1 );
+
+    node_index_insert__( index , util_alloc_string_copy( key ) , true , hash_value , file_node );
+  }
+}
+
+
+/*
+  Removes key from the index and returns the file_node; will return
+  NULL if the key is not in the index.
+*/
+
+static file_node_type * node_index_pop( node_index_type * index , const char * key , uint32_t hash_value) {
+  index_slot_type * slot = node_index_lookup( index , key , hash_value );
+  if (slot == NULL)
+    return NULL;
+  {
+    file_node_type * file_node = slot->file_node;
+    if (slot->owned_key)
+      free( slot->key );
+
+    slot->key       = INDEX_DELETED_KEY;
+    slot->file_node = NULL;
+    index->size--;
+    return file_node;
+  }
+}
+
+/* node_index functions - end. */
+/*****************************************************************/
+
+
 
 /*****************************************************************/
 static inline void block_fs_aquire_wlock( block_fs_type * block_fs ) {
@@ -508,8 +766,16 @@ static inline void block_fs_aquire_rlock( block_fs_type * block_fs ) {
 
 
 
-static void block_fs_insert_index_node( block_fs_type * block_fs , const char * filename , const file_node_type * file_node) {
-  hash_insert_ref( block_fs->index , filename , file_node);
+static void block_fs_insert_index_node( block_fs_type * block_fs , const char * filename , uint32_t hash_value , file_node_type * file_node) {
+  node_index_insert( block_fs->index , filename , hash_value , file_node);
+}
+
+
+static file_node_type * block_fs_get_index_node( const block_fs_type * block_fs , const char * filename , uint32_t hash_value ) {
+  file_node_type * file_node = node_index_get( block_fs->index , filename , hash_value );
+  if (file_node == NULL)
+    util_abort("%s: the file:%s does not exist in the filesystem mounted at:%s \n",__func__ , filename , block_fs->mount_file);
+  return file_node;
 }
 
 
@@ -592,12 +858,44 @@ static void block_fs_insert_free_node( block_fs_type * block_fs , file_node_type
 }
 
 
+/**
+   Appends file_node to the list of free nodes after the node 'tail',
+   which should be the current last node of the list, or NULL if the
+   list is empty. This is used when loading an index, where the free
+   nodes are already sorted, and avoids walking the list for every
+   node. Returns the new last node of the list.
+*/
+
+static free_node_type * block_fs_append_free_node( block_fs_type * block_fs , free_node_type * tail , file_node_type * file_node ) {
+  if ((tail == NULL) || (tail->file_node->node_size > file_node->node_size)) {
+    block_fs_insert_free_node( block_fs , file_node );
+    if (tail == NULL)
+      return block_fs->free_nodes;
+    else
+      return tail;
+  } else {
+    free_node_type * new = free_node_alloc( file_node );
+    new->prev  = tail;
+    tail->next = new;
+    
+    block_fs->num_free_nodes++;
+    block_fs->free_size += file_node->node_size;
+    return new;
+  }
+}
+
+
+static void block_fs_update_file_size( block_fs_type * block_fs , const file_node_type * node) {
+  block_fs->data_file_size = util_size_t_max( block_fs->data_file_size , node->node_offset + node->node_size);  /* Updating the total size of the file - i.e the next available offset. */
+}
+
+
 /**
    Installing the new node AND updating file tail. 
 */
 
 static void block_fs_install_node(block_fs_type * block_fs , file_node_type * node) {
-  block_fs->data_file_size = util_size_t_max( block_fs->data_file_size , node->node_offset + node->node_size);  /* Updating the total size of the file - i.e the next available offset. */
+  block_fs_update_file_size( block_fs , node );
   vector_append_owned_ref( block_fs->file_nodes , node , file_node_free__ );
 }
 
@@ -628,8 +926,9 @@ static void block_fs_set_filenames( block_fs_type * block_fs ) {
 
 
 static void block_fs_reinit( block_fs_type * block_fs ) {
-  block_fs->index               = hash_alloc_unlocked();
+  block_fs->index               = node_index_alloc( 0 );
   block_fs->file_nodes          = vector_alloc_new();
+  block_fs->index_nodes         = NULL;
   block_fs->free_nodes          = NULL;
   block_fs->num_free_nodes      = 0;
   block_fs->write_count         = 0;
@@ -660,8 +959,10 @@ static block_fs_type * block_fs_alloc_empty( const char * mount_file ,
   block_fs->max_total_cache_size = 512 * 1024 * 1024;  /* 512 MB */
   
   block_fs->fragmentation_limit = fragmentation_limit;   
+  block_fs->pending_writes      = vector_alloc_new();
+  block_fs->pending_size        = 0;
+  block_fs->max_pending_size    = 0;
   util_alloc_file_components( mount_file , &block_fs->path , &block_fs->base_name, NULL );
-  pthread_mutex_init( &block_fs->io_lock  , NULL);
   pthread_rwlock_init( &block_fs->rw_lock , NULL);
   {
     FILE * stream            = util_fopen( mount_file , "r");
@@ -800,7 +1101,7 @@ static void block_fs_open_data( block_fs_type * block_fs , bool read_write) {
       block_fs->data_stream = NULL;
     /* 
        If we ever try to dereference this pointer it will break
-       hard; but it should be stopped in hash_get() calls before the
+       hard; but it should be stopped in block_fs_get_index_node() calls before the
        data_stream is dereferenced anyway?
     */
   }
@@ -842,19 +1143,21 @@ static void block_fs_update_cache_node( block_fs_type * block_fs, file_node_type
 static void block_fs_preload( block_fs_type * block_fs ) {
   if ((block_fs->max_cache_size > 0) && (block_fs->data_stream != NULL) && (block_fs->max_total_cache_size > 0)) {
     void * buffer = util_malloc( block_fs->max_cache_size );
-    hash_iter_type * index_iter = hash_iter_alloc( block_fs->index );
+    node_index_type * index = block_fs->index;
     
-    while (!hash_iter_is_complete( index_iter )) {
-      file_node_type * node = hash_iter_get_next_value( index_iter );
-      if ((node->data_size < block_fs->max_cache_size) &&                                         /* Check the size of this node */ 
-          (block_fs->total_cache_size + node->data_size < block_fs->max_total_cache_size)) {      /* Check the total cache size */
-        block_fs_fseek_node_data(block_fs , node);
-        util_fread( buffer , 1 , node->data_size , block_fs->data_stream , __func__);
-        block_fs_update_cache_node( block_fs , node , node->data_size , buffer );
+    for (int i = 0; i < index->capacity; i++) {
+      const index_slot_type * slot = &index->slots[i];
+      if (index_slot_in_use( slot )) {
+        file_node_type * node = slot->file_node;
+        if ((node->data_size < block_fs->max_cache_size) &&                                         /* Check the size of this node */ 
+            (block_fs->total_cache_size + node->data_size < block_fs->max_total_cache_size)) {      /* Check the total cache size */
+          block_fs_fseek_node_data(block_fs , node);
+          util_fread( buffer , 1 , node->data_size , block_fs->data_stream , __func__);
+          block_fs_update_cache_node( block_fs , node , node->data_size , buffer );
+        }
       }
     }
     
-    hash_iter_free( index_iter );
     free( buffer );
   }
 }
@@ -926,7 +1229,7 @@ static void block_fs_build_index( block_fs_type * block_fs , long_vector_type *
   char * filename = NULL;
   file_node_type * file_node;
   
-  hash_resize( block_fs->index , DEFAULT_INDEX_SIZE );
+  node_index_resize( block_fs->index , DEFAULT_INDEX_SIZE );
   block_fs_fseek( block_fs , 0);
   do {
     file_node = file_node_fread_alloc( block_fs->data_stream , &filename );
@@ -947,7 +1250,7 @@ static void block_fs_build_index( block_fs_type * block_fs , long_vector_type *
           block_fs_install_node( block_fs , file_node );
           switch(file_node->status) {
           case(NODE_IN_USE):
-            block_fs_insert_index_node(block_fs , filename , file_node);
+            block_fs_insert_index_node(block_fs , filename , block_fs_key_hash( filename ) , file_node);
             break;
           case(NODE_FREE):
             block_fs_insert_free_node( block_fs , file_node );
@@ -975,9 +1278,11 @@ static void block_fs_build_index( block_fs_type * block_fs , long_vector_type *
 
 
 /**
-   Load an index for (slightly) faster mounting of the filesystem. The
-   function starts be reading a header and check if the current index
-   file is applicable.
+   Load an index for faster mounting of the filesystem. The function
+   starts be reading a header and check if the current index file is
+   applicable; the node records and the key_pool are then read with
+   one fread() each, and the node_index is filled without copying or
+   hashing any keys.
 
    Will return true of the loading succedeed, and false if no index
    was loaded.  
@@ -985,6 +1290,7 @@ static void block_fs_build_index( block_fs_type * block_fs , long_vector_type *
 
 
 static bool block_fs_load_index( block_fs_type * block_fs ) {
+  bool loaded = false;
   stat_type data_stat;
   if (fstat( block_fs->data_fd , &data_stat) == 0) {
     FILE * stream = fopen( block_fs->index_file , "r");
@@ -994,46 +1300,55 @@ static bool block_fs_load_index( block_fs_type * block_fs ) {
       time_t index_mtime = util_fread_time_t( stream );
 
       time_t data_mtime  = data_stat.st_mtime;
-      fclose( stream );
 
       if ((id == INDEX_MAGIC_INT) &&               /* This is indeed an index file. */ 
           (version == INDEX_FORMAT_VERSION) &&     /* The version on disk agrees with this version. */
           (index_mtime == data_mtime)) {           /* The time stamp agrees with the time stamp of the data. */
         
-        /* Read the whole index file in one single read operation. */
-        buffer_type * buffer = buffer_fread_alloc( block_fs->index_file );
-        
-        buffer_fskip( buffer , sizeof( time_t ) + 2 * sizeof( int ));
-        /*1: Loading all the active nodes. */
-        {
-          int num_active_nodes = buffer_fread_int( buffer );
-          hash_resize( block_fs->index , num_active_nodes * 2 + 64);
+        int    num_active_nodes     = util_fread_int( stream );
+        int    num_free_nodes       = util_fread_int( stream );
+        size_t key_pool_size        = util_fread_long( stream );
+        int    num_records          = num_active_nodes + num_free_nodes;
+        index_record_type * records = util_calloc( num_records , sizeof * records );
+        char * key_pool             = util_malloc( key_pool_size );
+
+        if ((fread( records , sizeof * records , num_records , stream ) == num_records) &&
+            (fread( key_pool , 1 , key_pool_size , stream ) == key_pool_size)) {
+          
+          block_fs->index_nodes = util_calloc( num_records , sizeof * block_fs->index_nodes );
           
+          /*1: Loading all the active nodes. */
+          node_index_resize( block_fs->index , num_active_nodes );
+          block_fs->index->key_pool = key_pool;
           for (int i=0; i < num_active_nodes; i++) {
-            const char * filename = buffer_fread_string( buffer );
-            file_node_type * file_node = file_node_index_buffer_fread_alloc( buffer );
-            block_fs_install_node( block_fs , file_node);
-            block_fs_insert_index_node(block_fs , filename , file_node);
+            const index_record_type * record = &records[i];
+            file_node_type * file_node = &block_fs->index_nodes[i];
+            file_node_init_index_record( file_node , NODE_IN_USE , record );
+            block_fs_update_file_size( block_fs , file_node );
+            node_index_insert__( block_fs->index , &key_pool[ record->key_offset ] , false , record->hash_value , file_node );
           }
-        }
-        
-        /*2: Loading all the free nodes. */
-        {
-          int num_free_nodes = buffer_fread_int( buffer );
-          for (int i=0; i < num_free_nodes; i++) {
-            file_node_type * file_node = file_node_index_buffer_fread_alloc( buffer );
-            block_fs_install_node( block_fs , file_node);
-            block_fs_insert_free_node(block_fs , file_node);
+          
+          /*2: Loading all the free nodes. */
+          {
+            free_node_type * tail = NULL;
+            for (int i=num_active_nodes; i < num_records; i++) {
+              file_node_type * file_node = &block_fs->index_nodes[i];
+              file_node_init_index_record( file_node , NODE_FREE , &records[i] );
+              block_fs_update_file_size( block_fs , file_node );
+              tail = block_fs_append_free_node( block_fs , tail , file_node );
+            }
           }
-        }
-        buffer_free( buffer );
+          loaded = true;
+        } else
+          free( key_pool );
         
-        return true;
+        free( records );
       }
+      fclose( stream );
     } 
   }
-  /** No index was loaded - for whatever reason. */
-  return false;
+  /** If no index was loaded - for whatever reason - false is returned. */
+  return loaded;
 }
 
 
@@ -1170,29 +1485,37 @@ static file_node_type * block_fs_get_new_node( block_fs_type * block_fs , const
 
 
 
-bool block_fs_has_file__( const block_fs_type * block_fs , const char * filename) {
-  return hash_has_key( block_fs->index , filename );
+static bool block_fs_has_file__( const block_fs_type * block_fs , const char * filename , uint32_t hash_value) {
+  return (node_index_get( block_fs->index , filename , hash_value ) != NULL);
 }
 
 
 
-bool block_fs_has_file( block_fs_type * block_fs , const char * filename) {
+bool block_fs_has_file_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value) {
   bool has_file;
   block_fs_aquire_rlock( block_fs );
   {
-    has_file = block_fs_has_file__( block_fs , filename );
+    has_file = block_fs_has_file__( block_fs , filename , hash_value );
   }
   block_fs_release_rwlock( block_fs );
   return has_file;
 }
 
 
+bool block_fs_has_file( block_fs_type * block_fs , const char * filename) {
+  return block_fs_has_file_hashed( block_fs , filename , block_fs_key_hash( filename ));
+}
+
+
 
 
-static void block_fs_unlink_file__( block_fs_type * block_fs , const char * filename ) {
-  file_node_type * node = hash_pop( block_fs->index , filename );
+static void block_fs_unlink_file__( block_fs_type * block_fs , const char * filename , uint32_t hash_value ) {
+  file_node_type * node = node_index_pop( block_fs->index , filename , hash_value );
+  if (node == NULL)
+    util_abort("%s: the file:%s does not exist in the filesystem mounted at:%s \n",__func__ , filename , block_fs->mount_file);
   block_fs_clear_cache_node( block_fs , node );
 
+  block_fs_drop_pending__( block_fs , node );
   node->status      = NODE_FREE;
   node->data_offset = 0;
   node->data_size   = 0;
@@ -1213,10 +1536,10 @@ double block_fs_get_fragmentation( const block_fs_type * block_fs ) {
 }
 
 
-void block_fs_unlink_file( block_fs_type * block_fs , const char * filename) {
+void block_fs_unlink_file_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value) {
   block_fs_aquire_wlock( block_fs );
 
-  block_fs_unlink_file__( block_fs , filename );
+  block_fs_unlink_file__( block_fs , filename , hash_value );
   if (block_fs_get_fragmentation( block_fs ) > block_fs->fragmentation_limit) 
     block_fs_rotate__( block_fs );
   
@@ -1224,6 +1547,11 @@ void block_fs_unlink_file( block_fs_type * block_fs , const char * filename) {
 }
 
 
+void block_fs_unlink_file( block_fs_type * block_fs , const char * filename) {
+  block_fs_unlink_file_hashed( block_fs , filename , block_fs_key_hash( filename ));
+}
+
+
 /**
    This function can be used to initiate explicit rotate of the file
    system, observe the following.
@@ -1260,7 +1588,7 @@ bool block_fs_rotate( block_fs_type * block_fs , double fragmentation_limit) {
    Could possibly use fdatasync() to improve speed slightly?
 */
 
-void block_fs_fsync( block_fs_type * block_fs ) {
+static void block_fs_fsync__( block_fs_type * block_fs ) {
   if (block_fs->data_owner) {
     //fdatasync( block_fs->data_fd );
     fsync( block_fs->data_fd );
@@ -1270,6 +1598,303 @@ void block_fs_fsync( block_fs_type * block_fs ) {
 }
 
 
+/**
+   In write-behind mode this is the commit point: all the pending
+   writes are written to disk, followed by one fsync().
+*/
+
+void block_fs_fsync( block_fs_type * block_fs ) {
+  if (block_fs->data_owner) {
+    block_fs_aquire_wlock( block_fs );
+    block_fs_commit__( block_fs );
+    block_fs_fsync__( block_fs );
+    block_fs_release_rwlock( block_fs );
+  }
+}
+
+
+
+
+/*****************************************************************/
+/* Write-behind mode: staging of writes and the batched commit.  */
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+
+static void pending_write_free( pending_write_type * pending ) {
+  free( pending->key );
+  util_safe_free( pending->data );
+  free( pending );
+}
+
+
+static void pending_write_free__( void * arg ) {
+  pending_write_free( (pending_write_type *) arg );
+}
+
+
+/*
+  Sorts the pending writes on the offset of the node in the data file;
+  pending writes which have been detached from their node sort first.
+*/
+
+static int pending_write_cmp( const void * arg1 , const void * arg2 ) {
+  const pending_write_type * pending1 = (const pending_write_type *) arg1;
+  const pending_write_type * pending2 = (const pending_write_type *) arg2;
+  long int offset1 = (pending1->file_node == NULL) ? -1 : pending1->file_node->node_offset;
+  long int offset2 = (pending2->file_node == NULL) ? -1 : pending2->file_node->node_offset;
+
+  if (offset1 < offset2)
+    return -1;
+  else if (offset1 > offset2)
+    return 1;
+  else
+    return 0;
+}
+
+
+/*
+  Will assemble the node header as written by file_node_fwrite(), but
+  with the NODE_WRITE_ACTIVE_START tag in the place of the status. The
+  size of the header is the data_offset of the node.
+*/
+
+static int pending_write_init_header( const pending_write_type * pending , char * header ) {
+  const file_node_type * node = pending->file_node;
+  int status    = NODE_WRITE_ACTIVE_START;
+  int key_len   = strlen( pending->key );
+  int len_tag   = (key_len == 0) ? -1 : key_len;   /* As util_fwrite_string(). */
+  char * ptr    = header;
+
+  memcpy( ptr , &status , sizeof status );                   ptr += sizeof status;
+  memcpy( ptr , &len_tag , sizeof len_tag );                 ptr += sizeof len_tag;
+  memcpy( ptr , pending->key , key_len + 1 );                ptr += key_len + 1;
+  memcpy( ptr , &node->node_size , sizeof node->node_size ); ptr += sizeof node->node_size;
+  memcpy( ptr , &node->data_size , sizeof node->data_size ); ptr += sizeof node->data_size;
+
+  if ((ptr - header) != node->data_offset)
+    util_abort("%s: internal error - header size:%d data_offset:%d \n",__func__ , (int) (ptr - header) , node->data_offset);
+
+  return ptr - header;
+}
+
+
+static void block_fs_pwrite_int__( block_fs_type * block_fs , long int offset , int value) {
+  if (pwrite( block_fs->data_fd , &value , sizeof value , offset ) != sizeof value)
+    util_abort("%s: failed to write to %s - aborting.\n %s(%d) \n",__func__ , block_fs->data_file , strerror(errno) , errno);
+}
+
+
+/*
+  Writes all of @iov at @offset; pwritev() may return after writing
+  only parts of the data, in which case the remaining part is written
+  with new calls. None of the iovec elements can have zero length.
+*/
+
+static void block_fs_pwritev__( block_fs_type * block_fs , long int offset , struct iovec * iov , int iovcnt) {
+  while (iovcnt > 0) {
+    ssize_t bytes_written = pwritev( block_fs->data_fd , iov , iovcnt , offset );
+    if (bytes_written <= 0) {
+      if ((bytes_written < 0) && (errno == EINTR))
+        continue;
+      util_abort("%s: failed to write to %s - aborting.\n %s(%d) \n",__func__ , block_fs->data_file , strerror(errno) , errno);
+    }
+
+    offset += bytes_written;
+    while ((iovcnt > 0) && (bytes_written >= (ssize_t) iov->iov_len)) {
+      bytes_written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = (char *) iov->iov_base + bytes_written;
+      iov->iov_len -= bytes_written;
+    }
+  }
+}
+
+
+static void block_fs_stage_write__( block_fs_type * block_fs , const char * filename , file_node_type * node , const void * ptr , int data_size) {
+  pending_write_type * pending = node->pending;
+
+  if (pending != NULL) {
+    /* The file has been written before in this batch - the node is reused for the same key. */
+    block_fs->pending_size -= pending->data_size;
+    pending->data = util_realloc_copy( pending->data , ptr , data_size );
+  } else {
+    pending = util_malloc( sizeof * pending );
+    pending->file_node = node;
+    pending->key       = util_alloc_string_copy( filename );
+    pending->data      = util_alloc_copy( ptr , data_size );
+    node->pending      = pending;
+    vector_append_owned_ref( block_fs->pending_writes , pending , pending_write_free__ );
+  }
+  pending->data_size = data_size;
+  block_fs->pending_size += data_size;
+  block_fs->write_count++;
+}
+
+
+/*
+  Called when a node with a pending write is unlinked; the data is
+  discarded and the pending_write is detached from the node, so that
+  the node can be reused for other data before commit.
+*/
+
+static void block_fs_drop_pending__( block_fs_type * block_fs , file_node_type * node ) {
+  pending_write_type * pending = node->pending;
+  if (pending != NULL) {
+    block_fs->pending_size -= pending->data_size;
+    util_safe_free( pending->data );
+    pending->data      = NULL;
+    pending->file_node = NULL;
+    node->pending      = NULL;
+  }
+}
+
+
+/*
+  Writes all the pending writes to disk; must be called with the write
+  lock held. The nodes are sorted on offset, and each run of adjacent
+  nodes - typically all the new nodes at the end of the file - is
+  written with one pwritev() call. The crash safety is as for
+  block_fs_fwrite__():
+
+    1. The complete nodes are written with the NODE_WRITE_ACTIVE_START
+       and NODE_WRITE_ACTIVE_END tags in place of the status and
+       NODE_END_TAG.
+
+    2. The status and the NODE_END_TAG are written to each node.
+
+  The fsync() is left to the calling scope.
+*/
+
+static void block_fs_commit__( block_fs_type * block_fs ) {
+  const int num_pending = vector_get_size( block_fs->pending_writes );
+  if (num_pending == 0)
+    return;
+
+  /* The headers written by block_fs_unlink_file__() can still be in the stdio buffer. */
+  fflush( block_fs->data_stream );
+  vector_sort( block_fs->pending_writes , pending_write_cmp );
+  {
+    const int write_active_end = NODE_WRITE_ACTIVE_END;
+    size_t header_size = 0;
+    int max_gap = 0;
+    char * headers;
+    char * zero_fill;
+    struct iovec * iov;
+    int i;
+
+    for (i = 0; i < num_pending; i++) {
+      const pending_write_type * pending = vector_iget_const( block_fs->pending_writes , i );
+      const file_node_type * node = pending->file_node;
+      if (node != NULL) {
+        header_size += node->data_offset;
+        max_gap = util_int_max( max_gap , node->node_size - node->data_offset - node->data_size - sizeof NODE_END_TAG );
+      }
+    }
+
+    headers   = util_malloc( util_size_t_max( 1 , header_size ));
+    zero_fill = util_malloc( util_int_max( 1 , max_gap ));
+    iov       = util_calloc( util_int_min( IOV_MAX , 4 * num_pending ) , sizeof * iov );
+    memset( zero_fill , 0 , util_int_max( 1 , max_gap ));
+
+    /* 1: The nodes with write active tags. */
+    {
+      char * header = headers;
+      long int next_offset = 0;
+      i = 0;
+      while (i < num_pending) {
+        long int run_offset = 0;
+        int iovcnt = 0;
+
+        while ((i < num_pending) && (iovcnt + 4 <= IOV_MAX)) {
+          const pending_write_type * pending = vector_iget_const( block_fs->pending_writes , i );
+          const file_node_type * node = pending->file_node;
+
+          if (node != NULL) {
+            int gap = node->node_size - node->data_offset - node->data_size - sizeof NODE_END_TAG;
+
+            if (iovcnt == 0)
+              run_offset = node->node_offset;
+            else if (node->node_offset != next_offset)
+              break;
+
+            iov[iovcnt].iov_base = header;
+            iov[iovcnt].iov_len  = pending_write_init_header( pending , header );
+            header += iov[iovcnt].iov_len;
+            iovcnt++;
+
+            if (node->data_size > 0) {
+              iov[iovcnt].iov_base = pending->data;
+              iov[iovcnt].iov_len  = node->data_size;
+              iovcnt++;
+            }
+
+            if (gap > 0) {
+              iov[iovcnt].iov_base = zero_fill;
+              iov[iovcnt].iov_len  = gap;
+              iovcnt++;
+            }
+
+            iov[iovcnt].iov_base = (void *) &write_active_end;
+            iov[iovcnt].iov_len  = sizeof write_active_end;
+            iovcnt++;
+
+            next_offset = node->node_offset + node->node_size;
+          }
+          i++;
+        }
+
+        if (iovcnt > 0)
+          block_fs_pwritev__( block_fs , run_offset , iov , iovcnt );
+      }
+    }
+
+    /* 2: Replace the write active tags - the nodes are now complete. */
+    for (i = 0; i < num_pending; i++) {
+      const pending_write_type * pending = vector_iget_const( block_fs->pending_writes , i );
+      file_node_type * node = pending->file_node;
+      if (node != NULL) {
+        block_fs_pwrite_int__( block_fs , node->node_offset , node->status );
+        block_fs_pwrite_int__( block_fs , node->node_offset + node->node_size - sizeof NODE_END_TAG , NODE_END_TAG );
+        node->pending = NULL;
+      }
+    }
+
+    free( iov );
+    free( zero_fill );
+    free( headers );
+  }
+  vector_clear( block_fs->pending_writes );
+  block_fs->pending_size = 0;
+}
+
+
+/**
+   Will enable write-behind mode for the filesystem: the data of
+   subsequent writes is kept in memory, and written to disk together
+   when more than @max_pending_size bytes are pending, on
+   block_fs_fsync() and when the filesystem is closed or rotated. In
+   write-behind mode the fsync_interval of the filesystem is ignored;
+   there is one fsync() per block_fs_fsync() call. Setting
+   @max_pending_size to zero will commit the pending writes and return
+   to the normal mode where each write goes directly to disk.
+*/
+
+void block_fs_set_write_behind( block_fs_type * block_fs , size_t max_pending_size ) {
+  block_fs_aquire_wlock( block_fs );
+  block_fs->max_pending_size = max_pending_size;
+  if (max_pending_size == 0) {
+    block_fs_commit__( block_fs );
+    block_fs_fsync__( block_fs );
+  }
+  block_fs_release_rwlock( block_fs );
+}
+
 
 
 /**
@@ -1303,7 +1928,16 @@ static void block_fs_fwrite__(block_fs_type * block_fs , const char * filename ,
     return;
 #endif
 
-  else {
+  else if (block_fs->max_pending_size > 0) {
+    node->status      = NODE_IN_USE;
+    node->data_size   = data_size; 
+    file_node_set_data_offset( node , filename );
+
+    block_fs_stage_write__( block_fs , filename , node , ptr , data_size );
+    block_fs_update_cache_node( block_fs , node , data_size , ptr);
+    if (block_fs->pending_size > block_fs->max_pending_size)
+      block_fs_commit__( block_fs );
+  } else {
     block_fs_fseek(block_fs , node->node_offset);
     node->status      = NODE_IN_USE;
     node->data_size   = data_size; 
@@ -1319,23 +1953,26 @@ static void block_fs_fwrite__(block_fs_type * block_fs , const char * filename ,
     /* Writes the file node header data, including the NODE_END_TAG. */
     file_node_fwrite( node , filename , block_fs->data_stream );
 
+    /* The readers use pread() on the data_fd and bypass the stdio buffer of data_stream. */
+    fflush( block_fs->data_stream );
+
     block_fs_update_cache_node( block_fs , node , data_size , ptr);
     block_fs->write_count++;
     if (block_fs->fsync_interval && ((block_fs->write_count % block_fs->fsync_interval) == 0)) 
-      block_fs_fsync( block_fs );
+      block_fs_fsync__( block_fs );
     
   }
 }
 
 
 
-static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char * filename , uint32_t hash_value , const void * ptr , size_t data_size) {
   file_node_type * file_node;
   bool   new_node = true;   
   size_t min_size = data_size + file_node_header_size( filename );
   
-  if (block_fs_has_file__( block_fs , filename )) {
-    file_node = hash_get( block_fs->index , filename );
+  if (block_fs_has_file__( block_fs , filename , hash_value )) {
+    file_node = block_fs_get_index_node( block_fs , filename , hash_value );
     if (file_node->node_size < min_size) {
       /* 
          The current node is too small for the new content:
@@ -1346,7 +1983,7 @@ static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char
          2. Get a new node.
         
       */
-      block_fs_unlink_file__( block_fs , filename );
+      block_fs_unlink_file__( block_fs , filename , hash_value );
       file_node = block_fs_get_new_node( block_fs , filename , min_size );
     } else
       new_node = false;  /* We are reusing the existing node. */
@@ -1357,15 +1994,15 @@ static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char
   /* The actual writing ... */
   block_fs_fwrite__( block_fs , filename , file_node , ptr , data_size);
   if (new_node)
-    block_fs_insert_index_node(block_fs , filename , file_node);
+    block_fs_insert_index_node(block_fs , filename , hash_value , file_node);
 }
 
 
 
-void block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+static void block_fs_fwrite_file_hashed(block_fs_type * block_fs , const char * filename , uint32_t hash_value , const void * ptr , size_t data_size) {
   block_fs_aquire_wlock( block_fs );
   {
-    block_fs_fwrite_file_unlocked( block_fs , filename , ptr , data_size );
+    block_fs_fwrite_file_unlocked( block_fs , filename , hash_value , ptr , data_size );
     
     /* OKAY - this is going to take some time ... */
     if ((block_fs->free_size * 1.0 / block_fs->data_file_size) > block_fs->fragmentation_limit)
@@ -1376,6 +2013,11 @@ void block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , con
 }
 
 
+void block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+  block_fs_fwrite_file_hashed( block_fs , filename , block_fs_key_hash( filename ) , ptr , data_size );
+}
+
+
 void block_fs_defrag( block_fs_type * block_fs ) {
   block_fs_aquire_wlock( block_fs );
   block_fs_rotate__( block_fs );
@@ -1383,15 +2025,40 @@ void block_fs_defrag( block_fs_type * block_fs ) {
 }
 
 
+void block_fs_fwrite_buffer_hashed(block_fs_type * block_fs , const char * filename , uint32_t hash_value , const buffer_type * buffer) {
+  block_fs_fwrite_file_hashed( block_fs , filename , hash_value , buffer_get_data( buffer ) , buffer_get_size( buffer ));
+}
+
+
 void block_fs_fwrite_buffer(block_fs_type * block_fs , const char * filename , const buffer_type * buffer) {
-  block_fs_fwrite_file( block_fs , filename , buffer_get_data( buffer ) , buffer_get_size( buffer ));
+  block_fs_fwrite_buffer_hashed( block_fs , filename , block_fs_key_hash( filename ) , buffer );
 }
 
 
 /**
-   Need extra locking here - because the global rwlock allows many
-   concurrent readers.
+   Positional read from the data file. The data file is only written
+   while holding the write lock, and all writes are flushed from the
+   data_stream before the lock is released; since pread() does not use
+   or update the file position many readers holding the read lock can
+   read concurrently without any further locking.
 */
+
+static void block_fs_pread__(const block_fs_type * block_fs , long int offset , void * ptr , size_t read_bytes) {
+  char * target_ptr = ptr;
+  size_t total_read = 0;
+
+  while (total_read < read_bytes) {
+    ssize_t bytes_read = pread( block_fs->data_fd , &target_ptr[total_read] , read_bytes - total_read , offset + total_read );
+    if (bytes_read > 0)
+      total_read += bytes_read;
+    else if ((bytes_read < 0) && (errno == EINTR))
+      continue;
+    else
+      util_abort("%s: only read %zu/%zu bytes from %s - aborting.\n %s(%d) \n",__func__ , total_read , read_bytes , block_fs->data_file , strerror(errno) , errno);
+  }
+}
+
+
 static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * file_node , void * ptr , size_t read_bytes) {
 
 #ifdef ENABLE_CACHE  
@@ -1403,11 +2070,10 @@ static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * f
 #endif
 
   {
-    pthread_mutex_lock( &block_fs->io_lock );
-    block_fs_fseek_node_data( block_fs , file_node );
-    util_fread( ptr , 1 , read_bytes , block_fs->data_stream , __func__);
-    //file_node_verify_end_tag( file_node , block_fs->data_stream );
-    pthread_mutex_unlock( &block_fs->io_lock );
+    if (file_node->pending != NULL)
+      memcpy( ptr , file_node->pending->data , read_bytes );
+    else
+      block_fs_pread__( block_fs , file_node->node_offset + file_node->data_offset , ptr , read_bytes );
   }
 }
 
@@ -1416,16 +2082,16 @@ static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * f
    Reads the full content of 'filename' into the buffer. 
 */
 
-void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * filename , buffer_type * buffer) {
+void block_fs_fread_realloc_buffer_hashed( block_fs_type * block_fs , const char * filename , uint32_t hash_value , buffer_type * buffer) {
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename);
+    file_node_type * node = block_fs_get_index_node( block_fs , filename , hash_value );
     
     buffer_clear( buffer );   /* Setting: content_size = 0; pos = 0;  */
     {
       /* 
          Going low-level - essentially a second implementation of
-         block_fs_fread__():
+         block_fs_fread__(), reading directly into the buffer storage:
       */
 
 #ifdef ENABLE_CACHE
@@ -1437,11 +2103,11 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 #endif
 
       {
-        pthread_mutex_lock( &block_fs->io_lock );
-        block_fs_fseek_node_data(block_fs , node );
-        buffer_stream_fread( buffer , node->data_size , block_fs->data_stream );
-        //file_node_verify_end_tag( node , block_fs->data_stream );
-        pthread_mutex_unlock( &block_fs->io_lock );
+        void * ptr = buffer_fwrite_reserve( buffer , node->data_size );
+        if (node->pending != NULL)
+          memcpy( ptr , node->pending->data , node->data_size );
+        else
+          block_fs_pread__( block_fs , node->node_offset + node->data_offset , ptr , node->data_size );
       }
       
     }
@@ -1451,6 +2117,11 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 }
 
 
+void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * filename , buffer_type * buffer) {
+  block_fs_fread_realloc_buffer_hashed( block_fs , filename , block_fs_key_hash( filename ) , buffer );
+}
+
+
 
 
 
@@ -1467,7 +2138,7 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 void block_fs_fread_file( block_fs_type * block_fs , const char * filename , void * ptr) {
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename);
+    file_node_type * node = block_fs_get_index_node( block_fs , filename , block_fs_key_hash( filename ));
     block_fs_fread__( block_fs , node , ptr , node->data_size);
   }
   block_fs_release_rwlock( block_fs );
@@ -1479,7 +2150,7 @@ int block_fs_get_filesize( block_fs_type * block_fs , const char * filename) {
   int data_size;
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename );
+    file_node_type * node = block_fs_get_index_node( block_fs , filename , block_fs_key_hash( filename ));
     data_size = node->data_size;
   }
   block_fs_release_rwlock( block_fs );
@@ -1494,38 +2165,63 @@ static void block_fs_dump_index( block_fs_type * block_fs ) {
     if (stat_return != 0)
       return;
     {
-      time_t data_mtime = stat_buffer.st_mtime;
-      FILE * index_stream = util_fopen( block_fs->index_file , "w");
-      util_fwrite_int( INDEX_MAGIC_INT , index_stream );
-      util_fwrite_int( INDEX_FORMAT_VERSION , index_stream );
-      util_fwrite_time_t( data_mtime , index_stream );
-
-      /* 1: Dumping the hash table of active nodes. */
-      {
-        hash_iter_type * index_iter = hash_iter_alloc( block_fs->index );
-        
-        util_fwrite_int( hash_get_size( block_fs->index ) , index_stream);
-        while (!hash_iter_is_complete( index_iter )) {
-          const char * key = hash_iter_get_next_key( index_iter );
-          const file_node_type * file_node = hash_get( block_fs->index , key );
-          
-          util_fwrite_string( key , index_stream);
-          file_node_dump_index( file_node , index_stream );
+      const node_index_type * index = block_fs->index;
+      time_t data_mtime             = stat_buffer.st_mtime;
+      int num_active_nodes          = node_index_get_size( index );
+      int num_records               = num_active_nodes + block_fs->num_free_nodes;
+      index_record_type * records   = util_calloc( num_records , sizeof * records );
+      size_t key_pool_size          = 0;
+      char * key_pool;
+      int irecord = 0;
+
+      /* 1: Records and keys of the active nodes. */
+      for (int i = 0; i < index->capacity; i++) {
+        if (index_slot_in_use( &index->slots[i] ))
+          key_pool_size += strlen( index->slots[i].key ) + 1;
+      }
+      key_pool      = util_malloc( key_pool_size );
+      key_pool_size = 0;
+      for (int i = 0; i < index->capacity; i++) {
+        const index_slot_type * slot = &index->slots[i];
+        if (index_slot_in_use( slot )) {
+          index_record_type * record = &records[irecord];
+          size_t key_size = strlen( slot->key ) + 1;
+
+          file_node_fill_index_record( slot->file_node , record );
+          record->key_offset = key_pool_size;
+          record->hash_value = slot->hash_value;
+          memcpy( &key_pool[key_pool_size] , slot->key , key_size );
+
+          key_pool_size += key_size;
+          irecord++;
         }
-        hash_iter_free( index_iter );
       }
       
-      /* 2: Dumping information about empty slots in the datafile. */
-      util_fwrite_int( block_fs->num_free_nodes , index_stream );
+      /* 2: Records of the empty slots in the datafile. */
       {
         free_node_type * current = block_fs->free_nodes;
         while ( current != NULL) {
-          file_node_dump_index( current->file_node , index_stream );
+          file_node_fill_index_record( current->file_node , &records[irecord] );
           current = current->next;
+          irecord++;
         }
       }
+
+      {
+        FILE * index_stream = util_fopen( block_fs->index_file , "w");
+        util_fwrite_int( INDEX_MAGIC_INT , index_stream );
+        util_fwrite_int( INDEX_FORMAT_VERSION , index_stream );
+        util_fwrite_time_t( data_mtime , index_stream );
+        util_fwrite_int( num_active_nodes , index_stream );
+        util_fwrite_int( block_fs->num_free_nodes , index_stream );
+        util_fwrite_long( key_pool_size , index_stream );
+        util_fwrite( records , sizeof * records , num_records , index_stream , __func__ );
+        util_fwrite( key_pool , 1 , key_pool_size , index_stream , __func__ );
+        fclose( index_stream );
+      }
       
-      fclose( index_stream );
+      util_safe_free( key_pool );
+      util_safe_free( records );
     }
   }
 }
@@ -1557,7 +2253,7 @@ void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
   }
 
   if (block_fs->data_owner) {
-    if ( unlink_empty && (hash_get_size( block_fs->index) == 0)) {
+    if ( unlink_empty && (node_index_get_size( block_fs->index) == 0)) {
       util_unlink_existing( block_fs->data_file );
       util_unlink_existing( block_fs->index_file );
       util_unlink_existing( block_fs->mount_file );
@@ -1573,8 +2269,10 @@ void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
   free( block_fs->mount_file );
   
   free_node_free_list( block_fs->free_nodes );
-  hash_free( block_fs->index );
+  node_index_free( block_fs->index );
   vector_free( block_fs->file_nodes );
+  util_safe_free( block_fs->index_nodes );
+  vector_free( block_fs->pending_writes );
   free( block_fs );
 }
 
@@ -1590,18 +2288,27 @@ void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
    
    Observe that the block_fs instance should hold the write lock when
    entering this function.
+
+   The mount map is only updated to point to the new version after all
+   the nodes have been committed and synced to the new data file, and
+   the old data file is deleted after that; if the process dies during
+   the rotation the old version is still mounted the next time.
 */
 
 static void block_fs_rotate__( block_fs_type * block_fs ) {
+  /* The old data file must be complete before it is played over to the new file. */
+  block_fs_commit__( block_fs );
+
   /* 
-     Write a updated mount map where the version info has been bumped
-     up with one; the new_fs will mount based on this mount_file.
+     Bump the version, which gives new data and lock filenames. A
+     new data file left behind by an earlier rotation which did not
+     complete is removed.
   */
   block_fs->version++;
-  block_fs_fwrite_mount_info__( block_fs->mount_file , block_fs->version ); 
   {
     vector_type    * old_nodes         = block_fs->file_nodes;
-    hash_type      * old_index         = block_fs->index;
+    file_node_type * old_index_nodes   = block_fs->index_nodes;
+    node_index_type * old_index        = block_fs->index;
     FILE           * old_data_stream   = block_fs->data_stream;
     free_node_type * old_free_nodes    = block_fs->free_nodes;
     char           * old_data_file     = util_alloc_string_copy( block_fs->data_file );
@@ -1612,26 +2319,40 @@ static void block_fs_rotate__( block_fs_type * block_fs ) {
         Now the block_fs pointers point to the new copy. Must use the
         old_xxx pointers to access the existing.
     */
+    util_unlink_existing( block_fs->data_file );
     block_fs_open_data( block_fs , block_fs->data_owner );
+    node_index_resize( block_fs->index , node_index_get_size( old_index ));
     {
-      hash_iter_type * iter = hash_iter_alloc( old_index );
       buffer_type * buffer  = buffer_alloc(1024);
       
-      while (!hash_iter_is_complete( iter )) {
-        const char * key          = hash_iter_get_next_key( iter );
-        file_node_type * old_node = hash_get( old_index , key );
-        buffer_clear( buffer );
-
-        /* Low level read of the old file. */
-        fseek__( old_data_stream , old_node->node_offset + old_node->data_offset , SEEK_SET );
-        buffer_stream_fread( buffer , old_node->data_size , old_data_stream );
+      for (int i = 0; i < old_index->capacity; i++) {
+        const index_slot_type * slot = &old_index->slots[i];
+        if (index_slot_in_use( slot )) {
+          const file_node_type * old_node = slot->file_node;
+          buffer_clear( buffer );
+
+          /* Low level read of the old file. */
+          fseek__( old_data_stream , old_node->node_offset + old_node->data_offset , SEEK_SET );
+          buffer_stream_fread( buffer , old_node->data_size , old_data_stream );
         
-        block_fs_fwrite_file_unlocked( block_fs , key , buffer_get_data( buffer ) , buffer_get_size( buffer ));  /* Normal write to the new file. */
+          block_fs_fwrite_file_unlocked( block_fs , slot->key , slot->hash_value , buffer_get_data( buffer ) , buffer_get_size( buffer ));  /* Normal write to the new file. */
+        }
       }
       
       buffer_free( buffer );
-      hash_iter_free( iter );
     }
+
+    /*
+      In write-behind mode the replayed nodes are still in memory;
+      they must be on disk before the mount map is switched to the new
+      version and the old data file is deleted. The index file
+      describes the old data file and is removed.
+    */
+    block_fs_commit__( block_fs );
+    block_fs_fsync__( block_fs );
+    util_unlink_existing( block_fs->index_file );
+    block_fs_fwrite_mount_info__( block_fs->mount_file , block_fs->version ); 
+
     /*
       OK - everything has been played over, and we should clean up the old fs:
 
@@ -1649,8 +2370,9 @@ static void block_fs_rotate__( block_fs_type * block_fs ) {
     free( old_data_file );
     
     free_node_free_list( old_free_nodes );
-    hash_free( old_index );
+    node_index_free( old_index );
     vector_free( old_nodes );
+    util_safe_free( old_index_nodes );
   }
 }
 
@@ -1772,16 +2494,14 @@ vector_type * block_fs_alloc_filelist( block_fs_type * block_fs  , const char *
   /* Inserting the nodes from the index. */
   block_fs_aquire_rlock( block_fs );
   {
-    hash_iter_type * iter        = hash_iter_alloc( block_fs->index );
-    while ( !hash_iter_is_complete( iter )) {
-      const char * key            = hash_iter_get_next_key( iter );
-      file_node_type * node = hash_get( block_fs->index , key );
-      if (pattern_match( pattern , key )) {
-        user_file_node_type * unode = user_file_node_alloc( key , node );
+    const node_index_type * index = block_fs->index;
+    for (int i = 0; i < index->capacity; i++) {
+      const index_slot_type * slot = &index->slots[i];
+      if (index_slot_in_use( slot ) && pattern_match( pattern , slot->key )) {
+        user_file_node_type * unode = user_file_node_alloc( slot->key , slot->file_node );
         vector_append_owned_ref( sort_vector , unode , user_file_node_free__ );
       }
     }
-    hash_iter_free( iter );
   }
   block_fs_release_rwlock( block_fs );
 
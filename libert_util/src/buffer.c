@@ -715,6 +715,29 @@ void buffer_stream_fread( buffer_type * buffer , size_t byte_size , FILE * strea
 }
 
 
+/**
+   Will make room for @byte_size bytes at the current position, and
+   update the position and content size as if @byte_size bytes had
+   been written. The return value is a pointer to the reserved
+   storage, which the calling scope should fill before the buffer is
+   resized again. Can be used to read data into the buffer with
+   functions which do not operate on a FILE *.
+*/
+
+void * buffer_fwrite_reserve( buffer_type * buffer , size_t byte_size ) {
+  size_t min_size = byte_size + buffer->pos;
+  void * ptr;
+  if (buffer->alloc_size < min_size)
+    buffer_resize__(buffer , min_size , true);
+
+  ptr = &buffer->data[buffer->pos];
+  buffer->pos += byte_size;
+  buffer->content_size = util_size_t_max(buffer->content_size , buffer->pos);
+
+  return ptr;
+}
+
+
 
 
 /**
@@ -809,5 +832,6 @@ void buffer_store(const buffer_type * buffer , const char * filename) {
 
 #ifdef ERT_HAVE_ZLIB
 #include "buffer_zlib.c"
+#include "buffer_codec.c"
 #endif
 
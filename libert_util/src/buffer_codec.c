@@ -0,0 +1,590 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'buffer_codec.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+/*
+  This file is compiled as part of the buffer.c file, after
+  buffer_zlib.c; if the symbol ERT_HAVE_ZLIB is defined.
+
+  Encoded storage of numerical arrays. The data can be passed through
+  two lossless filters before compression:
+
+    BUFFER_FILTER_DELTA: Each element (4 or 8 bytes) is replaced with
+       the integer difference from the previous element. For smooth
+       float fields the neighbouring values mostly share sign,
+       exponent and the leading mantissa bits, and the differences
+       are small numbers.
+
+    BUFFER_FILTER_SHUFFLE: The bytes are regrouped so that byte 0 of
+       all elements comes first, then byte 1 of all elements and so
+       on. The slowly varying high bytes then form long runs which
+       compress well.
+
+  and the (filtered) data are then compressed with one of the codecs
+  in buffer_codec_enum: zlib at a given level, no compression, or the
+  small LZ77 codec implemented below.
+
+  Layout of encoded data in the buffer:
+
+    | BUFFER_CODEC_MAGIC | codec | filters | element_size | payload |
+
+  Data encoded with the default codec - zlib at default level without
+  filters - is written by buffer_fwrite_compressed() without any
+  header, i.e. exactly as all data was written before the codecs were
+  introduced, and can be read by older versions. The reader
+  buffer_fread_encoded() will recognize the header, and read all
+  other data as plain zlib. The first byte of BUFFER_CODEC_MAGIC is
+  3, whereas the first byte of a zlib stream always has 8 in the low
+  nibble - so the two can not be confused.
+*/
+
+#include <stdint.h>
+
+#define BUFFER_CODEC_MAGIC   436245763
+#define BUFFER_CODEC_HEADER_SIZE  (4 * sizeof(int))
+
+/*****************************************************************/
+/* LZ codec */
+
+/*
+  A byte oriented LZ77 codec in the style of LZ4; it compresses less
+  than zlib, but both compression and in particular decompression are
+  several times faster. The compressed stream is a sequence of:
+
+    | token | [literal length bytes] | literals | offset (2 bytes) | [match length bytes] |
+
+  The high nibble of the token is the number of literals and the low
+  nibble is the match length minus LZ_MIN_MATCH; a nibble value of 15
+  is continued with bytes which are added to the length until a byte
+  different from 255 is found. The offset is the little endian
+  distance back to the start of the match. The last sequence of the
+  stream only contains literals.
+
+  The compressor is greedy, with a hash table of the last position
+  where each four byte sequence was seen.
+*/
+
+#define LZ_MIN_MATCH   4
+#define LZ_MAX_OFFSET  65535
+#define LZ_HASH_LOG    14
+
+
+static size_t buffer_lz_bound( size_t size ) {
+  return size + size / 255 + 16;
+}
+
+
+static uint32_t buffer_lz_read32( const unsigned char * p ) {
+  uint32_t value;
+  memcpy( &value , p , sizeof value );
+  return value;
+}
+
+
+static uint32_t buffer_lz_hash( uint32_t value ) {
+  return (value * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+
+static unsigned char * buffer_lz_write_length( unsigned char * op , size_t length ) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = (unsigned char) length;
+  return op;
+}
+
+
+static unsigned char * buffer_lz_write_literals( unsigned char * op , unsigned char * token , const unsigned char * literals , size_t length ) {
+  *token = (unsigned char) (util_size_t_min( length , 15 ) << 4);
+  if (length >= 15)
+    op = buffer_lz_write_length( op , length - 15 );
+
+  memcpy( op , literals , length );
+  return op + length;
+}
+
+
+/*
+  The target must have room for buffer_lz_bound( src_size ) bytes;
+  the return value is the compressed size.
+*/
+
+static size_t buffer_lz_compress( const unsigned char * src , size_t src_size , unsigned char * target ) {
+  uint32_t * table           = util_calloc( 1 << LZ_HASH_LOG , sizeof * table );
+  const unsigned char * end  = src + src_size;
+  const unsigned char * ip   = src;
+  const unsigned char * anchor = src;
+  unsigned char * op = target;
+
+  memset( table , 0 , (1 << LZ_HASH_LOG) * sizeof * table );
+  while (ip + LZ_MIN_MATCH <= end) {
+    uint32_t sequence          = buffer_lz_read32( ip );
+    uint32_t hash              = buffer_lz_hash( sequence );
+    const unsigned char * ref  = src + table[hash];
+
+    table[hash] = ip - src;
+    if ((ref < ip) && ((ip - ref) <= LZ_MAX_OFFSET) && (buffer_lz_read32( ref ) == sequence)) {
+      const unsigned char * match_end = ip + LZ_MIN_MATCH;
+      const unsigned char * ref_end   = ref + LZ_MIN_MATCH;
+      size_t offset = ip - ref;
+      size_t match_length;
+      unsigned char * token = op++;
+
+      while ((match_end < end) && (*match_end == *ref_end)) {
+        match_end++;
+        ref_end++;
+      }
+      match_length = match_end - ip - LZ_MIN_MATCH;
+
+      op = buffer_lz_write_literals( op , token , anchor , ip - anchor );
+      *op++ = offset & 0xFF;
+      *op++ = offset >> 8;
+
+      *token |= (unsigned char) util_size_t_min( match_length , 15 );
+      if (match_length >= 15)
+        op = buffer_lz_write_length( op , match_length - 15 );
+
+      ip     = match_end;
+      anchor = ip;
+    } else
+      /* Skip faster through data which does not compress. */
+      ip += 1 + ((ip - anchor) >> 6);
+  }
+
+  {
+    unsigned char * token = op++;
+    op = buffer_lz_write_literals( op , token , anchor , end - anchor );
+  }
+  free( table );
+  return op - target;
+}
+
+
+static bool buffer_lz_read_length( const unsigned char ** ip , const unsigned char * end , size_t * length) {
+  unsigned char c;
+  do {
+    if (*ip >= end)
+      return false;
+    c = **ip;
+    (*ip)++;
+    *length += c;
+  } while (c == 255);
+  return true;
+}
+
+
+/*
+  Will return false if the compressed data is corrupt, or does not
+  decompress to exactly target_size bytes.
+*/
+
+static bool buffer_lz_decompress( const unsigned char * src , size_t src_size , unsigned char * target , size_t target_size ) {
+  const unsigned char * ip   = src;
+  const unsigned char * iend = src + src_size;
+  unsigned char * op   = target;
+  unsigned char * oend = target + target_size;
+
+  while (ip < iend) {
+    unsigned char token = *ip++;
+    size_t length = token >> 4;
+
+    if ((length == 15) && !buffer_lz_read_length( &ip , iend , &length ))
+      return false;
+
+    if (((size_t) (iend - ip) < length) || ((size_t) (oend - op) < length))
+      return false;
+
+    memcpy( op , ip , length );
+    op += length;
+    ip += length;
+    if (ip == iend)
+      break;   /* The last sequence. */
+
+    {
+      size_t offset;
+      if ((iend - ip) < 2)
+        return false;
+
+      offset = ip[0] | (ip[1] << 8);
+      ip += 2;
+      if ((offset == 0) || (offset > (size_t) (op - target)))
+        return false;
+
+      length = token & 15;
+      if ((length == 15) && !buffer_lz_read_length( &ip , iend , &length ))
+        return false;
+      length += LZ_MIN_MATCH;
+
+      if ((size_t) (oend - op) < length)
+        return false;
+
+      {
+        const unsigned char * ref = op - offset;
+        if (offset >= length)
+          memcpy( op , ref , length );
+        else {
+          /* Overlapping match - a repeated pattern. */
+          for (size_t i = 0; i < length; i++)
+            op[i] = ref[i];
+        }
+        op += length;
+      }
+    }
+  }
+  return (op == oend);
+}
+
+/*****************************************************************/
+/* Filters */
+
+static uint64_t buffer_codec_load( const unsigned char * p , size_t element_size ) {
+  if (element_size == 4) {
+    uint32_t value;
+    memcpy( &value , p , sizeof value );
+    return value;
+  } else {
+    uint64_t value;
+    memcpy( &value , p , sizeof value );
+    return value;
+  }
+}
+
+
+static void buffer_codec_store( unsigned char * p , size_t element_size , uint64_t value) {
+  if (element_size == 4) {
+    uint32_t value32 = (uint32_t) value;
+    memcpy( p , &value32 , sizeof value32 );
+  } else
+    memcpy( p , &value , sizeof value );
+}
+
+
+/*
+  The delta filter is only applied for element_size 4 and 8 - that is
+  ensured by buffer_fwrite_encoded(). Bytes at the end which do not
+  form a complete element are copied unchanged.
+*/
+
+static void buffer_codec_filter( const unsigned char * src , unsigned char * target , size_t byte_size , size_t element_size , int filters) {
+  size_t elements = byte_size / element_size;
+  bool shuffle    = (filters & BUFFER_FILTER_SHUFFLE);
+
+  if (filters & BUFFER_FILTER_DELTA) {
+    uint64_t prev = 0;
+    unsigned char bytes[8];
+    for (size_t i = 0; i < elements; i++) {
+      uint64_t value = buffer_codec_load( &src[i * element_size] , element_size );
+      if (shuffle) {
+        buffer_codec_store( bytes , element_size , value - prev );
+        for (size_t b = 0; b < element_size; b++)
+          target[b * elements + i] = bytes[b];
+      } else
+        buffer_codec_store( &target[i * element_size] , element_size , value - prev );
+      prev = value;
+    }
+  } else if (shuffle) {
+    for (size_t b = 0; b < element_size; b++)
+      for (size_t i = 0; i < elements; i++)
+        target[b * elements + i] = src[i * element_size + b];
+  } else
+    memcpy( target , src , elements * element_size );
+
+  memcpy( &target[elements * element_size] , &src[elements * element_size] , byte_size - elements * element_size );
+}
+
+
+static void buffer_codec_unfilter( const unsigned char * src , unsigned char * target , size_t byte_size , size_t element_size , int filters) {
+  size_t elements = byte_size / element_size;
+  bool shuffle    = (filters & BUFFER_FILTER_SHUFFLE);
+
+  if (filters & BUFFER_FILTER_DELTA) {
+    uint64_t prev = 0;
+    unsigned char bytes[8];
+    for (size_t i = 0; i < elements; i++) {
+      uint64_t delta;
+      if (shuffle) {
+        for (size_t b = 0; b < element_size; b++)
+          bytes[b] = src[b * elements + i];
+        delta = buffer_codec_load( bytes , element_size );
+      } else
+        delta = buffer_codec_load( &src[i * element_size] , element_size );
+
+      prev += delta;
+      buffer_codec_store( &target[i * element_size] , element_size , prev );
+    }
+  } else if (shuffle) {
+    for (size_t b = 0; b < element_size; b++)
+      for (size_t i = 0; i < elements; i++)
+        target[i * element_size + b] = src[b * elements + i];
+  } else
+    memcpy( target , src , elements * element_size );
+
+  memcpy( &target[elements * element_size] , &src[elements * element_size] , byte_size - elements * element_size );
+}
+
+/*****************************************************************/
+
+buffer_codec_type buffer_codec_default( void ) {
+  buffer_codec_type codec;
+  codec.codec   = BUFFER_CODEC_ZLIB;
+  codec.level   = 0;
+  codec.filters = 0;
+  return codec;
+}
+
+
+bool buffer_codec_is_default( buffer_codec_type codec ) {
+  return ((codec.codec == BUFFER_CODEC_ZLIB) && (codec.level == 0) && (codec.filters == 0));
+}
+
+
+/**
+   Parses a codec specification of the form:
+
+      [DELTA+][SHUFFLE+]<NONE|LZ|ZLIB|ZLIB1 ... ZLIB9>
+
+   e.g. "SHUFFLE+LZ" or "DELTA+SHUFFLE+ZLIB1". Returns false if the
+   string can not be parsed, in that case *codec is not modified.
+*/
+
+bool buffer_codec_sscanf( const char * spec , buffer_codec_type * codec ) {
+  buffer_codec_type tmp = buffer_codec_default();
+  bool valid = false;
+  char ** tokens;
+  int num_tokens;
+
+  util_split_string( spec , "+" , &num_tokens , &tokens );
+  if (num_tokens > 0) {
+    const char * codec_name = tokens[num_tokens - 1];
+    valid = true;
+
+    for (int i = 0; i < num_tokens - 1; i++) {
+      if (util_string_equal( tokens[i] , "DELTA" ))
+        tmp.filters |= BUFFER_FILTER_DELTA;
+      else if (util_string_equal( tokens[i] , "SHUFFLE" ))
+        tmp.filters |= BUFFER_FILTER_SHUFFLE;
+      else
+        valid = false;
+    }
+
+    if (util_string_equal( codec_name , "NONE" ))
+      tmp.codec = BUFFER_CODEC_NONE;
+    else if (util_string_equal( codec_name , "LZ" ))
+      tmp.codec = BUFFER_CODEC_LZ;
+    else if (util_string_equal( codec_name , "ZLIB" ))
+      tmp.codec = BUFFER_CODEC_ZLIB;
+    else if ((strncmp( codec_name , "ZLIB" , 4 ) == 0) && (strlen( codec_name ) == 5) && (codec_name[4] >= '1') && (codec_name[4] <= '9')) {
+      tmp.codec = BUFFER_CODEC_ZLIB;
+      tmp.level = codec_name[4] - '0';
+    } else
+      valid = false;
+  }
+  util_free_stringlist( tokens , num_tokens );
+
+  if (valid)
+    *codec = tmp;
+  return valid;
+}
+
+
+/**
+   The inverse of buffer_codec_sscanf(); the returned string must be
+   freed by the calling scope.
+*/
+
+char * buffer_codec_alloc_string( buffer_codec_type codec ) {
+  const char * delta   = (codec.filters & BUFFER_FILTER_DELTA)   ? "DELTA+"   : "";
+  const char * shuffle = (codec.filters & BUFFER_FILTER_SHUFFLE) ? "SHUFFLE+" : "";
+
+  switch (codec.codec) {
+  case(BUFFER_CODEC_NONE):
+    return util_alloc_sprintf("%s%sNONE" , delta , shuffle);
+  case(BUFFER_CODEC_LZ):
+    return util_alloc_sprintf("%s%sLZ" , delta , shuffle);
+  case(BUFFER_CODEC_ZLIB):
+    if (codec.level > 0)
+      return util_alloc_sprintf("%s%sZLIB%d" , delta , shuffle , codec.level);
+    else
+      return util_alloc_sprintf("%s%sZLIB" , delta , shuffle);
+  default:
+    util_abort("%s: codec:%d not recognized \n",__func__ , codec.codec);
+    return NULL;
+  }
+}
+
+
+/*
+  Makes sure there is room for max_size bytes at the current position,
+  and returns a pointer to it.
+*/
+
+static unsigned char * buffer_codec_reserve( buffer_type * buffer , size_t max_size ) {
+  size_t remaining_size = buffer->alloc_size - buffer->pos;
+  if (max_size > remaining_size)
+    buffer_resize__( buffer , buffer->alloc_size + max_size , true );
+  return (unsigned char *) &buffer->data[buffer->pos];
+}
+
+
+static void buffer_codec_advance( buffer_type * buffer , size_t size ) {
+  buffer->pos         += size;
+  buffer->content_size = buffer->pos;
+}
+
+
+/**
+   Writes byte_size bytes of data from ptr, which is an array of
+   elements with size element_size, encoded with codec. As with
+   buffer_fwrite_compressed() any content in the buffer after the
+   current position is discarded. The return value is the number of
+   bytes written to the buffer.
+*/
+
+size_t buffer_fwrite_encoded( buffer_type * buffer , const void * ptr , size_t byte_size , size_t element_size , buffer_codec_type codec) {
+  if (buffer_codec_is_default( codec ))
+    return buffer_fwrite_compressed( buffer , ptr , byte_size );
+
+  {
+    size_t start_pos = buffer->pos;
+    int filters      = codec.filters;
+    const unsigned char * data = ptr;
+    unsigned char * work = NULL;
+
+    if ((element_size != 4) && (element_size != 8))
+      filters &= ~BUFFER_FILTER_DELTA;
+    if (element_size < 2)
+      filters &= ~BUFFER_FILTER_SHUFFLE;
+
+    buffer->content_size = buffer->pos;
+    buffer_fwrite_int( buffer , BUFFER_CODEC_MAGIC );
+    buffer_fwrite_int( buffer , codec.codec );
+    buffer_fwrite_int( buffer , filters );
+    buffer_fwrite_int( buffer , element_size );
+
+    if ((filters != 0) && (byte_size > 0)) {
+      work = util_malloc( byte_size );
+      buffer_codec_filter( ptr , work , byte_size , element_size , filters );
+      data = work;
+    }
+
+    switch (codec.codec) {
+    case(BUFFER_CODEC_NONE):
+      memcpy( buffer_codec_reserve( buffer , byte_size ) , data , byte_size );
+      buffer_codec_advance( buffer , byte_size );
+      break;
+    case(BUFFER_CODEC_LZ):
+      {
+        unsigned char * target = buffer_codec_reserve( buffer , buffer_lz_bound( byte_size ));
+        buffer_codec_advance( buffer , buffer_lz_compress( data , byte_size , target ));
+      }
+      break;
+    case(BUFFER_CODEC_ZLIB):
+      {
+        uLongf compressed_size = __compress_bound( byte_size );
+        unsigned char * target = buffer_codec_reserve( buffer , compressed_size );
+        int level              = (codec.level > 0) ? codec.level : Z_DEFAULT_COMPRESSION;
+        int compress_result    = compress2( target , &compressed_size , data , byte_size , level );
+
+        if (compress_result != Z_OK)
+          util_abort("%s: compress2() returned %d - different from Z_OK - aborting\n",__func__ , compress_result);
+        buffer_codec_advance( buffer , compressed_size );
+      }
+      break;
+    default:
+      util_abort("%s: codec:%d not recognized \n",__func__ , codec.codec);
+    }
+
+    util_safe_free( work );
+    return buffer->pos - start_pos;
+  }
+}
+
+
+/**
+   Reads encoded_size bytes written by buffer_fwrite_encoded() - or
+   by buffer_fwrite_compressed() - and decodes them to target_size
+   bytes at target_ptr. The return value is the decoded size.
+*/
+
+size_t buffer_fread_encoded( buffer_type * buffer , size_t encoded_size , void * target_ptr , size_t target_size) {
+  size_t remaining_size = buffer->content_size - buffer->pos;
+  int magic = 0;
+
+  if (remaining_size < encoded_size)
+    util_abort("%s: trying to read beyond end of buffer\n",__func__);
+
+  if (encoded_size >= BUFFER_CODEC_HEADER_SIZE)
+    memcpy( &magic , &buffer->data[buffer->pos] , sizeof magic );
+
+  if (magic != BUFFER_CODEC_MAGIC)
+    return buffer_fread_compressed( buffer , encoded_size , target_ptr , target_size );
+
+  {
+    int codec_id;
+    int filters;
+    size_t element_size;
+    size_t payload_size = encoded_size - BUFFER_CODEC_HEADER_SIZE;
+    const unsigned char * payload;
+    unsigned char * work;
+    bool valid = false;
+
+    buffer_fskip_int( buffer );
+    codec_id     = buffer_fread_int( buffer );
+    filters      = buffer_fread_int( buffer );
+    element_size = buffer_fread_int( buffer );
+    payload      = (const unsigned char *) &buffer->data[buffer->pos];
+
+    if ((filters != 0) && (target_size > 0))
+      work = util_malloc( target_size );
+    else
+      work = target_ptr;
+
+    switch (codec_id) {
+    case(BUFFER_CODEC_NONE):
+      if (payload_size == target_size) {
+        memcpy( work , payload , target_size );
+        valid = true;
+      }
+      break;
+    case(BUFFER_CODEC_LZ):
+      valid = buffer_lz_decompress( payload , payload_size , work , target_size );
+      break;
+    case(BUFFER_CODEC_ZLIB):
+      {
+        uLongf uncompressed_size = target_size;
+        int uncompress_result    = uncompress( work , &uncompressed_size , payload , payload_size );
+        valid = ((uncompress_result == Z_OK) && (uncompressed_size == target_size));
+      }
+      break;
+    default:
+      util_abort("%s: codec:%d not recognized - corrupt data or written by a newer version?\n",__func__ , codec_id);
+    }
+
+    if (!valid)
+      util_abort("%s: failed to decode %zu bytes with codec:%d to %zu bytes\n",__func__ , payload_size , codec_id , target_size);
+
+    if (work != target_ptr) {
+      buffer_codec_unfilter( work , target_ptr , target_size , element_size , filters );
+      free( work );
+    }
+
+    buffer->pos += payload_size;
+    return target_size;
+  }
+}
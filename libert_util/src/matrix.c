@@ -28,6 +28,9 @@
 #include <ert/util/matrix.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/rng.h>
+#ifdef ERT_HAVE_LAPACK
+#include <ert/util/matrix_blas.h>
+#endif
 
 /**
    This is V E R Y  S I M P L E matrix implementation. It is not
@@ -1067,32 +1070,131 @@ matrix_type * matrix_alloc_transpose( const matrix_type * A) {
    For general matrix multiplactions where A = B * C all have
    different dimensions you can use matrix_matmul() (which calls the
    BLAS routine dgemm());
+
+   The rows of A are updated in panels of at most
+   MATMUL_PANEL_ELEMENTS / columns rows: the panel is copied to a
+   contiguous temporary, and the product tmp * B is written back into
+   A. The temporary is therefore bounded independently of the number
+   of rows in A. When BLAS is available the panel product is computed
+   with dgemm(), otherwise with the column oriented kernels
+   matrix_panel_matmul4__() and matrix_panel_matmul1__() which only
+   touch contiguous memory in the inner loop.
+*/
+
+#define MATMUL_PANEL_ELEMENTS 32768
+#define MATMUL_MIN_PANEL_ROWS 8
+
+#ifndef ERT_HAVE_LAPACK
+
+/*
+  target[0..rows , j1..j1+4) = panel * B[: , j1..j1+4), where panel is
+  a contiguous column major [rows x columns] block and target is a
+  contiguous [rows x 4] block. Each column of the panel is loaded once
+  for four columns of the result; the four target columns should stay
+  in L1 cache.
 */
 
+static void matrix_panel_matmul4__( double * target , const double * panel , int rows , int columns , const matrix_type * B , int j1) {
+  double * t0 = target;
+  double * t1 = t0 + rows;
+  double * t2 = t1 + rows;
+  double * t3 = t2 + rows;
+  int i,k;
+
+  for (i=0; i < 4 * rows; i++)
+    target[i] = 0;
+
+  for (k=0; k < columns; k++) {
+    const double * p = &panel[ (size_t) k * rows ];
+    const double b0 = B->data[ GET_INDEX(B , k , j1    ) ];
+    const double b1 = B->data[ GET_INDEX(B , k , j1 + 1) ];
+    const double b2 = B->data[ GET_INDEX(B , k , j1 + 2) ];
+    const double b3 = B->data[ GET_INDEX(B , k , j1 + 3) ];
+
+    for (i=0; i < rows; i++) {
+      const double pi = p[i];
+      t0[i] += pi * b0;
+      t1[i] += pi * b1;
+      t2[i] += pi * b2;
+      t3[i] += pi * b3;
+    }
+  }
+}
+
+
+static void matrix_panel_matmul1__( double * target , const double * panel , int rows , int columns , const matrix_type * B , int j) {
+  int i,k;
+
+  for (i=0; i < rows; i++)
+    target[i] = 0;
+
+  for (k=0; k < columns; k++) {
+    const double * p = &panel[ (size_t) k * rows ];
+    const double b = B->data[ GET_INDEX(B , k , j) ];
+
+    for (i=0; i < rows; i++)
+      target[i] += p[i] * b;
+  }
+}
+
+#endif
+
 
 void matrix_inplace_matmul(matrix_type * A, const matrix_type * B) {
   if ((A->columns == B->rows) && (B->rows == B->columns)) {
-    double * tmp = util_malloc( sizeof * A->data * A->columns );
-    int i,j,k;
+    const int columns    = A->columns;
+    const int panel_rows = util_int_min( A->rows , util_int_max( MATMUL_MIN_PANEL_ROWS , MATMUL_PANEL_ELEMENTS / util_int_max( columns , 1 )));
+    int row1;
 
-    for (i=0; i < A->rows; i++) {
+    if (A->rows == 0 || columns == 0)
+      return;
 
-      /* Clearing the tmp vector */
-      for (k=0; k < B->rows; k++)
-        tmp[k] = 0;
+#ifdef ERT_HAVE_LAPACK
+    {
+      matrix_type * panel = matrix_alloc( panel_rows , columns );
 
-      for (j=0; j < B->rows; j++) {
-        double scalar_product = 0;
-        for (k=0; k < A->columns; k++)
-          scalar_product += A->data[ GET_INDEX(A,i,k) ] * B->data[ GET_INDEX(B,k,j) ];
+      for (row1 = 0; row1 < A->rows; row1 += panel_rows) {
+        int rows = util_int_min( panel_rows , A->rows - row1 );
+        matrix_type * A_view = matrix_alloc_shared( A , row1 , 0 , rows , columns );
 
-        /* Assign first to tmp[j] */
-        tmp[j] = scalar_product;
+        if (rows != matrix_get_rows( panel ))
+          matrix_resize( panel , rows , columns , false );
+        matrix_assign( panel , A_view );
+        matrix_dgemm( A_view , panel , B , false , false , 1 , 0 );
+        matrix_free( A_view );
       }
-      for (j=0; j < A->columns; j++)
-        A->data[ GET_INDEX(A , i, j) ] = tmp[j];
+      matrix_free( panel );
     }
-    free(tmp);
+#else
+    {
+      double * panel  = util_calloc( (size_t) panel_rows * columns , sizeof * panel );
+      double * target = util_calloc( 4 * panel_rows , sizeof * target );
+      int i,j,k;
+
+      for (row1 = 0; row1 < A->rows; row1 += panel_rows) {
+        int rows = util_int_min( panel_rows , A->rows - row1 );
+
+        for (k=0; k < columns; k++)
+          for (i=0; i < rows; i++)
+            panel[ (size_t) k * rows + i ] = A->data[ GET_INDEX(A , row1 + i , k) ];
+
+        for (j=0; j + 3 < columns; j += 4) {
+          matrix_panel_matmul4__( target , panel , rows , columns , B , j );
+          for (k=0; k < 4; k++)
+            for (i=0; i < rows; i++)
+              A->data[ GET_INDEX(A , row1 + i , j + k) ] = target[ k * rows + i ];
+        }
+
+        for (; j < columns; j++) {
+          matrix_panel_matmul1__( target , panel , rows , columns , B , j );
+          for (i=0; i < rows; i++)
+            A->data[ GET_INDEX(A , row1 + i , j) ] = target[i];
+        }
+      }
+      free( target );
+      free( panel );
+    }
+#endif
   } else
     util_abort("%s: size mismatch: A:[%d,%d]   B:[%d,%d]\n",__func__ , matrix_get_rows(A) , matrix_get_columns(A) , matrix_get_rows(B) , matrix_get_columns(B));
 }
@@ -1156,7 +1258,8 @@ void matrix_inplace_matmul_mt2(matrix_type * A, const matrix_type * B , thread_p
       arg_pack_append_ptr(arglist[it] , A );
       arg_pack_append_const_ptr(arglist[it] , B );
 
-      thread_pool_add_job( thread_pool , matrix_inplace_matmul_mt__ , arglist[it]);
+      if (row_size > 0)   /* More threads than rows. */
+        thread_pool_add_job( thread_pool , matrix_inplace_matmul_mt__ , arglist[it]);
       row_offset += row_size;
     }
   }
@@ -0,0 +1,307 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'task_graph.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/task_graph.h>
+
+/**
+   The task_graph is a small executor for a static graph of tasks with
+   dependencies between them. It is an alternative to the thread_pool
+   when the work consists of many small jobs where some jobs must wait
+   for others: with the thread_pool each group of jobs must be
+   completed with a thread_pool_join() before the next group can be
+   added, whereas the task_graph starts each task as soon as the tasks
+   it depends on have completed.
+
+     1. Allocate the graph with the number of worker threads.
+
+          task_graph_type * graph = task_graph_alloc( num_threads );
+
+     2. Add the tasks, and the dependencies between them. The task id
+        returned from task_graph_add_task() is used to refer to the
+        task:
+
+          int load  = task_graph_add_task( graph , load_func , load_arg );
+          int store = task_graph_add_task( graph , store_func , store_arg );
+          task_graph_add_dependency( graph , store , load );
+
+        Barrier tasks without a function can be used to let many tasks
+        depend on many other tasks without adding all the pairwise
+        dependencies.
+
+     3. Run the graph; task_graph_run() returns when all the tasks have
+        completed. The graph is cleared afterwards and can be reused.
+
+   Among the tasks which are ready to run the one which was added first
+   is started first; i.e. when the tasks are added in the order of a
+   sequential algorithm the work flows through the graph in roughly
+   that order, and tasks further down the list fill in when a worker
+   thread would otherwise be idle.
+
+   The worker threads are started in task_graph_run() and joined
+   before it returns; the calling thread also runs tasks. The argument
+   pointers are not touched by the task_graph.
+*/
+
+
+typedef void * (task_func_ftype) (void *);
+
+typedef struct {
+  task_func_ftype  * func;        /* NULL for barrier tasks. */
+  void             * arg;
+  int                pending;     /* The number of tasks this task is still waiting for. */
+  int_vector_type  * dependents;  /* The tasks waiting for this task; allocated on demand. */
+} task_type;
+
+
+#define TASK_GRAPH_TYPE_ID 71443209
+
+struct task_graph_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                num_threads;
+  int                size;
+  int                alloc_size;
+  task_type        * tasks;
+
+  int              * ready;          /* Min-heap of task ids which are ready to run. */
+  int                num_ready;
+  int                num_running;
+  int                num_complete;
+
+  pthread_mutex_t    lock;
+  pthread_cond_t     cond;
+};
+
+
+static UTIL_SAFE_CAST_FUNCTION( task_graph , TASK_GRAPH_TYPE_ID )
+
+
+task_graph_type * task_graph_alloc( int num_threads ) {
+  task_graph_type * graph = util_malloc( sizeof * graph );
+  UTIL_TYPE_ID_INIT( graph , TASK_GRAPH_TYPE_ID );
+  graph->num_threads = util_int_max( 1 , num_threads );
+  graph->size        = 0;
+  graph->alloc_size  = 0;
+  graph->tasks       = NULL;
+  graph->ready       = NULL;
+  pthread_mutex_init( &graph->lock , NULL );
+  pthread_cond_init( &graph->cond , NULL );
+  return graph;
+}
+
+
+void task_graph_clear( task_graph_type * graph ) {
+  int i;
+  for (i=0; i < graph->size; i++) {
+    if (graph->tasks[i].dependents)
+      int_vector_free( graph->tasks[i].dependents );
+  }
+  graph->size = 0;
+}
+
+
+void task_graph_free( task_graph_type * graph ) {
+  task_graph_clear( graph );
+  pthread_cond_destroy( &graph->cond );
+  pthread_mutex_destroy( &graph->lock );
+  free( graph->ready );
+  free( graph->tasks );
+  free( graph );
+}
+
+
+int task_graph_get_size( const task_graph_type * graph ) {
+  return graph->size;
+}
+
+
+int task_graph_get_num_threads( const task_graph_type * graph ) {
+  return graph->num_threads;
+}
+
+
+int task_graph_add_task( task_graph_type * graph , task_func_ftype * func , void * arg ) {
+  if (graph->size == graph->alloc_size) {
+    graph->alloc_size = util_int_max( 64 , 2 * graph->alloc_size );
+    graph->tasks      = util_realloc( graph->tasks , graph->alloc_size * sizeof * graph->tasks );
+  }
+  {
+    task_type * task  = &graph->tasks[ graph->size ];
+    task->func        = func;
+    task->arg         = arg;
+    task->pending     = 0;
+    task->dependents  = NULL;
+  }
+  graph->size++;
+  return graph->size - 1;
+}
+
+
+int task_graph_add_barrier( task_graph_type * graph ) {
+  return task_graph_add_task( graph , NULL , NULL );
+}
+
+
+/**
+   The task @task will not be started before the task @depends_on has
+   completed.
+*/
+
+void task_graph_add_dependency( task_graph_type * graph , int task , int depends_on ) {
+  if ((task < 0) || (task >= graph->size) || (depends_on < 0) || (depends_on >= graph->size) || (task == depends_on))
+    util_abort("%s: invalid dependency %d -> %d in graph with %d tasks\n",__func__ , depends_on , task , graph->size);
+
+  if (graph->tasks[ depends_on ].dependents == NULL)
+    graph->tasks[ depends_on ].dependents = int_vector_alloc( 0 , 0 );
+
+  int_vector_append( graph->tasks[ depends_on ].dependents , task );
+  graph->tasks[ task ].pending++;
+}
+
+
+/*****************************************************************/
+/* The ready heap; must be called with the lock held. */
+
+static void task_graph_push_ready( task_graph_type * graph , int task ) {
+  int * heap = graph->ready;
+  int index  = graph->num_ready++;
+
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (heap[parent] <= task)
+      break;
+    heap[index] = heap[parent];
+    index = parent;
+  }
+  heap[index] = task;
+}
+
+
+static int task_graph_pop_ready( task_graph_type * graph ) {
+  int * heap = graph->ready;
+  int task   = heap[0];
+  int last   = heap[ --graph->num_ready ];
+  int index  = 0;
+
+  while (true) {
+    int child = 2 * index + 1;
+    if (child >= graph->num_ready)
+      break;
+    if ((child + 1 < graph->num_ready) && (heap[child + 1] < heap[child]))
+      child++;
+    if (last <= heap[child])
+      break;
+    heap[index] = heap[child];
+    index = child;
+  }
+  if (graph->num_ready > 0)
+    heap[index] = last;
+  return task;
+}
+
+/*****************************************************************/
+
+
+static void * task_graph_worker( void * arg ) {
+  task_graph_type * graph = task_graph_safe_cast( arg );
+
+  pthread_mutex_lock( &graph->lock );
+  while (true) {
+    if (graph->num_complete == graph->size)
+      break;
+
+    if (graph->num_ready == 0) {
+      if (graph->num_running == 0)
+        util_abort("%s: no tasks can run - the graph has a cycle.\n",__func__);
+      pthread_cond_wait( &graph->cond , &graph->lock );
+      continue;
+    }
+
+    {
+      int task_id = task_graph_pop_ready( graph );
+      task_type * task = &graph->tasks[ task_id ];
+      int newly_ready = 0;
+
+      graph->num_running++;
+      pthread_mutex_unlock( &graph->lock );
+      if (task->func)
+        task->func( task->arg );
+      pthread_mutex_lock( &graph->lock );
+      graph->num_running--;
+      graph->num_complete++;
+
+      if (task->dependents) {
+        int i;
+        for (i=0; i < int_vector_size( task->dependents ); i++) {
+          int dependent = int_vector_iget( task->dependents , i );
+          graph->tasks[ dependent ].pending--;
+          if (graph->tasks[ dependent ].pending == 0) {
+            task_graph_push_ready( graph , dependent );
+            newly_ready++;
+          }
+        }
+      }
+
+      if (graph->num_complete == graph->size)
+        pthread_cond_broadcast( &graph->cond );
+      else if (newly_ready > 1)
+        pthread_cond_broadcast( &graph->cond );
+      else if (newly_ready == 1)
+        pthread_cond_signal( &graph->cond );
+    }
+  }
+  pthread_mutex_unlock( &graph->lock );
+  return NULL;
+}
+
+
+/**
+   Runs all the tasks in the graph, and returns when they have all
+   completed. The graph is cleared before returning.
+*/
+
+void task_graph_run( task_graph_type * graph ) {
+  if (graph->size > 0) {
+    int num_workers = util_int_min( graph->num_threads , graph->size ) - 1;
+    pthread_t * workers = util_calloc( util_int_max( num_workers , 1 ) , sizeof * workers );
+    int i;
+
+    graph->ready        = util_realloc( graph->ready , graph->size * sizeof * graph->ready );
+    graph->num_ready    = 0;
+    graph->num_running  = 0;
+    graph->num_complete = 0;
+    for (i=0; i < graph->size; i++) {
+      if (graph->tasks[i].pending == 0)
+        task_graph_push_ready( graph , i );
+    }
+
+    for (i=0; i < num_workers; i++)
+      pthread_create( &workers[i] , NULL , task_graph_worker , graph );
+    task_graph_worker( graph );
+    for (i=0; i < num_workers; i++)
+      pthread_join( workers[i] , NULL );
+
+    free( workers );
+  }
+  task_graph_clear( graph );
+}
@@ -108,6 +108,17 @@
 #include <ert/util/util.h>
 #include <ert/util/buffer.h>
 
+/*
+  On x86 with gcc/clang the endian flipping is done with SSSE3/AVX2
+  byte shuffles; the kernels are compiled with target attributes and
+  selected at runtime, so the library itself does not require any
+  special compiler flags.
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTIL_ENDIAN_SIMD
+#include <immintrin.h>
+#endif
+
 
 /*
    Macros for endian flipping. The macros create a new endian-flipped
@@ -140,7 +151,7 @@
 
 
 static uint16_t util_endian_convert16( uint16_t u ) {
-  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) >> 8U);
+  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) << 8U);
 }
 
 
@@ -179,6 +190,103 @@ static uint64_t util_endian_convert32_64( uint64_t u ) {
 
 
 
+#ifdef UTIL_ENDIAN_SIMD
+
+/*
+  The SIMD kernels flip as many complete vector registers as possible
+  and return the number of elements which have been flipped; the
+  remaining tail is handled by the scalar code. All loads and stores
+  are unaligned, the ecl_kw data pointers have no alignment guarantee
+  beyond malloc().
+*/
+
+__attribute__((target("ssse3")))
+static int util_endian_flip_ssse3( void * data , int element_size , int elements) {
+  const __m128i mask32 = _mm_set_epi8( 12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 );
+  const __m128i mask64 = _mm_set_epi8( 8,9,10,11,12,13,14,15 , 0,1,2,3,4,5,6,7 );
+  const __m128i mask   = (element_size == 4) ? mask32 : mask64;
+  const int     step   = 16 / element_size;
+  char * ptr = (char *) data;
+  int i;
+
+  for (i = 0; i + step <= elements; i += step) {
+    __m128i * p = (__m128i *) &ptr[i * element_size];
+    _mm_storeu_si128( p , _mm_shuffle_epi8( _mm_loadu_si128( p ) , mask ));
+  }
+  return i;
+}
+
+
+__attribute__((target("avx2")))
+static int util_endian_flip_avx2( void * data , int element_size , int elements) {
+  const __m256i mask32 = _mm256_set_epi8( 12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 ,
+                                          12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 );
+  const __m256i mask64 = _mm256_set_epi8( 8,9,10,11,12,13,14,15 , 0,1,2,3,4,5,6,7 ,
+                                          8,9,10,11,12,13,14,15 , 0,1,2,3,4,5,6,7 );
+  const __m256i mask   = (element_size == 4) ? mask32 : mask64;
+  const int     step   = 32 / element_size;
+  char * ptr = (char *) data;
+  int i;
+
+  for (i = 0; i + step <= elements; i += step) {
+    __m256i * p = (__m256i *) &ptr[i * element_size];
+    _mm256_storeu_si256( p , _mm256_shuffle_epi8( _mm256_loadu_si256( p ) , mask ));
+  }
+  return i;
+}
+
+
+__attribute__((target("ssse3")))
+static int util_endian_flip_float_to_double_ssse3( double * double_ptr , const float * float_ptr , int size) {
+  const __m128i mask = _mm_set_epi8( 12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 );
+  int i;
+
+  for (i = 0; i + 4 <= size; i += 4) {
+    __m128 f = _mm_castsi128_ps( _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) &float_ptr[i] ) , mask ));
+    _mm_storeu_pd( &double_ptr[i]     , _mm_cvtps_pd( f ));
+    _mm_storeu_pd( &double_ptr[i + 2] , _mm_cvtps_pd( _mm_movehl_ps( f , f )));
+  }
+  return i;
+}
+
+
+__attribute__((target("avx2")))
+static int util_endian_flip_float_to_double_avx2( double * double_ptr , const float * float_ptr , int size) {
+  const __m256i mask = _mm256_set_epi8( 12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 ,
+                                        12,13,14,15 , 8,9,10,11 , 4,5,6,7 , 0,1,2,3 );
+  int i;
+
+  for (i = 0; i + 8 <= size; i += 8) {
+    __m256 f = _mm256_castsi256_ps( _mm256_shuffle_epi8( _mm256_loadu_si256( (const __m256i *) &float_ptr[i] ) , mask ));
+    _mm256_storeu_pd( &double_ptr[i]     , _mm256_cvtps_pd( _mm256_castps256_ps128( f )));
+    _mm256_storeu_pd( &double_ptr[i + 4] , _mm256_cvtps_pd( _mm256_extractf128_ps( f , 1 )));
+  }
+  return i;
+}
+
+#endif
+
+
+/*
+  Will endian flip the @elements first elements of @data, starting
+  with a SIMD kernel if the CPU supports it, and returns the number of
+  elements which have been flipped. Only 4 and 8 byte elements are
+  handled by the SIMD kernels.
+*/
+
+static int util_endian_flip_vector_simd(void *data, int element_size , int elements) {
+#ifdef UTIL_ENDIAN_SIMD
+  if (__builtin_cpu_supports("avx2"))
+    return util_endian_flip_avx2( data , element_size , elements );
+
+  if (__builtin_cpu_supports("ssse3"))
+    return util_endian_flip_ssse3( data , element_size , elements );
+#endif
+  return 0;
+}
+
+
+
 void util_endian_flip_vector(void *data, int element_size , int elements) {
   int i;
   switch (element_size) {
@@ -194,39 +302,40 @@ void util_endian_flip_vector(void *data, int element_size , int elements) {
     }
   case(4):
     {
+      int offset = util_endian_flip_vector_simd( data , element_size , elements );
+      uint32_t *tmp32 = (uint32_t *) data + offset;
+      elements -= offset;
+      {
 #ifdef ARCH64
-      /*
-        In the case of a 64 bit CPU the fastest way to swap 32 bit
-        variables will be by swapping two elements in one operation;
-        this is provided by the util_endian_convert32_64() function. In the case
-        of binary ECLIPSE files this case is quite common, and
-        therefor worth supporting as a special case.
-      */
-      uint64_t *tmp64 = (uint64_t *) data;
+        /*
+          In the case of a 64 bit CPU the fastest scalar way to swap
+          32 bit variables will be by swapping two elements in one
+          operation; this is provided by the util_endian_convert32_64()
+          function. In the case of binary ECLIPSE files this case is
+          quite common, and therefor worth supporting as a special case.
+        */
+        uint64_t *tmp64 = (uint64_t *) tmp32;
 
-      for (i = 0; i <elements/2; i++)
-        tmp64[i] = util_endian_convert32_64(tmp64[i]);
+        for (i = 0; i <elements/2; i++)
+          tmp64[i] = util_endian_convert32_64(tmp64[i]);
 
-      if ( elements & 1 ) {
-        // Odd number of elements - flip the last element as an ordinary 32 bit swap.
-        uint32_t *tmp32 = (uint32_t *) data;
-        tmp32[ elements - 1] = util_endian_convert32( tmp32[elements - 1] );
-      }
-      break;
+        if ( elements & 1 ) {
+          // Odd number of elements - flip the last element as an ordinary 32 bit swap.
+          tmp32[ elements - 1] = util_endian_convert32( tmp32[elements - 1] );
+        }
 #else
-      uint32_t *tmp32 = (uint32_t *) data;
-
-      for (i = 0; i <elements; i++)
-        tmp32[i] = util_endian_convert32(tmp32[i]);
-
-      break;
+        for (i = 0; i <elements; i++)
+          tmp32[i] = util_endian_convert32(tmp32[i]);
 #endif
+      }
+      break;
     }
   case(8):
     {
+      int offset = util_endian_flip_vector_simd( data , element_size , elements );
       uint64_t *tmp64 = (uint64_t *) data;
 
-      for (i = 0; i <elements; i++)
+      for (i = offset; i <elements; i++)
         tmp64[i] = util_endian_convert64(tmp64[i]);
       break;
     }
@@ -236,6 +345,41 @@ void util_endian_flip_vector(void *data, int element_size , int elements) {
   }
 }
 
+
+/**
+   Will endian flip the float values in @float_ptr and convert them to
+   double in @double_ptr, in one pass over the data. The input vector
+   is not modified. This is the equivalent of:
+
+      util_endian_flip_vector( float_ptr , sizeof(float) , size );
+      util_float_to_double( double_ptr , float_ptr , size );
+
+   but without writing the flipped floats back to memory.
+*/
+
+void util_endian_flip_float_to_double(double * double_ptr , const float * float_ptr , int size) {
+  int i = 0;
+
+#ifdef UTIL_ENDIAN_SIMD
+  if (__builtin_cpu_supports("avx2"))
+    i = util_endian_flip_float_to_double_avx2( double_ptr , float_ptr , size );
+  else if (__builtin_cpu_supports("ssse3"))
+    i = util_endian_flip_float_to_double_ssse3( double_ptr , float_ptr , size );
+#endif
+
+  for (; i < size; i++) {
+    uint32_t u;
+    float    f;
+
+    memcpy( &u , &float_ptr[i] , sizeof u );
+    u = util_endian_convert32( u );
+    memcpy( &f , &u , sizeof f );
+    double_ptr[i] = f;
+  }
+}
+
+
+
 void util_endian_flip_vector_old(void *data, int element_size , int elements) {
   int i;
   switch (element_size) {
@@ -22,6 +22,7 @@
 
 
 #include <ert/util/block_fs.h>
+#include <ert/util/buffer.h>
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.h>
 
@@ -102,8 +103,176 @@ void test_lock_conflict() {
 
 
 
+static void fwrite_int_file( block_fs_type * bfs , const char * key , int size , int value) {
+  int * data = util_calloc( size , sizeof * data );
+  for (int i=0; i < size; i++)
+    data[i] = value + i;
+  block_fs_fwrite_file( bfs , key , data , size * sizeof * data );
+  free( data );
+}
+
+
+static void assert_int_file( block_fs_type * bfs , const char * key , int size , int value) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  const int * data;
+
+  test_assert_true( block_fs_has_file( bfs , key ));
+  test_assert_int_equal( block_fs_get_filesize( bfs , key ) , size * sizeof * data );
+  block_fs_fread_realloc_buffer( bfs , key , buffer );
+  data = buffer_get_data( buffer );
+  for (int i=0; i < size; i++)
+    test_assert_int_equal( data[i] , value + i );
+
+  buffer_free( buffer );
+}
+
+
+void test_write_behind() {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/write_behind");
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 10 , false , false , false );
+    block_fs_set_write_behind( bfs , 1024 * 1024 );
+
+    fwrite_int_file( bfs , "A" , 100 , 0 );
+    fwrite_int_file( bfs , "B" , 200 , 1000 );
+    fwrite_int_file( bfs , "C" , 300 , 2000 );
+
+    /* Pending writes are visible to readers before commit. */
+    assert_int_file( bfs , "B" , 200 , 1000 );
+
+    /* Rewrite, unlink and reuse of the freed node before commit. */
+    fwrite_int_file( bfs , "A" , 50 , 500 );
+    block_fs_unlink_file( bfs , "B" );
+    fwrite_int_file( bfs , "D" , 150 , 3000 );
+    block_fs_fsync( bfs );
+
+    fwrite_int_file( bfs , "C" , 1000 , 4000 );
+    block_fs_close( bfs , false );
+  }
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 10 , false , true , false );
+    assert_int_file( bfs , "A" , 50 , 500 );
+    test_assert_false( block_fs_has_file( bfs , "B" ));
+    assert_int_file( bfs , "C" , 1000 , 4000 );
+    assert_int_file( bfs , "D" , 150 , 3000 );
+    block_fs_close( bfs , false );
+  }
+  test_work_area_free( work_area );
+}
+
+
+
+/*
+  Rotation with write-behind on; the replayed nodes must be on disk
+  when the rotation returns, so a second mount which is made without
+  any commit or close of the first sees all the files.
+*/
+
+void test_rotate_write_behind() {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/rotate");
+  const int num_files = 20;
+  char key[32];
+  block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 10 , false , false , false );
+
+  block_fs_set_write_behind( bfs , 1024 * 1024 );
+  for (int i=0; i < num_files; i++) {
+    sprintf( key , "PERMX.0.%d" , i );
+    fwrite_int_file( bfs , key , 100 , i );
+  }
+  for (int i=0; i < num_files; i += 2) {
+    sprintf( key , "PERMX.0.%d" , i );
+    block_fs_unlink_file( bfs , key );
+  }
+  test_assert_true( block_fs_rotate( bfs , 0.0 ));
+  test_assert_false( util_file_exists( "test.data_0" ));
+  test_assert_true( util_file_exists( "test.data_1" ));
+
+  {
+    block_fs_type * bfs2 = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 10 , false , true , false );
+    for (int i=0; i < num_files; i++) {
+      sprintf( key , "PERMX.0.%d" , i );
+      if ((i % 2) == 0)
+        test_assert_false( block_fs_has_file( bfs2 , key ));
+      else
+        assert_int_file( bfs2 , key , 100 , i );
+    }
+    block_fs_close( bfs2 , false );
+  }
+  block_fs_close( bfs , false );
+  test_work_area_free( work_area );
+}
+
+
+static void assert_index_files( block_fs_type * bfs , int num_files ) {
+  char key[32];
+  for (int i=0; i < num_files; i++) {
+    sprintf( key , "PERMX.0.%d" , i );
+    if ((i % 3) == 0)
+      test_assert_false( block_fs_has_file( bfs , key ));
+    else if ((i % 5) == 0)
+      assert_int_file( bfs , key , 100 , 2*i );
+    else
+      assert_int_file( bfs , key , 10 + (i % 7) , i );
+  }
+  assert_int_file( bfs , "PORO.0.0" , 20 , 77 );
+}
+
+
+void test_index() {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/index");
+  const int num_files = 1000;
+  char key[32];
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 0 , false , false , false );
+    for (int i=0; i < num_files; i++) {
+      sprintf( key , "PERMX.0.%d" , i );
+      fwrite_int_file( bfs , key , 10 + (i % 7) , i );
+    }
+    for (int i=0; i < num_files; i += 3) {
+      sprintf( key , "PERMX.0.%d" , i );
+      block_fs_unlink_file( bfs , key );
+    }
+    block_fs_close( bfs , false );
+  }
+  test_assert_true( util_file_exists( "test.index" ));
+
+  /* Mounted from the index; grow some of the files so they are moved to new nodes. */
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 0 , false , false , false );
+    for (int i=0; i < num_files; i += 5) {
+      if ((i % 3) != 0) {
+        sprintf( key , "PERMX.0.%d" , i );
+        fwrite_int_file( bfs , key , 100 , 2*i );
+      }
+    }
+    fwrite_int_file( bfs , "PORO.0.0" , 20 , 77 );
+    assert_index_files( bfs , num_files );
+    block_fs_close( bfs , false );
+  }
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 0 , false , true , false );
+    assert_index_files( bfs , num_files );
+    block_fs_close( bfs , false );
+  }
+
+  /* Without the index the data file is scanned. */
+  unlink( "test.index" );
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 32 , 0 , 1.0 , 0 , false , true , false );
+    assert_index_files( bfs , num_files );
+    block_fs_close( bfs , false );
+  }
+  test_work_area_free( work_area );
+}
+
+
+
 int main(int argc , char ** argv) {
   test_readonly();
   test_lock_conflict();
+  test_write_behind();
+  test_rotate_write_behind();
+  test_index();
   exit(0);
 }
@@ -0,0 +1,184 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_buffer_codec.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+
+
+
+void test_roundtrip( const void * data , size_t byte_size , size_t element_size , buffer_codec_type codec) {
+  buffer_type * buffer = buffer_alloc( 16 );
+  void * copy = util_malloc( byte_size + 1 );
+  size_t encoded_size;
+
+  buffer_fwrite_int( buffer , 77 );
+  encoded_size = buffer_fwrite_encoded( buffer , data , byte_size , element_size , codec );
+  test_assert_size_t_equal( buffer_get_size( buffer ) , encoded_size + sizeof(int));
+
+  buffer_rewind( buffer );
+  test_assert_int_equal( buffer_fread_int( buffer ) , 77 );
+  test_assert_size_t_equal( buffer_fread_encoded( buffer , encoded_size , copy , byte_size ) , byte_size );
+  test_assert_size_t_equal( buffer_get_remaining_size( buffer ) , 0 );
+  test_assert_true( memcmp( data , copy , byte_size ) == 0 );
+
+  free( copy );
+  buffer_free( buffer );
+}
+
+
+void test_all_codecs( const void * data , size_t byte_size , size_t element_size) {
+  const buffer_codec_enum codecs[] = {BUFFER_CODEC_ZLIB , BUFFER_CODEC_NONE , BUFFER_CODEC_LZ};
+  for (int c = 0; c < 3; c++) {
+    for (int filters = 0; filters < 4; filters++) {
+      buffer_codec_type codec = {.codec = codecs[c] , .level = 0 , .filters = filters};
+      test_roundtrip( data , byte_size , element_size , codec );
+
+      if (codecs[c] == BUFFER_CODEC_ZLIB) {
+        codec.level = 1;
+        test_roundtrip( data , byte_size , element_size , codec );
+      }
+    }
+  }
+}
+
+
+void test_float_field() {
+  const int size = 10007;
+  float * field = util_malloc( size * sizeof * field );
+  for (int i = 0; i < size; i++)
+    field[i] = exp( 3 + sin( 0.01 * i ) + 0.5 * cos( 0.3 * i ));
+
+  test_all_codecs( field , size * sizeof * field , sizeof * field );
+  test_all_codecs( field , 5 * sizeof * field + 3 , sizeof * field );   /* Incomplete last element. */
+  free( field );
+}
+
+
+void test_double_field() {
+  const int size = 4099;
+  double * field = util_malloc( size * sizeof * field );
+  for (int i = 0; i < size; i++)
+    field[i] = (i % 10) * 0.25 - 100;
+
+  test_all_codecs( field , size * sizeof * field , sizeof * field );
+  free( field );
+}
+
+
+void test_bytes() {
+  const int size = 70000;
+  unsigned char * data = util_malloc( size );
+
+  /* Long overlapping matches and matches at offsets close to the maximum. */
+  for (int i = 0; i < size; i++)
+    data[i] = (i < 1000) ? 'A' : ((i * 7919) >> 3) & 0xFF;
+  test_all_codecs( data , size , 1 );
+
+  /* Incompressible data. */
+  srand( 7 );
+  for (int i = 0; i < size; i++)
+    data[i] = rand() & 0xFF;
+  test_all_codecs( data , size , 3 );
+
+  test_all_codecs( data , 3 , 1 );
+  test_all_codecs( data , 0 , 1 );
+  free( data );
+}
+
+
+/*
+   Data written with buffer_fwrite_compressed() - i.e. everything
+   written before the codecs were introduced - must still be readable.
+*/
+
+void test_legacy() {
+  const int size = 1000;
+  int * data = util_malloc( size * sizeof * data );
+  int * copy = util_malloc( size * sizeof * copy );
+  buffer_type * buffer = buffer_alloc( 16 );
+  size_t compressed_size;
+
+  for (int i = 0; i < size; i++)
+    data[i] = i / 3;
+
+  compressed_size = buffer_fwrite_compressed( buffer , data , size * sizeof * data );
+  buffer_rewind( buffer );
+  buffer_fread_encoded( buffer , compressed_size , copy , size * sizeof * copy );
+  test_assert_true( memcmp( data , copy , size * sizeof * data ) == 0 );
+
+  /* The default codec writes exactly the legacy format. */
+  {
+    buffer_type * buffer2 = buffer_alloc( 16 );
+    buffer_fwrite_encoded( buffer2 , data , size * sizeof * data , sizeof * data , buffer_codec_default());
+    test_assert_size_t_equal( buffer_get_size( buffer ) , buffer_get_size( buffer2 ));
+    test_assert_true( memcmp( buffer_get_data( buffer ) , buffer_get_data( buffer2 ) , buffer_get_size( buffer )) == 0 );
+    buffer_free( buffer2 );
+  }
+
+  buffer_free( buffer );
+  free( copy );
+  free( data );
+}
+
+
+void test_sscanf_ok( const char * spec , buffer_codec_enum codec_id , int level , int filters) {
+  buffer_codec_type codec;
+  test_assert_true( buffer_codec_sscanf( spec , &codec ));
+  test_assert_int_equal( codec.codec , codec_id );
+  test_assert_int_equal( codec.level , level );
+  test_assert_int_equal( codec.filters , filters );
+  {
+    char * string = buffer_codec_alloc_string( codec );
+    test_assert_string_equal( string , spec );
+    free( string );
+  }
+}
+
+
+void test_sscanf() {
+  buffer_codec_type codec = buffer_codec_default();
+
+  test_sscanf_ok( "ZLIB" , BUFFER_CODEC_ZLIB , 0 , 0 );
+  test_sscanf_ok( "ZLIB1" , BUFFER_CODEC_ZLIB , 1 , 0 );
+  test_sscanf_ok( "NONE" , BUFFER_CODEC_NONE , 0 , 0 );
+  test_sscanf_ok( "SHUFFLE+LZ" , BUFFER_CODEC_LZ , 0 , BUFFER_FILTER_SHUFFLE );
+  test_sscanf_ok( "DELTA+SHUFFLE+ZLIB9" , BUFFER_CODEC_ZLIB , 9 , BUFFER_FILTER_DELTA + BUFFER_FILTER_SHUFFLE );
+  test_sscanf_ok( "DELTA+NONE" , BUFFER_CODEC_NONE , 0 , BUFFER_FILTER_DELTA );
+
+  test_assert_false( buffer_codec_sscanf( "" , &codec ));
+  test_assert_false( buffer_codec_sscanf( "LZ4" , &codec ));
+  test_assert_false( buffer_codec_sscanf( "ZLIB0" , &codec ));
+  test_assert_false( buffer_codec_sscanf( "SHUFFLE" , &codec ));
+  test_assert_false( buffer_codec_sscanf( "BITSHUFFLE+LZ" , &codec ));
+  test_assert_true( buffer_codec_is_default( codec ));
+}
+
+
+int main(int argc , char ** argv) {
+  test_float_field();
+  test_double_field();
+  test_bytes();
+  test_legacy();
+  test_sscanf();
+  exit(0);
+}
@@ -0,0 +1,86 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_endian_flip.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#define MAX_ELEMENTS 67
+
+
+/*
+  Flip byte by byte and compare with util_endian_flip_vector(); the
+  different sizes and offsets exercise both the vector kernels, the
+  scalar tail and unaligned input.
+*/
+
+void test_flip(int element_size) {
+  char data[MAX_ELEMENTS * 8 + 1];
+  char expected[MAX_ELEMENTS * 8 + 1];
+  int elements;
+
+  for (elements = 0; elements <= MAX_ELEMENTS; elements++) {
+    int offset;
+    for (offset = 0; offset < 2; offset++) {
+      char * ptr = &data[offset];
+      int i,b;
+
+      for (i=0; i < elements * element_size; i++)
+        ptr[i] = (char) (i * 7 + 3);
+
+      for (i=0; i < elements; i++)
+        for (b=0; b < element_size; b++)
+          expected[i*element_size + b] = ptr[i*element_size + element_size - 1 - b];
+
+      util_endian_flip_vector( ptr , element_size , elements );
+      test_assert_int_equal( memcmp( ptr , expected , elements * element_size ) , 0 );
+    }
+  }
+}
+
+
+void test_float_to_double() {
+  float  float_data[MAX_ELEMENTS];
+  float  flipped[MAX_ELEMENTS];
+  double double_data[MAX_ELEMENTS];
+  int size;
+
+  for (size = 0; size <= MAX_ELEMENTS; size++) {
+    int i;
+    for (i=0; i < size; i++)
+      float_data[i] = 0.25 * i - 3.5;
+
+    memcpy( flipped , float_data , sizeof float_data );
+    util_endian_flip_vector( flipped , sizeof(float) , size );
+    util_endian_flip_float_to_double( double_data , flipped , size );
+
+    for (i=0; i < size; i++)
+      test_assert_double_equal( double_data[i] , float_data[i] );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_flip( 2 );
+  test_flip( 4 );
+  test_flip( 8 );
+  test_float_to_double();
+  exit(0);
+}
@@ -228,6 +228,70 @@ void test_inplace_sub_column() {
 }
 
 
+void assert_inplace_matmul( int rows , int columns , rng_type * rng) {
+  matrix_type * A = matrix_alloc( rows , columns );
+  matrix_type * B = matrix_alloc( columns , columns );
+  matrix_type * C = matrix_alloc( rows , columns );
+  int i,j,k;
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  for (i=0; i < rows; i++)
+    for (j=0; j < columns; j++) {
+      double sum = 0;
+      for (k=0; k < columns; k++)
+        sum += matrix_iget( A , i , k ) * matrix_iget( B , k , j );
+      matrix_iset( C , i , j , sum );
+    }
+
+  matrix_inplace_matmul( A , B );
+  for (i=0; i < rows; i++)
+    for (j=0; j < columns; j++)
+      test_assert_true( fabs( matrix_iget( A , i , j ) - matrix_iget( C , i , j )) < 1e-10 );
+
+  matrix_free( C );
+  matrix_free( B );
+  matrix_free( A );
+}
+
+
+void test_inplace_matmul() {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  assert_inplace_matmul( 1 , 1 , rng );
+  assert_inplace_matmul( 7 , 3 , rng );
+  assert_inplace_matmul( 5000 , 7 , rng );     /* Several row panels. */
+  assert_inplace_matmul( 3000 , 100 , rng );
+
+  /* Matmul on a view only updates the rows of the view. */
+  {
+    matrix_type * A = matrix_alloc( 20 , 5 );
+    matrix_type * A0 = matrix_alloc( 20 , 5 );
+    matrix_type * B = matrix_alloc( 5 , 5 );
+    matrix_type * view;
+
+    matrix_random_init( A , rng );
+    matrix_assign( A0 , A );
+    matrix_diag_set_scalar( B , 2 );
+
+    view = matrix_alloc_shared( A , 4 , 0 , 10 , 5 );
+    matrix_inplace_matmul( view , B );
+    matrix_free( view );
+    {
+      int i,j;
+      for (i=0; i < 20; i++)
+        for (j=0; j < 5; j++) {
+          double factor = (i >= 4 && i < 14) ? 2 : 1;
+          test_assert_true( fabs( matrix_iget( A , i , j ) - factor * matrix_iget( A0 , i , j )) < 1e-12 );
+        }
+    }
+    matrix_free( B );
+    matrix_free( A0 );
+    matrix_free( A );
+  }
+  rng_free( rng );
+}
+
+
 int main( int argc , char ** argv) {
   test_create_invalid();
   test_resize();
@@ -238,5 +302,6 @@ int main( int argc , char ** argv) {
   test_diag_std();
   test_masked_copy();
   test_inplace_sub_column();
+  test_inplace_matmul();
   exit(0);
 }
@@ -0,0 +1,157 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_task_graph.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/task_graph.h>
+
+
+/*
+  Each task records the value of a shared counter when it runs; a
+  task must run after all the tasks it depends on.
+*/
+
+typedef struct {
+  pthread_mutex_t * lock;
+  int             * counter;
+  int               order;
+} order_arg_type;
+
+
+void * record_order( void * arg ) {
+  order_arg_type * order_arg = arg;
+  pthread_mutex_lock( order_arg->lock );
+  order_arg->order = *order_arg->counter;
+  (*order_arg->counter)++;
+  pthread_mutex_unlock( order_arg->lock );
+  return NULL;
+}
+
+
+void test_empty() {
+  task_graph_type * graph = task_graph_alloc( 4 );
+  task_graph_run( graph );
+  test_assert_int_equal( task_graph_get_size( graph ) , 0 );
+  task_graph_free( graph );
+}
+
+
+/*
+  A pipeline of num_chains chains load -> compute -> store, where all
+  the stores must run after the previous store, and all the loads after
+  a common barrier.
+*/
+
+void test_pipeline( int num_threads ) {
+  const int num_chains = 50;
+  task_graph_type * graph = task_graph_alloc( num_threads );
+  order_arg_type * args = util_calloc( 3 * num_chains + 1 , sizeof * args );
+  pthread_mutex_t lock;
+  int counter = 0;
+  int start;
+  int i;
+
+  pthread_mutex_init( &lock , NULL );
+  for (i=0; i < 3 * num_chains + 1; i++) {
+    args[i].lock = &lock;
+    args[i].counter = &counter;
+    args[i].order = -1;
+  }
+
+  start = task_graph_add_task( graph , record_order , &args[3 * num_chains] );
+  for (int c = 0; c < num_chains; c++) {
+    int load    = task_graph_add_task( graph , record_order , &args[3*c] );
+    int compute = task_graph_add_task( graph , record_order , &args[3*c + 1] );
+    int store   = task_graph_add_task( graph , record_order , &args[3*c + 2] );
+
+    task_graph_add_dependency( graph , load , start );
+    task_graph_add_dependency( graph , compute , load );
+    task_graph_add_dependency( graph , store , compute );
+    if (c > 0)
+      task_graph_add_dependency( graph , store , store - 3 );
+  }
+  test_assert_int_equal( task_graph_get_size( graph ) , 3 * num_chains + 1 );
+  task_graph_run( graph );
+  test_assert_int_equal( task_graph_get_size( graph ) , 0 );
+  test_assert_int_equal( counter , 3 * num_chains + 1 );
+
+  test_assert_int_equal( args[3 * num_chains].order , 0 );
+  for (int c = 0; c < num_chains; c++) {
+    test_assert_true( args[3*c].order < args[3*c + 1].order );
+    test_assert_true( args[3*c + 1].order < args[3*c + 2].order );
+    if (c > 0)
+      test_assert_true( args[3*(c - 1) + 2].order < args[3*c + 2].order );
+  }
+
+  /* The graph can be reused after a run. */
+  counter = 0;
+  {
+    int first  = task_graph_add_task( graph , record_order , &args[0] );
+    int last   = task_graph_add_task( graph , record_order , &args[1] );
+    int middle = task_graph_add_barrier( graph );
+    task_graph_add_dependency( graph , middle , first );
+    task_graph_add_dependency( graph , last , middle );
+  }
+  task_graph_run( graph );
+  test_assert_int_equal( args[0].order , 0 );
+  test_assert_int_equal( args[1].order , 1 );
+
+  pthread_mutex_destroy( &lock );
+  free( args );
+  task_graph_free( graph );
+}
+
+
+/*
+  With one thread the ready task which was added first runs first.
+*/
+
+void test_serial_order() {
+  task_graph_type * graph = task_graph_alloc( 1 );
+  order_arg_type args[4];
+  pthread_mutex_t lock;
+  int counter = 0;
+
+  pthread_mutex_init( &lock , NULL );
+  for (int i=0; i < 4; i++) {
+    args[i].lock = &lock;
+    args[i].counter = &counter;
+    task_graph_add_task( graph , record_order , &args[i] );
+  }
+  task_graph_add_dependency( graph , 0 , 3 );
+  task_graph_run( graph );
+
+  test_assert_int_equal( args[1].order , 0 );
+  test_assert_int_equal( args[2].order , 1 );
+  test_assert_int_equal( args[3].order , 2 );
+  test_assert_int_equal( args[0].order , 3 );
+  pthread_mutex_destroy( &lock );
+  task_graph_free( graph );
+}
+
+
+int main(int argc , char ** argv) {
+  test_empty();
+  test_serial_order();
+  test_pipeline( 1 );
+  test_pipeline( 4 );
+  test_pipeline( 16 );
+  exit(0);
+}
@@ -42,7 +42,13 @@ extern "C" {
   void            local_driver_free__(void * __driver );
   job_status_type local_driver_get_job_status(void * __driver , void * __job);
   void            local_driver_free_job(void * __job);
+  void            local_driver_set_job_event(void * __driver , void * __job , job_event_ftype * callback , void * arg , int tag);
   void            local_driver_init_option_list(stringlist_type * option_list);
+  void            local_driver_set_reaper( local_driver_type * driver , bool use_reaper );
+  bool            local_driver_has_reaper( const local_driver_type * driver );
+
+  double          local_job_get_cpu_time( const local_job_type * job );
+  long            local_job_get_max_rss( const local_job_type * job );
 
 
 
@@ -107,18 +107,39 @@ extern "C" {
   typedef bool (has_option_ftype) (const void *, const char *);
   typedef void (init_option_list_ftype) (stringlist_type *);
 
+  /*
+    Drivers which can tell the queue when the status of a job has
+    changed implement set_job_event(); the driver will then call
+    callback( arg , tag ) - from any thread - once when the event is
+    set, and subsequently every time the status of the job changes.
+    When free_job() returns the callback is not running, and will not
+    be invoked again for that job.
+  */
+  typedef void (job_event_ftype) (void * arg, int tag);
+  typedef void (set_job_event_ftype) (void *, void *, job_event_ftype * callback, void * arg, int tag);
+
 
   queue_driver_type * queue_driver_alloc_RSH(const char * rsh_cmd, const hash_type * rsh_hostlist);
   queue_driver_type * queue_driver_alloc_LSF(const char * queue_name, const char * resource_request, const char * remote_lsf_server);
   queue_driver_type * queue_driver_alloc_TORQUE();
   queue_driver_type * queue_driver_alloc_local();
   queue_driver_type * queue_driver_alloc(job_driver_type type);
+  queue_driver_type * queue_driver_alloc_custom(const char * name,
+                                                void * data,
+                                                submit_job_ftype * submit,
+                                                get_status_ftype * get_status,
+                                                kill_job_ftype * kill_job,
+                                                free_job_ftype * free_job,
+                                                free_queue_driver_ftype * free_driver,
+                                                set_job_event_ftype * set_job_event);
 
   void * queue_driver_submit_job(queue_driver_type * driver, const char * run_cmd, int num_cpu, const char * run_path, const char * job_name, int argc, const char ** argv);
   void queue_driver_free_job(queue_driver_type * driver, void * job_data);
   void queue_driver_blacklist_node(queue_driver_type * driver, void * job_data);
   void queue_driver_kill_job(queue_driver_type * driver, void * job_data);
   job_status_type queue_driver_get_status(queue_driver_type * driver, void * job_data);
+  bool queue_driver_has_job_events(const queue_driver_type * driver);
+  void queue_driver_set_job_event(queue_driver_type * driver, void * job_data, job_event_ftype * callback, void * arg, int tag);
 
   const char * queue_driver_get_name(const queue_driver_type * driver);
 
@@ -23,10 +23,13 @@ extern "C" {
 #endif
 #include <ert/util/hash.h>
 
+#include <ert/job_queue/queue_driver.h>
+
 #define RSH_HOST           "RSH_HOST"
 #define RSH_HOSTLIST       "RSH_HOSTLIST"
 #define RSH_CMD            "RSH_CMD" 
 #define RSH_CLEAR_HOSTLIST "RSH_CLEAR_HOSTLIST"
+#define RSH_PERSISTENT_CONNECTION "RSH_PERSISTENT_CONNECTION"
 
   typedef struct rsh_driver_struct rsh_driver_type;
   typedef struct rsh_job_struct    rsh_job_type;
@@ -40,11 +40,13 @@ extern "C" {
 #define TORQUE_JOB_PREFIX_KEY    "JOB_PREFIX"
 #define TORQUE_SUBMIT_SLEEP      "SUBMIT_SLEEP"
 #define TORQUE_DEBUG_OUTPUT      "DEBUG_OUTPUT"
+#define TORQUE_QSTAT_REFRESH_INTERVAL "QSTAT_REFRESH_INTERVAL"
 
 #define TORQUE_DEFAULT_QSUB_CMD      "qsub"
 #define TORQUE_DEFAULT_QSTAT_CMD     "qstat"
 #define TORQUE_DEFAULT_QDEL_CMD      "qdel"
 #define TORQUE_DEFAULT_SUBMIT_SLEEP  "0"
+#define TORQUE_DEFAULT_QSTAT_REFRESH_INTERVAL "5"
 
 
   typedef struct torque_driver_struct torque_driver_type;
@@ -23,11 +23,15 @@
 #include <stdio.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
 
 #include <ert/util/msg.h>
 #include <ert/util/util.h>
 #include <ert/util/thread_pool.h>
 #include <ert/util/arg_pack.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/bool_vector.h>
 
 #include <ert/job_queue/job_queue.h>
 #include <ert/job_queue/job_node.h>
@@ -136,6 +140,45 @@
 
        When the queue manager subsequently finds the job with status
        'JOB_QUEUE_WAITING' it will (re)submit this job.
+
+
+    5. Drivers which can tell the queue about status changes, i.e. the
+       drivers implementing set_job_event(), are not polled for every
+       job in every round. When a job has been submitted to such a
+       driver the queue registers the job_queue_job_event() callback
+       for it, and the driver calls that (from any thread) when the
+       status of the job has changed. The callback appends the
+       queue_index of the job to the event list and wakes up the
+       queue manager, which then updates the status of only those
+       jobs. The driver data of all the jobs is freed before the
+       queue is freed, and the driver does not return from
+       free_job() while the callback is running; i.e. the callback is
+       never invoked on a queue which has been freed.
+
+       All the jobs are still polled every poll interval; that is
+       usleep_time for drivers which must be polled, and
+       JOB_QUEUE_EVENT_POLL_FACTOR * usleep_time for the drivers with
+       events. The jobs which are running, but have not yet been
+       confirmed running through the status file, are checked every
+       usleep_time to enforce the max_confirm_wait time. Between the
+       rounds the queue manager sleeps until it is woken up by an
+       event, a status change made by the callback threads, new jobs,
+       a user exit - or usleep_time has passed.
+
+
+    6. The jobs are submitted to the driver by the submit_pool, and
+       not by the queue manager itself; submitting a job can take
+       seconds, e.g. when the LSF driver spawns bsub. The queue
+       manager marks a WAITING job as submitting and hands it to one
+       of the submit_threads threads; when the submit has completed
+       the job is SUBMITTED (or still WAITING if the driver failed),
+       and the queue manager is woken up. The jobs which are being
+       submitted count as active jobs towards max_running.
+
+       The number of submits is limited by max_submit_rate (submits
+       per second, 0 means no limit) instead of a fixed number per
+       round. The time spent in the driver submit function is
+       recorded, see job_queue_get_submit_count() and friends.
 */
 
 
@@ -231,8 +274,28 @@ struct job_queue_struct {
   unsigned long              usleep_time;                       /* The sleep time before checking for updates. */
   pthread_mutex_t            run_mutex;                         /* This mutex is used to ensure that ONLY one thread is executing the job_queue_run_jobs(). */
   thread_pool_type         * work_pool;
+
+  pthread_mutex_t            event_mutex;                       /* Protecting the events list and the wakeup flag. */
+  pthread_cond_t             event_cond;                        /* Signalled when an event is added, or wakeup is set. */
+  int_vector_type          * events;                            /* The queue_index of jobs where the driver has reported a status change. */
+  int_vector_type          * event_buffer;                      /* The events being handled by the queue manager; swapped with events. */
+  bool                       wakeup;                            /* Something other than a driver event needs the attention of the queue manager. */
+
+  thread_pool_type         * submit_pool;
+  int                        submit_threads;                    /* The number of threads submitting jobs to the driver concurrently. */
+  double                     max_submit_rate;                   /* The maximum number of submits per second; 0 means no limit. */
+  pthread_mutex_t            submit_mutex;                      /* Protecting the submitting flags, and the submit statistics. */
+  bool_vector_type         * submitting;                        /* True for the jobs which are currently being submitted by the submit_pool. */
+  int                        num_submitting;
+  double                     submit_backoff_time;               /* The driver failed to submit a job; no new submits before this time. */
+  int                        submit_count;                      /* The submit statistics; the time spent in the driver submit function. */
+  double                     submit_time_total;
+  double                     submit_time_max;
 };
 
+#define JOB_QUEUE_EVENT_POLL_FACTOR 8
+#define JOB_QUEUE_DEFAULT_SUBMIT_THREADS 4
+
 
 
 
@@ -253,11 +316,86 @@ static bool job_queue_change_node_status(job_queue_type * queue , job_queue_node
 
 
 /*****************************************************************/
+/* Events */
+
+
+static double job_queue_wall_time( ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+
+/*
+  Called by the driver, from any thread, when the status of the job
+  with queue_index @queue_index has changed.
+*/
+
+static void job_queue_job_event( void * arg , int queue_index ) {
+  job_queue_type * queue = arg;
+  pthread_mutex_lock( &queue->event_mutex );
+  int_vector_append( queue->events , queue_index );
+  pthread_cond_signal( &queue->event_cond );
+  pthread_mutex_unlock( &queue->event_mutex );
+}
+
+
+/*
+  Wakes up the queue manager when a job has changed status outside of
+  the driver, or when new jobs have been added.
+*/
+
+static void job_queue_wakeup( job_queue_type * queue ) {
+  pthread_mutex_lock( &queue->event_mutex );
+  queue->wakeup = true;
+  pthread_cond_signal( &queue->event_cond );
+  pthread_mutex_unlock( &queue->event_mutex );
+}
+
+
+/*
+  Blocks until there are events, the queue has been woken up, or
+  @usec microseconds have passed. Must NOT hold on to the joblist
+  lock.
+*/
+
+static void job_queue_wait_for_events( job_queue_type * queue , double usec ) {
+  struct timespec deadline;
+  clock_gettime( CLOCK_REALTIME , &deadline );
+  if (usec > 0) {
+    long nsec = deadline.tv_nsec + (long) (1000 * usec);
+    deadline.tv_sec  += nsec / 1000000000;
+    deadline.tv_nsec  = nsec % 1000000000;
+  }
 
+  pthread_mutex_lock( &queue->event_mutex );
+  while ((int_vector_size( queue->events ) == 0) && !queue->wakeup) {
+    if (pthread_cond_timedwait( &queue->event_cond , &queue->event_mutex , &deadline ) == ETIMEDOUT)
+      break;
+  }
+  queue->wakeup = false;
+  pthread_mutex_unlock( &queue->event_mutex );
+}
 
 
+/*
+  Moves the pending events over to the event_buffer, where the queue
+  manager can handle them without holding the event lock.
+*/
 
+static int_vector_type * job_queue_swap_events( job_queue_type * queue ) {
+  int_vector_reset( queue->event_buffer );
+  pthread_mutex_lock( &queue->event_mutex );
+  {
+    int_vector_type * events = queue->events;
+    queue->events = queue->event_buffer;
+    queue->event_buffer = events;
+  }
+  pthread_mutex_unlock( &queue->event_mutex );
+  return queue->event_buffer;
+}
 
+/*****************************************************************/
 
 
 /**
@@ -272,18 +410,46 @@ static bool job_queue_change_node_status(job_queue_type * queue , job_queue_node
 
 /*
   Will return true if there is any status change. Must already hold
-  on to joblist readlock
+  on to joblist readlock.
+
+  With @poll_all == true the status of all the jobs is checked,
+  otherwise only the jobs which the driver has reported events for,
+  and the running jobs which have not yet been confirmed running;
+  they must be checked against the max_confirm_wait time.
 */
 
-static bool job_queue_update_status(job_queue_type * queue ) {
+static bool job_queue_update_status(job_queue_type * queue , bool poll_all) {
   bool update = false;
-  int ijob;
+  const int_vector_type * events = job_queue_swap_events( queue );
+
+  if (poll_all) {
+    int ijob;
+    for (ijob = 0; ijob < job_list_get_size( queue->job_list ); ijob++) {
+      job_queue_node_type * node = job_list_iget_job( queue->job_list , ijob );
+      bool node_update = job_queue_node_update_status( node , queue->status , queue->driver );
+      if (node_update)
+        update = true;
+    }
+  } else {
+    int i;
+    for (i = 0; i < int_vector_size( events ); i++) {
+      int queue_index = int_vector_iget( events , i );
+      if (queue_index < job_list_get_size( queue->job_list )) {
+        job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
+        bool node_update = job_queue_node_update_status( node , queue->status , queue->driver );
+        if (node_update)
+          update = true;
+      }
+    }
 
-  for (ijob = 0; ijob < job_list_get_size( queue->job_list ); ijob++) {
-    job_queue_node_type * node = job_list_iget_job( queue->job_list , ijob );
-    bool node_update = job_queue_node_update_status( node , queue->status , queue->driver );
-    if (node_update)
-      update = true;
+    for (i = 0; i < job_list_get_size( queue->job_list ); i++) {
+      job_queue_node_type * node = job_list_iget_job( queue->job_list , i );
+      if ((job_queue_node_get_status( node ) == JOB_QUEUE_RUNNING) && !job_queue_node_status_confirmed_running( node )) {
+        bool node_update = job_queue_node_update_status( node , queue->status , queue->driver );
+        if (node_update)
+          update = true;
+      }
+    }
   }
   return update;
 }
@@ -300,12 +466,111 @@ static submit_status_type job_queue_submit_job(job_queue_type * queue , int queu
     {
       job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
       submit_status = job_queue_node_submit( node , queue->status , queue->driver );
+
+      if ((submit_status == SUBMIT_OK) && queue_driver_has_job_events( queue->driver ))
+        queue_driver_set_job_event( queue->driver , job_queue_node_get_driver_data( node ) , job_queue_job_event , queue , queue_index );
     }
   }
   return submit_status;
 }
 
 
+/*
+  Run by the submit_pool threads.
+*/
+
+static void * job_queue_run_submit( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  job_queue_type * queue = arg_pack_iget_ptr( arg_pack , 0 );
+  int queue_index = arg_pack_iget_int( arg_pack , 1 );
+  submit_status_type submit_status;
+  double submit_time;
+
+  job_list_get_rdlock( queue->job_list );
+  {
+    double start_time = job_queue_wall_time();
+    submit_status = job_queue_submit_job( queue , queue_index );
+    submit_time = job_queue_wall_time() - start_time;
+  }
+  job_list_unlock( queue->job_list );
+
+  pthread_mutex_lock( &queue->submit_mutex );
+  {
+    bool_vector_iset( queue->submitting , queue_index , false );
+    queue->num_submitting--;
+
+    if (submit_status == SUBMIT_OK) {
+      queue->submit_count++;
+      queue->submit_time_total += submit_time;
+      queue->submit_time_max = util_double_max( queue->submit_time_max , submit_time );
+    } else if (submit_status == SUBMIT_DRIVER_FAIL)
+      /*
+        The driver did not accept the job; probably it is full. The
+        job is still WAITING, and will be retried after usleep_time.
+      */
+      queue->submit_backoff_time = job_queue_wall_time() + 1e-6 * queue->usleep_time;
+  }
+  pthread_mutex_unlock( &queue->submit_mutex );
+
+  arg_pack_free( arg_pack );
+  job_queue_wakeup( queue );
+  return NULL;
+}
+
+
+static bool job_queue_is_submitting( job_queue_type * queue , int queue_index ) {
+  bool submitting;
+  pthread_mutex_lock( &queue->submit_mutex );
+  submitting = bool_vector_safe_iget( queue->submitting , queue_index );
+  pthread_mutex_unlock( &queue->submit_mutex );
+  return submitting;
+}
+
+
+static double job_queue_get_submit_backoff_time( job_queue_type * queue ) {
+  double backoff_time;
+  pthread_mutex_lock( &queue->submit_mutex );
+  backoff_time = queue->submit_backoff_time;
+  pthread_mutex_unlock( &queue->submit_mutex );
+  return backoff_time;
+}
+
+
+static int job_queue_get_num_submitting( job_queue_type * queue ) {
+  int num_submitting;
+  pthread_mutex_lock( &queue->submit_mutex );
+  num_submitting = queue->num_submitting;
+  pthread_mutex_unlock( &queue->submit_mutex );
+  return num_submitting;
+}
+
+
+static void job_queue_start_submit( job_queue_type * queue , int queue_index ) {
+  pthread_mutex_lock( &queue->submit_mutex );
+  bool_vector_iset( queue->submitting , queue_index , true );
+  queue->num_submitting++;
+  pthread_mutex_unlock( &queue->submit_mutex );
+  {
+    arg_pack_type * arg_pack = arg_pack_alloc();
+    arg_pack_append_ptr( arg_pack , queue );
+    arg_pack_append_int( arg_pack , queue_index );
+    thread_pool_add_job( queue->submit_pool , job_queue_run_submit , arg_pack );
+  }
+}
+
+
+/*
+  Blocks until all the submits handed to the submit_pool have
+  completed. Must hold on to the joblist readlock - like the submit
+  threads.
+*/
+
+static void job_queue_wait_for_submits( job_queue_type * queue ) {
+  while (job_queue_get_num_submitting( queue ) > 0)
+    util_usleep( 1000 );
+}
+
+
 
 
 
@@ -438,6 +703,7 @@ job_list_unlock( queue->job_list );
 bool job_queue_kill_job( job_queue_type * queue , int job_index) {
   bool result;
   ASSIGN_LOCKED_ATTRIBUTE( result , job_queue_kill_job_node , queue , node);
+  job_queue_wakeup( queue );
   return result;
 }
 
@@ -531,6 +797,7 @@ void job_queue_iset_external_restart(job_queue_type * queue , int job_index) {
     job_queue_node_restart(node,queue->status);
   }
   job_list_unlock( queue->job_list );
+  job_queue_wakeup( queue );
 }
 
 
@@ -556,6 +823,7 @@ void job_queue_iset_external_fail(job_queue_type * queue , int job_index) {
     job_queue_node_status_transition(node,queue->status,JOB_QUEUE_EXIT);
   }
   job_list_unlock( queue->job_list );
+  job_queue_wakeup( queue );
 }
 
 
@@ -632,6 +900,15 @@ void job_queue_reset(job_queue_type * queue) {
   job_list_unlock( queue->job_list );
   job_queue_status_clear(queue->status);
 
+  pthread_mutex_lock( &queue->event_mutex );
+  int_vector_reset( queue->events );
+  queue->wakeup = false;
+  pthread_mutex_unlock( &queue->event_mutex );
+
+  bool_vector_reset( queue->submitting );
+  queue->submit_backoff_time = 0;
+  job_queue_reset_submit_stats( queue );
+
   /*
       Be ready for the next run
   */
@@ -650,6 +927,11 @@ bool job_queue_is_running( const job_queue_type * queue ) {
 
 static void job_queue_user_exit__( job_queue_type * queue ) {
   int queue_index;
+  /*
+    A job which is being submitted now would not be killed; the submit
+    threads do not start new submits after user_exit is set.
+  */
+  job_queue_wait_for_submits( queue );
   for (queue_index = 0; queue_index < job_list_get_size( queue->job_list ); queue_index++) {
     job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
 
@@ -712,6 +994,7 @@ static void * job_queue_run_DONE_callback( void * arg ) {
   }
   job_list_unlock(job_queue->job_list );
   arg_pack_free( arg_pack );
+  job_queue_wakeup( job_queue );
   return NULL;
 }
 
@@ -756,6 +1039,7 @@ static void * job_queue_run_EXIT_callback( void * arg ) {
   }
   job_list_unlock(job_queue->job_list );
   arg_pack_free( arg_pack );
+  job_queue_wakeup( job_queue );
 
   return NULL;
 }
@@ -777,6 +1061,7 @@ static void * job_queue_run_DO_KILL_callback( void * arg ) {
   }
   job_list_unlock(job_queue->job_list );
   arg_pack_free( arg_pack );
+  job_queue_wakeup( job_queue );
   return NULL;
 }
 
@@ -885,10 +1170,17 @@ void job_queue_run_jobs(job_queue_type * queue , int num_total_run, bool verbose
     */
     const int NUM_WORKER_THREADS = 4;
     queue->work_pool = thread_pool_alloc( NUM_WORKER_THREADS , true );
+    queue->submit_pool = thread_pool_alloc( queue->submit_threads , true );
     {
       bool new_jobs         = false;
       bool cont             = true;
       int  phase = 0;
+      double poll_interval  = queue->usleep_time;    /* Microseconds */
+      double next_poll      = 0;
+      double next_submit    = 0;                     /* With a max_submit_rate the next submit can not start before this time. */
+
+      if (queue_driver_has_job_events( queue->driver ))
+        poll_interval *= JOB_QUEUE_EVENT_POLL_FACTOR;
 
       queue->running = true;
       do {
@@ -906,7 +1198,12 @@ void job_queue_run_jobs(job_queue_type * queue , int num_total_run, bool verbose
 
         /*****************************************************************/
         {
-          bool update_status = job_queue_update_status( queue );
+          bool poll_all = (job_queue_wall_time() >= next_poll);
+          bool update_status;
+
+          if (poll_all)
+            next_poll = job_queue_wall_time() + 1e-6 * poll_interval;
+          update_status = job_queue_update_status( queue , poll_all );
           if (verbose) {
             if (update_status || new_jobs)
               job_queue_print_summary(queue , update_status );
@@ -943,52 +1240,62 @@ void job_queue_run_jobs(job_queue_type * queue , int num_total_run, bool verbose
           }
 
           if (cont) {
-            /* Submitting new jobs */
-            int max_submit     = 5; /* This is the maximum number of jobs submitted in one while() { ... } below.
-                                       Only to ensure that the waiting time before a status update is not too long. */
-            int total_active   = job_queue_status_get_count(queue->status, JOB_QUEUE_PENDING) + job_queue_status_get_count(queue->status, JOB_QUEUE_RUNNING);
+            /*
+              Submitting new jobs; the jobs are handed to the
+              submit_pool, and the submits which are still in progress
+              count as active jobs.
+            */
+            int num_submitting = job_queue_get_num_submitting( queue );
+            int total_active   = job_queue_status_get_count(queue->status, JOB_QUEUE_PENDING) +
+                                 job_queue_status_get_count(queue->status, JOB_QUEUE_RUNNING) +
+                                 job_queue_status_get_count(queue->status, JOB_QUEUE_SUBMITTED) + num_submitting;
             int num_submit_new;
 
             {
               int max_running = job_queue_get_max_running( queue );
               if (max_running > 0)
-                num_submit_new = util_int_min( max_submit ,  max_running - total_active );
+                num_submit_new = max_running - total_active;
               else
                 /*
                    If max_running == 0 that should be interpreted as no limit; i.e. the queue layer will
                    attempt to send an unlimited number of jobs to the driver - the driver can reject the jobs.
                 */
-                num_submit_new = util_int_min( max_submit , job_queue_status_get_count(queue->status, JOB_QUEUE_WAITING));
+                num_submit_new = job_queue_status_get_count(queue->status, JOB_QUEUE_WAITING) - num_submitting;
             }
 
             new_jobs = false;
-            if (job_queue_status_get_count(queue->status, JOB_QUEUE_WAITING) > 0)   /* We have waiting jobs at all           */
-              if (num_submit_new > 0)                                               /* The queue can allow more running jobs */
-                new_jobs = true;
+            if (job_queue_status_get_count(queue->status, JOB_QUEUE_WAITING) > num_submitting)   /* We have waiting jobs at all           */
+              if (num_submit_new > 0)                                                            /* The queue can allow more running jobs */
+                if (!queue->user_exit && !queue->pause_on)
+                  new_jobs = true;
 
             if (new_jobs) {
-              int submit_count = 0;
               int queue_index  = 0;
+              double now = job_queue_wall_time();
 
-              while ((queue_index < job_list_get_size( queue->job_list )) && (num_submit_new > 0)) {
+              if (now < job_queue_get_submit_backoff_time( queue ))
+                new_jobs = false;
+
+              while (new_jobs && (queue_index < job_list_get_size( queue->job_list )) && (num_submit_new > 0)) {
                 job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
-                if (job_queue_node_get_status(node) == JOB_QUEUE_WAITING) {
-                  {
-                    submit_status_type submit_status = job_queue_submit_job(queue , queue_index);
-
-                    if (submit_status == SUBMIT_OK) {
-                      num_submit_new--;
-                      submit_count++;
-                    } else if ((submit_status == SUBMIT_DRIVER_FAIL) || (submit_status == SUBMIT_QUEUE_CLOSED))
+                if ((job_queue_node_get_status(node) == JOB_QUEUE_WAITING) && !job_queue_is_submitting( queue , queue_index )) {
+                  if (queue->max_submit_rate > 0) {
+                    if (now < next_submit)
                       break;
+                    next_submit = util_double_max( next_submit , now ) + 1.0 / queue->max_submit_rate;
                   }
+                  job_queue_start_submit( queue , queue_index );
+                  num_submit_new--;
                 }
                 queue_index++;
               }
             }
 
 
-            {
+            if ((job_queue_status_get_count(queue->status, JOB_QUEUE_DONE) +
+                 job_queue_status_get_count(queue->status, JOB_QUEUE_EXIT) +
+                 job_queue_status_get_count(queue->status, JOB_QUEUE_DO_KILL_NODE_FAILURE) +
+                 job_queue_status_get_count(queue->status, JOB_QUEUE_DO_KILL)) > 0) {
               /*
                 Checking for complete / exited / overtime jobs
                */
@@ -1024,16 +1331,35 @@ void job_queue_run_jobs(job_queue_type * queue , int num_total_run, bool verbose
         job_list_unlock( queue->job_list );
         if (local_user_exit)
           cont = false;    /* This is how we signal that we want to get out . */
-        else {
-          util_yield();
-          job_list_reader_wait( queue->job_list , queue->usleep_time , 8 * queue->usleep_time);
+        else if (cont) {
+          /*
+            Sleep until the next poll, or until something happens; but
+            never longer than usleep_time, the checks of the jobs
+            which have not been confirmed running depend on that. The
+            drivers with events report the jobs submitted in this
+            round immediately, so the next round - and the next batch
+            of submits - follows as soon as they have been accepted.
+          */
+          double wait_time = util_double_min( 1e6 * (next_poll - job_queue_wall_time()) , queue->usleep_time );
+          if (new_jobs && (queue->max_submit_rate > 0))
+            wait_time = util_double_min( wait_time , 1e6 * (next_submit - job_queue_wall_time()));
+          if (wait_time > 0)
+            job_queue_wait_for_events( queue , wait_time );
         }
       } while ( cont );
     }
     if (verbose)
       printf("\n");
+    thread_pool_join( queue->submit_pool );
+    thread_pool_free( queue->submit_pool );
     thread_pool_join( queue->work_pool );
     thread_pool_free( queue->work_pool );
+
+    if (verbose && (queue->submit_count > 0))
+      printf("Submitted %d jobs - time per submit: mean %.3f s  max %.3f s\n" ,
+             queue->submit_count ,
+             job_queue_get_mean_submit_time( queue ) ,
+             job_queue_get_max_submit_time( queue ));
   }
 
   /*
@@ -1157,6 +1483,7 @@ int job_queue_add_job(job_queue_type * queue ,
         job_queue_change_node_status(queue , node , JOB_QUEUE_WAITING);
       }
       job_list_unlock( queue->job_list );
+      job_queue_wakeup( queue );
       return queue_index;   /* Handle used by the calling scope. */
     } else {
       char * cwd = util_alloc_cwd();
@@ -1203,8 +1530,21 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
   queue->work_pool        = NULL;
   queue->job_list         = job_list_alloc(  );
   queue->status           = job_queue_status_alloc( );
+  queue->events           = int_vector_alloc( 0 , 0 );
+  queue->event_buffer     = int_vector_alloc( 0 , 0 );
+  queue->wakeup           = false;
+  queue->submit_pool      = NULL;
+  queue->submit_threads   = JOB_QUEUE_DEFAULT_SUBMIT_THREADS;
+  queue->max_submit_rate  = 0;
+  queue->submitting       = bool_vector_alloc( 0 , false );
+  queue->num_submitting   = 0;
+  queue->submit_backoff_time = 0;
+  job_queue_reset_submit_stats( queue );
 
   pthread_mutex_init( &queue->run_mutex    , NULL );
+  pthread_mutex_init( &queue->event_mutex  , NULL );
+  pthread_cond_init( &queue->event_cond    , NULL );
+  pthread_mutex_init( &queue->submit_mutex , NULL );
 
   return queue;
 }
@@ -1220,6 +1560,7 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
 
 void job_queue_submit_complete( job_queue_type * queue ){
   queue->submit_complete = true;
+  job_queue_wakeup( queue );
 }
 
 
@@ -1254,6 +1595,70 @@ int job_queue_get_max_submit(const job_queue_type * job_queue ) {
 }
 
 
+/**
+   The number of threads which submit jobs to the driver
+   concurrently. Takes effect at the next job_queue_run_jobs().
+*/
+
+void job_queue_set_submit_threads( job_queue_type * job_queue , int submit_threads ) {
+  if (submit_threads <= 0)
+    util_abort("%s: the number of submit threads must be positive - got:%d \n",__func__ , submit_threads);
+  job_queue->submit_threads = submit_threads;
+}
+
+
+int job_queue_get_submit_threads( const job_queue_type * job_queue ) {
+  return job_queue->submit_threads;
+}
+
+
+/**
+   The maximum number of jobs submitted to the driver per second; the
+   default value 0 means no limit.
+*/
+
+void job_queue_set_max_submit_rate( job_queue_type * job_queue , double max_submit_rate ) {
+  if (max_submit_rate < 0)
+    util_abort("%s: the submit rate can not be negative - got:%g \n",__func__ , max_submit_rate);
+  job_queue->max_submit_rate = max_submit_rate;
+}
+
+
+double job_queue_get_max_submit_rate( const job_queue_type * job_queue ) {
+  return job_queue->max_submit_rate;
+}
+
+
+/**
+   Statistics of the time spent in the driver submit function, for
+   the jobs which were successfully submitted.
+*/
+
+void job_queue_reset_submit_stats( job_queue_type * job_queue ) {
+  job_queue->submit_count      = 0;
+  job_queue->submit_time_total = 0;
+  job_queue->submit_time_max   = 0;
+}
+
+
+int job_queue_get_submit_count( const job_queue_type * job_queue ) {
+  return job_queue->submit_count;
+}
+
+
+double job_queue_get_mean_submit_time( const job_queue_type * job_queue ) {
+  if (job_queue->submit_count > 0)
+    return job_queue->submit_time_total / job_queue->submit_count;
+  else
+    return 0;
+}
+
+
+double job_queue_get_max_submit_time( const job_queue_type * job_queue ) {
+  return job_queue->submit_time_max;
+}
+
+
 /**
    Returns true if the queue is currently paused, which means that no
    more jobs are submitted.
@@ -1271,6 +1676,7 @@ void job_queue_set_pause_on( job_queue_type * job_queue) {
 
 void job_queue_set_pause_off( job_queue_type * job_queue) {
   job_queue->pause_on = false;
+  job_queue_wakeup( job_queue );
 }
 
 /*
@@ -1291,6 +1697,7 @@ bool job_queue_start_user_exit( job_queue_type * queue) {
     while (true) {
       if (queue->running) {
         queue->user_exit = true;
+        job_queue_wakeup( queue );
         break;
     }
       usleep( usleep_time );
@@ -1312,6 +1719,12 @@ void job_queue_free(job_queue_type * queue) {
   util_safe_free( queue->exit_file );
   job_list_free( queue->job_list );
   job_queue_status_free( queue->status );
+  int_vector_free( queue->events );
+  int_vector_free( queue->event_buffer );
+  bool_vector_free( queue->submitting );
+  pthread_cond_destroy( &queue->event_cond );
+  pthread_mutex_destroy( &queue->event_mutex );
+  pthread_mutex_destroy( &queue->submit_mutex );
   free(queue);
 }
 
@@ -17,36 +17,94 @@
 */
 
 #include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
+#include <unistd.h>
+
+#ifdef HAVE_PIDFD_EPOLL
+#include <sys/syscall.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#endif
 
 #include <ert/util/util.h>
-#include <ert/util/arg_pack.h>
 
 #include <ert/job_queue/queue_driver.h>
 #include <ert/job_queue/local_driver.h>
 
 
+/*
+  The local driver runs the jobs as child processes of the current
+  process. When a child has exited the status of the job is set to
+  DONE, and the event callback of the queue is invoked. There are two
+  ways to wait for the children:
+
+    1. One reaper thread for all the jobs. Every child is represented
+       with a pidfd (from pidfd_open()) in an epoll set, and the reaper
+       thread collects the children as their pidfd becomes readable.
+       This is only available on Linux >= 5.3.
+
+    2. One thread per job sitting in waitid() until the child has
+       exited. This is used when the reaper is not available, or has
+       been disabled with local_driver_set_reaper().
+
+  In both cases the child is only reaped while holding the event_lock
+  of the job; local_driver_kill_job() signals the child under the same
+  lock, so it can not hit a pid which has been reused. A running job
+  which is freed by the queue is only marked as freed, and is freed by
+  the thread which collects the child. When the event callback of a
+  completed job is running, local_job_free() waits for it to return;
+  the queue frees all its jobs before it is freed itself, so the
+  callback can not be invoked on a queue which has been freed.
+
+  In both cases the resource usage of the child is recorded, and is
+  available with local_job_get_cpu_time() and local_job_get_max_rss()
+  when the job has completed.
+*/
+
+
 struct local_job_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool            active;
-  job_status_type status;
-  pthread_t       run_thread;
-  pid_t           child_process;
+  bool              active;
+  bool              freed;            /* The job has been freed by the queue while the child is still running. */
+  job_status_type   status;
+  pthread_t         run_thread;
+  pid_t             child_process;
+  int               pidfd;            /* Only used by the reaper; -1 otherwise. */
+  struct rusage     rusage;
+  pthread_mutex_t   event_lock;       /* Protecting the status and the event fields below. */
+  pthread_cond_t    event_cond;       /* Signalled when the event callback has returned. */
+  int               callbacks_running;
+  job_event_ftype * event_callback;   /* Called when the job has completed - can be NULL. */
+  void            * event_arg;
+  int               event_tag;
+  local_job_type  * prev;             /* The list of jobs held by the reaper; protected by the submit_lock of the driver. */
+  local_job_type  * next;
 };
 
 
 #define LOCAL_DRIVER_TYPE_ID 66196305
 #define LOCAL_JOB_TYPE_ID    63056619
 
+#define LOCAL_DRIVER_MAX_EVENTS 64
+
 struct local_driver_struct {
   UTIL_TYPE_ID_DECLARATION;
   pthread_attr_t     thread_attr;
   pthread_mutex_t    submit_lock;
+
+  bool               use_reaper;
+  bool               reaper_running;
+  pthread_t          reaper_thread;
+  int                epoll_fd;
+  int                stop_pipe[2];     /* Writing to stop_pipe[1] stops the reaper thread. */
+  local_job_type   * reaper_jobs;      /* The jobs registered with the reaper. */
 };
 
 /*****************************************************************/
@@ -61,15 +119,69 @@ local_job_type * local_job_alloc() {
   job = util_malloc(sizeof * job );
   UTIL_TYPE_ID_INIT( job , LOCAL_JOB_TYPE_ID );
   job->active = false;
+  job->freed = false;
   job->status = JOB_QUEUE_WAITING;
+  job->child_process = 0;
+  job->pidfd = -1;
+  memset( &job->rusage , 0 , sizeof job->rusage );
+  job->event_callback = NULL;
+  job->event_arg = NULL;
+  job->event_tag = -1;
+  job->callbacks_running = 0;
+  job->prev = NULL;
+  job->next = NULL;
+  pthread_mutex_init( &job->event_lock , NULL );
+  pthread_cond_init( &job->event_cond , NULL );
   return job;
 }
 
+
+static void local_job_free__(local_job_type * job) {
+  pthread_cond_destroy( &job->event_cond );
+  pthread_mutex_destroy( &job->event_lock );
+  free(job);
+}
+
+
+/*
+  A job whose child is still running is only marked as freed; the
+  reaper or the wait thread frees it when the child has exited. A job
+  which has completed is freed when the event callback has returned.
+*/
+
 void local_job_free(local_job_type * job) {
-  if (job->active) {
-    /* Thread clean up */
+  bool running;
+
+  pthread_mutex_lock( &job->event_lock );
+  running = job->active;
+  if (running)
+    job->freed = true;
+  else {
+    while (job->callbacks_running > 0)
+      pthread_cond_wait( &job->event_cond , &job->event_lock );
   }
-  free(job);
+  pthread_mutex_unlock( &job->event_lock );
+
+  if (!running)
+    local_job_free__( job );
+}
+
+
+/*
+  CPU time (user + system) in seconds, and the maximum resident set
+  size in kilobytes, of the child process. Both are zero until the job
+  has completed.
+*/
+
+double local_job_get_cpu_time( const local_job_type * job ) {
+  const struct rusage * usage = &job->rusage;
+  return usage->ru_utime.tv_sec + 1e-6 * usage->ru_utime.tv_usec +
+         usage->ru_stime.tv_sec + 1e-6 * usage->ru_stime.tv_usec;
+}
+
+
+long local_job_get_max_rss( const local_job_type * job ) {
+  return job->rusage.ru_maxrss;
 }
 
 
@@ -80,11 +192,37 @@ job_status_type local_driver_get_job_status(void * __driver, void * __job) {
     return JOB_QUEUE_NOT_ACTIVE;
   else {
     local_job_type * job = local_job_safe_cast( __job );
-    return job->status;
+    job_status_type status;
+    pthread_mutex_lock( &job->event_lock );
+    status = job->status;
+    pthread_mutex_unlock( &job->event_lock );
+    return status;
   }
 }
 
 
+/*
+  The callback is invoked immediately, so that the queue picks up the
+  RUNNING status set in local_driver_submit_job(), and then again from
+  the run thread when the job has completed. The callback is invoked
+  without holding the lock, since the queue might free the job as soon
+  as it has seen the DONE status.
+*/
+
+void local_driver_set_job_event( void * __driver , void * __job , job_event_ftype * callback , void * arg , int tag) {
+  local_job_type * job = local_job_safe_cast( __job );
+
+  pthread_mutex_lock( &job->event_lock );
+  job->event_callback = callback;
+  job->event_arg      = arg;
+  job->event_tag      = tag;
+  pthread_mutex_unlock( &job->event_lock );
+
+  if (callback)
+    callback( arg , tag );
+}
+
+
 
 void local_driver_free_job( void * __job ) {
   local_job_type    * job    = local_job_safe_cast( __job );
@@ -92,45 +230,279 @@ void local_driver_free_job( void * __job ) {
 }
 
 
+/*
+  The child is collected while holding the lock, i.e. an active job
+  can not have had its pid reused. The job is completed by the reaper
+  or the wait thread when the child has exited.
+*/
+
 void local_driver_kill_job( void * __driver , void * __job) {
   local_job_type    * job  = local_job_safe_cast( __job );
-  
-  if (job->active) {
-    pthread_cancel( job->run_thread ); 
-  }
-  
-  kill( job->child_process , SIGTERM );
+
+  pthread_mutex_lock( &job->event_lock );
+  if (job->active)
+    kill( job->child_process , SIGTERM );
+  pthread_mutex_unlock( &job->event_lock );
+}
+
+
+/*
+  Must be called with the event_lock held, and will release it. The
+  event callback is invoked without holding the lock, so that it can
+  query the driver. The job is not touched after the lock has been
+  released for the last time; local_job_free() might be waiting for
+  the callback to return.
+*/
+
+static void local_job_complete( local_job_type * job ) {
+  job->status = JOB_QUEUE_DONE;
+  job->active = false;
+
+  if (job->freed) {
+    pthread_mutex_unlock( &job->event_lock );
+    local_job_free__( job );
+  } else if (job->event_callback) {
+    job_event_ftype * event_callback = job->event_callback;
+    void * event_arg                 = job->event_arg;
+    int event_tag                    = job->event_tag;
+
+    job->callbacks_running++;
+    pthread_mutex_unlock( &job->event_lock );
+
+    event_callback( event_arg , event_tag );
+
+    pthread_mutex_lock( &job->event_lock );
+    job->callbacks_running--;
+    pthread_cond_broadcast( &job->event_cond );
+    pthread_mutex_unlock( &job->event_lock );
+  } else
+    pthread_mutex_unlock( &job->event_lock );
 }
 
 
+/*
+  Waits for the child without reaping it, the child is then reaped
+  while holding the event_lock.
+*/
+
 void * submit_job_thread__(void * __arg) {
-  arg_pack_type *arg_pack = arg_pack_safe_cast(__arg);
-  const char *executable = arg_pack_iget_const_ptr(arg_pack, 0);
-  /*
-    The arg_pack contains a run_path field as the second argument,
-    it has therefor been left here as a comment:
-
-    const char * run_path    = arg_pack_iget_const_ptr(arg_pack , 1);
-  */
-  int argc = arg_pack_iget_int(arg_pack, 2);
-  char **argv = arg_pack_iget_ptr(arg_pack, 3);
-  local_job_type *job = arg_pack_iget_ptr(arg_pack, 4);
+  local_job_type * job = local_job_safe_cast( __arg );
+  siginfo_t info;
+  int wait_status;
 
-  {
-    int wait_status;
-    job->child_process = util_spawn(executable, argc, (const char**) argv, NULL, NULL);
-    util_free_stringlist(argv, argc);
-    arg_pack_free(arg_pack);
-    waitpid(job->child_process, &wait_status, 0);
+  while (waitid( P_PID , job->child_process , &info , WEXITED | WNOWAIT ) != 0) {
+    if (errno != EINTR)
+      break;
   }
 
-  job->status = JOB_QUEUE_DONE;
-  job->active = false;
+  pthread_mutex_lock( &job->event_lock );
+  wait4( job->child_process , &wait_status , 0 , &job->rusage );
+  local_job_complete( job );
+
   pthread_exit(NULL);
   return NULL;
 }
 
 
+/*****************************************************************/
+/* The reaper thread. */
+
+#ifdef HAVE_PIDFD_EPOLL
+
+static int local_driver_pidfd_open( pid_t pid ) {
+  return syscall( SYS_pidfd_open , pid , 0 );
+}
+
+
+/*
+  The reaper_jobs list is maintained with the submit_lock held; it is
+  only used to hand the remaining jobs over to wait threads when the
+  driver is freed.
+*/
+
+static void local_driver_link_reaper_job( local_driver_type * driver , local_job_type * job ) {
+  job->prev = NULL;
+  job->next = driver->reaper_jobs;
+  if (driver->reaper_jobs)
+    driver->reaper_jobs->prev = job;
+  driver->reaper_jobs = job;
+}
+
+
+static void local_driver_unlink_reaper_job( local_driver_type * driver , local_job_type * job ) {
+  if (job->prev)
+    job->prev->next = job->next;
+  else
+    driver->reaper_jobs = job->next;
+
+  if (job->next)
+    job->next->prev = job->prev;
+
+  job->prev = NULL;
+  job->next = NULL;
+}
+
+
+static void local_driver_reap_job( local_driver_type * driver , local_job_type * job ) {
+  int wait_status;
+
+  epoll_ctl( driver->epoll_fd , EPOLL_CTL_DEL , job->pidfd , NULL );
+  pthread_mutex_lock( &driver->submit_lock );
+  local_driver_unlink_reaper_job( driver , job );
+  pthread_mutex_unlock( &driver->submit_lock );
+
+  pthread_mutex_lock( &job->event_lock );
+  wait4( job->child_process , &wait_status , 0 , &job->rusage );
+  close( job->pidfd );
+  job->pidfd = -1;
+  local_job_complete( job );
+}
+
+
+static void * local_driver_reaper__( void * arg ) {
+  local_driver_type * driver = local_driver_safe_cast( arg );
+  struct epoll_event events[ LOCAL_DRIVER_MAX_EVENTS ];
+  bool stop = false;
+
+  while (!stop) {
+    int num_events = epoll_wait( driver->epoll_fd , events , LOCAL_DRIVER_MAX_EVENTS , -1 );
+
+    if (num_events < 0) {
+      if (errno == EINTR)
+        continue;
+      util_abort("%s: epoll_wait() failed: %s \n",__func__ , strerror( errno ));
+    }
+
+    for (int i = 0; i < num_events; i++) {
+      local_job_type * job = events[i].data.ptr;
+      if (job == NULL)
+        stop = true;
+      else
+        local_driver_reap_job( driver , job );
+    }
+  }
+  return NULL;
+}
+
+
+/*
+  Starts the reaper thread on the first submit; if pidfd_open() is not
+  supported by the running kernel the driver falls back to one thread
+  per job. Called with the submit_lock held.
+*/
+
+static void local_driver_start_reaper( local_driver_type * driver ) {
+  int test_fd = local_driver_pidfd_open( getpid() );
+
+  if (test_fd < 0) {
+    driver->use_reaper = false;
+    return;
+  }
+  close( test_fd );
+
+  driver->epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+  if (driver->epoll_fd < 0)
+    util_abort("%s: epoll_create1() failed: %s \n",__func__ , strerror( errno ));
+
+  if (pipe( driver->stop_pipe ) != 0)
+    util_abort("%s: pipe() failed: %s \n",__func__ , strerror( errno ));
+  fcntl( driver->stop_pipe[0] , F_SETFD , FD_CLOEXEC );
+  fcntl( driver->stop_pipe[1] , F_SETFD , FD_CLOEXEC );
+
+  {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    epoll_ctl( driver->epoll_fd , EPOLL_CTL_ADD , driver->stop_pipe[0] , &event );
+  }
+
+  if (pthread_create( &driver->reaper_thread , NULL , local_driver_reaper__ , driver ) != 0)
+    util_abort("%s: failed to create reaper thread - aborting \n",__func__);
+
+  driver->reaper_running = true;
+}
+
+
+/*
+  The jobs which are still held by the reaper when it is stopped are
+  handed over to one wait thread each; their pidfds are closed. A job
+  which the queue has already freed is then freed by the wait thread
+  when the child has exited.
+*/
+
+static void local_driver_stop_reaper( local_driver_type * driver ) {
+  if (driver->reaper_running) {
+    char stop = 1;
+    if (write( driver->stop_pipe[1] , &stop , 1 ) != 1)
+      util_abort("%s: failed to stop the reaper thread \n",__func__);
+
+    pthread_join( driver->reaper_thread , NULL );
+
+    pthread_mutex_lock( &driver->submit_lock );
+    while (driver->reaper_jobs) {
+      local_job_type * job = driver->reaper_jobs;
+      local_driver_unlink_reaper_job( driver , job );
+
+      pthread_mutex_lock( &job->event_lock );
+      close( job->pidfd );
+      job->pidfd = -1;
+      if (pthread_create( &job->run_thread , &driver->thread_attr , submit_job_thread__ , job) != 0)
+        util_abort("%s: failed to create run thread - aborting \n",__func__);
+      pthread_mutex_unlock( &job->event_lock );
+    }
+    pthread_mutex_unlock( &driver->submit_lock );
+
+    close( driver->stop_pipe[0] );
+    close( driver->stop_pipe[1] );
+    close( driver->epoll_fd );
+    driver->reaper_running = false;
+  }
+}
+
+
+/*
+  Returns false if the pidfd could not be created, e.g. when running
+  out of file descriptors; the caller must then wait for the child
+  with a thread.
+*/
+
+static bool local_driver_add_reaper_job( local_driver_type * driver , local_job_type * job ) {
+  int pidfd = local_driver_pidfd_open( job->child_process );
+  if (pidfd < 0)
+    return false;
+
+  job->pidfd = pidfd;
+  {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = job;
+    if (epoll_ctl( driver->epoll_fd , EPOLL_CTL_ADD , pidfd , &event ) != 0) {
+      close( pidfd );
+      job->pidfd = -1;
+      return false;
+    }
+  }
+  local_driver_link_reaper_job( driver , job );
+  return true;
+}
+
+#else
+
+static void local_driver_start_reaper( local_driver_type * driver ) {
+  driver->use_reaper = false;
+}
+
+static void local_driver_stop_reaper( local_driver_type * driver ) {
+}
+
+static bool local_driver_add_reaper_job( local_driver_type * driver , local_job_type * job ) {
+  return false;
+}
+
+#endif
+
+/*****************************************************************/
+
 
 void * local_driver_submit_job(void * __driver           , 
                                const char *  submit_cmd  , 
@@ -142,19 +514,27 @@ void * local_driver_submit_job(void * __driver           ,
   local_driver_type * driver = local_driver_safe_cast( __driver );
   {
     local_job_type * job    = local_job_alloc();
-    arg_pack_type  * arg_pack = arg_pack_alloc();
-    arg_pack_append_const_ptr( arg_pack , submit_cmd);
-    arg_pack_append_const_ptr( arg_pack , run_path );
-    arg_pack_append_int( arg_pack , argc );
-    arg_pack_append_ptr( arg_pack , util_alloc_stringlist_copy( argv , argc ));   /* Due to conflict with threads and python GC we take a local copy. */
-    arg_pack_append_ptr( arg_pack , job );
     
     pthread_mutex_lock( &driver->submit_lock );
+    if (driver->use_reaper && !driver->reaper_running)
+      local_driver_start_reaper( driver );
+
     job->active = true;
     job->status = JOB_QUEUE_RUNNING;
-    
-    if (pthread_create( &job->run_thread , &driver->thread_attr , submit_job_thread__ , arg_pack) != 0) 
-      util_abort("%s: failed to create run thread - aborting \n",__func__);
+
+    /*
+      The job is registered with the reaper while holding the
+      event_lock, so that the reaper can not complete the job before
+      the pidfd field has been set.
+    */
+    pthread_mutex_lock( &job->event_lock );
+    job->child_process = util_spawn( submit_cmd , argc , argv , NULL , NULL );
+
+    if (!(driver->use_reaper && local_driver_add_reaper_job( driver , job ))) {
+      if (pthread_create( &job->run_thread , &driver->thread_attr , submit_job_thread__ , job) != 0) 
+        util_abort("%s: failed to create run thread - aborting \n",__func__);
+    }
+    pthread_mutex_unlock( &job->event_lock );
     
     pthread_mutex_unlock( &driver->submit_lock );
     return job;
@@ -162,9 +542,27 @@ void * local_driver_submit_job(void * __driver           ,
 }
 
 
+void local_driver_set_reaper( local_driver_type * driver , bool use_reaper ) {
+  pthread_mutex_lock( &driver->submit_lock );
+  driver->use_reaper = use_reaper;
+  pthread_mutex_unlock( &driver->submit_lock );
+}
+
+
+/*
+  Returns true if the jobs are collected by the reaper thread; that is
+  only known after the first job has been submitted.
+*/
+
+bool local_driver_has_reaper( const local_driver_type * driver ) {
+  return driver->use_reaper && driver->reaper_running;
+}
+
 
 void local_driver_free(local_driver_type * driver) {
+  local_driver_stop_reaper( driver );
   pthread_attr_destroy ( &driver->thread_attr );
+  pthread_mutex_destroy( &driver->submit_lock );
   free(driver);
   driver = NULL;
 }
@@ -182,7 +580,16 @@ void * local_driver_alloc() {
   pthread_mutex_init( &local_driver->submit_lock , NULL );
   pthread_attr_init( &local_driver->thread_attr );
   pthread_attr_setdetachstate( &local_driver->thread_attr , PTHREAD_CREATE_DETACHED );
-  
+
+#ifdef HAVE_PIDFD_EPOLL
+  local_driver->use_reaper = true;
+#else
+  local_driver->use_reaper = false;
+#endif
+  local_driver->reaper_running = false;
+  local_driver->epoll_fd = -1;
+  local_driver->reaper_jobs = NULL;
+
   return local_driver;
 }
 
@@ -23,6 +23,7 @@
 #include <dlfcn.h>
 #include <unistd.h>
 
+#include <ert/util/build_config.h>
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
@@ -493,6 +494,33 @@ static int lsf_driver_submit_internal_job( lsf_driver_type * driver ,
 
 
 
+/*
+  The shell submit methods run concurrently from the job_queue submit
+  threads, and each bsub invocation needs a private file for its
+  stdout. With mkstemp() the file is created atomically; the fallback
+  util_alloc_tmp_file() only probes for a free name with rand() and is
+  therefore serialized on the submit_lock.
+*/
+
+static char * lsf_driver_alloc_submit_file( lsf_driver_type * driver ) {
+#ifdef HAVE_MKSTEMP
+  char * tmp_file = util_alloc_sprintf("/tmp/enkf-submit-%d-XXXXXX" , getpid());
+  int fd = mkstemp( tmp_file );
+  if (fd == -1)
+    util_abort("%s: failed to create temporary file:%s \n",__func__ , tmp_file);
+  close( fd );
+  return tmp_file;
+#else
+  char * tmp_file;
+  pthread_mutex_lock( &driver->submit_lock );
+  tmp_file = util_alloc_tmp_file("/tmp" , "enkf-submit" , true);
+  fclose( util_fopen( tmp_file , "w" ));   /* Claim the name before releasing the lock. */
+  pthread_mutex_unlock( &driver->submit_lock );
+  return tmp_file;
+#endif
+}
+
+
 static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
                                        const char *  lsf_stdout ,
                                        const char *  job_name   ,
@@ -501,7 +529,7 @@ static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
                                        int           job_argc,
                                        const char ** job_argv) {
   int job_id;
-  char * tmp_file = util_alloc_tmp_file("/tmp" , "enkf-submit" , true);
+  char * tmp_file = lsf_driver_alloc_submit_file( driver );
 
   {
     stringlist_type * remote_argv = lsf_driver_alloc_cmd( driver , lsf_stdout , job_name , submit_cmd , num_cpu , job_argc , job_argv);
@@ -917,22 +945,28 @@ void * lsf_driver_submit_job(void * __driver ,
     {
       char * lsf_stdout                    = util_alloc_filename(run_path , job_name , "LSF-stdout");
       lsf_submit_method_enum submit_method = driver->submit_method;
-      pthread_mutex_lock( &driver->submit_lock );
 
       if (driver->debug_output)
         printf("LSF DRIVER submitting using method:%d \n",submit_method);
 
       if (submit_method == LSF_SUBMIT_INTERNAL) {
+        /*
+          The internal submit fills in the lsf_request struct of the
+          driver; only one job can be submitted at a time. The shell
+          methods spawn a separate bsub process for each job, and can
+          run concurrently from the job_queue submit threads.
+        */
+        pthread_mutex_lock( &driver->submit_lock );
         if (stringlist_get_size(driver->exclude_hosts) > 0)
           printf("WARNING:  EXCLUDE_HOST is not supported with submit method LSF_SUBMIT_INTERNAL");
         job->lsf_jobnr = lsf_driver_submit_internal_job( driver , lsf_stdout , job_name , submit_cmd , num_cpu , argc, argv);
+        pthread_mutex_unlock( &driver->submit_lock );
       } else {
         job->lsf_jobnr      = lsf_driver_submit_shell_job( driver , lsf_stdout , job_name , submit_cmd , num_cpu , argc, argv);
         job->lsf_jobnr_char = util_alloc_sprintf("%ld" , job->lsf_jobnr);
         hash_insert_ref( driver->my_jobs , job->lsf_jobnr_char , NULL );
       }
 
-      pthread_mutex_unlock( &driver->submit_lock );
       free( lsf_stdout );
     }
 
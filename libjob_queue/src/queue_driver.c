@@ -71,6 +71,7 @@ struct queue_driver_struct {
   get_option_ftype * get_option;
   has_option_ftype * has_option;
   init_option_list_ftype * init_options;
+  set_job_event_ftype * set_job_event; /* NULL for drivers which can not notify the queue; the queue must poll them. */
 
   void * data; /* Driver specific data - passed as first argument to the driver functions above. */
 
@@ -175,6 +176,7 @@ static queue_driver_type * queue_driver_alloc_empty() {
   driver->submit = NULL;
   driver->get_status = NULL;
   driver->kill_job = NULL;
+  driver->blacklist_node = NULL;
   driver->free_job = NULL;
   driver->free_driver = NULL;
   driver->get_option = NULL;
@@ -184,6 +186,7 @@ static queue_driver_type * queue_driver_alloc_empty() {
   driver->data = NULL;
   driver->max_running_string = NULL;
   driver->init_options = NULL;
+  driver->set_job_event = NULL;
 
   queue_driver_set_generic_option__(driver, MAX_RUNNING, "0");
 
@@ -228,6 +231,7 @@ queue_driver_type * queue_driver_alloc(job_driver_type type) {
       driver->free_driver = local_driver_free__;
       driver->name = util_alloc_string_copy("local");
       driver->init_options = local_driver_init_option_list;
+      driver->set_job_event = local_driver_set_job_event;
       driver->data = local_driver_alloc();
       break;
     case RSH_DRIVER:
@@ -265,6 +269,36 @@ queue_driver_type * queue_driver_alloc(job_driver_type type) {
 }
 
 
+
+/**
+   Creates a driver from an external implementation of the driver
+   functions, e.g. a mock driver in a test. The driver instance takes
+   ownership of @data, which is freed with @free_driver. The
+   @set_job_event function can be NULL, in which case the queue will
+   poll the driver for the status of the jobs.
+ */
+
+queue_driver_type * queue_driver_alloc_custom(const char * name,
+                                              void * data,
+                                              submit_job_ftype * submit,
+                                              get_status_ftype * get_status,
+                                              kill_job_ftype * kill_job,
+                                              free_job_ftype * free_job,
+                                              free_queue_driver_ftype * free_driver,
+                                              set_job_event_ftype * set_job_event) {
+  queue_driver_type * driver = queue_driver_alloc_empty();
+  driver->name = util_alloc_string_copy(name);
+  driver->data = data;
+  driver->submit = submit;
+  driver->get_status = get_status;
+  driver->kill_job = kill_job;
+  driver->free_job = free_job;
+  driver->free_driver = free_driver;
+  driver->set_job_event = set_job_event;
+  return driver;
+}
+
+
 /*****************************************************************/
 
 bool queue_driver_has_option(queue_driver_type * driver, const char * option_key) {
@@ -359,8 +393,18 @@ job_status_type queue_driver_get_status(queue_driver_type * driver, void * job_d
   return status;
 }
 
+bool queue_driver_has_job_events(const queue_driver_type * driver) {
+  return (driver->set_job_event != NULL);
+}
+
+void queue_driver_set_job_event(queue_driver_type * driver, void * job_data, job_event_ftype * callback, void * arg, int tag) {
+  if (driver->set_job_event)
+    driver->set_job_event(driver->data, job_data, callback, arg, tag);
+}
+
 void queue_driver_free_driver(queue_driver_type * driver) {
-  driver->free_driver(driver->data);
+  if (driver->free_driver)
+    driver->free_driver(driver->data);
 }
 
 /*****************************************************************/
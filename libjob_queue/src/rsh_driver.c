@@ -21,20 +21,83 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/wait.h>
 #include <netdb.h>
 #include <pthread.h>
 #include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
 
 
 #include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
-#include <ert/util/arg_pack.h>
 
 #include <ert/job_queue/queue_driver.h>
 #include <ert/job_queue/rsh_driver.h>
 
+extern char **environ;
 
 
+/*
+  The rsh driver runs the jobs on a list of hosts with the rsh_command
+  (typically ssh). There are two ways to start a job:
+
+    1. Through a persistent control connection: for every host one
+       process 'rsh_command host sh' is started, and the remote shell
+       reads job launch commands from its stdin. The jobs are started
+       in the background by the remote shell, which reports back:
+
+          STARTED <job_id> <remote pid>
+          DONE <job_id> <exit status>
+
+       on its stdout; one reader thread per host parses these lines
+       and updates the jobs. The jobs are started with setsid when the
+       remote host has it, so every job is the leader of its own
+       process group; killing a job is done by writing 'kill -TERM
+       -<remote pid>' to the remote shell, which also terminates the
+       processes started by the job. The stdout of the jobs is
+       redirected to stderr, so that it does not interfere with the
+       status lines.
+
+    2. One 'rsh_command host cmd arg1 arg2 ...' process per job, and a
+       thread which waits for that process to exit. The rsh process
+       is started in its own process group, and killing the job sends
+       SIGTERM to that group. Whether that terminates the remote job
+       depends on the rsh_command; the local processes are always
+       terminated.
+
+  The control connection is the default; it is disabled with the
+  RSH_PERSISTENT_CONNECTION option. If the connection to a host is
+  lost the driver falls back to one process per job for that host, and
+  the jobs which were running through the connection are reported as
+  JOB_QUEUE_EXIT.
+
+  A new job goes to the host with the lowest fraction of its slots in
+  use; among equally loaded hosts the search starts after the host
+  which was used last.
+*/
+
+
+
+
+
+typedef struct rsh_host_struct {
+  char            * host_name;
+  int               max_running;  /* How many can the host handle. */
+  int               running;      /* How many are currently running on the host (goverened by this driver instance that is). */
+  pthread_mutex_t   host_mutex;   /* Protects running, the connection fields and the fields of the jobs running on this host. */
+
+  bool              persistent;   /* Use the control connection - turned off if the connection fails. */
+  bool              connected;
+  bool              reader_started;
+  pid_t             shell_pid;    /* The local rsh process of the control connection. */
+  int               socket_fd;    /* Connected to stdin and stdout of the rsh process. */
+  int               stop_pipe[2]; /* Writing to stop_pipe[1] stops the reader thread. */
+  pthread_t         reader_thread;
+  hash_type       * jobs;         /* The jobs running through the control connection, indexed by job id. */
+} rsh_host_type;
 
 
 
@@ -43,18 +106,17 @@ struct rsh_job_struct {
   bool         active;       /* Means that it allocated - not really in use */ 
   job_status_type status;        
   pthread_t    run_thread;
-  const char * host_name;    /* Currently not set */
+  const char * host_name;
   char       * run_path;
-};
-
 
+  struct rsh_host_struct * host;   /* The host the job is running on. */
 
-typedef struct {
-  char            * host_name;
-  int               max_running;  /* How many can the host handle. */
-  int               running;      /* How many are currently running on the host (goverened by this driver instance that is). */
-  pthread_mutex_t   host_mutex;
-} rsh_host_type;
+  int          job_id;       /* Unique within the driver; used in the status lines of the control connection. */
+  pid_t        pid;          /* The local rsh process, or the remote pid when running through the control connection. */
+  bool         complete;
+  bool         freed;        /* The job has been freed while the host still holds it; the host frees it on completion. */
+  bool         kill_requested;
+};
 
 
 
@@ -71,6 +133,8 @@ struct rsh_driver_struct {
   int                 last_host_index;
   rsh_host_type     **host_list;
   hash_type          *__host_hash;  /* Stupid redundancy ... */
+  bool                persistent;
+  int                 next_job_id;
 };
 
 
@@ -82,13 +146,60 @@ static UTIL_SAFE_CAST_FUNCTION( rsh_job , RSH_JOB_TYPE_ID )
 
 
 
+rsh_job_type * rsh_job_alloc(const char * run_path) {
+  rsh_job_type * job;
+  job = util_malloc(sizeof * job );
+  job->active     = false;
+  job->status     = JOB_QUEUE_WAITING;
+  job->run_path   = util_alloc_string_copy(run_path);
+  job->host_name  = NULL;
+  job->host       = NULL;
+  job->job_id     = 0;
+  job->pid        = 0;
+  job->complete   = false;
+  job->freed      = false;
+  job->kill_requested = false;
+  UTIL_TYPE_ID_INIT( job , RSH_JOB_TYPE_ID );
+  return job;
+}
+
+
+
+static void rsh_job_free__(rsh_job_type * job) {
+  free(job->run_path);
+  free(job);
+}
+
+
+/*
+  The job is owned by its host until it has completed; freeing a job
+  which is still running only marks it, and it is freed by the host
+  when it completes.
+*/
+
+void rsh_job_free(rsh_job_type * job) {
+  bool host_owned = false;
+
+  if (job->host) {
+    pthread_mutex_lock( &job->host->host_mutex );
+    host_owned = !job->complete;
+    if (host_owned)
+      job->freed = true;
+    pthread_mutex_unlock( &job->host->host_mutex );
+  }
+
+  if (!host_owned)
+    rsh_job_free__( job );
+}
+
+
 /**
    If the host is for some reason not available, NULL should be
    returned. Will also return NULL if some funny guy tries to allocate
    with max_running <= 0.  
 */
 
-static rsh_host_type * rsh_host_alloc(const char * host_name , int max_running) {
+static rsh_host_type * rsh_host_alloc(const char * host_name , int max_running , bool persistent) {
   if (max_running > 0) {
     struct addrinfo * result;
     if (getaddrinfo(host_name , NULL , NULL , &result) == 0) {
@@ -98,6 +209,13 @@ static rsh_host_type * rsh_host_alloc(const char * host_name , int max_running)
       host->max_running = max_running;
       host->running     = 0;
       pthread_mutex_init( &host->host_mutex , NULL );
+
+      host->persistent     = persistent;
+      host->connected      = false;
+      host->reader_started = false;
+      host->shell_pid      = 0;
+      host->socket_fd      = -1;
+      host->jobs           = hash_alloc();
       
       freeaddrinfo( result );
       return host;
@@ -110,117 +228,431 @@ static rsh_host_type * rsh_host_alloc(const char * host_name , int max_running)
 }
 
 
+/*****************************************************************/
+/* The control connection. */
 
-static void rsh_host_free(rsh_host_type * rsh_host) {
-  free(rsh_host->host_name);
-  free(rsh_host);
+
+/*
+  Marks the job as complete, and releases the slot on the host. Must
+  be called with the host_mutex held.
+*/
+
+static void rsh_host_complete_job( rsh_host_type * rsh_host , rsh_job_type * job , job_status_type status) {
+  job->status = status;
+  job->complete = true;
+  rsh_host->running--;
+  if (job->freed)
+    rsh_job_free__( job );
 }
 
 
-static bool rsh_host_available(rsh_host_type * rsh_host) {
-  bool available;
+/*
+  Completes all the jobs still registered with the connection; they are
+  reported as JOB_QUEUE_EXIT. Must be called with the host_mutex held.
+*/
 
-  pthread_mutex_lock( &rsh_host->host_mutex );
-  {
-    available = false;
-    if ((rsh_host->max_running - rsh_host->running) > 0) {  // The host has free slots()
-      bool ping_ok = true;
-#ifdef ERT_HAVE_PING
-      ping_ok = util_ping( rsh_host->host_name );
+static void rsh_host_drop_jobs( rsh_host_type * rsh_host ) {
+  hash_iter_type * iter = hash_iter_alloc( rsh_host->jobs );
+  while (!hash_iter_is_complete( iter )) {
+    rsh_job_type * job = hash_iter_get_next_value( iter );
+    rsh_host_complete_job( rsh_host , job , JOB_QUEUE_EXIT );
+  }
+  hash_iter_free( iter );
+  hash_clear( rsh_host->jobs );
+}
+
+
+/*
+  Writes one command line to the remote shell; returns false if the
+  connection has been lost. Must be called with the host_mutex held.
+*/
+
+static bool rsh_host_send( rsh_host_type * rsh_host , const char * line ) {
+  size_t length = strlen( line );
+  size_t offset = 0;
+  int flags = 0;
+#ifdef MSG_NOSIGNAL
+  flags = MSG_NOSIGNAL;
 #endif
-      if (ping_ok) {                // The host answers to ping()
-        available = true;
-        rsh_host->running++;
+
+  while (offset < length) {
+    ssize_t bytes = send( rsh_host->socket_fd , &line[offset] , length - offset , flags );
+    if (bytes < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    offset += bytes;
+  }
+  return true;
+}
+
+
+static void rsh_host_send_kill( rsh_host_type * rsh_host , rsh_job_type * job ) {
+  char * line = util_alloc_sprintf("kill -TERM -%d 2>/dev/null || kill -TERM %d\n" , job->pid , job->pid );
+  rsh_host_send( rsh_host , line );
+  free( line );
+}
+
+
+static void rsh_host_parse_line( rsh_host_type * rsh_host , const char * line ) {
+  char tag[16];
+  int job_id , value;
+
+  if (sscanf( line , "%15s %d %d" , tag , &job_id , &value ) == 3) {
+    char * key = util_alloc_sprintf("%d" , job_id );
+
+    pthread_mutex_lock( &rsh_host->host_mutex );
+    if (hash_has_key( rsh_host->jobs , key )) {
+      rsh_job_type * job = hash_get( rsh_host->jobs , key );
+
+      if (strcmp( tag , "STARTED" ) == 0) {
+        job->pid = value;
+        if (job->kill_requested)
+          rsh_host_send_kill( rsh_host , job );
+      } else if (strcmp( tag , "DONE" ) == 0) {
+        hash_del( rsh_host->jobs , key );
+        rsh_host_complete_job( rsh_host , job , JOB_QUEUE_DONE );
       }
-    } 
+    }
+    pthread_mutex_unlock( &rsh_host->host_mutex );
+    free( key );
   }
+}
+
+
+static void * rsh_host_reader__( void * arg ) {
+  rsh_host_type * rsh_host = arg;
+  char buffer[4096];
+  size_t length = 0;
+  bool stopped = false;
+
+  while (true) {
+    struct pollfd fds[2];
+    fds[0].fd = rsh_host->socket_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = rsh_host->stop_pipe[0];
+    fds[1].events = POLLIN;
+
+    if (poll( fds , 2 , -1 ) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    if (fds[1].revents) {
+      stopped = true;
+      break;
+    }
+
+    {
+      ssize_t bytes = read( rsh_host->socket_fd , &buffer[length] , sizeof buffer - length - 1);
+      if (bytes < 0 && errno == EINTR)
+        continue;
+      if (bytes <= 0)
+        break;
+      length += bytes;
+    }
+
+    {
+      char * line_start = buffer;
+      char * line_end;
+      buffer[length] = '\0';
+      while ((line_end = strchr( line_start , '\n' )) != NULL) {
+        *line_end = '\0';
+        rsh_host_parse_line( rsh_host , line_start );
+        line_start = line_end + 1;
+      }
+      length -= (line_start - buffer);
+      memmove( buffer , line_start , length );
+      if (length == sizeof buffer - 1)
+        length = 0;   /* Overlong line - not from us; discard it. */
+    }
+  }
+
+  pthread_mutex_lock( &rsh_host->host_mutex );
+  if (rsh_host->connected && !stopped) {
+    fprintf(stderr,"** Warning: lost the connection to host:%s - starting one rsh process per job.\n", rsh_host->host_name);
+    rsh_host->persistent = false;
+  }
+  rsh_host->connected = false;
+  rsh_host_drop_jobs( rsh_host );
   pthread_mutex_unlock( &rsh_host->host_mutex );
+  return NULL;
+}
 
-  return available;
+
+static void rsh_set_cloexec( int fd ) {
+  fcntl( fd , F_SETFD , FD_CLOEXEC );
 }
 
 
+/*
+  Starts 'rsh_cmd host sh' with stdin and stdout connected to a
+  socket, and the reader thread for the host. Must be called with the
+  host_mutex held; returns false if the connection could not be
+  started.
+*/
 
+static bool rsh_host_connect( rsh_host_type * rsh_host , const char * rsh_cmd ) {
+  int sockets[2];
+  int spawn_status;
 
+  if (socketpair( AF_UNIX , SOCK_STREAM , 0 , sockets ) != 0)
+    return false;
+  rsh_set_cloexec( sockets[0] );
+  rsh_set_cloexec( sockets[1] );
 
-static void rsh_host_submit_job(rsh_host_type * rsh_host , rsh_job_type * job, const char * rsh_cmd , const char * submit_cmd , int num_cpu , int job_argc , const char ** job_argv) {
-  /* 
-     Observe that this job has already been added to the running jobs
-     in the rsh_host_available function.
-  */
-  int argc           = job_argc + 2;
-  const char ** argv = util_malloc( argc * sizeof * argv );
-  
-  argv[0] = rsh_host->host_name;
-  argv[1] = submit_cmd;
   {
-    int iarg;
-    for (iarg = 0; iarg < job_argc; iarg++)
-      argv[iarg + 2] = job_argv[iarg];
+    posix_spawn_file_actions_t file_actions;
+    char * argv[4];
+
+    argv[0] = (char *) rsh_cmd;
+    argv[1] = rsh_host->host_name;
+    argv[2] = "sh";
+    argv[3] = NULL;
+
+    posix_spawn_file_actions_init( &file_actions );
+    posix_spawn_file_actions_adddup2( &file_actions , sockets[1] , STDIN_FILENO );
+    posix_spawn_file_actions_adddup2( &file_actions , sockets[1] , STDOUT_FILENO );
+    spawn_status = posix_spawnp( &rsh_host->shell_pid , rsh_cmd , &file_actions , NULL , argv , environ );
+    posix_spawn_file_actions_destroy( &file_actions );
   }
-  
-  util_spawn_blocking(rsh_cmd, argc, argv, NULL, NULL);   /* This call is blocking. */
-  job->status = JOB_QUEUE_DONE;
+  close( sockets[1] );
 
-  pthread_mutex_lock( &rsh_host->host_mutex );
-  rsh_host->running--;
-  pthread_mutex_unlock( &rsh_host->host_mutex );  
-  free( argv );
+  if (spawn_status != 0) {
+    fprintf(stderr,"** Warning: failed to start \'%s %s sh\': %s \n", rsh_cmd , rsh_host->host_name , strerror( spawn_status ));
+    close( sockets[0] );
+    return false;
+  }
+
+  if (pipe( rsh_host->stop_pipe ) != 0)
+    util_abort("%s: pipe() failed: %s \n",__func__ , strerror( errno ));
+  rsh_set_cloexec( rsh_host->stop_pipe[0] );
+  rsh_set_cloexec( rsh_host->stop_pipe[1] );
+
+  rsh_host->socket_fd = sockets[0];
+  rsh_host->connected = true;
+
+  /*
+    The jobs are started with $ert_setsid in front; it is empty if the
+    remote host does not have setsid. A failed write here shows up as
+    a lost connection in the reader thread.
+  */
+  rsh_host_send( rsh_host , "ert_setsid=$(command -v setsid)\n" );
+
+  if (pthread_create( &rsh_host->reader_thread , NULL , rsh_host_reader__ , rsh_host ) != 0)
+    util_abort("%s: failed to create reader thread - aborting \n",__func__);
+  rsh_host->reader_started = true;
+  return true;
 }
 
 
 /*
-  static const char * rsh_host_get_hostname(const rsh_host_type * host) { return host->host_name; }
+  Stops the reader thread and the rsh process; jobs still running
+  through the connection are reported as JOB_QUEUE_EXIT. Must be
+  called without holding the host_mutex.
 */
 
+static void rsh_host_disconnect( rsh_host_type * rsh_host ) {
+  if (rsh_host->reader_started) {
+    char stop = 1;
+    if (write( rsh_host->stop_pipe[1] , &stop , 1 ) != 1)
+      util_abort("%s: failed to stop the reader thread \n",__func__);
+    pthread_join( rsh_host->reader_thread , NULL );
+
+    close( rsh_host->stop_pipe[0] );
+    close( rsh_host->stop_pipe[1] );
+    close( rsh_host->socket_fd );
+    rsh_host->socket_fd = -1;
+
+    kill( rsh_host->shell_pid , SIGTERM );
+    waitpid( rsh_host->shell_pid , NULL , 0 );
+    rsh_host->reader_started = false;
+  }
+}
 
 
-static void * rsh_host_submit_job__(void * __arg_pack) {
-  arg_pack_type * arg_pack = arg_pack_safe_cast(__arg_pack);
-  char * rsh_cmd           = arg_pack_iget_ptr(arg_pack , 0); 
-  rsh_host_type * rsh_host = arg_pack_iget_ptr(arg_pack , 1);
-  char * submit_cmd        = arg_pack_iget_ptr(arg_pack , 2); 
-  int num_cpu              = arg_pack_iget_int(arg_pack , 3);    
-  int argc                 = arg_pack_iget_int(arg_pack , 4); 
-  const char ** argv       = arg_pack_iget_ptr(arg_pack , 5); 
-  rsh_job_type * job       = arg_pack_iget_ptr(arg_pack , 6);
-  
-  rsh_host_submit_job(rsh_host , job , rsh_cmd , submit_cmd , num_cpu , argc , argv);
-  pthread_exit( NULL );
-  arg_pack_free( arg_pack );
-}
+/*
+  Starts the job through the control connection; returns false if the
+  host does not have a working connection. Must be called with the
+  host_mutex held.
+*/
 
+static bool rsh_host_launch_job( rsh_host_type * rsh_host , rsh_job_type * job , const char * rsh_cmd , const char * submit_cmd , int job_argc , const char ** job_argv) {
+  if (!rsh_host->persistent)
+    return false;
 
+  if (!rsh_host->connected) {
+    if (rsh_host->reader_started || !rsh_host_connect( rsh_host , rsh_cmd )) {
+      rsh_host->persistent = false;
+      return false;
+    }
+  }
 
-  
+  {
+    char * key = util_alloc_sprintf("%d" , job->job_id );
+    bool sent;
 
-/*****************************************************************/
+    {
+      stringlist_type * cmd = stringlist_alloc_new( );
+      stringlist_append_ref( cmd , submit_cmd );
+      for (int iarg = 0; iarg < job_argc; iarg++)
+        stringlist_append_ref( cmd , job_argv[iarg] );
+      {
+        char * cmd_string = stringlist_alloc_joined_string( cmd , " ");
+        char * line = util_alloc_sprintf("{ $ert_setsid %s </dev/null 1>&2 & pid=$!; echo \"STARTED %d $pid\"; wait $pid; echo \"DONE %d $?\"; } &\n",
+                                         cmd_string , job->job_id , job->job_id );
+        sent = rsh_host_send( rsh_host , line );
+        free( line );
+        free( cmd_string );
+      }
+      stringlist_free( cmd );
+    }
 
+    if (sent)
+      hash_insert_ref( rsh_host->jobs , key , job );
+    free( key );
+    return sent;
+  }
+}
 
 /*****************************************************************/
 
 
+static void rsh_host_free(rsh_host_type * rsh_host) {
+  rsh_host_disconnect( rsh_host );
+  hash_free( rsh_host->jobs );
+  pthread_mutex_destroy( &rsh_host->host_mutex );
+  free(rsh_host->host_name);
+  free(rsh_host);
+}
 
 
-rsh_job_type * rsh_job_alloc(const char * run_path) {
-  rsh_job_type * job;
-  job = util_malloc(sizeof * job );
-  job->active     = false;
-  job->status     = JOB_QUEUE_WAITING;
-  job->run_path   = util_alloc_string_copy(run_path);
-  UTIL_TYPE_ID_INIT( job , RSH_JOB_TYPE_ID );
-  return job;
+static bool rsh_host_ping( rsh_host_type * rsh_host ) {
+  bool ping_ok = true;
+#ifdef ERT_HAVE_PING
+  if (!rsh_host->connected)
+    ping_ok = util_ping( rsh_host->host_name );
+#endif
+  return ping_ok;
 }
 
 
+/*
+  The fraction of the slots on the host which are in use; 1.0 or more
+  means the host is full.
+*/
 
-void rsh_job_free(rsh_job_type * job) {
-  free(job->run_path);
-  free(job);
+static double rsh_host_get_load( rsh_host_type * rsh_host ) {
+  double load;
+  pthread_mutex_lock( &rsh_host->host_mutex );
+  load = 1.0 * rsh_host->running / rsh_host->max_running;
+  pthread_mutex_unlock( &rsh_host->host_mutex );
+  return load;
+}
+
+
+/*
+  Reserves one slot on the host; returns false if the host has become
+  full in the meantime.
+*/
+
+static bool rsh_host_reserve( rsh_host_type * rsh_host ) {
+  bool reserved = false;
+  pthread_mutex_lock( &rsh_host->host_mutex );
+  if (rsh_host->running < rsh_host->max_running) {
+    rsh_host->running++;
+    reserved = true;
+  }
+  pthread_mutex_unlock( &rsh_host->host_mutex );
+  return reserved;
 }
 
 
 
+/*
+  Waits for the local rsh process of a job started without the
+  control connection. The process is left as a zombie until the
+  host_mutex is held, and is reaped together with setting the
+  complete flag; rsh_driver_kill_job() checks the flag under the same
+  lock, so it can not signal a process group whose id has been
+  reused.
+*/
+
+typedef struct {
+  rsh_host_type * rsh_host;
+  rsh_job_type  * job;
+} rsh_wait_arg_type;
+
+
+static void * rsh_host_wait_job__(void * __arg) {
+  rsh_wait_arg_type * wait_arg = __arg;
+  rsh_host_type * rsh_host = wait_arg->rsh_host;
+  rsh_job_type * job = wait_arg->job;
+  siginfo_t info;
+  int status;
+
+  free( wait_arg );
+  while (waitid( P_PID , job->pid , &info , WEXITED | WNOWAIT ) != 0) {
+    if (errno != EINTR)
+      break;
+  }
+
+  pthread_mutex_lock( &rsh_host->host_mutex );
+  waitpid( job->pid , &status , 0 );
+  rsh_host_complete_job( rsh_host , job , JOB_QUEUE_DONE );
+  pthread_mutex_unlock( &rsh_host->host_mutex );
+  return NULL;
+}
+
+
+/*
+  Starts 'rsh_cmd host submit_cmd arg1 arg2 ...' as the leader of a
+  new process group, so the job can be killed together with the
+  processes it has started.
+*/
+
+static void rsh_host_spawn_job(rsh_driver_type * driver , rsh_host_type * rsh_host , rsh_job_type * job, const char * submit_cmd , int job_argc , const char ** job_argv) {
+  char ** argv = util_calloc( job_argc + 4 , sizeof * argv );
+  
+  argv[0] = driver->rsh_command;
+  argv[1] = rsh_host->host_name;
+  argv[2] = (char *) submit_cmd;
+  {
+    int iarg;
+    for (iarg = 0; iarg < job_argc; iarg++)
+      argv[iarg + 3] = (char *) job_argv[iarg];
+  }
+  argv[job_argc + 3] = NULL;
+
+  {
+    posix_spawnattr_t spawn_attr;
+    int spawn_status;
+
+    posix_spawnattr_init( &spawn_attr );
+    posix_spawnattr_setflags( &spawn_attr , POSIX_SPAWN_SETPGROUP );
+    posix_spawnattr_setpgroup( &spawn_attr , 0 );
+    spawn_status = posix_spawnp( &job->pid , driver->rsh_command , NULL , &spawn_attr , argv , environ );
+    posix_spawnattr_destroy( &spawn_attr );
+
+    if (spawn_status != 0)
+      util_abort("%s: failed to spawn external command: \'%s\': %s \n", __func__, driver->rsh_command , strerror( spawn_status ));
+  }
+  free( argv );
+
+  {
+    rsh_wait_arg_type * wait_arg = util_malloc( sizeof * wait_arg );
+    wait_arg->rsh_host = rsh_host;
+    wait_arg->job = job;
+    if (pthread_create( &job->run_thread , &driver->thread_attr , rsh_host_wait_job__ , wait_arg ) != 0)
+      util_abort("%s: failed to create thread \n", __func__ );
+  }
+}
+
+
+/*****************************************************************/
+
 
 job_status_type rsh_driver_get_job_status(void * __driver , void * __job) {
   if (__job == NULL) 
@@ -232,14 +664,20 @@ job_status_type rsh_driver_get_job_status(void * __driver , void * __job) {
       if (job->active == false) {
         util_abort("%s: internal error - should not query status on inactive jobs \n" , __func__);
         return JOB_QUEUE_NOT_ACTIVE;   /* Dummy to shut up compiler */
-      } else 
-        return job->status;
+      } else {
+        rsh_host_type * rsh_host = job->host;
+        job_status_type status;
+
+        pthread_mutex_lock( &rsh_host->host_mutex );
+        status = job->status;
+        pthread_mutex_unlock( &rsh_host->host_mutex );
+        return status;
+      }
     }
   }
 }
 
 
-
 void rsh_driver_free_job( void * __job ) {
   rsh_job_type    * job    = rsh_job_safe_cast( __job );
   rsh_job_free(job);
@@ -249,9 +687,22 @@ void rsh_driver_free_job( void * __job ) {
 
 void rsh_driver_kill_job(void * __driver ,void  * __job) {
   rsh_job_type    * job    = rsh_job_safe_cast( __job );
-  if (job->active)
-    pthread_cancel( job->run_thread );
-  rsh_job_free( job );
+  rsh_host_type   * rsh_host = job->host;
+
+  pthread_mutex_lock( &rsh_host->host_mutex );
+  if (!job->complete) {
+    char * key = util_alloc_sprintf("%d" , job->job_id );
+    if (hash_has_key( rsh_host->jobs , key )) {
+      /* Running through the control connection. */
+      if (job->pid > 0)
+        rsh_host_send_kill( rsh_host , job );
+      else
+        job->kill_requested = true;
+    } else
+      kill( -job->pid , SIGTERM );
+    free( key );
+  }
+  pthread_mutex_unlock( &rsh_host->host_mutex );
 }
 
 
@@ -267,50 +718,63 @@ void * rsh_driver_submit_job(void  * __driver,
   rsh_driver_type * driver = rsh_driver_safe_cast( __driver );
   rsh_job_type  * job      = NULL; 
   {
-    /* 
-       command is freed in the start_routine() function
-    */
     pthread_mutex_lock( &driver->submit_lock );
     {
       rsh_host_type * host = NULL;
-      int ihost;
-      int host_index = 0;
+      bool * rejected;
       
       if (driver->num_hosts == 0)
         util_abort("%s: fatal error - no hosts added to the rsh driver.\n",__func__);
       
-      for (ihost = 0; ihost < driver->num_hosts; ihost++) {
-        host_index = (ihost + driver->last_host_index) % driver->num_hosts;
-        if (rsh_host_available(driver->host_list[host_index])) {
-          host = driver->host_list[host_index];
+      /*
+        Select the least loaded host which is not full and answers to
+        ping; a host with a live control connection is not pinged.
+      */
+      rejected = util_calloc( driver->num_hosts , sizeof * rejected );
+      for (int ihost = 0; ihost < driver->num_hosts; ihost++)
+        rejected[ihost] = false;
+
+      while (host == NULL) {
+        int best_index = -1;
+        double best_load = 1.0;
+
+        for (int i = 0; i < driver->num_hosts; i++) {
+          int host_index = (i + driver->last_host_index) % driver->num_hosts;
+          if (!rejected[host_index]) {
+            double load = rsh_host_get_load( driver->host_list[host_index] );
+            if (load < best_load) {
+              best_load = load;
+              best_index = host_index;
+            }
+          }
+        }
+
+        if (best_index < 0)
           break;
-        } 
+
+        if (rsh_host_ping( driver->host_list[best_index] ) && rsh_host_reserve( driver->host_list[best_index] )) {
+          host = driver->host_list[best_index];
+          driver->last_host_index = (best_index + 1) % driver->num_hosts;
+        } else
+          rejected[best_index] = true;
       }
-      driver->last_host_index = (host_index + 1) % driver->num_hosts;
+      free( rejected );
       
       if (host != NULL) {
-        /* A host is available */
-        arg_pack_type * arg_pack = arg_pack_alloc();   /* The arg_pack is freed() in the rsh_host_submit_job__() function.
-                                                          freeing it here is dangerous, because we might free it before the 
-                                                          thread-called function is finished with it. */
-        
         job = rsh_job_alloc(run_path);
-        
-        arg_pack_append_ptr(arg_pack ,  driver->rsh_command);
-        arg_pack_append_ptr(arg_pack ,  host);
-        arg_pack_append_ptr(arg_pack , (char *) submit_cmd);
-        arg_pack_append_int(arg_pack , num_cpu );
-        arg_pack_append_int(arg_pack , argc );
-        arg_pack_append_ptr(arg_pack , argv );
-        arg_pack_append_ptr(arg_pack , job);  
-        
-        {
-          int pthread_return_value = pthread_create( &job->run_thread , &driver->thread_attr , rsh_host_submit_job__ , arg_pack);
-          if (pthread_return_value != 0) 
-            util_abort("%s failed to create thread ERROR:%d  \n", __func__ , pthread_return_value);
-        }
+        job->host_name = host->host_name;
+        job->host = host;
+        job->job_id = driver->next_job_id++;
         job->status = JOB_QUEUE_RUNNING; 
         job->active = true;
+
+        pthread_mutex_lock( &host->host_mutex );
+        {
+          bool launched = rsh_host_launch_job( host , job , driver->rsh_command , submit_cmd , argc , argv );
+          if (!launched)
+            rsh_host_spawn_job( driver , host , job , submit_cmd , argc , argv );
+        }
+        pthread_mutex_unlock( &host->host_mutex );
       }
     }
     pthread_mutex_unlock( &driver->submit_lock );
@@ -385,13 +849,15 @@ void * rsh_driver_alloc( ) {
   rsh_driver->last_host_index = 0;  
   rsh_driver->rsh_command = NULL;
   rsh_driver->__host_hash = hash_alloc();
+  rsh_driver->persistent  = true;
+  rsh_driver->next_job_id = 1;
   return rsh_driver;
 }
 
 
 
 void rsh_driver_add_host(rsh_driver_type * rsh_driver , const char * hostname , int host_max_running) {
-  rsh_host_type * new_host = rsh_host_alloc(hostname , host_max_running);  /* Could in principle update an existing node if the host name is old. */
+  rsh_host_type * new_host = rsh_host_alloc(hostname , host_max_running , rsh_driver->persistent);  /* Could in principle update an existing node if the host name is old. */
   if (new_host != NULL) {
     rsh_driver->num_hosts++;
     rsh_driver->host_list = util_realloc(rsh_driver->host_list , rsh_driver->num_hosts * sizeof * rsh_driver->host_list );
@@ -427,6 +893,28 @@ void rsh_driver_add_host_from_string(rsh_driver_type * rsh_driver , const char *
 
 
 
+/*
+  Applies to the hosts already added as well; a host with an open
+  control connection keeps it for the jobs already running.
+*/
+
+static bool rsh_driver_set_persistent_connection( rsh_driver_type * driver , const char * value ) {
+  bool persistent;
+  if (util_sscanf_bool( value , &persistent )) {
+    driver->persistent = persistent;
+    for (int ihost = 0; ihost < driver->num_hosts; ihost++) {
+      rsh_host_type * rsh_host = driver->host_list[ihost];
+      pthread_mutex_lock( &rsh_host->host_mutex );
+      rsh_host->persistent = persistent;
+      pthread_mutex_unlock( &rsh_host->host_mutex );
+    }
+    return true;
+  } else
+    return false;
+}
+
+
+
 bool rsh_driver_set_option( void * __driver , const char * option_key , const void * value ) {
   rsh_driver_type * driver = rsh_driver_safe_cast( __driver );
   bool has_option = true;
@@ -443,6 +931,8 @@ bool rsh_driver_set_option( void * __driver , const char * option_key , const vo
       rsh_driver_set_host_list( driver , NULL );
     else if (strcmp( RSH_CMD , option_key) == 0)
       driver->rsh_command = util_realloc_string_copy( driver->rsh_command , value );
+    else if (strcmp( RSH_PERSISTENT_CONNECTION , option_key) == 0)
+      has_option = rsh_driver_set_persistent_connection( driver , value );
     else
       has_option = false;
   }
@@ -463,7 +953,9 @@ const void * rsh_driver_get_option( const void * __driver , const char * option_
         hash_insert_int( driver->__host_hash , host->host_name , host->max_running);
       }
       return driver->__host_hash;
-    } else {
+    } else if (strcmp( RSH_PERSISTENT_CONNECTION , option_key) == 0)
+      return driver->persistent ? "1" : "0";
+    else {
       util_abort("%s: get not implemented fro option_id:%s for rsh \n",__func__ , option_key );
       return NULL;
     }
@@ -476,6 +968,7 @@ void rsh_driver_init_option_list(stringlist_type * option_list) {
   stringlist_append_ref(option_list, RSH_HOSTLIST);    
   stringlist_append_ref(option_list, RSH_CMD);    
   stringlist_append_ref(option_list, RSH_CLEAR_HOSTLIST);    
+  stringlist_append_ref(option_list, RSH_PERSISTENT_CONNECTION);
 }
 
 #undef RSH_JOB_ID    
@@ -18,8 +18,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <pthread.h>
 
 #include <ert/util/util.h>
+#include <ert/util/hash.h>
 #include <ert/util/type_macros.h>
 
 #include <ert/job_queue/torque_driver.h>
@@ -44,12 +47,20 @@ struct torque_driver_struct {
   char * cluster_label;
   int    submit_sleep;
   FILE * debug_stream;
+
+  char            * qstat_refresh_interval_char;
+  int               qstat_refresh_interval;
+  time_t            last_qstat_update;
+  hash_type       * my_jobs;        /* The jobs submitted by this driver; other jobs in the qstat output are ignored. */
+  hash_type       * qstat_cache;    /* The status of all the jobs in my_jobs from the last qstat call. */
+  pthread_mutex_t   qstat_mutex;    /* Protects the my_jobs, qstat_cache and last_qstat_update fields. */
 };
 
 struct torque_job_struct {
   UTIL_TYPE_ID_DECLARATION;
   long int torque_jobnr;
   char * torque_jobnr_char;
+  torque_driver_type * driver;      /* Set when the job is registered in my_jobs of the driver. */
 };
 
 UTIL_SAFE_CAST_FUNCTION(torque_driver, TORQUE_DRIVER_TYPE_ID);
@@ -73,6 +84,11 @@ void * torque_driver_alloc() {
   torque_driver->cluster_label = NULL;
   torque_driver->job_prefix = NULL;
   torque_driver->debug_stream = NULL;
+  torque_driver->qstat_refresh_interval_char = NULL;
+  torque_driver->last_qstat_update = 0;
+  torque_driver->my_jobs = hash_alloc();
+  torque_driver->qstat_cache = hash_alloc();
+  pthread_mutex_init( &torque_driver->qstat_mutex , NULL );
 
   torque_driver_set_option(torque_driver, TORQUE_QSUB_CMD, TORQUE_DEFAULT_QSUB_CMD);
   torque_driver_set_option(torque_driver, TORQUE_QSTAT_CMD, TORQUE_DEFAULT_QSTAT_CMD);
@@ -80,6 +96,7 @@ void * torque_driver_alloc() {
   torque_driver_set_option(torque_driver, TORQUE_NUM_CPUS_PER_NODE, "1");
   torque_driver_set_option(torque_driver, TORQUE_NUM_NODES, "1");
   torque_driver_set_option(torque_driver, TORQUE_SUBMIT_SLEEP, TORQUE_DEFAULT_SUBMIT_SLEEP);
+  torque_driver_set_option(torque_driver, TORQUE_QSTAT_REFRESH_INTERVAL, TORQUE_DEFAULT_QSTAT_REFRESH_INTERVAL);
 
   return torque_driver;
 }
@@ -99,8 +116,18 @@ static void torque_driver_set_qsub_cmd(torque_driver_type * driver, const char *
   driver->qsub_cmd = util_realloc_string_copy(driver->qsub_cmd, qsub_cmd);
 }
 
+/*
+  The cached status values were produced by the previous qstat
+  command, they are therefor discarded when the command is changed.
+*/
+
 static void torque_driver_set_qstat_cmd(torque_driver_type * driver, const char * qstat_cmd) {
   driver->qstat_cmd = util_realloc_string_copy(driver->qstat_cmd, qstat_cmd);
+
+  pthread_mutex_lock( &driver->qstat_mutex );
+  hash_clear( driver->qstat_cache );
+  driver->last_qstat_update = 0;
+  pthread_mutex_unlock( &driver->qstat_mutex );
 }
 
 static void torque_driver_set_qdel_cmd(torque_driver_type * driver, const char * qdel_cmd) {
@@ -121,6 +148,21 @@ static bool torque_driver_set_submit_sleep(torque_driver_type * driver, const ch
 }
 
 
+void torque_driver_set_qstat_refresh_interval(torque_driver_type * driver, int refresh_interval) {
+  driver->qstat_refresh_interval = refresh_interval;
+  util_safe_free( driver->qstat_refresh_interval_char );
+  driver->qstat_refresh_interval_char = util_alloc_sprintf("%d", refresh_interval);
+}
+
+static bool torque_driver_set_qstat_refresh_interval_option(torque_driver_type * driver, const char * refresh_interval_char) {
+  int refresh_interval;
+  if (util_sscanf_int(refresh_interval_char, &refresh_interval) && (refresh_interval >= 0)) {
+    torque_driver_set_qstat_refresh_interval(driver, refresh_interval);
+    return true;
+  } else
+    return false;
+}
+
 static bool torque_driver_set_num_nodes(torque_driver_type * driver, const char* num_nodes_char) {
   int num_nodes = 0;
   if (util_sscanf_int(num_nodes_char, &num_nodes)) {
@@ -188,6 +230,8 @@ bool torque_driver_set_option(void * __driver, const char * option_key, const vo
       torque_driver_set_debug_output(driver, value);
     else if (strcmp(TORQUE_SUBMIT_SLEEP, option_key) == 0)
       option_set = torque_driver_set_submit_sleep(driver, value);
+    else if (strcmp(TORQUE_QSTAT_REFRESH_INTERVAL, option_key) == 0)
+      option_set = torque_driver_set_qstat_refresh_interval_option(driver, value);
     else
       option_set = false;
   }
@@ -215,6 +259,8 @@ const void * torque_driver_get_option(const void * __driver, const char * option
       return driver->cluster_label;
     else if(strcmp(TORQUE_JOB_PREFIX_KEY, option_key) == 0)
       return driver->job_prefix;
+    else if (strcmp(TORQUE_QSTAT_REFRESH_INTERVAL, option_key) == 0)
+      return driver->qstat_refresh_interval_char;
     else {
       util_abort("%s: option_id:%s not recognized for TORQUE driver \n", __func__, option_key);
       return NULL;
@@ -232,6 +278,7 @@ void torque_driver_init_option_list(stringlist_type * option_list) {
   stringlist_append_ref(option_list, TORQUE_KEEP_QSUB_OUTPUT);
   stringlist_append_ref(option_list, TORQUE_CLUSTER_LABEL);
   stringlist_append_ref(option_list, TORQUE_JOB_PREFIX_KEY);
+  stringlist_append_ref(option_list, TORQUE_QSTAT_REFRESH_INTERVAL);
 }
 
 torque_job_type * torque_job_alloc() {
@@ -239,6 +286,7 @@ torque_job_type * torque_job_alloc() {
   job = util_malloc(sizeof * job);
   job->torque_jobnr_char = NULL;
   job->torque_jobnr = 0;
+  job->driver = NULL;
   UTIL_TYPE_ID_INIT(job, TORQUE_JOB_TYPE_ID);
 
   return job;
@@ -398,7 +446,24 @@ static int torque_driver_submit_shell_job(torque_driver_type * driver,
   }
 }
 
+/*
+  Removes the job from the my_jobs and qstat_cache tables of the
+  driver; the job will not be picked up from the qstat output again.
+*/
+
+static void torque_driver_forget_job(torque_driver_type * driver, torque_job_type * job) {
+  pthread_mutex_lock( &driver->qstat_mutex );
+  if (hash_has_key( driver->my_jobs , job->torque_jobnr_char ))
+    hash_del( driver->my_jobs , job->torque_jobnr_char );
+
+  if (hash_has_key( driver->qstat_cache , job->torque_jobnr_char ))
+    hash_del( driver->qstat_cache , job->torque_jobnr_char );
+  pthread_mutex_unlock( &driver->qstat_mutex );
+}
+
 void torque_job_free(torque_job_type * job) {
+  if (job->driver)
+    torque_driver_forget_job(job->driver, job);
 
   util_safe_free(job->torque_jobnr_char);
   free(job);
@@ -435,6 +500,15 @@ void * torque_driver_submit_job(void * __driver,
     free(local_job_name);
   }
 
+  if (job->torque_jobnr > 0) {
+    pthread_mutex_lock( &driver->qstat_mutex );
+    hash_insert_ref( driver->my_jobs , job->torque_jobnr_char , NULL );
+    job->driver = driver;
+    if (hash_has_key( driver->qstat_cache , job->torque_jobnr_char ))
+      hash_del( driver->qstat_cache , job->torque_jobnr_char );
+    pthread_mutex_unlock( &driver->qstat_mutex );
+  }
+
   if (job->torque_jobnr > 0)
     return job;
   else {
@@ -480,8 +554,54 @@ static job_status_type torque_driver_get_qstat_status(torque_driver_type * drive
   return status;
 }
 
+
+/*
+  Parses one job line from the output of qstat:
+
+     Job id                    Name             User            Time Use S Queue
+     ------------------------- ---------------- --------------- -------- - -----
+     1612427.st-lcmm           ...130getupdates fama            00:00:01 R normal
+
+  The return value is the job number without the server part, or NULL
+  if the line can not be parsed. The status is JOB_QUEUE_STATUS_FAILURE
+  if the status letter is not recognized.
+*/
+
+static char * torque_driver_alloc_parse_status_line(const char * line, job_status_type * status) {
+  char job_id_full_string[32];
+  char string_status[2];
+
+  *status = JOB_QUEUE_STATUS_FAILURE;
+  if (sscanf(line, "%31s %*s %*s %*s %1s %*s", job_id_full_string, string_status) == 2) {
+    const char * dotPtr = strchr(job_id_full_string, '.');
+    int dotPosition = dotPtr ? dotPtr - job_id_full_string : strlen(job_id_full_string);
+
+    switch( string_status[0] ) {
+    case 'R':
+      *status = JOB_QUEUE_RUNNING;
+      break;
+
+    case 'E':
+      *status = JOB_QUEUE_DONE;
+      break;
+
+    case 'C':
+      *status = JOB_QUEUE_DONE;
+      break;
+
+    case 'Q':
+      *status = JOB_QUEUE_PENDING;
+      break;
+    }
+
+    return util_alloc_substring_copy(job_id_full_string, 0, dotPosition);
+  } else
+    return NULL;
+}
+
+
 job_status_type torque_driver_parse_status(const char * qstat_file, const char * jobnr_char) {
-  int status = JOB_QUEUE_STATUS_FAILURE;
+  job_status_type status = JOB_QUEUE_STATUS_FAILURE;
 
   if (util_file_exists(qstat_file)) {
     char * line = NULL;
@@ -494,54 +614,99 @@ job_status_type torque_driver_parse_status(const char * qstat_file, const char *
     }
 
     if (line) {
-      char job_id_full_string[32];
-      char   string_status[2];
+      job_status_type line_status;
+      char * job_id_as_char_ptr = torque_driver_alloc_parse_status_line(line, &line_status);
 
-      if (sscanf(line, "%s %*s %*s %*s %s %*s", job_id_full_string, string_status) == 2) {
-        const char *dotPtr = strchr(job_id_full_string, '.');
-        int dotPosition = dotPtr - job_id_full_string;
-
-        {
-          char* job_id_as_char_ptr = util_alloc_substring_copy(job_id_full_string, 0, dotPosition);
-          if (util_string_equal(job_id_as_char_ptr, jobnr_char)) {
+      if (job_id_as_char_ptr) {
+        if (util_string_equal(job_id_as_char_ptr, jobnr_char))
+          status = line_status;
+        free(job_id_as_char_ptr);
+      }
+      free(line);
+    }
+  }
+  if (status == JOB_QUEUE_STATUS_FAILURE)
+    fprintf(stderr,"** Warning: failed to get job status for job:%s from file:%s\n",jobnr_char , qstat_file );
 
-            switch( string_status[0] ) {
-            case 'R':
-              status = JOB_QUEUE_RUNNING;
-              break;
+  return status;
+}
 
-            case 'E':
-              status = JOB_QUEUE_DONE;
-              break;
 
-            case 'C':
-              status = JOB_QUEUE_DONE;
-              break;
+/*
+  Calls qstat once without a job argument, and stores the status of
+  all the jobs submitted by this driver in the qstat_cache table. Must
+  be called with the qstat_mutex held.
+*/
 
-            case 'Q':
-              status = JOB_QUEUE_PENDING;
-              break;
-            }
+static void torque_driver_update_qstat_cache(torque_driver_type * driver) {
+  char * tmp_file = util_alloc_tmp_file("/tmp", "enkf-qstat", true);
 
-            free(job_id_as_char_ptr);
-          }
+  util_spawn_blocking(driver->qstat_cmd, 0, NULL, tmp_file, NULL);
+  hash_clear(driver->qstat_cache);
+  if (util_file_exists( tmp_file )) {
+    FILE * stream = util_fopen(tmp_file, "r");
+    bool at_eof = false;
+
+    util_fskip_lines(stream, 2);
+    while (!at_eof) {
+      char * line = util_fscanf_alloc_line(stream, &at_eof);
+      if (line) {
+        job_status_type status;
+        char * jobnr_char = torque_driver_alloc_parse_status_line(line, &status);
+
+        if (jobnr_char) {
+          if ((status != JOB_QUEUE_STATUS_FAILURE) && hash_has_key(driver->my_jobs, jobnr_char))
+            hash_insert_int(driver->qstat_cache, jobnr_char, status);
+          free(jobnr_char);
         }
+        free(line);
       }
-      free(line);
     }
+    fclose(stream);
+    unlink(tmp_file);
   }
-  if (status == JOB_QUEUE_STATUS_FAILURE)
-    fprintf(stderr,"** Warning: failed to get job status for job:%s from file:%s\n",jobnr_char , qstat_file );
-
-  return status;
+  free(tmp_file);
+  driver->last_qstat_update = time(NULL);
 }
 
 
+/*
+  The status of all the jobs is fetched with one qstat call, which is
+  repeated when the cached status values are older than the refresh
+  interval. A job which is missing from the cache, e.g. because it was
+  submitted after the last qstat call, triggers a new qstat call - at
+  most once per second. If the job is still missing we fall back to
+  calling qstat for this job alone.
+*/
 
 job_status_type torque_driver_get_job_status(void * __driver, void * __job) {
   torque_driver_type * driver = torque_driver_safe_cast(__driver);
   torque_job_type * job = torque_job_safe_cast(__job);
-  return torque_driver_get_qstat_status(driver, job->torque_jobnr_char);
+  job_status_type status = JOB_QUEUE_STATUS_FAILURE;
+  bool cached;
+
+  pthread_mutex_lock( &driver->qstat_mutex );
+  {
+    double age = difftime(time(NULL), driver->last_qstat_update);
+
+    if ((age > driver->qstat_refresh_interval) || (!hash_has_key(driver->qstat_cache, job->torque_jobnr_char) && (age > 0)))
+      torque_driver_update_qstat_cache(driver);
+
+    cached = hash_has_key(driver->qstat_cache, job->torque_jobnr_char);
+    if (cached)
+      status = hash_get_int(driver->qstat_cache, job->torque_jobnr_char);
+  }
+  pthread_mutex_unlock( &driver->qstat_mutex );
+
+  if (!cached) {
+    status = torque_driver_get_qstat_status(driver, job->torque_jobnr_char);
+    if (status != JOB_QUEUE_STATUS_FAILURE) {
+      pthread_mutex_lock( &driver->qstat_mutex );
+      hash_insert_int(driver->qstat_cache, job->torque_jobnr_char, status);
+      pthread_mutex_unlock( &driver->qstat_mutex );
+    }
+  }
+  return status;
 }
 
 
@@ -550,6 +715,7 @@ void torque_driver_kill_job(void * __driver, void * __job) {
   torque_driver_type * driver = torque_driver_safe_cast(__driver);
   torque_job_type * job = torque_job_safe_cast(__job);
   util_spawn_blocking(driver->qdel_cmd, 1, (const char **) &job->torque_jobnr_char, NULL, NULL);
+  torque_driver_forget_job(driver, job);
 }
 
 void torque_driver_free(torque_driver_type * driver) {
@@ -562,6 +728,10 @@ void torque_driver_free(torque_driver_type * driver) {
   free(driver->num_nodes_char);
   if (driver->job_prefix)
     free(driver->job_prefix);
+  util_safe_free(driver->qstat_refresh_interval_char);
+  hash_free(driver->qstat_cache);
+  hash_free(driver->my_jobs);
+  pthread_mutex_destroy( &driver->qstat_mutex );
 
   free(driver);
 }
@@ -0,0 +1,280 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'job_local_driver_test.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#include <ert/job_queue/local_driver.h>
+
+
+/*
+  Runs many short jobs through the local driver, with the reaper
+  thread and with one thread per job. The completion of the jobs is
+  observed through the event callback, as in the job_queue.
+*/
+
+typedef struct {
+  pthread_mutex_t    lock;
+  pthread_cond_t     cond;
+  local_driver_type * driver;
+  local_job_type   ** jobs;
+  bool              * complete;
+  int                 num_complete;
+} job_set_type;
+
+
+static void job_event( void * arg , int tag ) {
+  job_set_type * job_set = arg;
+
+  pthread_mutex_lock( &job_set->lock );
+  if (!job_set->complete[tag] && local_driver_get_job_status( job_set->driver , job_set->jobs[tag] ) == JOB_QUEUE_DONE) {
+    job_set->complete[tag] = true;
+    job_set->num_complete++;
+    pthread_cond_signal( &job_set->cond );
+  }
+  pthread_mutex_unlock( &job_set->lock );
+}
+
+
+static int count_threads( ) {
+  int num_threads = -1;
+  FILE * stream = util_fopen( "/proc/self/status" , "r");
+  char line[256];
+
+  while (fgets( line , sizeof line , stream )) {
+    if (sscanf( line , "Threads: %d" , &num_threads ) == 1)
+      break;
+  }
+  fclose( stream );
+  return num_threads;
+}
+
+
+static void wait_for_jobs( job_set_type * job_set , int num_jobs ) {
+  struct timespec deadline;
+  clock_gettime( CLOCK_REALTIME , &deadline );
+  deadline.tv_sec += 60;
+
+  pthread_mutex_lock( &job_set->lock );
+  while (job_set->num_complete < num_jobs) {
+    if (pthread_cond_timedwait( &job_set->cond , &job_set->lock , &deadline ) != 0)
+      test_error_exit("Only %d of %d jobs completed\n", job_set->num_complete , num_jobs );
+  }
+  pthread_mutex_unlock( &job_set->lock );
+}
+
+
+void test_run_jobs( bool use_reaper , int num_jobs ) {
+  local_driver_type * driver = local_driver_alloc();
+  job_set_type job_set;
+  const char * argv[2] = { "-c" , "sleep 0.5" };
+  int threads_before = count_threads();
+  int threads_running;
+
+  pthread_mutex_init( &job_set.lock , NULL );
+  pthread_cond_init( &job_set.cond , NULL );
+  job_set.driver = driver;
+  job_set.jobs = util_calloc( num_jobs , sizeof * job_set.jobs );
+  job_set.complete = util_calloc( num_jobs , sizeof * job_set.complete );
+  job_set.num_complete = 0;
+
+  local_driver_set_reaper( driver , use_reaper );
+  for (int i = 0; i < num_jobs; i++) {
+    job_set.complete[i] = false;
+    job_set.jobs[i] = local_driver_submit_job( driver , "/bin/sh" , 1 , "." , "JOB" , 2 , argv );
+    local_driver_set_job_event( driver , job_set.jobs[i] , job_event , &job_set , i );
+  }
+
+  threads_running = count_threads();
+  printf("%-8s jobs:%4d  threads: %d -> %d\n", local_driver_has_reaper( driver ) ? "reaper" : "threads" , num_jobs , threads_before , threads_running);
+  if (local_driver_has_reaper( driver ))
+    test_assert_true( threads_running <= threads_before + 1 );
+  else
+    test_assert_false( use_reaper );
+
+  wait_for_jobs( &job_set , num_jobs );
+  for (int i = 0; i < num_jobs; i++) {
+    test_assert_int_equal( local_driver_get_job_status( driver , job_set.jobs[i] ) , JOB_QUEUE_DONE );
+    test_assert_true( local_job_get_max_rss( job_set.jobs[i] ) > 0 );
+    test_assert_true( local_job_get_cpu_time( job_set.jobs[i] ) >= 0 );
+    local_driver_free_job( job_set.jobs[i] );
+  }
+
+  free( job_set.jobs );
+  free( job_set.complete );
+  pthread_cond_destroy( &job_set.cond );
+  pthread_mutex_destroy( &job_set.lock );
+  local_driver_free__( driver );
+}
+
+
+/*
+  A killed job is reported as DONE when the child has exited, and a
+  job which is freed while running is cleaned up by the reaper or the
+  wait thread.
+*/
+
+void test_kill_and_free( bool use_reaper ) {
+  local_driver_type * driver = local_driver_alloc();
+  job_set_type job_set;
+  local_job_type * jobs[2];
+  bool complete[2] = { false , false };
+  const char * argv[1] = { "100" };
+
+  pthread_mutex_init( &job_set.lock , NULL );
+  pthread_cond_init( &job_set.cond , NULL );
+  job_set.driver = driver;
+  job_set.jobs = jobs;
+  job_set.complete = complete;
+  job_set.num_complete = 0;
+
+  local_driver_set_reaper( driver , use_reaper );
+  jobs[0] = local_driver_submit_job( driver , "/bin/sleep" , 1 , "." , "JOB" , 1 , argv );
+  local_driver_set_job_event( driver , jobs[0] , job_event , &job_set , 0 );
+  test_assert_int_equal( local_driver_get_job_status( driver , jobs[0] ) , JOB_QUEUE_RUNNING );
+  local_driver_kill_job( driver , jobs[0] );
+  wait_for_jobs( &job_set , 1 );
+  test_assert_int_equal( local_driver_get_job_status( driver , jobs[0] ) , JOB_QUEUE_DONE );
+  local_driver_free_job( jobs[0] );
+
+  {
+    const char * short_argv[1] = { "0.1" };
+    jobs[1] = local_driver_submit_job( driver , "/bin/sleep" , 1 , "." , "JOB" , 1 , short_argv );
+    local_driver_free_job( jobs[1] );
+    util_usleep( 300000 );
+  }
+
+  pthread_cond_destroy( &job_set.cond );
+  pthread_mutex_destroy( &job_set.lock );
+  local_driver_free__( driver );
+}
+
+
+/*
+  The driver is freed while jobs are still running; they complete
+  after the driver is gone, and a job which has already been freed by
+  the queue is freed when its child exits.
+*/
+
+void test_free_driver( bool use_reaper ) {
+  local_driver_type * driver = local_driver_alloc();
+  job_set_type job_set;
+  local_job_type * jobs[2];
+  bool complete[2] = { false , false };
+  const char * argv[1] = { "0.2" };
+
+  pthread_mutex_init( &job_set.lock , NULL );
+  pthread_cond_init( &job_set.cond , NULL );
+  job_set.driver = driver;
+  job_set.jobs = jobs;
+  job_set.complete = complete;
+  job_set.num_complete = 0;
+
+  local_driver_set_reaper( driver , use_reaper );
+  for (int i = 0; i < 2; i++) {
+    jobs[i] = local_driver_submit_job( driver , "/bin/sleep" , 1 , "." , "JOB" , 1 , argv );
+    local_driver_set_job_event( driver , jobs[i] , job_event , &job_set , i );
+  }
+  local_driver_free_job( jobs[1] );
+  local_driver_free__( driver );
+
+  wait_for_jobs( &job_set , 1 );
+  test_assert_true( complete[0] );
+  test_assert_true( local_job_get_max_rss( jobs[0] ) > 0 );
+  local_driver_free_job( jobs[0] );
+  util_usleep( 100000 );
+
+  pthread_cond_destroy( &job_set.cond );
+  pthread_mutex_destroy( &job_set.lock );
+}
+
+
+/*
+  The job is freed while the event callback is running; freeing the
+  job must wait for the callback to return.
+*/
+
+typedef struct {
+  pthread_mutex_t     lock;
+  pthread_cond_t      cond;
+  local_driver_type * driver;
+  local_job_type    * job;
+  bool                started;
+  bool                returned;
+} slow_event_type;
+
+
+static void slow_job_event( void * arg , int tag ) {
+  slow_event_type * slow_event = arg;
+  if (local_driver_get_job_status( slow_event->driver , slow_event->job ) == JOB_QUEUE_DONE) {
+    pthread_mutex_lock( &slow_event->lock );
+    slow_event->started = true;
+    pthread_cond_signal( &slow_event->cond );
+    pthread_mutex_unlock( &slow_event->lock );
+
+    util_usleep( 200000 );
+    slow_event->returned = true;
+  }
+}
+
+
+void test_free_during_callback( bool use_reaper ) {
+  local_driver_type * driver = local_driver_alloc();
+  slow_event_type slow_event;
+  const char * argv[1] = { "0.1" };
+
+  pthread_mutex_init( &slow_event.lock , NULL );
+  pthread_cond_init( &slow_event.cond , NULL );
+  slow_event.started = false;
+  slow_event.returned = false;
+  slow_event.driver = driver;
+
+  local_driver_set_reaper( driver , use_reaper );
+  slow_event.job = local_driver_submit_job( driver , "/bin/sleep" , 1 , "." , "JOB" , 1 , argv );
+  local_driver_set_job_event( driver , slow_event.job , slow_job_event , &slow_event , 0 );
+
+  pthread_mutex_lock( &slow_event.lock );
+  while (!slow_event.started)
+    pthread_cond_wait( &slow_event.cond , &slow_event.lock );
+  pthread_mutex_unlock( &slow_event.lock );
+
+  local_driver_free_job( slow_event.job );
+  test_assert_true( slow_event.returned );
+
+  pthread_cond_destroy( &slow_event.cond );
+  pthread_mutex_destroy( &slow_event.lock );
+  local_driver_free__( driver );
+}
+
+
+int main(int argc , char ** argv) {
+  test_run_jobs( true , 256 );
+  test_run_jobs( false , 64 );
+  test_kill_and_free( true );
+  test_kill_and_free( false );
+  test_free_driver( true );
+  test_free_driver( false );
+  test_free_during_callback( true );
+  test_free_during_callback( false );
+  exit(0);
+}
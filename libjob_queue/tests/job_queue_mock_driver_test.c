@@ -0,0 +1,323 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'job_queue_mock_driver_test.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/vector.h>
+
+#include <ert/job_queue/job_queue.h>
+#include <ert/job_queue/queue_driver.h>
+
+
+/*
+  Benchmark of the job_queue main loop with a mock driver. The jobs
+  of the mock driver do not run anything; a simulator thread just
+  changes the status of each job to DONE a fixed time after it was
+  submitted. The same jobs are run through a driver with events and a
+  driver which must be polled, and the number of status calls, the
+  throughput and the latency from the job completing to the DONE
+  callback is reported. Finally a slow submit function is used to
+  time the submit pool and the submit rate limit.
+*/
+
+typedef struct {
+  double finish_time;
+  double callback_time;
+} record_type;
+
+
+typedef struct {
+  int               index;
+  job_status_type   status;
+  double            finish_time;
+  job_event_ftype * event_callback;
+  void            * event_arg;
+  int               event_tag;
+} mock_job_type;
+
+
+typedef struct {
+  pthread_mutex_t   lock;
+  pthread_cond_t    cond;
+  pthread_t         thread;
+  vector_type     * running;        /* The submitted jobs in order of completion. */
+  int               next_running;
+  bool              stop;
+  double            run_time;
+  int               submit_usleep;  /* Simulating the time spent by e.g. bsub. */
+  long              status_calls;
+  record_type     * records;
+} mock_driver_type;
+
+
+static double wall_time( ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+
+static void * mock_simulator( void * arg ) {
+  mock_driver_type * driver = arg;
+
+  pthread_mutex_lock( &driver->lock );
+  while (true) {
+    if (driver->next_running == vector_get_size( driver->running )) {
+      if (driver->stop)
+        break;
+      pthread_cond_wait( &driver->cond , &driver->lock );
+    } else {
+      mock_job_type * job = vector_iget( driver->running , driver->next_running );
+      double now = wall_time();
+
+      if (now < job->finish_time) {
+        pthread_mutex_unlock( &driver->lock );
+        util_usleep( (unsigned long) (1e6 * (job->finish_time - now)) );
+        pthread_mutex_lock( &driver->lock );
+      } else {
+        job_event_ftype * event_callback = job->event_callback;
+        void * event_arg = job->event_arg;
+        int event_tag = job->event_tag;
+
+        driver->next_running++;
+        driver->records[ job->index ].finish_time = now;
+        job->status = JOB_QUEUE_DONE;
+        pthread_mutex_unlock( &driver->lock );
+
+        if (event_callback)
+          event_callback( event_arg , event_tag );
+        pthread_mutex_lock( &driver->lock );
+      }
+    }
+  }
+  pthread_mutex_unlock( &driver->lock );
+  return NULL;
+}
+
+
+static void * mock_submit( void * data , const char * cmd , int num_cpu , const char * run_path , const char * job_name , int argc , const char ** argv) {
+  mock_driver_type * driver = data;
+  mock_job_type * job = util_malloc( sizeof * job );
+
+  if (driver->submit_usleep > 0)
+    util_usleep( driver->submit_usleep );
+
+  util_sscanf_int( argv[0] , &job->index );
+  job->event_callback = NULL;
+  job->event_arg = NULL;
+  job->event_tag = -1;
+  job->status = JOB_QUEUE_RUNNING;
+  job->finish_time = wall_time() + driver->run_time;
+
+  pthread_mutex_lock( &driver->lock );
+  vector_append_ref( driver->running , job );
+  pthread_cond_signal( &driver->cond );
+  pthread_mutex_unlock( &driver->lock );
+  return job;
+}
+
+
+static job_status_type mock_get_status( void * data , void * job_data ) {
+  mock_driver_type * driver = data;
+  mock_job_type * job = job_data;
+  job_status_type status;
+
+  pthread_mutex_lock( &driver->lock );
+  driver->status_calls++;
+  status = job->status;
+  pthread_mutex_unlock( &driver->lock );
+  return status;
+}
+
+
+static void mock_set_job_event( void * data , void * job_data , job_event_ftype * callback , void * arg , int tag) {
+  mock_driver_type * driver = data;
+  mock_job_type * job = job_data;
+
+  pthread_mutex_lock( &driver->lock );
+  job->event_callback = callback;
+  job->event_arg = arg;
+  job->event_tag = tag;
+  pthread_mutex_unlock( &driver->lock );
+  callback( arg , tag );
+}
+
+
+static void mock_kill_job( void * data , void * job_data ) {
+}
+
+
+/*
+  The jobs are owned by the running vector of the driver, since the
+  simulator might still hold on to a job which the queue has freed.
+*/
+
+static void mock_free_job( void * job_data ) {
+}
+
+
+static void mock_free_driver( void * data ) {
+  mock_driver_type * driver = data;
+
+  pthread_mutex_lock( &driver->lock );
+  driver->stop = true;
+  pthread_cond_signal( &driver->cond );
+  pthread_mutex_unlock( &driver->lock );
+  pthread_join( driver->thread , NULL );
+
+  for (int i = 0; i < vector_get_size( driver->running ); i++)
+    free( vector_iget( driver->running , i ));
+  vector_free( driver->running );
+  pthread_cond_destroy( &driver->cond );
+  pthread_mutex_destroy( &driver->lock );
+  free( driver );
+}
+
+
+static queue_driver_type * mock_driver_alloc( bool events , double run_time , int submit_usleep , record_type * records , mock_driver_type ** mock) {
+  mock_driver_type * driver = util_malloc( sizeof * driver );
+  pthread_mutex_init( &driver->lock , NULL );
+  pthread_cond_init( &driver->cond , NULL );
+  driver->running = vector_alloc_new();
+  driver->next_running = 0;
+  driver->stop = false;
+  driver->run_time = run_time;
+  driver->submit_usleep = submit_usleep;
+  driver->status_calls = 0;
+  driver->records = records;
+  pthread_create( &driver->thread , NULL , mock_simulator , driver );
+
+  *mock = driver;
+  return queue_driver_alloc_custom( "MOCK" , driver ,
+                                    mock_submit ,
+                                    mock_get_status ,
+                                    mock_kill_job ,
+                                    mock_free_job ,
+                                    mock_free_driver ,
+                                    events ? mock_set_job_event : NULL );
+}
+
+
+static bool done_callback( void * arg ) {
+  record_type * record = arg;
+  record->callback_time = wall_time();
+  return true;
+}
+
+
+/*
+  Runs @num_jobs jobs through the queue, and returns the mean latency
+  from a job completing in the driver to the DONE callback. The wall
+  time of the run is returned in @elapsed.
+*/
+
+static double run_queue( int num_jobs , bool events , int max_running , int submit_usleep , int submit_threads , double max_submit_rate , double * elapsed_time) {
+  record_type * records = util_calloc( num_jobs , sizeof * records );
+  mock_driver_type * mock;
+  queue_driver_type * driver = mock_driver_alloc( events , 0.10 , submit_usleep , records , &mock );
+  job_queue_type * queue = job_queue_alloc( 1 , NULL , NULL , NULL );
+  double latency = 0;
+  double start_time;
+
+  job_queue_set_driver( queue , driver );
+  job_queue_set_submit_threads( queue , submit_threads );
+  job_queue_set_max_submit_rate( queue , max_submit_rate );
+  {
+    char * max_running_string = util_alloc_sprintf( "%d" , max_running );
+    queue_driver_set_option( driver , MAX_RUNNING , max_running_string );
+    free( max_running_string );
+  }
+
+  for (int i = 0; i < num_jobs; i++) {
+    char * index = util_alloc_sprintf( "%d" , i );
+    job_queue_add_job( queue , "mock" , done_callback , NULL , NULL , &records[i] , 1 , "." , "MOCK" , 1 , (const char **) &index );
+    free( index );
+  }
+
+  start_time = wall_time();
+  job_queue_run_jobs( queue , num_jobs , false );
+  {
+    double elapsed = wall_time() - start_time;
+
+    test_assert_int_equal( job_queue_get_num_complete( queue ) , num_jobs );
+    for (int i = 0; i < num_jobs; i++) {
+      test_assert_true( records[i].callback_time >= records[i].finish_time );
+      latency += records[i].callback_time - records[i].finish_time;
+    }
+    latency /= num_jobs;
+
+    printf("%-8s jobs:%6d  max_running:%5d  time:%8.3f s  jobs/s:%9.1f  status calls/job:%7.2f  mean latency:%7.2f ms  submit threads:%3d  mean submit:%7.2f ms\n",
+           events ? "events" : "polling" , num_jobs , max_running , elapsed , num_jobs / elapsed ,
+           1.0 * mock->status_calls / num_jobs , 1000 * latency , submit_threads , 1000 * job_queue_get_mean_submit_time( queue ));
+
+    if (events)
+      test_assert_true( mock->status_calls < 10L * num_jobs );
+
+    test_assert_int_equal( job_queue_get_submit_count( queue ) , num_jobs );
+    test_assert_true( job_queue_get_max_submit_time( queue ) >= job_queue_get_mean_submit_time( queue ));
+    test_assert_true( job_queue_get_mean_submit_time( queue ) >= 1e-6 * submit_usleep );
+    *elapsed_time = elapsed;
+  }
+
+  job_queue_free( queue );
+  queue_driver_free( driver );
+  free( records );
+  return latency;
+}
+
+
+int main(int argc , char ** argv) {
+  int num_jobs = 10000;
+  if (argc > 1)
+    util_sscanf_int( argv[1] , &num_jobs );
+
+  {
+    double elapsed;
+    double event_latency   = run_queue( num_jobs , true , 100 , 0 , 4 , 0 , &elapsed );
+    double polling_latency = run_queue( util_int_max( 1 , num_jobs / 100 ) , false , 100 , 0 , 4 , 0 , &elapsed );
+
+    test_assert_true( event_latency < polling_latency );
+  }
+
+  /*
+    Submitting takes 50 ms; with 10 submit threads 200 jobs are
+    submitted in approximately one second, a single thread needs ten
+    seconds.
+  */
+  {
+    double serial_time , parallel_time;
+    run_queue( 200 , true , 1000 , 50000 ,  1 , 0 , &serial_time );
+    run_queue( 200 , true , 1000 , 50000 , 10 , 0 , &parallel_time );
+    test_assert_true( 3 * parallel_time < serial_time );
+  }
+
+  /*
+    With at most 50 submits per second 100 jobs need two seconds.
+  */
+  {
+    double elapsed;
+    run_queue( 100 , true , 1000 , 0 , 4 , 50 , &elapsed );
+    test_assert_true( elapsed > 1.9 );
+  }
+  exit(0);
+}
@@ -0,0 +1,275 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'job_rsh_driver_test.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <errno.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/job_queue/rsh_driver.h>
+
+
+/*
+  The rsh command is a shell script which runs the command locally
+  with the environment variable RSH_HOST set to the host name, and
+  logs every invocation in rsh.log. The job script writes RSH_HOST to
+  the file given as first argument, and sleeps for the number of
+  seconds given as second argument in a child process; the pid of the
+  child is written to the file <first argument>.pid.
+*/
+
+#define JOB_SCRIPT "echo $RSH_HOST > $1\nsleep $2 &\necho $! > $1.pid\nwait\n"
+
+static void write_script( const char * filename , const char * content ) {
+  FILE * stream = util_fopen( filename , "w");
+  fprintf( stream , "#!/bin/sh\n%s" , content );
+  fclose( stream );
+  util_addmode_if_owner( filename , S_IXUSR );
+}
+
+
+static rsh_driver_type * alloc_driver( bool persistent ) {
+  rsh_driver_type * driver = rsh_driver_alloc();
+  char * rsh_cmd = util_alloc_abs_path( "rsh" );
+
+  rsh_driver_set_option( driver , RSH_CMD , rsh_cmd );
+  test_assert_true( rsh_driver_set_option( driver , RSH_PERSISTENT_CONNECTION , persistent ? "True" : "False" ));
+  test_assert_string_equal( rsh_driver_get_option( driver , RSH_PERSISTENT_CONNECTION ) , persistent ? "1" : "0");
+  free( rsh_cmd );
+  return driver;
+}
+
+
+static int count_lines( const char * filename ) {
+  int count = 0;
+  if (util_file_exists( filename )) {
+    FILE * stream = util_fopen( filename , "r");
+    int c;
+    while ((c = fgetc( stream )) != EOF) {
+      if (c == '\n')
+        count++;
+    }
+    fclose( stream );
+  }
+  return count;
+}
+
+
+static double wall_time( ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+
+static rsh_job_type * submit( rsh_driver_type * driver , int index , const char * sleep_time ) {
+  char * job_script = util_alloc_abs_path( "job.sh" );
+  char * cwd = util_alloc_cwd();
+  char * host_file = util_alloc_sprintf( "%s/job%d.host" , cwd , index );
+  const char * argv[2] = { host_file , sleep_time };
+  rsh_job_type * job = rsh_driver_submit_job( driver , job_script , 1 , cwd , "JOB" , 2 , argv );
+
+  free( host_file );
+  free( cwd );
+  free( job_script );
+  return job;
+}
+
+
+static void wait_for_status( rsh_driver_type * driver , rsh_job_type * job , job_status_type status ) {
+  double deadline = wall_time() + 30;
+  while (rsh_driver_get_job_status( driver , job ) == JOB_QUEUE_RUNNING) {
+    if (wall_time() > deadline)
+      test_error_exit("Job did not complete\n");
+    util_usleep( 10000 );
+  }
+  test_assert_int_equal( rsh_driver_get_job_status( driver , job ) , status );
+}
+
+
+/*
+  Waits until the job has written the pid of its sleep process, and
+  returns the pid.
+*/
+
+static pid_t wait_for_child_pid( int index ) {
+  char * pid_file = util_alloc_sprintf( "job%d.host.pid" , index );
+  double deadline = wall_time() + 30;
+  int pid = 0;
+
+  while (true) {
+    if (util_file_exists( pid_file )) {
+      char * content = util_fread_alloc_file_content( pid_file , NULL );
+      bool pid_ok = (sscanf( content , "%d" , &pid ) == 1) && (pid > 0);
+      free( content );
+      if (pid_ok)
+        break;
+    }
+    if (wall_time() > deadline)
+      test_error_exit("Job did not start\n");
+    util_usleep( 10000 );
+  }
+  free( pid_file );
+  return pid;
+}
+
+
+/*
+  Returns false as soon as the process is gone, and true if it is
+  still there after five seconds.
+*/
+
+static bool process_exists( pid_t pid ) {
+  double deadline = wall_time() + 5;
+  while (wall_time() < deadline) {
+    if ((kill( pid , 0 ) != 0) && (errno == ESRCH))
+      return false;
+    util_usleep( 10000 );
+  }
+  return true;
+}
+
+
+static int count_host( int num_jobs , const char * host_name ) {
+  int count = 0;
+  for (int i = 0; i < num_jobs; i++) {
+    char * host_file = util_alloc_sprintf( "job%d.host" , i );
+    if (util_file_exists( host_file )) {
+      char * host = util_fread_alloc_file_content( host_file , NULL );
+      if (strncmp( host , host_name , strlen( host_name )) == 0)
+        count++;
+      free( host );
+    }
+    free( host_file );
+  }
+  return count;
+}
+
+
+/*
+  Twelve jobs on two hosts with eight and four slots; the hosts are
+  filled in proportion to their number of slots.
+*/
+
+void test_run_jobs( bool persistent ) {
+  test_work_area_type * work_area = test_work_area_alloc( "job_rsh_driver" );
+  rsh_driver_type * driver = alloc_driver( persistent );
+  const int num_jobs = 12;
+  rsh_job_type * jobs[12];
+  double submit_time;
+
+  write_script( "rsh" , "echo \"$@\" >> rsh.log\nhost=$1\nshift\nRSH_HOST=$host exec /bin/sh -c \"$*\"\n");
+  write_script( "job.sh" , JOB_SCRIPT );
+  rsh_driver_add_host( driver , "localhost" , 8 );
+  rsh_driver_add_host( driver , "127.0.0.1" , 4 );
+
+  submit_time = wall_time();
+  for (int i = 0; i < num_jobs; i++)
+    jobs[i] = submit( driver , i , "1" );
+  submit_time = wall_time() - submit_time;
+  test_assert_NULL( submit( driver , num_jobs , "1" ) );
+
+  for (int i = 0; i < num_jobs; i++) {
+    test_assert_not_NULL( jobs[i] );
+    wait_for_status( driver , jobs[i] , JOB_QUEUE_DONE );
+  }
+  printf("%-10s submit time per job: %6.2f ms  rsh processes: %d\n", persistent ? "persistent" : "per job" , 1000 * submit_time / num_jobs , count_lines( "rsh.log" ));
+
+  test_assert_int_equal( count_host( num_jobs , "localhost" ) , 8 );
+  test_assert_int_equal( count_host( num_jobs , "127.0.0.1" ) , 4 );
+  test_assert_int_equal( count_lines( "rsh.log" ) , persistent ? 2 : num_jobs );
+
+  /*
+    Killing a job; first right after the submit and then when it is
+    running. The sleep process started by the job must also be gone.
+  */
+  {
+    rsh_job_type * job = submit( driver , num_jobs , "100" );
+    double start = wall_time();
+    rsh_driver_kill_job( driver , job );
+    wait_for_status( driver , job , JOB_QUEUE_DONE );
+    test_assert_true( wall_time() - start < 10 );
+    rsh_driver_free_job( job );
+  }
+  {
+    rsh_job_type * job = submit( driver , num_jobs + 1 , "100" );
+    pid_t child_pid = wait_for_child_pid( num_jobs + 1 );
+    double start = wall_time();
+
+    test_assert_int_equal( kill( child_pid , 0 ) , 0 );
+    rsh_driver_kill_job( driver , job );
+    wait_for_status( driver , job , JOB_QUEUE_DONE );
+    test_assert_true( wall_time() - start < 10 );
+    test_assert_false( process_exists( child_pid ));
+    rsh_driver_free_job( job );
+  }
+
+  /* A job which is freed before it has completed. */
+  rsh_driver_free_job( submit( driver , 0 , "0.1" ) );
+  util_usleep( 500000 );
+
+  for (int i = 0; i < num_jobs; i++)
+    rsh_driver_free_job( jobs[i] );
+  rsh_driver_free__( driver );
+  test_work_area_free( work_area );
+}
+
+
+/*
+  The remote shell exits shortly after the control connection has been
+  started; the job sent through it is reported as EXIT, and the
+  following jobs are started with one rsh process each.
+*/
+
+void test_broken_connection( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "job_rsh_driver" );
+  rsh_driver_type * driver = alloc_driver( true );
+
+  write_script( "rsh" , "echo \"$@\" >> rsh.log\nhost=$1\nshift\nif [ \"$*\" = sh ]; then sleep 0.2; exit 1; fi\nRSH_HOST=$host exec /bin/sh -c \"$*\"\n");
+  write_script( "job.sh" , JOB_SCRIPT );
+  rsh_driver_add_host( driver , "localhost" , 2 );
+  {
+    rsh_job_type * job1 = submit( driver , 0 , "0" );
+    rsh_job_type * job2;
+    wait_for_status( driver , job1 , JOB_QUEUE_EXIT );
+
+    job2 = submit( driver , 1 , "0" );
+    wait_for_status( driver , job2 , JOB_QUEUE_DONE );
+    test_assert_false( util_file_exists( "job0.host" ));
+    test_assert_int_equal( count_host( 2 , "localhost" ) , 1 );
+
+    rsh_driver_free_job( job1 );
+    rsh_driver_free_job( job2 );
+  }
+  rsh_driver_free__( driver );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_run_jobs( true );
+  test_run_jobs( false );
+  test_broken_connection( );
+  exit(0);
+}
@@ -18,6 +18,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <ert/util/test_work_area.h>
 #include <ert/util/test_util.h>
@@ -42,6 +44,7 @@ void setoption_setalloptions_optionsset() {
   test_option(driver, TORQUE_KEEP_QSUB_OUTPUT, "0");
   test_option(driver, TORQUE_CLUSTER_LABEL, "thecluster");
   test_option(driver, TORQUE_JOB_PREFIX_KEY, "coolJob");
+  test_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL, "60");
 
   test_assert_int_equal( 0 , torque_driver_get_submit_sleep(driver));
   test_assert_NULL( torque_driver_get_debug_stream(driver) );
@@ -68,6 +71,9 @@ void setoption_set_typed_options_wrong_format_returns_false() {
   test_assert_false(torque_driver_set_option(driver, TORQUE_KEEP_QSUB_OUTPUT, "22"));
   test_assert_false(torque_driver_set_option(driver, TORQUE_KEEP_QSUB_OUTPUT, "1.1"));
   test_assert_false(torque_driver_set_option(driver, TORQUE_SUBMIT_SLEEP, "X45"));
+  test_assert_false(torque_driver_set_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL, "2.5"));
+  test_assert_false(torque_driver_set_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL, "-1"));
+  test_assert_true(torque_driver_set_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL, "0"));
 }
 
 void getoption_nooptionsset_defaultoptionsreturned() {
@@ -80,6 +86,7 @@ void getoption_nooptionsset_defaultoptionsreturned() {
   test_assert_string_equal(torque_driver_get_option(driver, TORQUE_NUM_NODES), "1");
   test_assert_string_equal(torque_driver_get_option(driver, TORQUE_CLUSTER_LABEL), NULL );
   test_assert_string_equal(torque_driver_get_option(driver, TORQUE_JOB_PREFIX_KEY), NULL);
+  test_assert_string_equal(torque_driver_get_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL), TORQUE_DEFAULT_QSTAT_REFRESH_INTERVAL);
 
   printf("Default options OK\n");
   torque_driver_free(driver);
@@ -136,6 +143,105 @@ void test_parse_invalid( ) {
 }
 
 
+
+/*
+  The fake qsub hands out the job numbers 1,2,3,... and the fake qstat
+  lists the content of the file qstat.out, which also contains jobs
+  which were not submitted by the driver. Every qstat call is logged
+  with its number of arguments in qstat.log.
+*/
+
+static void write_script(const char * filename, const char * content) {
+  FILE * stream = util_fopen(filename, "w");
+  fprintf(stream, "#!/bin/sh\n%s", content);
+  fclose(stream);
+  util_addmode_if_owner(filename, S_IXUSR);
+}
+
+static void write_qstat_output(int num_jobs, const char * status_letters) {
+  FILE * stream = util_fopen("qstat.out", "w");
+  fprintf(stream, "Job id                    Name             User            Time Use S Queue\n");
+  fprintf(stream, "------------------------- ---------------- --------------- -------- - -----\n");
+  for (int i = 1; i <= 2 * num_jobs; i++) {
+    char status = status_letters[i % strlen(status_letters)];
+    fprintf(stream, "%d.fake-server              job-%d           user            00:00:01 %c normal\n", i + (i > num_jobs ? 1000000 : 0), i, status);
+  }
+  fclose(stream);
+}
+
+static int count_qstat_calls(int num_args) {
+  int count = 0;
+  FILE * stream = util_fopen("qstat.log", "r");
+  int args;
+  while (fscanf(stream, "%d", &args) == 1) {
+    if (args == num_args)
+      count++;
+  }
+  fclose(stream);
+  return count;
+}
+
+static job_status_type status_from_letter(char letter) {
+  switch (letter) {
+  case 'Q':
+    return JOB_QUEUE_PENDING;
+  case 'R':
+    return JOB_QUEUE_RUNNING;
+  default:
+    return JOB_QUEUE_DONE;
+  }
+}
+
+void test_qstat_cache(int num_jobs) {
+  test_work_area_type * work_area = test_work_area_alloc("job_torque_qstat_cache");
+  torque_driver_type * driver = torque_driver_alloc();
+  torque_job_type ** jobs = util_calloc(num_jobs, sizeof * jobs);
+  char * run_path = util_alloc_cwd();
+
+  write_script("qsub", "n=$(( $(cat qsub.count) + 1 ))\necho $n > qsub.count\necho $n.fake-server\n");
+  write_script("qstat", "echo $# >> qstat.log\ncat qstat.out\n");
+  {
+    FILE * stream = util_fopen("qsub.count", "w");
+    fprintf(stream, "0\n");
+    fclose(stream);
+  }
+  {
+    char * qsub_cmd = util_alloc_abs_path("qsub");
+    char * qstat_cmd = util_alloc_abs_path("qstat");
+    torque_driver_set_option(driver, TORQUE_QSUB_CMD, qsub_cmd);
+    torque_driver_set_option(driver, TORQUE_QSTAT_CMD, qstat_cmd);
+    torque_driver_set_option(driver, TORQUE_QSTAT_REFRESH_INTERVAL, "1");
+    free(qsub_cmd);
+    free(qstat_cmd);
+  }
+
+  for (int i = 0; i < num_jobs; i++)
+    jobs[i] = torque_driver_submit_job(driver, "job.sh", 1, run_path, "TEST-QSTAT-CACHE", 0, NULL);
+
+  write_qstat_output(num_jobs, "QRC");
+  for (int i = 0; i < num_jobs; i++)
+    test_assert_int_equal(torque_driver_get_job_status(driver, jobs[i]), status_from_letter("QRC"[(i + 1) % 3]));
+  test_assert_int_equal(count_qstat_calls(0), 1);
+  test_assert_int_equal(count_qstat_calls(1), 0);
+
+  /* The cached status is used until the refresh interval has passed. */
+  write_qstat_output(num_jobs, "E");
+  test_assert_int_equal(torque_driver_get_job_status(driver, jobs[0]), JOB_QUEUE_RUNNING);
+  sleep(2);
+  for (int i = 0; i < num_jobs; i++)
+    test_assert_int_equal(torque_driver_get_job_status(driver, jobs[i]), JOB_QUEUE_DONE);
+  test_assert_int_equal(count_qstat_calls(0), 2);
+  test_assert_int_equal(count_qstat_calls(1), 0);
+
+  for (int i = 0; i < num_jobs; i++)
+    torque_driver_free_job(jobs[i]);
+  free(jobs);
+  free(run_path);
+  torque_driver_free(driver);
+  test_work_area_free(work_area);
+}
+
+
 int main(int argc, char ** argv) {
   getoption_nooptionsset_defaultoptionsreturned();
   setoption_setalloptions_optionsset();
@@ -143,5 +249,6 @@ int main(int argc, char ** argv) {
   setoption_set_typed_options_wrong_format_returns_false();
   create_submit_script_script_according_to_input();
   test_parse_invalid( );
+  test_qstat_cache( 2000 );
   exit(0);
 }
@@ -196,6 +196,15 @@ class EclFile(BaseCClass):
               in cases where a high number of EclFile instances are
               open concurrently.
 
+           ecl.ECL_FILE_MMAP : The file is memory mapped and the
+              keywords are loaded from the mapping instead of with
+              fseek()/fread(); only for unformatted files opened
+              read-only.
+
+           ecl.ECL_FILE_INDEX : The keyword index is stored in the
+              file 'filename.index' and reused when the file is
+              opened again, as long as the file is unchanged.
+
         When the file has been loaded the EclFile instance can be used
         to query for and get reference to the EclKW instances
         constituting the file, like e.g. SWAT from a restart file or
@@ -36,6 +36,10 @@ class AnalysisConfig(BaseCClass):
     _have_enough_realisations = EnkfPrototype("bool analysis_config_have_enough_realisations(analysis_config, int, int)")
     _get_max_runtime = EnkfPrototype("int analysis_config_get_max_runtime(analysis_config)")
     _set_max_runtime = EnkfPrototype("void analysis_config_set_max_runtime(analysis_config, int)")
+    _get_update_threads = EnkfPrototype("int analysis_config_get_update_threads(analysis_config)")
+    _set_update_threads = EnkfPrototype("void analysis_config_set_update_threads(analysis_config, int)")
+    _get_update_block_size = EnkfPrototype("int analysis_config_get_update_block_size(analysis_config)")
+    _set_update_block_size = EnkfPrototype("void analysis_config_set_update_block_size(analysis_config, int)")
     _get_stop_long_running = EnkfPrototype("bool analysis_config_get_stop_long_running(analysis_config)")
     _set_stop_long_running = EnkfPrototype("void analysis_config_set_stop_long_running(analysis_config, bool)")
     _get_active_module_name = EnkfPrototype("char* analysis_config_get_active_module_name(analysis_config)")
@@ -111,6 +115,20 @@ class AnalysisConfig(BaseCClass):
     def set_max_runtime(self, max_runtime):
         self._set_max_runtime(max_runtime)
 
+    def get_update_threads(self):
+        """ @rtype: int """
+        return self._get_update_threads()
+
+    def set_update_threads(self, update_threads):
+        self._set_update_threads(update_threads)
+
+    def get_update_block_size(self):
+        """ @rtype: int """
+        return self._get_update_block_size()
+
+    def set_update_block_size(self, block_size):
+        self._set_update_block_size(block_size)
+
     def free(self):
         self._free()
         
@@ -19,6 +19,8 @@ class EnkfControlKeywords(object):
         ert_keywords.addKeyword(self.addEnkfScaling())
         ert_keywords.addKeyword(self.addEnkfTruncation())
         ert_keywords.addKeyword(self.addUpdateLogPath())
+        ert_keywords.addKeyword(self.addUpdateThreads())
+        ert_keywords.addKeyword(self.addUpdateBlockSize())
         ert_keywords.addKeyword(self.addRerunStart())
         ert_keywords.addKeyword(self.addUpdateResults())
         ert_keywords.addKeyword(self.addEnkfCrossValidation())
@@ -166,6 +168,24 @@ class EnkfControlKeywords(object):
         return update_log_path
 
 
+    def addUpdateThreads(self):
+        update_threads = ConfigurationLineDefinition(keyword=KeywordDefinition("UPDATE_THREADS"),
+                                                     arguments=[IntegerArgument(from_value=0)],
+                                                     documentation_link="keywords/update_threads",
+                                                     required=False,
+                                                     group=self.group)
+        return update_threads
+
+
+    def addUpdateBlockSize(self):
+        update_block_size = ConfigurationLineDefinition(keyword=KeywordDefinition("UPDATE_BLOCK_SIZE"),
+                                                        arguments=[IntegerArgument(from_value=0)],
+                                                        documentation_link="keywords/update_block_size",
+                                                        required=False,
+                                                        group=self.group)
+        return update_block_size
+
+
     def addUpdateResults(self):
         update_results = ConfigurationLineDefinition(keyword=KeywordDefinition("UPDATE_RESULTS"),
                                                      arguments=[BoolArgument()],
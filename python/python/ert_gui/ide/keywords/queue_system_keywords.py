@@ -1,4 +1,4 @@
-from ert_gui.ide.keywords.definitions import StringArgument, KeywordDefinition, IntegerArgument, PathArgument
+from ert_gui.ide.keywords.definitions import StringArgument, KeywordDefinition, IntegerArgument, PathArgument, FloatArgument
 from ert_gui.ide.keywords.definitions.configuration_line_definition import ConfigurationLineDefinition
 
 
@@ -21,6 +21,8 @@ class QueueSystemKeywords(object):
         ert_keywords.addKeyword(self.addMaxRunningRsh())
         ert_keywords.addKeyword(self.addHostType())
         ert_keywords.addKeyword(self.addLsfResources())
+        ert_keywords.addKeyword(self.addSubmitThreads())
+        ert_keywords.addKeyword(self.addMaxSubmitRate())
 
 
 
@@ -95,6 +97,24 @@ class QueueSystemKeywords(object):
         return max_running_local
 
 
+    def addSubmitThreads(self):
+        submit_threads = ConfigurationLineDefinition(keyword = KeywordDefinition("SUBMIT_THREADS"),
+                                                     arguments=[IntegerArgument(from_value=1)],
+                                                     documentation_link="keywords/submit_threads",
+                                                     required=False,
+                                                     group=self.group)
+        return submit_threads
+
+
+    def addMaxSubmitRate(self):
+        max_submit_rate = ConfigurationLineDefinition(keyword = KeywordDefinition("MAX_SUBMIT_RATE"),
+                                                      arguments=[FloatArgument(from_value=0)],
+                                                      documentation_link="keywords/max_submit_rate",
+                                                      required=False,
+                                                      group=self.group)
+        return max_submit_rate
+
+
     def addRshHost(self):
         rsh_host = ConfigurationLineDefinition(keyword = KeywordDefinition("RSH_HOST"),
                                                arguments=[StringArgument(), StringArgument(rest_of_line=True, allow_space=True)],
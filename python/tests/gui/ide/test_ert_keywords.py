@@ -104,6 +104,8 @@ class ErtKeywordTest(ExtendedTestCase):
         self.keywordTest("ENKF_SCALING", [BoolArgument], "keywords/enkf_scaling", "Enkf Control")
         self.keywordTest("ENKF_TRUNCATION", [FloatArgument], "keywords/enkf_truncation", "Enkf Control")
         self.keywordTest("UPDATE_LOG_PATH", [PathArgument], "keywords/update_log_path", "Enkf Control")
+        self.keywordTest("UPDATE_THREADS", [IntegerArgument], "keywords/update_threads", "Enkf Control")
+        self.keywordTest("UPDATE_BLOCK_SIZE", [IntegerArgument], "keywords/update_block_size", "Enkf Control")
         self.keywordTest("UPDATE_RESULTS", [BoolArgument], "keywords/update_results", "Enkf Control")
         self.keywordTest("ENKF_CROSS_VALIDATION", [StringArgument], "keywords/enkf_cross_validation", "Enkf Control")
         self.keywordTest("ENKF_KERNEL_REGRESSION", [StringArgument], "keywords/enkf_kernel_regression", "Enkf Control")
@@ -145,6 +147,8 @@ class ErtKeywordTest(ExtendedTestCase):
         self.keywordTest("RSH_COMMAND", [PathArgument], "keywords/rsh_command", "Queue System")
         self.keywordTest("MAX_RUNNING_RSH", [IntegerArgument], "keywords/max_running_rsh", "Queue System")
         self.keywordTest("HOST_TYPE", [StringArgument], "keywords/host_type", "Queue System")
+        self.keywordTest("SUBMIT_THREADS", [IntegerArgument], "keywords/submit_threads", "Queue System")
+        self.keywordTest("MAX_SUBMIT_RATE", [FloatArgument], "keywords/max_submit_rate", "Queue System")
 
 
     def test_plot_keywords(self):